@@ -0,0 +1,17 @@
+/**
+ * \file            printf.h
+ * \brief           Debug output for benchmark build
+ *
+ * Library configuration includes `printf.h` from the application.
+ * Benchmark disables debug output, to keep it out of measurements and JSON results.
+ */
+#ifndef LWCELL_BENCH_PRINTF_HDR_H
+#define LWCELL_BENCH_PRINTF_HDR_H
+
+#include <stdio.h>
+
+#define LWCELL_CFG_DBG_OUT(fmt, ...)                                                                                   \
+    do {                                                                                                               \
+    } while (0)
+
+#endif /* LWCELL_BENCH_PRINTF_HDR_H */
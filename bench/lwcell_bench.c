@@ -0,0 +1,416 @@
+/**
+ * \file            lwcell_bench.c
+ * \brief           Microbenchmarks for library hot paths
+ *
+ * Benchmarks run on host without modem. Core is initialized manually,
+ * without producer and process threads, so that parser and utility functions
+ * can be called directly.
+ *
+ * Results are printed to standard output in JSON format.
+ * Optional first argument is a multiplier for number of iterations.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lwcell/lwcell.h"
+#include "lwcell/lwcell_buff.h"
+#include "lwcell/lwcell_mem.h"
+#include "lwcell/lwcell_pbuf.h"
+#include "lwcell/lwcell_private.h"
+#include "lwcell/lwcell_timeout.h"
+
+/**
+ * \brief           Single benchmark result
+ */
+typedef struct {
+    const char* name; /*!< Benchmark name */
+    const char* unit; /*!< Unit of work, `line`, `byte` or `op` */
+    uint64_t units;   /*!< Number of processed units */
+    uint64_t ns;      /*!< Total time in units of nanoseconds */
+} bench_result_t;
+
+/**
+ * \brief           Benchmark function
+ * \param[in]       iters: Number of iterations to run
+ * \return          Number of processed units
+ */
+typedef uint64_t (*bench_fn)(uint32_t iters);
+
+/* Recorded unsolicited messages, as received from modem when idle */
+static const char* urc_mix[] = {
+    "+CSQ: 21,99\r\n",
+    "+CREG: 0,1\r\n",
+    "+CGREG: 0,1\r\n",
+    "+CSQ: 18,0\r\n",
+    "+CREG: 0,5\r\n",
+    "NORMAL POWER DOWN\r\n",
+    "+CTZV: 23/10/19,12:00:00,+8\r\n",
+    "\r\n",
+};
+
+static volatile size_t bench_sink; /* Prevents compiler from removing results */
+static uint8_t payload[LWCELL_CFG_CONN_MAX_DATA_LEN];
+
+/**
+ * \brief           Get monotonic time in units of nanoseconds
+ * \return          Current time
+ */
+static uint64_t
+prv_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * \brief           Send data to AT port, not used by benchmarks
+ * \param[in]       data: Data to send
+ * \param[in]       len: Number of bytes to send
+ * \return          Number of bytes sent
+ */
+static size_t
+prv_send_fn(const void* data, size_t len) {
+    LWCELL_UNUSED(data);
+    return len;
+}
+
+/**
+ * \brief           Initialize low-level communication, called by \ref lwcell_init only
+ * \param[in]       ll: Low-level structure
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_ll_init(lwcell_ll_t* ll) {
+    ll->send_fn = prv_send_fn;
+    return lwcellOK;
+}
+
+/**
+ * \brief           Deinitialize low-level communication
+ * \param[in]       ll: Low-level structure
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_ll_deinit(lwcell_ll_t* ll) {
+    LWCELL_UNUSED(ll);
+    return lwcellOK;
+}
+
+/**
+ * \brief           Connection callback, accepts all received data
+ * \param[in]       evt: Event information
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+prv_conn_evt_fn(lwcell_evt_t* evt) {
+    if (lwcell_evt_get_type(evt) == LWCELL_EVT_CONN_RECV) {
+        bench_sink += lwcell_pbuf_length(lwcell_evt_conn_recv_get_buff(evt), 1);
+    }
+    return lwcellOK;
+}
+
+/**
+ * \brief           Timeout callback, never called as process thread is not running
+ * \param[in]       arg: Custom argument
+ */
+static void
+prv_timeout_fn(void* arg) {
+    LWCELL_UNUSED(arg);
+}
+
+/**
+ * \brief           Feed data to parser, the same way as \ref lwcell_input_process does
+ * \param[in]       data: Data to process
+ * \param[in]       len: Number of bytes
+ */
+static void
+prv_process(const void* data, size_t len) {
+    lwcell_core_lock();
+    lwcelli_process(data, len);
+    lwcell_core_unlock();
+}
+
+/**
+ * \brief           Parse mix of unsolicited lines
+ */
+static uint64_t
+bench_parser_urc_mix(uint32_t iters) {
+    uint64_t lines = 0;
+
+    for (uint32_t i = 0; i < iters; ++i) {
+        for (size_t j = 0; j < LWCELL_ARRAYSIZE(urc_mix); ++j) {
+            prv_process(urc_mix[j], strlen(urc_mix[j]));
+            ++lines;
+        }
+    }
+    return lines;
+}
+
+/**
+ * \brief           Receive connection data with `+RECEIVE` statement,
+ *                  delivered in chunks as UART driver would do
+ */
+static uint64_t
+bench_parser_receive(uint32_t iters) {
+    char hdr[32];
+    size_t hdr_len;
+    uint64_t bytes = 0;
+
+    hdr_len = (size_t)sprintf(hdr, "+RECEIVE,0,%u:\r\n", (unsigned)sizeof(payload));
+    for (uint32_t i = 0; i < iters; ++i) {
+        prv_process(hdr, hdr_len);
+        for (size_t off = 0; off < sizeof(payload); off += 64) {
+            prv_process(&payload[off], LWCELL_MIN(64, sizeof(payload) - off));
+        }
+        bytes += sizeof(payload);
+    }
+    return bytes;
+}
+
+/**
+ * \brief           Write and read ring buffer in blocks
+ */
+static uint64_t
+bench_buff_write_read(uint32_t iters) {
+    lwcell_buff_t buff;
+    uint8_t block[256];
+    uint64_t bytes = 0;
+
+    if (!lwcell_buff_init(&buff, 4096)) {
+        return 0;
+    }
+    memset(block, 0xA5, sizeof(block));
+    for (uint32_t i = 0; i < iters; ++i) {
+        for (size_t j = 0; j < 8; ++j) {
+            lwcell_buff_write(&buff, block, sizeof(block));
+        }
+        for (size_t j = 0; j < 8; ++j) {
+            bytes += lwcell_buff_read(&buff, block, sizeof(block));
+        }
+    }
+    bench_sink += block[0];
+    lwcell_buff_free(&buff);
+    return bytes;
+}
+
+/**
+ * \brief           Create chain of packet buffers
+ * \param[in]       count: Number of packet buffers in chain
+ * \param[in]       len: Length of each packet buffer
+ * \return          Chain head or `NULL` on failure
+ */
+static lwcell_pbuf_p
+prv_pbuf_chain_new(size_t count, size_t len) {
+    lwcell_pbuf_p head = NULL, p;
+
+    for (size_t i = 0; i < count; ++i) {
+        if ((p = lwcell_pbuf_new(len)) == NULL) {
+            break;
+        }
+        memset(lwcell_pbuf_data(p), 'a' + (int)i, len);
+        if (head == NULL) {
+            head = p;
+        } else {
+            lwcell_pbuf_cat(head, p);
+        }
+    }
+    return head;
+}
+
+/**
+ * \brief           Find string at the end of packet buffer chain
+ */
+static uint64_t
+bench_pbuf_memfind(uint32_t iters) {
+    lwcell_pbuf_p p;
+    uint64_t ops = 0;
+
+    if ((p = prv_pbuf_chain_new(4, 512)) == NULL) {
+        return 0;
+    }
+    lwcell_pbuf_take(p, "\r\n\r\n", 4, lwcell_pbuf_length(p, 1) - 4);
+    for (uint32_t i = 0; i < iters; ++i) {
+        bench_sink += lwcell_pbuf_memfind(p, "\r\n\r\n", 4, 0);
+        ++ops;
+    }
+    lwcell_pbuf_free(p);
+    return ops;
+}
+
+/**
+ * \brief           Copy data from packet buffer chain to linear memory
+ */
+static uint64_t
+bench_pbuf_copy(uint32_t iters) {
+    lwcell_pbuf_p p;
+    uint8_t out[2048];
+    uint64_t bytes = 0;
+
+    if ((p = prv_pbuf_chain_new(4, 512)) == NULL) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < iters; ++i) {
+        bytes += lwcell_pbuf_copy(p, out, sizeof(out), 0);
+    }
+    bench_sink += out[sizeof(out) - 1];
+    lwcell_pbuf_free(p);
+    return bytes;
+}
+
+/**
+ * \brief           Allocate 2 packet buffers, concatenate and free them
+ */
+static uint64_t
+bench_pbuf_cat(uint32_t iters) {
+    lwcell_pbuf_p head, tail;
+    uint64_t ops = 0;
+
+    for (uint32_t i = 0; i < iters; ++i) {
+        head = lwcell_pbuf_new(256);
+        tail = lwcell_pbuf_new(256);
+        if (head == NULL || tail == NULL) {
+            lwcell_pbuf_free(head);
+            lwcell_pbuf_free(tail);
+            break;
+        }
+        lwcell_pbuf_cat(head, tail);
+        lwcell_pbuf_free(head);
+        ++ops;
+    }
+    return ops;
+}
+
+/**
+ * \brief           Allocate and free memory of mixed sizes with multiple live blocks
+ */
+static uint64_t
+bench_mem_mixed(uint32_t iters) {
+    static const size_t sizes[] = {16, 48, 24, 256, 32, 1460, 64, 128, 8, 512};
+    void* slots[64] = {NULL};
+    uint64_t ops = 0;
+    uint32_t seed = 1;
+
+    for (uint32_t i = 0; i < iters; ++i) {
+        size_t s;
+
+        seed = seed * 1103515245U + 12345U;
+        s = (seed >> 16) % LWCELL_ARRAYSIZE(slots);
+        if (slots[s] != NULL) {
+            lwcell_mem_free(slots[s]);
+            slots[s] = NULL;
+        } else {
+            slots[s] = lwcell_mem_malloc(sizes[i % LWCELL_ARRAYSIZE(sizes)]);
+        }
+        ++ops;
+    }
+    for (size_t s = 0; s < LWCELL_ARRAYSIZE(slots); ++s) {
+        lwcell_mem_free(slots[s]);
+    }
+    return ops;
+}
+
+/**
+ * \brief           Add many timeouts with different times and remove them
+ */
+static uint64_t
+bench_timeout_add_remove(uint32_t iters) {
+    const uint32_t count = 1000;
+    uint64_t ops = 0;
+    uint32_t seed = 1;
+
+    for (uint32_t i = 0; i < iters; ++i) {
+        for (uint32_t j = 0; j < count; ++j) {
+            seed = seed * 1103515245U + 12345U;
+            lwcell_timeout_add(3600000U + ((seed >> 16) & 0xFFFF), prv_timeout_fn, NULL);
+        }
+        while (lwcell_timeout_remove(prv_timeout_fn) == lwcellOK) {}
+        ops += 2 * count;
+    }
+    return ops;
+}
+
+/**
+ * \brief           Run single benchmark
+ * \param[out]      res: Result output
+ * \param[in]       name: Benchmark name
+ * \param[in]       unit: Unit of work
+ * \param[in]       fn: Benchmark function
+ * \param[in]       iters: Number of iterations
+ */
+static void
+prv_run(bench_result_t* res, const char* name, const char* unit, bench_fn fn, uint32_t iters) {
+    uint64_t start;
+
+    fn(iters / 10 + 1); /* Warm-up */
+    start = prv_now_ns();
+    res->units = fn(iters);
+    res->ns = prv_now_ns() - start;
+    res->name = name;
+    res->unit = unit;
+}
+
+/**
+ * \brief           Initialize library core without threads
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+prv_core_init(void) {
+    lwcell_sys_init();
+    if (!lwcell_sys_mbox_create(&lwcell.mbox_process, LWCELL_CFG_THREAD_PROCESS_MBOX_SIZE)) {
+        return 0;
+    }
+    lwcell_ll_init(&lwcell.ll);
+    lwcell.status.f.initialized = 1;
+    lwcell.status.f.dev_present = 1;
+
+    /* Connection used by receive benchmark */
+    lwcell.m.conns[0].status.f.active = 1;
+    lwcell.m.conns[0].evt_func = prv_conn_evt_fn;
+    return 1;
+}
+
+/**
+ * \brief           Program entry point
+ * \param[in]       argc: Number of arguments
+ * \param[in]       argv: Arguments. Optional first argument is iteration multiplier
+ * \return          `0` on success
+ */
+int
+main(int argc, char** argv) {
+    bench_result_t res[8];
+    size_t cnt = 0;
+    uint32_t mul = 1;
+
+    if (argc > 1 && atoi(argv[1]) > 0) {
+        mul = (uint32_t)atoi(argv[1]);
+    }
+    if (!prv_core_init()) {
+        fprintf(stderr, "Cannot initialize library core\r\n");
+        return 1;
+    }
+    memset(payload, 'x', sizeof(payload));
+
+    prv_run(&res[cnt++], "parser_urc_mix", "line", bench_parser_urc_mix, 20000 * mul);
+    prv_run(&res[cnt++], "parser_receive", "byte", bench_parser_receive, 2000 * mul);
+    prv_run(&res[cnt++], "buff_write_read", "byte", bench_buff_write_read, 20000 * mul);
+    prv_run(&res[cnt++], "pbuf_memfind", "op", bench_pbuf_memfind, 20000 * mul);
+    prv_run(&res[cnt++], "pbuf_copy", "byte", bench_pbuf_copy, 50000 * mul);
+    prv_run(&res[cnt++], "pbuf_cat", "op", bench_pbuf_cat, 200000 * mul);
+    prv_run(&res[cnt++], "mem_mixed", "op", bench_mem_mixed, 1000000 * mul);
+    prv_run(&res[cnt++], "timeout_add_remove", "op", bench_timeout_add_remove, 20 * mul);
+
+    printf("{\n  \"suite\": \"lwcell_bench\",\n  \"multiplier\": %u,\n  \"results\": [\n", (unsigned)mul);
+    for (size_t i = 0; i < cnt; ++i) {
+        double sec = (double)res[i].ns / 1e9;
+
+        printf("    {\"name\": \"%s\", \"unit\": \"%s\", \"units\": %llu, \"ns\": %llu, "
+               "\"ns_per_unit\": %.3f, \"units_per_sec\": %.1f}%s\n",
+               res[i].name, res[i].unit, (unsigned long long)res[i].units, (unsigned long long)res[i].ns,
+               res[i].units > 0 ? (double)res[i].ns / (double)res[i].units : 0.0,
+               sec > 0 ? (double)res[i].units / sec : 0.0, i + 1 < cnt ? "," : "");
+    }
+    printf("  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,1952 @@
+/**
+ * \file            lwcell_bench_e2e.c
+ * \brief           End-to-end benchmarks over simulated modem link
+ *
+ * Benchmarks run full library stack, including producer and process threads,
+ * against modem model from \ref lwcell_modem_sim.c.
+ *
+ * Benchmark is built with \ref LWCELL_CFG_AT_PORT_AUTOBAUD enabled,
+ * link is switched to \ref LWCELL_CFG_AT_PORT_BAUDRATE_MAX during reset when supported by modem.
+ * `lwcell_bench_e2e_cmux` variant is built with \ref LWCELL_CFG_CMUX enabled,
+ * where AT commands and connection data use separate multiplexer channels.
+ * Both variants are built with \ref LWCELL_CFG_TRANSPARENT and \ref LWCELL_CFG_PPP enabled,
+ * transparent mode benchmark runs last as stopping it deactivates PDP context.
+ * PPP peer of modem model echoes all frames back to host.
+ * HTTP server of modem model fails every 5th request, HTTP download resumes after each failure.
+ * HTTP upload latency is time between progress events of consecutive body segments.
+ * MQTT publish burst writes messages with non-blocking client as fast as output buffer allows.
+ * MQTT client feature benchmarks run with software client only.
+ * Broker of modem model acknowledges messages on `dup/` topics only when sent again with DUP flag.
+ * Broker echoes messages on `echo/` topics back to publishing client.
+ *
+ * Results are printed to standard output in JSON format.
+ * Link and workload are configured with optional arguments:
+ *
+ *  - `--baud N`: Initial UART baudrate, default `115200`
+ *  - `--modem-baud N`: Initial modem UART baudrate, default is the same as `--baud`
+ *  - `--modem-max-baud N`: Maximal baudrate supported by modem, default `921600`
+ *  - `--delay-us N`: Modem processing delay in units of microseconds, default `2000`
+ *  - `--rtt-ms N`: Radio link round-trip time in units of milliseconds, default `50`
+ *  - `--size N`: Number of bytes for TCP upload and download and HTTP download and upload, default `32768`
+ *  - `--msg N`: Length of single TCP upload message, default `1460`
+ *  - `--count N`: Number of MQTT messages and SMS messages, default `20`
+ *  - `--mqtt-size N`: MQTT publish payload length, default `128`
+ */
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lwcell/apps/lwcell_mqtt_client_api.h"
+#include "lwcell/lwcell.h"
+#include "lwcell/lwcell_netconn.h"
+#include "lwcell_modem_sim.h"
+
+/**
+ * \brief           Single end-to-end benchmark result
+ */
+typedef struct {
+    const char* name;   /*!< Benchmark name */
+    const char* reason; /*!< Reason for skipped benchmark, `NULL` when benchmark was run */
+    uint8_t ok;         /*!< Set to `1` when all operations succeeded */
+    uint64_t bytes;     /*!< Number of application bytes transferred */
+    uint64_t msgs;      /*!< Number of messages with measured latency */
+    uint64_t ns;        /*!< Total time in units of nanoseconds */
+    uint64_t cpu_ns;    /*!< Library CPU time in units of nanoseconds */
+    uint64_t lat[4];    /*!< Latency `p50`, `p90`, `p99` and `max` in units of nanoseconds */
+} e2e_result_t;
+
+/**
+ * \brief           Benchmark configuration
+ */
+static struct {
+    lwcell_modem_sim_cfg_t link; /*!< Simulated link */
+    uint32_t size;               /*!< TCP upload and download size */
+    uint32_t msg;                /*!< TCP upload message size */
+    uint32_t count;              /*!< Number of MQTT and SMS messages */
+    uint32_t mqtt_size;          /*!< MQTT payload size */
+} cfg = {
+    .link = {.baudrate = 115200, .max_baudrate = 921600, .proc_delay_us = 2000, .rtt_us = 50000},
+    .size = 32768,
+    .msg = LWCELL_CFG_CONN_MAX_DATA_LEN,
+    .count = 20,
+    .mqtt_size = 128,
+};
+
+static uint64_t* lat_samples; /* Latency samples of running benchmark */
+static size_t lat_cnt, lat_size;
+static uint64_t bench_start_ns, bench_start_cpu_ns;
+static uint64_t http_post_ts; /* Time of last HTTP upload progress event */
+
+/**
+ * \brief           State of download running in background during command latency benchmark
+ */
+static struct {
+    pthread_mutex_t mutex; /*!< Mutex protecting structure */
+    uint8_t started;       /*!< Set to `1` when first data have been received */
+    uint8_t done;          /*!< Set to `1` when download has finished */
+    uint8_t ok;            /*!< Set to `1` when all data have been received */
+    uint64_t recv;         /*!< Number of received bytes */
+} dl = {.mutex = PTHREAD_MUTEX_INITIALIZER};
+
+/**
+ * \brief           State of transparent mode download
+ */
+static struct {
+    pthread_mutex_t mutex; /*!< Mutex protecting structure */
+    pthread_cond_t cond;   /*!< Signals received data */
+    uint64_t recv;         /*!< Number of received bytes */
+    uint64_t ts;           /*!< Timestamp of chunk being received */
+    uint8_t closed;        /*!< Set to `1` when remote side closed connection */
+} tp = {.mutex = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER};
+
+/**
+ * \brief           State of PPP loopback
+ */
+static struct {
+    pthread_mutex_t mutex; /*!< Mutex protecting structure */
+    pthread_cond_t cond;   /*!< Signals received data */
+    uint64_t recv;         /*!< Number of received bytes */
+    uint8_t up;            /*!< PPP data mode is active */
+} ppp = {.mutex = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER};
+
+/**
+ * \brief           State of non-blocking MQTT publish burst
+ */
+static struct {
+    pthread_mutex_t mutex;  /*!< Mutex protecting structure */
+    pthread_cond_t cond;    /*!< Signals client events */
+    uint64_t* ts;           /*!< Start time of each message */
+    uint32_t done;          /*!< Number of published messages */
+    uint8_t connected;      /*!< Set to `1` when client is connected, `2` when connection failed */
+    uint8_t failed;         /*!< Set to `1` when any publish failed */
+} mb = {.mutex = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER};
+
+/**
+ * \brief           Get process CPU time, excluding modem model
+ * \return          CPU time in units of nanoseconds
+ */
+static uint64_t
+prv_cpu_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec - lwcell_modem_sim_get_cpu_ns();
+}
+
+/**
+ * \brief           Start benchmark measurement
+ * \param[out]      res: Result to initialize
+ * \param[in]       name: Benchmark name
+ * \param[in]       samples: Maximal number of latency samples
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+prv_begin(e2e_result_t* res, const char* name, size_t samples) {
+    memset(res, 0x00, sizeof(*res));
+    res->name = name;
+    lat_cnt = 0;
+    lat_size = samples;
+    free(lat_samples);
+    if ((lat_samples = calloc(LWCELL_MAX(samples, 1), sizeof(*lat_samples))) == NULL) {
+        res->reason = "out of memory";
+        return 0;
+    }
+    bench_start_ns = lwcell_modem_sim_now_ns();
+    bench_start_cpu_ns = prv_cpu_ns();
+    return 1;
+}
+
+/**
+ * \brief           Add latency sample
+ * \param[in]       ns: Latency in units of nanoseconds
+ */
+static void
+prv_sample(uint64_t ns) {
+    if (lat_cnt < lat_size) {
+        lat_samples[lat_cnt++] = ns;
+    }
+}
+
+/**
+ * \brief           Compare function for latency samples
+ */
+static int
+prv_cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * \brief           Finish benchmark measurement and compute percentiles
+ * \param[in,out]   res: Result to finalize
+ * \param[in]       bytes: Number of application bytes transferred
+ * \param[in]       ok: Set to `1` when all operations succeeded
+ */
+static void
+prv_end(e2e_result_t* res, uint64_t bytes, uint8_t ok) {
+    static const uint32_t pct[] = {50, 90, 99};
+
+    res->ns = lwcell_modem_sim_now_ns() - bench_start_ns;
+    res->cpu_ns = prv_cpu_ns() - bench_start_cpu_ns;
+    res->bytes = bytes;
+    res->msgs = lat_cnt;
+    res->ok = ok;
+    if (lat_cnt > 0) {
+        qsort(lat_samples, lat_cnt, sizeof(*lat_samples), prv_cmp_u64);
+        for (size_t i = 0; i < LWCELL_ARRAYSIZE(pct); ++i) {
+            res->lat[i] = lat_samples[(lat_cnt - 1) * pct[i] / 100];
+        }
+        res->lat[3] = lat_samples[lat_cnt - 1];
+    }
+}
+
+/**
+ * \brief           Global library event callback
+ * \param[in]       evt: Event information
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+prv_evt_fn(lwcell_evt_t* evt) {
+#if LWCELL_CFG_HTTP
+    if (lwcell_evt_get_type(evt) == LWCELL_EVT_HTTP_POST_PROGRESS) {
+        uint64_t now = lwcell_modem_sim_now_ns();
+
+        prv_sample(now - http_post_ts);
+        http_post_ts = now;
+    }
+#else  /* LWCELL_CFG_HTTP */
+    LWCELL_UNUSED(evt);
+#endif /* !LWCELL_CFG_HTTP */
+    return lwcellOK;
+}
+
+/**
+ * \brief           Connection callback for upload connection
+ * \param[in]       evt: Event information
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+prv_conn_evt_fn(lwcell_evt_t* evt) {
+    if (lwcell_evt_get_type(evt) == LWCELL_EVT_CONN_RECV) {
+        lwcell_conn_recved(lwcell_evt_conn_recv_get_conn(evt), lwcell_evt_conn_recv_get_buff(evt));
+    }
+    return lwcellOK;
+}
+
+/**
+ * \brief           TCP upload with connection API, latency of each blocking send
+ * \param[out]      res: Result output
+ */
+static void
+bench_tcp_upload(e2e_result_t* res) {
+    lwcell_conn_p conn = NULL;
+    uint8_t* data;
+    uint64_t sent = 0, t;
+    uint8_t ok = 0;
+    size_t bw;
+
+    if (!prv_begin(res, "tcp_upload", (cfg.size + cfg.msg - 1) / cfg.msg) || (data = malloc(cfg.msg)) == NULL) {
+        return;
+    }
+    memset(data, 'u', cfg.msg);
+    if (lwcell_conn_start(&conn, LWCELL_CONN_TYPE_TCP, "sim.local", LWCELL_MODEM_SIM_PORT_DISCARD, NULL,
+                          prv_conn_evt_fn, 1)
+            == lwcellOK
+        && conn != NULL) {
+        ok = 1;
+        while (sent < cfg.size) {
+            size_t len = LWCELL_MIN(cfg.msg, cfg.size - sent);
+
+            t = lwcell_modem_sim_now_ns();
+            if (lwcell_conn_send(conn, data, len, &bw, 1) != lwcellOK || bw != len) {
+                ok = 0;
+                break;
+            }
+            prv_sample(lwcell_modem_sim_now_ns() - t);
+            sent += len;
+        }
+        lwcell_conn_close(conn, 1);
+    }
+    prv_end(res, sent, ok && lwcell_modem_sim_get_rx_bytes(LWCELL_MODEM_SIM_PORT_DISCARD) >= sent);
+    free(data);
+}
+
+/**
+ * \brief           TCP download with netconn API, latency of each received chunk
+ *                  from modem reception to application
+ * \param[out]      res: Result output
+ */
+static void
+bench_tcp_download(e2e_result_t* res) {
+    lwcell_netconn_p nc;
+    lwcell_pbuf_p pbuf;
+    uint8_t req[8] = {'G', 'E', 'T', 0};
+    uint64_t recv = 0, ts;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, "tcp_download", cfg.size / LWCELL_CFG_CONN_MAX_DATA_LEN + 1)) {
+        return;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        req[4 + i] = (uint8_t)(cfg.size >> (8 * i));
+    }
+    if ((nc = lwcell_netconn_new(LWCELL_NETCONN_TYPE_TCP)) == NULL) {
+        return;
+    }
+    lwcell_netconn_set_receive_timeout(nc, 10000);
+    if (lwcell_netconn_connect(nc, "sim.local", LWCELL_MODEM_SIM_PORT_STREAM) == lwcellOK) {
+        if (lwcell_netconn_write(nc, req, sizeof(req)) == lwcellOK && lwcell_netconn_flush(nc) == lwcellOK) {
+            ok = 1;
+            while (recv < cfg.size) {
+                if (lwcell_netconn_receive(nc, &pbuf) != lwcellOK) {
+                    ok = 0;
+                    break;
+                }
+                if (lwcell_pbuf_copy(pbuf, &ts, sizeof(ts), 0) == sizeof(ts)) {
+                    prv_sample(lwcell_modem_sim_now_ns() - ts);
+                }
+                recv += lwcell_pbuf_length(pbuf, 1);
+                lwcell_pbuf_free_s(&pbuf);
+            }
+        }
+        lwcell_netconn_close(nc);
+    }
+    lwcell_netconn_delete(nc);
+    prv_end(res, recv, ok);
+}
+
+/**
+ * \brief           Receive thread for background download
+ * \param[in]       arg: Netconn handle
+ * \return          `NULL`
+ */
+static void*
+prv_download_thread(void* arg) {
+    lwcell_netconn_p nc = arg;
+    lwcell_pbuf_p pbuf;
+    uint64_t recv = 0;
+    uint8_t ok = 1;
+
+    while (recv < cfg.size) {
+        if (lwcell_netconn_receive(nc, &pbuf) != lwcellOK) {
+            ok = 0;
+            break;
+        }
+        recv += lwcell_pbuf_length(pbuf, 1);
+        lwcell_pbuf_free_s(&pbuf);
+        pthread_mutex_lock(&dl.mutex);
+        dl.started = 1;
+        dl.recv = recv;
+        pthread_mutex_unlock(&dl.mutex);
+    }
+    pthread_mutex_lock(&dl.mutex);
+    dl.started = dl.done = 1;
+    dl.ok = ok;
+    pthread_mutex_unlock(&dl.mutex);
+    return NULL;
+}
+
+/**
+ * \brief           Latency of blocking `AT+CSQ` command while bulk TCP download
+ *                  keeps modem UART busy with connection data
+ * \param[out]      res: Result output
+ */
+static void
+bench_cmd_latency_during_download(e2e_result_t* res) {
+    lwcell_netconn_p nc;
+    pthread_t thread;
+    uint8_t req[8] = {'G', 'E', 'T', LWCELL_MODEM_SIM_STREAM_BURST};
+    uint8_t started = 0, done = 0, ok = 0;
+    uint64_t t, recv = 0;
+    int16_t rssi;
+
+    if (!prv_begin(res, "cmd_latency_during_download", 1024)) {
+        return;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        req[4 + i] = (uint8_t)(cfg.size >> (8 * i));
+    }
+    if ((nc = lwcell_netconn_new(LWCELL_NETCONN_TYPE_TCP)) == NULL) {
+        return;
+    }
+    dl.started = dl.done = dl.ok = 0;
+    dl.recv = 0;
+    lwcell_netconn_set_receive_timeout(nc, 10000);
+    /* Receiver runs before request is sent, data may arrive before send is acknowledged */
+    if (lwcell_netconn_connect(nc, "sim.local", LWCELL_MODEM_SIM_PORT_STREAM) == lwcellOK
+        && pthread_create(&thread, NULL, prv_download_thread, nc) == 0) {
+        ok = lwcell_netconn_write(nc, req, sizeof(req)) == lwcellOK && lwcell_netconn_flush(nc) == lwcellOK;
+        while (ok && !started) {
+            lwcell_delay(1);
+            pthread_mutex_lock(&dl.mutex);
+            started = dl.started;
+            pthread_mutex_unlock(&dl.mutex);
+        }
+        while (ok && !done) {
+            t = lwcell_modem_sim_now_ns();
+            if (lwcell_network_rssi(&rssi, NULL, NULL, 1) != lwcellOK) {
+                ok = 0;
+            }
+            prv_sample(lwcell_modem_sim_now_ns() - t); /* Command has been issued while download was running */
+            pthread_mutex_lock(&dl.mutex);
+            done = dl.done;
+            pthread_mutex_unlock(&dl.mutex);
+        }
+        if (!ok) {
+            lwcell_netconn_close(nc); /* Wakes up receiver */
+        }
+        pthread_join(thread, NULL);
+        recv = dl.recv;
+        ok = ok && dl.ok;
+    }
+    lwcell_netconn_close(nc);
+    lwcell_netconn_delete(nc);
+    prv_end(res, recv, ok);
+}
+
+/**
+ * \brief           MQTT publish with MQTT client API, latency of each blocking publish
+ * \param[out]      res: Result output
+ * \param[in]       name: Benchmark name
+ * \param[in]       qos: Quality of service
+ */
+static void
+bench_mqtt_publish(e2e_result_t* res, const char* name, lwcell_mqtt_qos_t qos) {
+    static const lwcell_mqtt_client_info_t info = {
+        .id = "lwcell_bench",
+        .keep_alive = 60,
+    };
+    lwcell_mqtt_client_api_p client;
+    uint8_t* data;
+    uint64_t sent = 0, t;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, name, cfg.count) || (data = malloc(cfg.mqtt_size)) == NULL) {
+        return;
+    }
+    memset(data, 'm', cfg.mqtt_size);
+    if ((client = lwcell_mqtt_client_api_new(cfg.mqtt_size + 256, 256)) != NULL) {
+        if (lwcell_mqtt_client_api_connect(client, "sim.local", LWCELL_MODEM_SIM_PORT_MQTT, &info)
+            == LWCELL_MQTT_CONN_STATUS_ACCEPTED) {
+            ok = 1;
+            for (uint32_t i = 0; i < cfg.count; ++i) {
+                t = lwcell_modem_sim_now_ns();
+                if (lwcell_mqtt_client_api_publish(client, "bench/e2e", data, cfg.mqtt_size, qos, 0) != lwcellOK) {
+                    ok = 0;
+                    break;
+                }
+                prv_sample(lwcell_modem_sim_now_ns() - t);
+                sent += cfg.mqtt_size;
+            }
+            lwcell_mqtt_client_api_close(client);
+        }
+        lwcell_mqtt_client_api_delete(client);
+    }
+    prv_end(res, sent, ok);
+    free(data);
+}
+
+#if LWCELL_CFG_MQTT
+
+/**
+ * \brief           Native MQTT connect refused by broker, followed by accepted connect.
+ *
+ * Refused connect must close TCP connection of the modem, otherwise the next one fails.
+ * Latency is time of each connect call
+ * \param[out]      res: Result output
+ */
+static void
+bench_mqtt_connect_refused(e2e_result_t* res) {
+    static const lwcell_mqtt_client_info_t info_refused = {
+        .id = LWCELL_MODEM_SIM_MQTT_REFUSED_ID,
+        .keep_alive = 60,
+    };
+    static const lwcell_mqtt_client_info_t info = {
+        .id = "lwcell_bench",
+        .keep_alive = 60,
+    };
+    lwcell_mqtt_client_api_p client;
+    uint64_t t;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, "mqtt_connect_refused", 2)) {
+        return;
+    }
+    if ((client = lwcell_mqtt_client_api_new(256, 256)) != NULL) {
+        t = lwcell_modem_sim_now_ns();
+        if (lwcell_mqtt_client_api_connect(client, "sim.local", LWCELL_MODEM_SIM_PORT_MQTT, &info_refused)
+            != LWCELL_MQTT_CONN_STATUS_ACCEPTED) {
+            prv_sample(lwcell_modem_sim_now_ns() - t);
+            t = lwcell_modem_sim_now_ns();
+            if (lwcell_mqtt_client_api_connect(client, "sim.local", LWCELL_MODEM_SIM_PORT_MQTT, &info)
+                == LWCELL_MQTT_CONN_STATUS_ACCEPTED) {
+                prv_sample(lwcell_modem_sim_now_ns() - t);
+                ok = 1;
+                lwcell_mqtt_client_api_close(client);
+            }
+        }
+        lwcell_mqtt_client_api_delete(client);
+    }
+    prv_end(res, 0, ok);
+}
+
+#endif /* LWCELL_CFG_MQTT */
+
+/**
+ * \brief           MQTT client event callback for publish burst
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: MQTT event
+ */
+static void
+prv_mqtt_burst_evt_fn(lwcell_mqtt_client_p client, lwcell_mqtt_evt_t* evt) {
+    LWCELL_UNUSED(client);
+    pthread_mutex_lock(&mb.mutex);
+    switch (evt->type) {
+        case LWCELL_MQTT_EVT_CONNECT:
+            mb.connected = evt->evt.connect.status == LWCELL_MQTT_CONN_STATUS_ACCEPTED ? 1 : 2;
+            break;
+        case LWCELL_MQTT_EVT_DISCONNECT:
+            mb.connected = 2;
+            break;
+        case LWCELL_MQTT_EVT_PUBLISH:
+            if (evt->evt.publish.res == lwcellOK) {
+                prv_sample(lwcell_modem_sim_now_ns() - mb.ts[(size_t)evt->evt.publish.arg]);
+            } else {
+                mb.failed = 1;
+            }
+            ++mb.done;
+            break;
+        default: break;
+    }
+    pthread_cond_broadcast(&mb.cond);
+    pthread_mutex_unlock(&mb.mutex);
+}
+
+/**
+ * \brief           Benchmark MQTT publish burst with non-blocking client,
+ *                  next message is written as soon as output buffer has space for it.
+ *
+ * Latency is time between publish call and published event.
+ * \param[out]      res: Benchmark result
+ * \param[in]       name: Benchmark name
+ * \param[in]       qos: Quality of service
+ */
+static void
+bench_mqtt_publish_burst(e2e_result_t* res, const char* name, lwcell_mqtt_qos_t qos) {
+    static const lwcell_mqtt_client_info_t info = {
+        .id = "lwcell_bench_burst",
+        .keep_alive = 60,
+    };
+    lwcell_mqtt_client_p client;
+    uint8_t* data;
+    uint32_t i = 0;
+    lwcellr_t r;
+
+    if (!prv_begin(res, name, cfg.count) || (data = malloc(cfg.mqtt_size)) == NULL) {
+        return;
+    }
+    if ((mb.ts = calloc(LWCELL_MAX(cfg.count, 1), sizeof(*mb.ts))) == NULL) {
+        free(data);
+        res->reason = "out of memory";
+        return;
+    }
+    memset(data, 'b', cfg.mqtt_size);
+    mb.done = mb.connected = mb.failed = 0;
+    if ((client = lwcell_mqtt_client_new(4 * (cfg.mqtt_size + 64), 256)) != NULL) {
+        if (lwcell_mqtt_client_connect(client, "sim.local", LWCELL_MODEM_SIM_PORT_MQTT, prv_mqtt_burst_evt_fn, &info)
+            == lwcellOK) {
+            pthread_mutex_lock(&mb.mutex);
+            while (mb.connected == 0) {
+                pthread_cond_wait(&mb.cond, &mb.mutex);
+            }
+            while (mb.connected == 1 && i < cfg.count) {
+                mb.ts[i] = lwcell_modem_sim_now_ns();
+                pthread_mutex_unlock(&mb.mutex);
+                r = lwcell_mqtt_client_publish(client, "bench/burst", data, cfg.mqtt_size, qos, 0, (void*)(size_t)i);
+                pthread_mutex_lock(&mb.mutex);
+                if (r == lwcellOK) {
+                    ++i;
+                } else if (r == lwcellERRMEM && mb.done < i) {
+                    pthread_cond_wait(&mb.cond, &mb.mutex); /* Wait for space in output buffer */
+                } else {
+                    mb.failed = 1;
+                    break;
+                }
+            }
+            while (mb.connected == 1 && mb.done < i) {
+                pthread_cond_wait(&mb.cond, &mb.mutex);
+            }
+            pthread_mutex_unlock(&mb.mutex);
+            lwcell_mqtt_client_disconnect(client);
+            pthread_mutex_lock(&mb.mutex);
+            while (mb.connected == 1) {
+                pthread_cond_wait(&mb.cond, &mb.mutex);
+            }
+            pthread_mutex_unlock(&mb.mutex);
+        }
+        lwcell_mqtt_client_delete(client);
+    }
+    prv_end(res, (uint64_t)mb.done * cfg.mqtt_size, mb.done == cfg.count && !mb.failed);
+    free(mb.ts);
+    free(data);
+}
+
+#if !LWCELL_CFG_MQTT
+
+/* Payload byte of streamed MQTT messages at offset */
+#define MF_BYTE(off)   ((uint8_t)((off) * 7 + 3))
+
+/* Topic prefix of topic alias benchmark, followed by single digit */
+#define MF_ALIAS_TOPIC LWCELL_MODEM_SIM_MQTT_ECHO "alias/"
+
+/**
+ * \brief           State of MQTT client feature benchmarks, updated by client and handler callbacks.
+ *
+ * Counters are reset with \ref prv_mf_reset, mutex and condition must stay last
+ */
+static struct mqtt_feat {
+    uint32_t connect_evts;   /*!< Number of connect events */
+    uint32_t connects;       /*!< Number of accepted connects */
+    uint32_t disconnects;    /*!< Number of disconnect events */
+    uint8_t session_present; /*!< Session present flag of last accepted connect */
+    uint32_t subscribed;     /*!< Number of successful subscribe events */
+    uint32_t published[3];   /*!< Number of successful publish events, per client index in client argument */
+    uint32_t failed;         /*!< Number of failed publish events */
+    uint32_t keep_alives;    /*!< Number of keep-alive events */
+    uint32_t recv;           /*!< Number of received messages passed to client callback */
+    uint32_t routed[4];      /*!< Number of received messages per subscription handler */
+    uint32_t aliased[3];     /*!< Number of received messages per topic alias benchmark topic */
+    uint32_t streams;        /*!< Number of fragmented messages received completely with valid payload */
+    uint8_t stream_bad;      /*!< Set to `1` when fragmented message was invalid */
+    size_t stream_off;       /*!< Offset of next expected payload fragment */
+    size_t stream_len;       /*!< Total payload length of fragmented message */
+    uint8_t* data;           /*!< Payload of streamed publish */
+    size_t data_len;         /*!< Length of payload of streamed publish */
+    size_t data_left;        /*!< Payload bytes of streamed publish not written yet */
+    uint64_t ts;             /*!< Start time of measured operation */
+    pthread_mutex_t mutex;   /*!< Mutex protecting structure */
+    pthread_cond_t cond;     /*!< Signals client events */
+} mf = {.mutex = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER};
+
+/**
+ * \brief           Reset counters of MQTT client feature benchmarks
+ */
+static void
+prv_mf_reset(void) {
+    pthread_mutex_lock(&mf.mutex);
+    memset(&mf, 0x00, offsetof(struct mqtt_feat, mutex));
+    pthread_mutex_unlock(&mf.mutex);
+}
+
+/**
+ * \brief           Write as much payload of streamed publish as output buffer accepts,
+ *                  finish message when all is written. Must be called with core locked
+ * \param[in]       client: MQTT client
+ */
+static void
+prv_mf_stream_write(lwcell_mqtt_client_p client) {
+    size_t bw = 0;
+
+    if (mf.data_left > 0
+        && lwcell_mqtt_client_publish_write(client, &mf.data[mf.data_len - mf.data_left], mf.data_left, &bw)
+               == lwcellOK) {
+        mf.data_left -= bw;
+        if (mf.data_left == 0) {
+            lwcell_mqtt_client_publish_end(client);
+        }
+    }
+}
+
+/**
+ * \brief           MQTT client event callback for client feature benchmarks
+ * \param[in]       client: MQTT client, argument is client index
+ * \param[in]       evt: MQTT event
+ */
+static void
+prv_mf_evt_fn(lwcell_mqtt_client_p client, lwcell_mqtt_evt_t* evt) {
+    size_t idx = (size_t)lwcell_mqtt_client_get_arg(client);
+
+    if (evt->type == LWCELL_MQTT_EVT_PUBLISH_WRITE) {
+        prv_mf_stream_write(client); /* Publish functions may report events, write without mutex */
+        return;
+    }
+    pthread_mutex_lock(&mf.mutex);
+    switch (evt->type) {
+        case LWCELL_MQTT_EVT_CONNECT:
+            ++mf.connect_evts;
+            if (evt->evt.connect.status == LWCELL_MQTT_CONN_STATUS_ACCEPTED) {
+                ++mf.connects;
+                mf.session_present = evt->evt.connect.session_present;
+            }
+            break;
+        case LWCELL_MQTT_EVT_DISCONNECT: ++mf.disconnects; break;
+        case LWCELL_MQTT_EVT_SUBSCRIBE: mf.subscribed += evt->evt.sub_unsub_scribed.res == lwcellOK; break;
+        case LWCELL_MQTT_EVT_PUBLISH:
+            if (evt->evt.publish.res == lwcellOK) {
+                ++mf.published[idx];
+            } else {
+                ++mf.failed;
+            }
+            break;
+        case LWCELL_MQTT_EVT_KEEP_ALIVE: ++mf.keep_alives; break;
+        case LWCELL_MQTT_EVT_PUBLISH_RECV: {
+            const char* topic = (const char*)evt->evt.publish_recv.topic;
+            size_t len = evt->evt.publish_recv.topic_len, pre = sizeof(MF_ALIAS_TOPIC) - 1;
+
+            if (len == pre + 1 && !strncmp(topic, MF_ALIAS_TOPIC, pre) && topic[pre] >= '0'
+                && topic[pre] < '0' + (char)LWCELL_ARRAYSIZE(mf.aliased)) {
+                ++mf.aliased[topic[pre] - '0'];
+            }
+            ++mf.recv;
+            break;
+        }
+        case LWCELL_MQTT_EVT_PUBLISH_RECV_START:
+            mf.stream_off = 0;
+            mf.stream_len = evt->evt.publish_recv.payload_len;
+            mf.stream_bad = evt->evt.publish_recv.payload != NULL;
+            break;
+        case LWCELL_MQTT_EVT_PUBLISH_RECV_DATA: {
+            const uint8_t* d = evt->evt.publish_recv_data.payload;
+
+            if (evt->evt.publish_recv_data.offset != mf.stream_off) {
+                mf.stream_bad = 1;
+            }
+            for (size_t i = 0; i < evt->evt.publish_recv_data.len; ++i) {
+                if (d[i] != MF_BYTE(mf.stream_off + i)) {
+                    mf.stream_bad = 1;
+                }
+            }
+            mf.stream_off += evt->evt.publish_recv_data.len;
+            break;
+        }
+        case LWCELL_MQTT_EVT_PUBLISH_RECV_END:
+            if (evt->evt.publish_recv_end.res == lwcellOK && !mf.stream_bad && mf.stream_off == mf.stream_len) {
+                prv_sample(lwcell_modem_sim_now_ns() - mf.ts);
+                ++mf.streams;
+            }
+            break;
+        default: break;
+    }
+    pthread_cond_broadcast(&mf.cond);
+    pthread_mutex_unlock(&mf.mutex);
+}
+
+/**
+ * \brief           Subscription handler for router benchmark
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Publish receive event
+ * \param[in]       arg: Handler index
+ */
+static void
+prv_mf_route_fn(lwcell_mqtt_client_p client, lwcell_mqtt_evt_t* evt, void* arg) {
+    LWCELL_UNUSED(client);
+    LWCELL_UNUSED(evt);
+    pthread_mutex_lock(&mf.mutex);
+    ++mf.routed[(size_t)arg];
+    pthread_cond_broadcast(&mf.cond);
+    pthread_mutex_unlock(&mf.mutex);
+}
+
+/**
+ * \brief           Wait until counter of MQTT feature benchmark state reaches value
+ * \param[in]       cnt: Counter in \ref mf structure
+ * \param[in]       val: Value to wait for
+ * \param[in]       timeout_ms: Maximal time to wait in units of milliseconds
+ * \return          `1` when value was reached, `0` on timeout
+ */
+static uint8_t
+prv_mf_wait(const uint32_t* cnt, uint32_t val, uint32_t timeout_ms) {
+    struct timespec ts;
+    uint8_t ok = 1;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ++ts.tv_sec;
+        ts.tv_nsec -= 1000000000L;
+    }
+    pthread_mutex_lock(&mf.mutex);
+    while (*cnt < val) {
+        if (pthread_cond_timedwait(&mf.cond, &mf.mutex, &ts) != 0) {
+            ok = *cnt >= val;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&mf.mutex);
+    return ok;
+}
+
+/**
+ * \brief           Connect client of feature benchmark and wait for connect event
+ * \param[in]       client: MQTT client
+ * \param[in]       info: Client information
+ * \return          `1` when connection was accepted, `0` otherwise
+ */
+static uint8_t
+prv_mf_connect(lwcell_mqtt_client_p client, const lwcell_mqtt_client_info_t* info) {
+    uint32_t evts, connects;
+
+    pthread_mutex_lock(&mf.mutex);
+    evts = mf.connect_evts;
+    connects = mf.connects;
+    pthread_mutex_unlock(&mf.mutex);
+    return lwcell_mqtt_client_connect(client, "sim.local", LWCELL_MODEM_SIM_PORT_MQTT, prv_mf_evt_fn, info)
+               == lwcellOK
+           && prv_mf_wait(&mf.connect_evts, evts + 1, 10000) && mf.connects > connects;
+}
+
+/**
+ * \brief           Disconnect client of feature benchmark and wait for disconnect event
+ * \param[in]       client: MQTT client
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+prv_mf_disconnect(lwcell_mqtt_client_p client) {
+    uint32_t disconnects;
+
+    pthread_mutex_lock(&mf.mutex);
+    disconnects = mf.disconnects;
+    pthread_mutex_unlock(&mf.mutex);
+    return lwcell_mqtt_client_disconnect(client) == lwcellOK && prv_mf_wait(&mf.disconnects, disconnects + 1, 10000);
+}
+
+#endif /* !LWCELL_CFG_MQTT */
+
+/**
+ * \brief           `QoS 1` and `QoS 2` messages acknowledged by broker only after retransmission with DUP flag.
+ *                  Latency is time from publish until acknowledge
+ * \param[out]      res: Result output
+ */
+static void
+bench_mqtt_qos_retransmit(e2e_result_t* res) {
+#if !LWCELL_CFG_MQTT && LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT
+    static const lwcell_mqtt_client_info_t info = {
+        .id = "lwcell_bench_retransmit",
+        .keep_alive = 60,
+    };
+    lwcell_modem_sim_mqtt_stats_t before, after;
+    lwcell_mqtt_client_p client;
+    uint32_t cnt = 4;
+    uint64_t t;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, "mqtt_qos_retransmit", cnt)) {
+        return;
+    }
+    prv_mf_reset();
+    lwcell_modem_sim_get_mqtt_stats(&before);
+    if ((client = lwcell_mqtt_client_new(1024, 256)) != NULL) {
+        if (prv_mf_connect(client, &info)) {
+            ok = 1;
+            for (uint32_t i = 0; ok && i < cnt; ++i) {
+                t = lwcell_modem_sim_now_ns();
+                ok = lwcell_mqtt_client_publish(client, LWCELL_MODEM_SIM_MQTT_DUP "retransmit", "retransmit", 10,
+                                                (i & 1) ? LWCELL_MQTT_QOS_EXACTLY_ONCE : LWCELL_MQTT_QOS_AT_LEAST_ONCE,
+                                                0, NULL)
+                         == lwcellOK
+                     && prv_mf_wait(&mf.published[0], i + 1, 4 * LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT + 5000);
+                prv_sample(lwcell_modem_sim_now_ns() - t);
+            }
+            prv_mf_disconnect(client);
+        }
+        lwcell_mqtt_client_delete(client);
+    }
+    lwcell_modem_sim_get_mqtt_stats(&after);
+    prv_end(res, (uint64_t)mf.published[0] * 10, ok && mf.failed == 0 && after.dup - before.dup >= cnt);
+#else  /* !LWCELL_CFG_MQTT && LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT */
+    memset(res, 0x00, sizeof(*res));
+    res->name = "mqtt_qos_retransmit";
+    res->reason = "LWCELL_CFG_MQTT enabled or LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT disabled";
+#endif /* LWCELL_CFG_MQTT || !LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT */
+}
+
+/**
+ * \brief           Persistent session resumed after reconnect.
+ *
+ * Messages left unacknowledged by broker are sent again with DUP flag,
+ * messages published while offline are kept in RAM store and sent after them.
+ * Latency is time from reconnect until all messages are acknowledged
+ * \param[out]      res: Result output
+ */
+static void
+bench_mqtt_session_replay(e2e_result_t* res) {
+#if !LWCELL_CFG_MQTT
+    static const lwcell_mqtt_client_info_t info = {
+        .id = "lwcell_bench_session",
+        .keep_alive = 60,
+        .persistent_session = 1,
+    };
+    lwcell_modem_sim_mqtt_stats_t before, after;
+    lwcell_mqtt_client_p client;
+    lwcell_buff_t store;
+    uint64_t t;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, "mqtt_session_replay", 1)) {
+        return;
+    }
+    prv_mf_reset();
+    lwcell_modem_sim_get_mqtt_stats(&before);
+    if (lwcell_buff_init(&store, 2048)) {
+        if ((client = lwcell_mqtt_client_new(1024, 256)) != NULL) {
+            lwcell_mqtt_client_set_store(client, &lwcell_mqtt_store_ram, &store);
+            if (prv_mf_connect(client, &info) && !mf.session_present) {
+                ok = 1;
+                for (uint32_t i = 0; i < 3; ++i) {
+                    ok = ok
+                         && lwcell_mqtt_client_publish(client, LWCELL_MODEM_SIM_MQTT_DUP "session", "unacked", 7,
+                                                       i == 1 ? LWCELL_MQTT_QOS_EXACTLY_ONCE
+                                                              : LWCELL_MQTT_QOS_AT_LEAST_ONCE,
+                                                       0, NULL)
+                                == lwcellOK;
+                }
+                ok = ok && prv_mf_disconnect(client);
+                for (uint32_t i = 0; i < 3; ++i) {
+                    ok = ok
+                         && lwcell_mqtt_client_publish(client, "bench/session", "offline", 7,
+                                                       LWCELL_MQTT_QOS_AT_LEAST_ONCE, 0, NULL)
+                                == lwcellOK;
+                }
+                t = lwcell_modem_sim_now_ns();
+                ok = ok && prv_mf_connect(client, &info) && mf.session_present
+                     && prv_mf_wait(&mf.published[0], 6, 10000);
+                prv_sample(lwcell_modem_sim_now_ns() - t);
+                prv_mf_disconnect(client);
+            }
+            lwcell_mqtt_client_delete(client);
+        }
+        lwcell_buff_free(&store);
+    }
+    lwcell_modem_sim_get_mqtt_stats(&after);
+    prv_end(res, 6 * 7, ok && mf.failed == 0 && mf.published[0] == 6 && after.dup - before.dup >= 3);
+#else  /* !LWCELL_CFG_MQTT */
+    memset(res, 0x00, sizeof(*res));
+    res->name = "mqtt_session_replay";
+    res->reason = "LWCELL_CFG_MQTT enabled";
+#endif /* LWCELL_CFG_MQTT */
+}
+
+/**
+ * \brief           Messages bigger than RX buffer, echoed by broker and received in fragments.
+ *                  Latency is time from publish until last fragment
+ * \param[out]      res: Result output
+ */
+static void
+bench_mqtt_recv_stream(e2e_result_t* res) {
+#if !LWCELL_CFG_MQTT
+    static const lwcell_mqtt_client_info_t info = {
+        .id = "lwcell_bench_recv_stream",
+        .keep_alive = 60,
+    };
+    lwcell_mqtt_client_p client;
+    uint8_t data[2048];
+    uint32_t cnt = 4;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, "mqtt_recv_stream", cnt)) {
+        return;
+    }
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = MF_BYTE(i);
+    }
+    prv_mf_reset();
+    if ((client = lwcell_mqtt_client_new(sizeof(data) + 256, 256)) != NULL) {
+        if (prv_mf_connect(client, &info)) {
+            ok = 1;
+            for (uint32_t i = 0; ok && i < cnt; ++i) {
+                mf.ts = lwcell_modem_sim_now_ns();
+                ok = lwcell_mqtt_client_publish(client, LWCELL_MODEM_SIM_MQTT_ECHO "stream", data, sizeof(data),
+                                                LWCELL_MQTT_QOS_AT_MOST_ONCE, 0, NULL)
+                         == lwcellOK
+                     && prv_mf_wait(&mf.streams, i + 1, 10000);
+            }
+            prv_mf_disconnect(client);
+        }
+        lwcell_mqtt_client_delete(client);
+    }
+    prv_end(res, (uint64_t)mf.streams * sizeof(data), ok && mf.recv == 0);
+#else  /* !LWCELL_CFG_MQTT */
+    memset(res, 0x00, sizeof(*res));
+    res->name = "mqtt_recv_stream";
+    res->reason = "LWCELL_CFG_MQTT enabled";
+#endif /* LWCELL_CFG_MQTT */
+}
+
+/**
+ * \brief           Receive queue overflow of MQTT client API, broker echoes more messages than queue holds
+ *                  and application receives them only after all arrived.
+ *                  Latency is time from publish until message is queued or dropped
+ * \param[out]      res: Result output
+ * \param[in]       name: Benchmark name
+ * \param[in]       overflow: Overflow policy
+ */
+static void
+bench_mqtt_api_overflow(e2e_result_t* res, const char* name, lwcell_mqtt_client_api_overflow_t overflow) {
+#if !LWCELL_CFG_MQTT
+    static const lwcell_mqtt_client_info_t info = {
+        .id = "lwcell_bench_api",
+        .keep_alive = 60,
+    };
+    lwcell_mqtt_client_api_stats_t stats = {0};
+    lwcell_mqtt_client_api_buf_p buf;
+    lwcell_mqtt_client_api_p client;
+    uint32_t cnt = LWCELL_CFG_MQTT_API_MBOX_SIZE + 4, got = 0, first = 0, idx;
+    uint64_t t;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, name, cnt)) {
+        return;
+    }
+    if ((client = lwcell_mqtt_client_api_new(256, 256)) != NULL) {
+        lwcell_mqtt_client_api_set_overflow(client, overflow);
+        if (lwcell_mqtt_client_api_connect(client, "sim.local", LWCELL_MODEM_SIM_PORT_MQTT, &info)
+            == LWCELL_MQTT_CONN_STATUS_ACCEPTED) {
+            ok = 1;
+            for (uint32_t i = 0; ok && i < cnt; ++i) {
+                t = lwcell_modem_sim_now_ns();
+                ok = lwcell_mqtt_client_api_publish(client, LWCELL_MODEM_SIM_MQTT_ECHO "api", &i, sizeof(i),
+                                                    LWCELL_MQTT_QOS_AT_MOST_ONCE, 0)
+                     == lwcellOK;
+                for (uint32_t w = 0; ok && w < 1000; ++w) {
+                    lwcell_mqtt_client_api_get_stats(client, &stats);
+                    if (stats.received + stats.dropped_newest > i) {
+                        break;
+                    }
+                    lwcell_delay(1);
+                }
+                prv_sample(lwcell_modem_sim_now_ns() - t);
+            }
+
+            /* Queue keeps consecutive messages, oldest or newest ones */
+            while (lwcell_mqtt_client_api_receive(client, &buf, 100) == lwcellOK) {
+                memcpy(&idx, buf->payload, sizeof(idx));
+                if (got == 0) {
+                    first = idx;
+                }
+                ok = ok && buf->payload_len == sizeof(idx) && idx == first + got;
+                ++got;
+                lwcell_mqtt_client_api_buf_free(buf);
+            }
+            lwcell_mqtt_client_api_get_stats(client, &stats);
+            ok = ok && got > 0 && got < cnt && stats.received + stats.dropped_newest == cnt;
+            if (overflow == LWCELL_MQTT_CLIENT_API_OVERFLOW_DROP_OLDEST) {
+                ok = ok && first + got == cnt && stats.dropped_oldest == cnt - got && stats.dropped_newest == 0;
+            } else {
+                ok = ok && first == 0 && stats.dropped_newest == cnt - got && stats.dropped_oldest == 0;
+            }
+#if LWCELL_CFG_MQTT_API_ZERO_COPY
+            ok = ok && stats.zero_copy == stats.received;
+#endif /* LWCELL_CFG_MQTT_API_ZERO_COPY */
+            lwcell_mqtt_client_api_close(client);
+        }
+        lwcell_mqtt_client_api_delete(client);
+    }
+    prv_end(res, (uint64_t)got * sizeof(idx), ok);
+#else  /* !LWCELL_CFG_MQTT */
+    LWCELL_UNUSED(overflow);
+    memset(res, 0x00, sizeof(*res));
+    res->name = name;
+    res->reason = "LWCELL_CFG_MQTT enabled";
+#endif /* LWCELL_CFG_MQTT */
+}
+
+/**
+ * \brief           Received messages routed to subscription handlers with wildcard topic filters,
+ *                  message without matching filter goes to client callback.
+ *                  Latency is time of one round of messages
+ * \param[out]      res: Result output
+ */
+static void
+bench_mqtt_router(e2e_result_t* res) {
+#if !LWCELL_CFG_MQTT
+    static const lwcell_mqtt_client_info_t info = {
+        .id = "lwcell_bench_router",
+        .keep_alive = 60,
+    };
+    static const char* const filters[] = {"echo/+", "echo/a/#", "echo/a/b", "+/+/c"};
+    static const char* const topics[] = {"echo/x", "echo/a", "echo/a/b", "echo/a/c", "echo/b/c", "echo/b/d"};
+    static const uint32_t expected[] = {2, 3, 1, 2}; /* Matches of each filter per round */
+    lwcell_mqtt_client_p client;
+    uint32_t rounds = 4;
+    uint64_t t;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, "mqtt_router", rounds)) {
+        return;
+    }
+    prv_mf_reset();
+    if ((client = lwcell_mqtt_client_new(1024, 256)) != NULL) {
+        if (prv_mf_connect(client, &info)) {
+            ok = 1;
+            for (size_t i = 0; ok && i < LWCELL_ARRAYSIZE(filters); ++i) {
+                ok = lwcell_mqtt_client_subscribe_ex(client, filters[i], LWCELL_MQTT_QOS_AT_MOST_ONCE, prv_mf_route_fn,
+                                                     (void*)i, NULL)
+                         == lwcellOK
+                     && prv_mf_wait(&mf.subscribed, (uint32_t)i + 1, 10000);
+            }
+            for (uint32_t r = 0; ok && r < rounds; ++r) {
+                t = lwcell_modem_sim_now_ns();
+                for (size_t i = 0; ok && i < LWCELL_ARRAYSIZE(topics); ++i) {
+                    ok = lwcell_mqtt_client_publish(client, topics[i], "route", 5, LWCELL_MQTT_QOS_AT_MOST_ONCE, 0,
+                                                    NULL)
+                         == lwcellOK;
+                }
+
+                /* Unmatched message is the last one of round */
+                ok = ok && prv_mf_wait(&mf.recv, r + 1, 10000);
+                prv_sample(lwcell_modem_sim_now_ns() - t);
+            }
+            for (size_t i = 0; i < LWCELL_ARRAYSIZE(expected); ++i) {
+                ok = ok && mf.routed[i] == expected[i] * rounds;
+            }
+            prv_mf_disconnect(client);
+        }
+        lwcell_mqtt_client_delete(client);
+    }
+    prv_end(res, (uint64_t)rounds * LWCELL_ARRAYSIZE(topics) * 5, ok && mf.recv == rounds);
+#else  /* !LWCELL_CFG_MQTT */
+    memset(res, 0x00, sizeof(*res));
+    res->name = "mqtt_router";
+    res->reason = "LWCELL_CFG_MQTT enabled";
+#endif /* LWCELL_CFG_MQTT */
+}
+
+/**
+ * \brief           MQTT 5.0 client publishing repeatedly to the same topics,
+ *                  broker must receive empty topics with aliases and echo messages with full topic.
+ *                  Latency is time of one round of messages
+ * \param[out]      res: Result output
+ */
+static void
+bench_mqtt5_topic_alias(e2e_result_t* res) {
+#if !LWCELL_CFG_MQTT && LWCELL_CFG_MQTT_V5
+    static const lwcell_mqtt_client_info_t info = {
+        .id = "lwcell_bench_v5",
+        .keep_alive = 60,
+        .version = 5,
+    };
+    lwcell_modem_sim_mqtt_stats_t before, after;
+    lwcell_mqtt_client_p client;
+    uint32_t rounds = 4, topics = LWCELL_ARRAYSIZE(mf.aliased);
+    char topic[sizeof(MF_ALIAS_TOPIC) + 1];
+    uint64_t t;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, "mqtt5_topic_alias", rounds)) {
+        return;
+    }
+    prv_mf_reset();
+    lwcell_modem_sim_get_mqtt_stats(&before);
+    if ((client = lwcell_mqtt_client_new(1024, 256)) != NULL) {
+        if (prv_mf_connect(client, &info)) {
+            ok = 1;
+            for (uint32_t r = 0; ok && r < rounds; ++r) {
+                t = lwcell_modem_sim_now_ns();
+                for (uint32_t i = 0; ok && i < topics; ++i) {
+                    sprintf(topic, MF_ALIAS_TOPIC "%u", (unsigned)i);
+                    ok = lwcell_mqtt_client_publish(client, topic, "alias", 5, LWCELL_MQTT_QOS_AT_MOST_ONCE, 0, NULL)
+                         == lwcellOK;
+                }
+                ok = ok && prv_mf_wait(&mf.recv, (r + 1) * topics, 10000);
+                prv_sample(lwcell_modem_sim_now_ns() - t);
+            }
+            for (uint32_t i = 0; i < topics; ++i) {
+                ok = ok && mf.aliased[i] == rounds;
+            }
+            prv_mf_disconnect(client);
+        }
+        lwcell_mqtt_client_delete(client);
+    }
+    lwcell_modem_sim_get_mqtt_stats(&after);
+    prv_end(res, (uint64_t)rounds * topics * 5, ok && after.alias - before.alias == (rounds - 1) * topics);
+#else  /* !LWCELL_CFG_MQTT && LWCELL_CFG_MQTT_V5 */
+    memset(res, 0x00, sizeof(*res));
+    res->name = "mqtt5_topic_alias";
+    res->reason = "LWCELL_CFG_MQTT enabled or LWCELL_CFG_MQTT_V5 disabled";
+#endif /* LWCELL_CFG_MQTT || !LWCELL_CFG_MQTT_V5 */
+}
+
+/**
+ * \brief           MQTT 5.0 persistent session with `QoS 1` message not acknowledged by broker.
+ *
+ * Message is sent with topic alias and must not be sent again on the same connection,
+ * client closes connection after \ref LWCELL_CFG_MQTT_MAX_RETRANSMITS timeouts.
+ * After reconnect message is sent again with DUP flag and topic string, as broker forgot aliases.
+ * Latency is time from reconnect until acknowledge
+ * \param[out]      res: Result output
+ */
+static void
+bench_mqtt5_session_resume(e2e_result_t* res) {
+#if !LWCELL_CFG_MQTT && LWCELL_CFG_MQTT_V5 && LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT
+    static const lwcell_mqtt_client_info_t info = {
+        .id = "lwcell_bench_v5_session",
+        .keep_alive = 60,
+        .persistent_session = 1,
+        .version = 5,
+    };
+    lwcell_modem_sim_mqtt_stats_t before, after;
+    lwcell_mqtt_client_p client;
+    uint64_t t;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, "mqtt5_session_resume", 1)) {
+        return;
+    }
+    prv_mf_reset();
+    if ((client = lwcell_mqtt_client_new(1024, 256)) != NULL) {
+        if (prv_mf_connect(client, &info)) {
+            /* First message assigns topic alias, the second one is sent with alias only */
+            lwcell_modem_sim_get_mqtt_stats(&before);
+            ok = lwcell_mqtt_client_publish(client, LWCELL_MODEM_SIM_MQTT_DUP "v5", "resume", 6,
+                                            LWCELL_MQTT_QOS_AT_MOST_ONCE, 0, NULL)
+                     == lwcellOK
+                 && lwcell_mqtt_client_publish(client, LWCELL_MODEM_SIM_MQTT_DUP "v5", "resume", 6,
+                                               LWCELL_MQTT_QOS_AT_LEAST_ONCE, 0, NULL)
+                        == lwcellOK
+                 && prv_mf_wait(&mf.disconnects, 1,
+                                (LWCELL_CFG_MQTT_MAX_RETRANSMITS + 1) * LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT + 5000);
+            lwcell_modem_sim_get_mqtt_stats(&after);
+            ok = ok && after.dup == before.dup && after.alias - before.alias == 1;
+
+            t = lwcell_modem_sim_now_ns();
+            lwcell_modem_sim_get_mqtt_stats(&before);
+            ok = ok && prv_mf_connect(client, &info) && mf.session_present
+                 && prv_mf_wait(&mf.published[0], 2, 10000);
+            prv_sample(lwcell_modem_sim_now_ns() - t);
+            lwcell_modem_sim_get_mqtt_stats(&after);
+            ok = ok && after.dup - before.dup == 1 && after.alias == before.alias;
+            if (lwcell_mqtt_client_is_connected(client)) {
+                prv_mf_disconnect(client);
+            }
+        }
+        lwcell_mqtt_client_delete(client);
+    }
+    prv_end(res, 2 * 6, ok && mf.failed == 0 && mf.published[0] == 2);
+#else  /* !LWCELL_CFG_MQTT && LWCELL_CFG_MQTT_V5 && LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT */
+    memset(res, 0x00, sizeof(*res));
+    res->name = "mqtt5_session_resume";
+    res->reason = "LWCELL_CFG_MQTT enabled or LWCELL_CFG_MQTT_V5 or LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT disabled";
+#endif /* LWCELL_CFG_MQTT || !LWCELL_CFG_MQTT_V5 || !LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT */
+}
+
+/**
+ * \brief           `QoS 1` message of `--size` bytes written in parts through small TX buffer,
+ *                  bigger than packet buffer of broker model
+ * \param[out]      res: Result output
+ */
+static void
+bench_mqtt_publish_stream(e2e_result_t* res) {
+#if !LWCELL_CFG_MQTT
+    static const lwcell_mqtt_client_info_t info = {
+        .id = "lwcell_bench_publish_stream",
+        .keep_alive = 60,
+    };
+    lwcell_mqtt_client_p client;
+    uint64_t rx;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, "mqtt_publish_stream", 0)) {
+        return;
+    }
+    prv_mf_reset();
+    if ((mf.data = malloc(LWCELL_MAX(cfg.size, 1))) == NULL) {
+        res->reason = "out of memory";
+        return;
+    }
+    for (size_t i = 0; i < cfg.size; ++i) {
+        mf.data[i] = MF_BYTE(i);
+    }
+    rx = lwcell_modem_sim_get_rx_bytes(LWCELL_MODEM_SIM_PORT_MQTT);
+    if ((client = lwcell_mqtt_client_new(512, 256)) != NULL) {
+        if (prv_mf_connect(client, &info)) {
+            lwcell_core_lock(); /* First write must not race with write event */
+            mf.data_len = mf.data_left = cfg.size;
+            ok = lwcell_mqtt_client_publish_begin(client, "bench/stream", cfg.size, LWCELL_MQTT_QOS_AT_LEAST_ONCE, 0,
+                                                  NULL)
+                 == lwcellOK;
+            if (ok) {
+                prv_mf_stream_write(client);
+            }
+            lwcell_core_unlock();
+            ok = ok && prv_mf_wait(&mf.published[0], 1, 60000);
+            prv_mf_disconnect(client);
+        }
+        lwcell_mqtt_client_delete(client);
+    }
+    rx = lwcell_modem_sim_get_rx_bytes(LWCELL_MODEM_SIM_PORT_MQTT) - rx;
+    prv_end(res, cfg.size, ok && mf.failed == 0 && mf.data_left == 0 && rx >= cfg.size);
+    free(mf.data);
+    mf.data = NULL;
+#else  /* !LWCELL_CFG_MQTT */
+    memset(res, 0x00, sizeof(*res));
+    res->name = "mqtt_publish_stream";
+    res->reason = "LWCELL_CFG_MQTT enabled";
+#endif /* LWCELL_CFG_MQTT */
+}
+
+/**
+ * \brief           Keep-alive with broker answering `PINGREQ` and with broker ignoring it,
+ *                  where client must close connection when `PINGRESP` deadline expires.
+ *                  Latency is time until second keep-alive event and time until disconnect
+ * \param[out]      res: Result output
+ */
+static void
+bench_mqtt_keep_alive_deadline(e2e_result_t* res) {
+#if !LWCELL_CFG_MQTT
+    static const lwcell_mqtt_client_info_t info = {
+        .id = "lwcell_bench_ping",
+        .keep_alive = 1,
+    };
+    static const lwcell_mqtt_client_info_t info_no_ping = {
+        .id = LWCELL_MODEM_SIM_MQTT_NO_PING_ID,
+        .keep_alive = 1,
+    };
+    lwcell_modem_sim_mqtt_stats_t before, after;
+    lwcell_mqtt_client_p client;
+    uint64_t t, closed_ns = 0;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, "mqtt_keep_alive_deadline", 2)) {
+        return;
+    }
+    prv_mf_reset();
+    lwcell_modem_sim_get_mqtt_stats(&before);
+    if ((client = lwcell_mqtt_client_new(256, 256)) != NULL) {
+        t = lwcell_modem_sim_now_ns();
+        if (prv_mf_connect(client, &info)) {
+            ok = prv_mf_wait(&mf.keep_alives, 2, 5000);
+            prv_sample(lwcell_modem_sim_now_ns() - t);
+            ok = prv_mf_disconnect(client) && ok;
+        }
+
+        /* Deadline is half of keep-alive interval after PINGREQ */
+        if (ok && prv_mf_connect(client, &info_no_ping)) {
+            t = lwcell_modem_sim_now_ns();
+            ok = prv_mf_wait(&mf.disconnects, 2, 5000);
+            closed_ns = lwcell_modem_sim_now_ns() - t;
+            prv_sample(closed_ns);
+        } else {
+            ok = 0;
+        }
+        lwcell_mqtt_client_delete(client);
+    }
+    lwcell_modem_sim_get_mqtt_stats(&after);
+    prv_end(res, 0,
+            ok && mf.keep_alives == 2 && after.pingreq - before.pingreq >= 3 && closed_ns < 3000000000ULL);
+#else  /* !LWCELL_CFG_MQTT */
+    memset(res, 0x00, sizeof(*res));
+    res->name = "mqtt_keep_alive_deadline";
+    res->reason = "LWCELL_CFG_MQTT enabled";
+#endif /* LWCELL_CFG_MQTT */
+}
+
+/**
+ * \brief           Manager clients with weights `1` and `3` sharing sends, followed by failover
+ *                  of unacknowledged messages to backup client when connection closes.
+ *
+ * Weighted client must send its messages while the other sends at most half of them.
+ * Failing client uses MQTT 5.0 and backup client MQTT 3.1.1, messages move between protocol versions.
+ * Pool memory of deleted client must be reused by new client, as pool has no other free memory.
+ * Latency is time until weighted clients finish and time until backup client finishes
+ * \param[out]      res: Result output
+ */
+static void
+bench_mqtt_mgr(e2e_result_t* res) {
+#if !LWCELL_CFG_MQTT && LWCELL_CFG_MQTT_MGR && LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT
+    static const lwcell_mqtt_client_info_t info[] = {
+        {.id = "lwcell_bench_mgr0", .keep_alive = 60, .version = 5},
+        {.id = "lwcell_bench_mgr1", .keep_alive = 60},
+        {.id = "lwcell_bench_mgr2", .keep_alive = 60},
+    };
+    static const uint8_t weights[] = {1, 3, 1};
+    size_t len = LWCELL_CFG_CONN_MAX_DATA_LEN - 32, tx_len = 8 * LWCELL_CFG_CONN_MAX_DATA_LEN;
+    lwcell_mqtt_client_p c[3] = {NULL};
+    lwcell_mqtt_mgr_p mgr;
+    lwcell_buff_t store;
+    uint32_t cnt = 8, share = 0;
+    uint8_t *data, ok = 0;
+    uint64_t t;
+
+    if (!prv_begin(res, "mqtt_mgr", 2)) {
+        return;
+    }
+    if ((data = malloc(len)) == NULL || !lwcell_buff_init(&store, 2048)) {
+        free(data);
+        res->reason = "out of memory";
+        return;
+    }
+    memset(data, 'g', len);
+    prv_mf_reset();
+    if ((mgr = lwcell_mqtt_mgr_new(LWCELL_ARRAYSIZE(c) * (tx_len + 256))) != NULL) {
+        ok = 1;
+        for (size_t i = 0; ok && i < LWCELL_ARRAYSIZE(c); ++i) {
+            ok = (c[i] = lwcell_mqtt_mgr_client_new(mgr, tx_len, 256, weights[i])) != NULL;
+            if (ok) {
+                lwcell_mqtt_client_set_arg(c[i], (void*)i);
+                ok = prv_mf_connect(c[i], &info[i]);
+            }
+        }
+
+        /* Both queues are filled before manager starts sending */
+        t = lwcell_modem_sim_now_ns();
+        lwcell_core_lock();
+        for (uint32_t i = 0; ok && i < cnt; ++i) {
+            ok = lwcell_mqtt_client_publish(c[1], "bench/mgr", data, len, LWCELL_MQTT_QOS_AT_MOST_ONCE, 0, NULL)
+                     == lwcellOK
+                 && lwcell_mqtt_client_publish(c[0], "bench/mgr", data, len, LWCELL_MQTT_QOS_AT_MOST_ONCE, 0, NULL)
+                        == lwcellOK;
+        }
+        lwcell_core_unlock();
+        if (ok && prv_mf_wait(&mf.published[1], cnt, 30000)) {
+            pthread_mutex_lock(&mf.mutex);
+            share = mf.published[0];
+            pthread_mutex_unlock(&mf.mutex);
+            ok = share * 2 <= cnt && prv_mf_wait(&mf.published[0], cnt, 30000);
+        } else {
+            ok = 0;
+        }
+        prv_sample(lwcell_modem_sim_now_ns() - t);
+
+        /* Messages not acknowledged by broker continue on backup client */
+        if (ok) {
+            t = lwcell_modem_sim_now_ns();
+            lwcell_mqtt_client_set_store(c[2], &lwcell_mqtt_store_ram, &store);
+            lwcell_mqtt_mgr_set_failover(c[0], c[2]);
+            for (uint32_t i = 0; ok && i < 3; ++i) {
+                ok = lwcell_mqtt_client_publish(c[0], LWCELL_MODEM_SIM_MQTT_DUP "mgr", "failover", 8,
+                                                LWCELL_MQTT_QOS_AT_LEAST_ONCE, 0, NULL)
+                     == lwcellOK;
+            }
+            ok = ok && prv_mf_disconnect(c[0])
+                 && prv_mf_wait(&mf.published[2], 3, 4 * LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT + 5000);
+            prv_sample(lwcell_modem_sim_now_ns() - t);
+        }
+        for (size_t i = 1; i < LWCELL_ARRAYSIZE(c); ++i) {
+            if (c[i] != NULL && lwcell_mqtt_client_is_connected(c[i])) {
+                prv_mf_disconnect(c[i]);
+            }
+        }
+
+        /* Region of deleted client is the only free memory of pool */
+        if (ok) {
+            lwcell_mqtt_client_delete(c[1]);
+            ok = lwcell_mqtt_mgr_client_new(mgr, tx_len + 1, 256, 1) == NULL
+                 && (c[1] = lwcell_mqtt_mgr_client_new(mgr, tx_len, 256, 1)) != NULL;
+        }
+        lwcell_mqtt_mgr_delete(mgr);
+    }
+    prv_end(res, (uint64_t)2 * cnt * len + 3 * 8, ok && mf.failed == 0 && mf.published[2] == 3);
+    lwcell_buff_free(&store);
+    free(data);
+#else  /* !LWCELL_CFG_MQTT && LWCELL_CFG_MQTT_MGR && LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT */
+    memset(res, 0x00, sizeof(*res));
+    res->name = "mqtt_mgr";
+    res->reason = "LWCELL_CFG_MQTT enabled or LWCELL_CFG_MQTT_MGR or LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT disabled";
+#endif /* LWCELL_CFG_MQTT || !LWCELL_CFG_MQTT_MGR || !LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT */
+}
+
+#if LWCELL_CFG_HTTP
+
+/**
+ * \brief           HTTP range callback, verifying received body
+ * \param[in]       pbuf: Packet buffer with body data
+ * \param[in]       offset: Offset of first byte in `pbuf`
+ * \param[in]       arg: Pointer to `uint8_t` set to `0` on corrupted data
+ * \return          \ref lwcellOK to continue download
+ */
+static lwcellr_t
+prv_http_range_fn(lwcell_pbuf_p pbuf, uint32_t offset, void* arg) {
+    const uint8_t* data = lwcell_pbuf_data(pbuf);
+    size_t len = lwcell_pbuf_length(pbuf, 0);
+
+    for (size_t i = 0; i < len; ++i) {
+        if (data[i] != LWCELL_MODEM_SIM_HTTP_BYTE(offset + i)) {
+            *(uint8_t*)arg = 0;
+            return lwcellERR;
+        }
+    }
+    return lwcellOK;
+}
+
+/**
+ * \brief           HTTP POST body producer, generating content expected by modem model
+ * \param[out]      buff: Buffer to fill
+ * \param[in]       btw: Number of bytes to write
+ * \param[in]       offset: Offset in the body
+ * \param[in]       arg: Unused
+ * \return          Number of bytes written
+ */
+static size_t
+prv_http_body_fn(void* buff, size_t btw, uint32_t offset, void* arg) {
+    LWCELL_UNUSED(arg);
+    for (size_t i = 0; i < btw; ++i) {
+        ((uint8_t*)buff)[i] = LWCELL_MODEM_SIM_HTTP_BYTE(offset + i);
+    }
+    return btw;
+}
+
+/**
+ * \brief           HTTP POST response callback, parsing number of bytes received by server
+ * \param[in]       pbuf: Packet buffer with response body
+ * \param[in]       offset: Offset of first byte in `pbuf`
+ * \param[in]       arg: Pointer to `uint32_t` for received length
+ * \return          \ref lwcellOK to continue
+ */
+static lwcellr_t
+prv_http_resp_fn(lwcell_pbuf_p pbuf, uint32_t offset, void* arg) {
+    char str[16] = {0};
+
+    LWCELL_UNUSED(offset);
+    lwcell_pbuf_copy(pbuf, str, sizeof(str) - 1, 0);
+    *(uint32_t*)arg = (uint32_t)strtoul(str, NULL, 10);
+    return lwcellOK;
+}
+
+#endif /* LWCELL_CFG_HTTP */
+
+/**
+ * \brief           HTTP POST with body produced in segments, latency between segments
+ * \param[out]      res: Result output
+ */
+static void
+bench_http_upload(e2e_result_t* res) {
+#if LWCELL_CFG_HTTP
+    uint32_t recv = 0;
+    uint16_t status = 0;
+    uint8_t ok;
+
+    if (!prv_begin(res, "http_upload", cfg.size / LWCELL_CFG_HTTP_POST_SEGMENT_LEN + 1)) {
+        return;
+    }
+    http_post_ts = lwcell_modem_sim_now_ns();
+    ok = lwcell_http_post("http://sim.local/upload", "application/octet-stream", cfg.size, prv_http_body_fn, NULL,
+                          prv_http_resp_fn, &recv, &status, NULL, NULL, 1)
+         == lwcellOK;
+    prv_end(res, recv, ok && status == 200 && recv == cfg.size);
+#else  /* LWCELL_CFG_HTTP */
+    memset(res, 0x00, sizeof(*res));
+    res->name = "http_upload";
+    res->reason = "LWCELL_CFG_HTTP disabled";
+#endif /* !LWCELL_CFG_HTTP */
+}
+
+/**
+ * \brief           HTTP download in ranges with resume after failed requests
+ * \param[out]      res: Result output
+ */
+static void
+bench_http_download(e2e_result_t* res) {
+#if LWCELL_CFG_HTTP
+    char url[64];
+    uint32_t recv = 0;
+    uint8_t ok = 1;
+
+    if (!prv_begin(res, "http_download", 0)) {
+        return;
+    }
+    sprintf(url, "http://sim.local/res?len=%u&fail=5", (unsigned)cfg.size);
+    if (lwcell_network_attach(LWCELL_PDP_APP_PROTOCOL, "internet", NULL, NULL, NULL, NULL, 1) != lwcellOK
+        || lwcell_http_download(url, 0, 8192, prv_http_range_fn, &ok, &recv) != lwcellOK) {
+        ok = 0;
+    }
+    prv_end(res, recv, ok && recv == cfg.size);
+#else  /* LWCELL_CFG_HTTP */
+    memset(res, 0x00, sizeof(*res));
+    res->name = "http_download";
+    res->reason = "LWCELL_CFG_HTTP disabled";
+#endif /* !LWCELL_CFG_HTTP */
+}
+
+/**
+ * \brief           Back-to-back small HTTP range requests, latency of each request
+ * \param[out]      res: Result output
+ * \param[in]       name: Benchmark name
+ * \param[in]       keep_alive: Time to keep HTTP service initialized between requests,
+ *                      `0` to initialize and terminate it for every request
+ */
+static void
+bench_http_requests(e2e_result_t* res, const char* name, uint32_t keep_alive) {
+#if LWCELL_CFG_HTTP
+    uint64_t bytes = 0, t;
+    uint16_t status;
+    uint8_t ok = 1;
+
+    if (!prv_begin(res, name, cfg.count)) {
+        return;
+    }
+    lwcell_http_set_keep_alive(keep_alive);
+    for (uint32_t i = 0; ok && i < cfg.count; ++i) {
+        t = lwcell_modem_sim_now_ns();
+        if (lwcell_http_get_range("http://sim.local/res?len=4096", (i * 256) % 4096, 256, prv_http_range_fn, &ok,
+                                  &status, NULL, NULL, 1)
+                != lwcellOK
+            || status != 206) {
+            ok = 0;
+        }
+        prv_sample(lwcell_modem_sim_now_ns() - t);
+        bytes += 256;
+    }
+    if (lwcell_http_session_close(NULL, NULL, 1) != lwcellOK) {
+        ok = 0;
+    }
+    lwcell_http_set_keep_alive(LWCELL_CFG_HTTP_KEEP_ALIVE);
+    prv_end(res, bytes, ok);
+#else  /* LWCELL_CFG_HTTP */
+    LWCELL_UNUSED(keep_alive);
+    memset(res, 0x00, sizeof(*res));
+    res->name = name;
+    res->reason = "LWCELL_CFG_HTTP disabled";
+#endif /* !LWCELL_CFG_HTTP */
+}
+
+/**
+ * \brief           SMS send, latency of each blocking send
+ * \param[out]      res: Result output
+ */
+static void
+bench_sms_send(e2e_result_t* res) {
+#if LWCELL_CFG_SMS
+    static const char text[] = "LwCELL end-to-end benchmark message";
+    uint64_t sent = 0, t;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, "sms_send", cfg.count)) {
+        return;
+    }
+    if (lwcell_sms_enable(NULL, NULL, 1) == lwcellOK) {
+        ok = 1;
+        for (uint32_t i = 0; i < cfg.count; ++i) {
+            t = lwcell_modem_sim_now_ns();
+            if (lwcell_sms_send("+10000000000", text, NULL, NULL, 1) != lwcellOK) {
+                ok = 0;
+                break;
+            }
+            prv_sample(lwcell_modem_sim_now_ns() - t);
+            sent += sizeof(text) - 1;
+        }
+    }
+    prv_end(res, sent, ok);
+#else  /* LWCELL_CFG_SMS */
+    memset(res, 0x00, sizeof(*res));
+    res->name = "sms_send";
+    res->reason = "LWCELL_CFG_SMS disabled";
+#endif /* !LWCELL_CFG_SMS */
+}
+
+#if LWCELL_CFG_TRANSPARENT
+
+/**
+ * \brief           Transparent mode receive callback.
+ *
+ * Stream is not split to chunks by modem, timestamp is located
+ * at the beginning of each \ref LWCELL_CFG_CONN_MAX_DATA_LEN bytes
+ * \param[in]       data: Received data, `NULL` when connection has been closed
+ * \param[in]       len: Length of data
+ * \param[in]       arg: Unused
+ */
+static void
+prv_transparent_recv_fn(const void* data, size_t len, void* arg) {
+    const uint8_t* d = data;
+
+    LWCELL_UNUSED(arg);
+    pthread_mutex_lock(&tp.mutex);
+    if (d == NULL) {
+        tp.closed = 1;
+    }
+    for (size_t i = 0; d != NULL && i < len; ++i, ++tp.recv) {
+        size_t off = (size_t)(tp.recv % LWCELL_CFG_CONN_MAX_DATA_LEN);
+
+        if (off < sizeof(tp.ts)) {
+            tp.ts = (tp.ts & ~(0xFFULL << (8 * off))) | ((uint64_t)d[i] << (8 * off));
+            if (off == sizeof(tp.ts) - 1) {
+                prv_sample(lwcell_modem_sim_now_ns() - tp.ts);
+            }
+        }
+    }
+    pthread_cond_signal(&tp.cond);
+    pthread_mutex_unlock(&tp.mutex);
+}
+
+#endif /* LWCELL_CFG_TRANSPARENT */
+
+/**
+ * \brief           TCP download in transparent mode, latency of each chunk
+ *                  from modem reception to application
+ * \param[out]      res: Result output
+ */
+static void
+bench_tcp_download_transparent(e2e_result_t* res) {
+#if LWCELL_CFG_TRANSPARENT
+    uint8_t req[8] = {'G', 'E', 'T', 0};
+    struct timespec ts;
+    uint64_t recv;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, "tcp_download_transparent", cfg.size / LWCELL_CFG_CONN_MAX_DATA_LEN + 1)) {
+        return;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        req[4 + i] = (uint8_t)(cfg.size >> (8 * i));
+    }
+    if (lwcell_transparent_start("internet", NULL, NULL, LWCELL_CONN_TYPE_TCP, "sim.local",
+                                 LWCELL_MODEM_SIM_PORT_STREAM, prv_transparent_recv_fn, NULL, NULL, NULL, 1)
+        == lwcellOK) {
+        if (lwcell_transparent_write(req, sizeof(req)) == lwcellOK) {
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_sec += 10;
+            ok = 1;
+            pthread_mutex_lock(&tp.mutex);
+            while (tp.recv < cfg.size && !tp.closed) {
+                if (pthread_cond_timedwait(&tp.cond, &tp.mutex, &ts) != 0) {
+                    ok = 0;
+                    break;
+                }
+            }
+            pthread_mutex_unlock(&tp.mutex);
+        }
+        if (lwcell_transparent_stop(NULL, NULL, 1) != lwcellOK) {
+            ok = 0;
+        }
+    }
+    pthread_mutex_lock(&tp.mutex);
+    recv = tp.recv;
+    pthread_mutex_unlock(&tp.mutex);
+    prv_end(res, recv, ok && recv >= cfg.size);
+#else  /* LWCELL_CFG_TRANSPARENT */
+    memset(res, 0x00, sizeof(*res));
+    res->name = "tcp_download_transparent";
+    res->reason = "LWCELL_CFG_TRANSPARENT disabled";
+#endif /* !LWCELL_CFG_TRANSPARENT */
+}
+
+#if LWCELL_CFG_PPP
+
+/**
+ * \brief           PPP network interface input function
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data
+ * \param[in]       arg: Unused
+ */
+static void
+prv_ppp_input_fn(const void* data, size_t len, void* arg) {
+    LWCELL_UNUSED(data);
+    LWCELL_UNUSED(arg);
+    pthread_mutex_lock(&ppp.mutex);
+    ppp.recv += len;
+    pthread_cond_signal(&ppp.cond);
+    pthread_mutex_unlock(&ppp.mutex);
+}
+
+/**
+ * \brief           PPP network interface link status function
+ * \param[in]       up: Link status
+ * \param[in]       arg: Unused
+ */
+static void
+prv_ppp_link_fn(uint8_t up, void* arg) {
+    LWCELL_UNUSED(arg);
+    pthread_mutex_lock(&ppp.mutex);
+    ppp.up = up;
+    pthread_cond_signal(&ppp.cond);
+    pthread_mutex_unlock(&ppp.mutex);
+}
+
+#endif /* LWCELL_CFG_PPP */
+
+/**
+ * \brief           PPP frames echoed by network peer, latency of each frame round-trip.
+ *                  With multiplexer, signal quality is read on AT channel after each frame
+ * \param[out]      res: Result output
+ */
+static void
+bench_ppp_loopback(e2e_result_t* res) {
+#if LWCELL_CFG_PPP
+    static const lwcell_ppp_netif_t netif = {
+        .input_fn = prv_ppp_input_fn,
+        .link_fn = prv_ppp_link_fn,
+    };
+    uint8_t* frame;
+    struct timespec ts;
+    uint64_t sent = 0, t;
+    uint8_t ok = 0;
+
+    if (!prv_begin(res, "ppp_loopback", cfg.count) || (frame = malloc(cfg.msg)) == NULL) {
+        return;
+    }
+    memset(frame, 0x7E, cfg.msg);
+    ppp.recv = 0;
+    if (lwcell_ppp_start("internet", &netif, NULL, NULL, NULL, 1) == lwcellOK) {
+        ok = 1;
+        for (uint32_t i = 0; ok && i < cfg.count; ++i) {
+            t = lwcell_modem_sim_now_ns();
+            if (lwcell_ppp_output(frame, cfg.msg) != cfg.msg) {
+                ok = 0;
+                break;
+            }
+            sent += cfg.msg;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_sec += 10;
+            pthread_mutex_lock(&ppp.mutex);
+            while (ppp.recv < sent && ppp.up) {
+                if (pthread_cond_timedwait(&ppp.cond, &ppp.mutex, &ts) != 0) {
+                    ok = 0;
+                    break;
+                }
+            }
+            ok = ok && ppp.recv >= sent;
+            pthread_mutex_unlock(&ppp.mutex);
+            prv_sample(lwcell_modem_sim_now_ns() - t);
+#if LWCELL_CFG_CMUX
+            {
+                int16_t rssi;
+
+                if (lwcell_network_rssi(&rssi, NULL, NULL, 1) != lwcellOK) {
+                    ok = 0;
+                }
+            }
+#endif /* LWCELL_CFG_CMUX */
+        }
+        if (lwcell_ppp_stop(NULL, NULL, 1) != lwcellOK || lwcell_ppp_is_active()) {
+            ok = 0;
+        }
+    }
+    prv_end(res, sent, ok);
+    free(frame);
+#else  /* LWCELL_CFG_PPP */
+    memset(res, 0x00, sizeof(*res));
+    res->name = "ppp_loopback";
+    res->reason = "LWCELL_CFG_PPP disabled";
+#endif /* !LWCELL_CFG_PPP */
+}
+
+/**
+ * \brief           Parse command line arguments
+ * \param[in]       argc: Number of arguments
+ * \param[in]       argv: Arguments
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+prv_parse_args(int argc, char** argv) {
+    for (int i = 1; i < argc; i += 2) {
+        uint32_t val;
+
+        if (i + 1 >= argc || atol(argv[i + 1]) <= 0) {
+            return 0;
+        }
+        val = (uint32_t)atol(argv[i + 1]);
+        if (!strcmp(argv[i], "--baud")) {
+            cfg.link.baudrate = val;
+        } else if (!strcmp(argv[i], "--modem-baud")) {
+            cfg.link.modem_baudrate = val;
+        } else if (!strcmp(argv[i], "--modem-max-baud")) {
+            cfg.link.max_baudrate = val;
+        } else if (!strcmp(argv[i], "--delay-us")) {
+            cfg.link.proc_delay_us = val;
+        } else if (!strcmp(argv[i], "--rtt-ms")) {
+            cfg.link.rtt_us = val * 1000;
+        } else if (!strcmp(argv[i], "--size")) {
+            cfg.size = val;
+        } else if (!strcmp(argv[i], "--msg")) {
+            cfg.msg = val;
+        } else if (!strcmp(argv[i], "--count")) {
+            cfg.count = val;
+        } else if (!strcmp(argv[i], "--mqtt-size")) {
+            cfg.mqtt_size = val;
+        } else {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * \brief           Program entry point
+ * \param[in]       argc: Number of arguments
+ * \param[in]       argv: Arguments
+ * \return          `0` on success
+ */
+int
+main(int argc, char** argv) {
+    e2e_result_t res[26];
+    size_t cnt = 0;
+    int ret = 0;
+
+    if (!prv_parse_args(argc, argv)) {
+        fprintf(stderr,
+                "Usage: %s [--baud N] [--modem-baud N] [--modem-max-baud N] [--delay-us N] [--rtt-ms N] "
+                "[--size N] [--msg N] [--count N] [--mqtt-size N]\r\n",
+                argv[0]);
+        return 1;
+    }
+    lwcell_modem_sim_set_config(&cfg.link);
+    if (lwcell_init(prv_evt_fn, 1) != lwcellOK) {
+        fprintf(stderr, "Cannot initialize library\r\n");
+        return 1;
+    }
+    if (lwcell_network_attach(LWCELL_PDP_SOCKET, "internet", NULL, NULL, NULL, NULL, 1) != lwcellOK) {
+        fprintf(stderr, "Cannot attach to network\r\n");
+        return 1;
+    }
+
+    bench_tcp_upload(&res[cnt++]);
+    bench_tcp_download(&res[cnt++]);
+    bench_cmd_latency_during_download(&res[cnt++]);
+    bench_mqtt_publish(&res[cnt++], "mqtt_publish_qos0", LWCELL_MQTT_QOS_AT_MOST_ONCE);
+    bench_mqtt_publish(&res[cnt++], "mqtt_publish_qos1", LWCELL_MQTT_QOS_AT_LEAST_ONCE);
+    bench_mqtt_publish_burst(&res[cnt++], "mqtt_publish_burst_qos0", LWCELL_MQTT_QOS_AT_MOST_ONCE);
+    bench_mqtt_publish_burst(&res[cnt++], "mqtt_publish_burst_qos1", LWCELL_MQTT_QOS_AT_LEAST_ONCE);
+#if LWCELL_CFG_MQTT
+    bench_mqtt_connect_refused(&res[cnt++]);
+#endif /* LWCELL_CFG_MQTT */
+    bench_mqtt_qos_retransmit(&res[cnt++]);
+    bench_mqtt_session_replay(&res[cnt++]);
+    bench_mqtt_recv_stream(&res[cnt++]);
+    bench_mqtt_api_overflow(&res[cnt++], "mqtt_api_overflow_drop_newest", LWCELL_MQTT_CLIENT_API_OVERFLOW_DROP_NEWEST);
+    bench_mqtt_api_overflow(&res[cnt++], "mqtt_api_overflow_drop_oldest", LWCELL_MQTT_CLIENT_API_OVERFLOW_DROP_OLDEST);
+    bench_mqtt_router(&res[cnt++]);
+    bench_mqtt5_topic_alias(&res[cnt++]);
+    bench_mqtt5_session_resume(&res[cnt++]);
+    bench_mqtt_publish_stream(&res[cnt++]);
+    bench_mqtt_keep_alive_deadline(&res[cnt++]);
+    bench_mqtt_mgr(&res[cnt++]);
+    bench_sms_send(&res[cnt++]);
+    bench_ppp_loopback(&res[cnt++]);
+    bench_http_download(&res[cnt++]);
+    bench_http_requests(&res[cnt++], "http_requests", 0);
+    bench_http_requests(&res[cnt++], "http_requests_keep_alive", 10000);
+    bench_http_upload(&res[cnt++]);
+    bench_tcp_download_transparent(&res[cnt++]);
+
+    printf("{\n  \"suite\": \"lwcell_bench_e2e\",\n");
+    printf("  \"link\": {\"baudrate_initial\": %u, \"baudrate\": %u, \"proc_delay_us\": %u, \"rtt_us\": %u},\n",
+           (unsigned)cfg.link.baudrate, (unsigned)lwcell_modem_sim_get_baudrate(), (unsigned)cfg.link.proc_delay_us,
+           (unsigned)cfg.link.rtt_us);
+    printf("  \"results\": [\n");
+    for (size_t i = 0; i < cnt; ++i) {
+        double sec = (double)res[i].ns / 1e9;
+
+        if (res[i].reason != NULL) {
+            printf("    {\"name\": \"%s\", \"skipped\": true, \"reason\": \"%s\"}", res[i].name, res[i].reason);
+        } else {
+            printf("    {\"name\": \"%s\", \"ok\": %s, \"bytes\": %llu, \"messages\": %llu, \"ns\": %llu, "
+                   "\"goodput_bps\": %.1f, \"lat_p50_us\": %.1f, \"lat_p90_us\": %.1f, \"lat_p99_us\": %.1f, "
+                   "\"lat_max_us\": %.1f, \"cpu_ns_per_kb\": %.1f}",
+                   res[i].name, res[i].ok ? "true" : "false", (unsigned long long)res[i].bytes,
+                   (unsigned long long)res[i].msgs, (unsigned long long)res[i].ns,
+                   sec > 0 ? (double)res[i].bytes * 8 / sec : 0.0, (double)res[i].lat[0] / 1e3,
+                   (double)res[i].lat[1] / 1e3, (double)res[i].lat[2] / 1e3, (double)res[i].lat[3] / 1e3,
+                   res[i].bytes > 0 ? (double)res[i].cpu_ns * 1024 / (double)res[i].bytes : 0.0);
+            if (!res[i].ok) {
+                ret = 1;
+            }
+        }
+        printf("%s\n", i + 1 < cnt ? "," : "");
+    }
+    printf("  ]\n}\n");
+    free(lat_samples);
+    lwcell_modem_sim_stop();
+    return ret;
+}
@@ -0,0 +1,1682 @@
+/**
+ * \file            lwcell_modem_sim.c
+ * \brief           Simulated modem link for end-to-end benchmarks
+ *
+ * Module implements low-level layer of the library (\ref lwcell_ll_init),
+ * connected to a modem model running in separate thread.
+ *
+ * Both UART directions are paced by baudrate. Host and modem baudrates are modeled separately,
+ * data sent on mismatched baudrate are lost, as garbage would be received on real UART.
+ * Modem supports `AT+IPR` baudrate change and `AT&W` to keep it over `AT+CFUN=1,1` reset.
+ *
+ * Modem supports 3GPP TS 27.010 basic mode multiplexer, started with `AT+CMUX` command.
+ * Each channel has its own command parser. Frames to host are sent one by one,
+ * frames of AT channel have priority over queued frames of data channel, as they would on real device.
+ *
+ * Modem parses AT commands, replies after processing delay
+ * and emulates remote network endpoints behind radio link with configured round-trip time.
+ * Data to host are delivered with \ref lwcell_input_process in small chunks,
+ * the same way as UART driver with DMA and idle line detection would do.
+ */
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lwcell/lwcell.h"
+#include "lwcell/lwcell_input.h"
+#include "lwcell_modem_sim.h"
+
+/* Number of bytes passed to input function at a time */
+#define SIM_INPUT_CHUNK_LEN 64
+
+/* Maximal length of AT command line */
+#define SIM_LINE_LEN        256
+
+/* Size of per-connection reassembly buffer for remote endpoints */
+#define SIM_CONN_BUFF_LEN   4096
+
+/* Maximal length of MQTT topic or client ID remembered by broker, including `NULL` termination */
+#define SIM_MQTT_TOPIC_LEN  64
+
+/* Get big-endian 16-bit value */
+#define SIM_U16(p)          ((size_t)(p)[0] << 8 | (size_t)(p)[1])
+
+/* Guard time after transparent mode escape sequence, before modem responds */
+#define SIM_ESCAPE_GUARD_NS 100000000ULL
+
+/* Multiplexer constants */
+#define SIM_CMUX_FLAG       0xF9
+#define SIM_CMUX_CR         0x02
+#define SIM_CMUX_PF         0x10
+#define SIM_CMUX_SABM       0x2F
+#define SIM_CMUX_UA         0x63
+#define SIM_CMUX_DISC       0x43
+#define SIM_CMUX_UIH        0xEF
+#define SIM_CMUX_MSG_CLD    0x30
+#define SIM_CMUX_DLCI_DATA  2    /* Highest supported DLCI, channel with lowest priority */
+#define SIM_CMUX_MAX_N1     1024 /* Maximal supported information field length */
+
+/**
+ * \brief           Data packet, travelling over UART in one direction
+ */
+typedef struct sim_pkt {
+    struct sim_pkt* next; /*!< Next packet in a list */
+    uint64_t at;          /*!< Time when packet is ready to be processed or sent */
+    uint32_t baudrate;    /*!< Baudrate used by sender */
+    uint8_t dlci;         /*!< Multiplexer channel of packet data */
+    size_t len;           /*!< Length of packet data */
+    size_t ptr;           /*!< Number of bytes already delivered */
+    uint8_t data[];       /*!< Packet data */
+} sim_pkt_t;
+
+/**
+ * \brief           Modem connection and remote endpoint state
+ */
+typedef struct {
+    uint8_t active;                   /*!< Connection is active */
+    uint16_t port;                    /*!< Remote port, selects endpoint behavior */
+    uint8_t dlci;                     /*!< Multiplexer channel used to open connection */
+    uint8_t transparent;              /*!< Connection is opened in transparent mode */
+    uint8_t buff[SIM_CONN_BUFF_LEN];  /*!< Received data, not yet processed by endpoint */
+    size_t buff_len;                  /*!< Number of bytes in reassembly buffer */
+
+    struct {
+        uint8_t v5;      /*!< Client connected with MQTT 5.0 */
+        uint8_t no_ping; /*!< `PINGREQ` packets of client are not answered */
+        size_t skip;     /*!< Remaining bytes of packet too big for reassembly buffer */
+        uint8_t ack[4];  /*!< Acknowledge of skipped packet, sent when packet is received completely */
+        size_t ack_len;  /*!< Length of acknowledge of skipped packet, `0` when none */
+        char alias[LWCELL_MODEM_SIM_MQTT_ALIAS_MAX][SIM_MQTT_TOPIC_LEN]; /*!< Topics of aliases, index is alias - 1 */
+    } mqtt;                                                              /*!< MQTT broker state of connection */
+} sim_conn_t;
+
+/**
+ * \brief           Modem command parser mode
+ */
+typedef enum {
+    SIM_MODE_CMD,  /*!< Receiving AT commands */
+    SIM_MODE_DATA, /*!< Receiving connection data after `AT+CIPSEND` */
+    SIM_MODE_SMS,  /*!< Receiving SMS text after `AT+CMGS` */
+    SIM_MODE_TRANSPARENT, /*!< Receiving connection data in transparent mode, until `+++` */
+    SIM_MODE_PPP,         /*!< PPP data mode after `ATD*99#`, network peer echoes all frames, until `+++` */
+    SIM_MODE_MQTT_PUB,    /*!< Receiving message payload after `AT+MPUBEX` */
+    SIM_MODE_HTTP_DATA,   /*!< Receiving HTTP POST body after `AT+HTTPDATA` */
+} sim_mode_t;
+
+/**
+ * \brief           Command channel state, one per multiplexer channel
+ */
+typedef struct {
+    sim_mode_t mode;                            /*!< Command parser mode */
+    char line[SIM_LINE_LEN];                    /*!< Command line being received */
+    size_t line_len;                            /*!< Length of command line */
+    uint8_t data[LWCELL_CFG_CONN_MAX_DATA_LEN]; /*!< Connection data being received */
+    size_t data_len;                            /*!< Number of received connection data bytes */
+    size_t data_exp;                            /*!< Number of expected connection data bytes */
+    uint8_t data_conn;                          /*!< Connection number for connection data */
+} sim_chan_t;
+
+/**
+ * \brief           Modem simulator state
+ */
+static struct {
+    lwcell_modem_sim_cfg_t cfg; /*!< Link configuration */
+    uint32_t host_baudrate;     /*!< Current host UART baudrate, protected by mutex */
+    uint32_t modem_baudrate;    /*!< Current modem UART baudrate */
+    uint32_t saved_baudrate;    /*!< Modem baudrate saved with `AT&W` */
+
+    pthread_t thread;      /*!< Modem thread */
+    pthread_mutex_t mutex; /*!< Protects host to modem queue and statistics */
+    pthread_cond_t cond;   /*!< Wakes up modem thread */
+    uint8_t started;       /*!< Modem thread is started */
+    uint8_t running;       /*!< Modem thread shall keep running */
+
+    sim_pkt_t* rx_head;    /*!< Host to modem queue, head */
+    sim_pkt_t* rx_tail;    /*!< Host to modem queue, tail */
+    uint64_t rx_line_free; /*!< Time when host to modem line becomes idle */
+    sim_pkt_t* tx_head;    /*!< Modem to host queue, sorted by time */
+    uint64_t tx_line_free; /*!< Time when modem to host line becomes idle */
+    uint64_t input_cpu_ns; /*!< Modem thread CPU time spent inside library input function */
+
+    sim_chan_t chans[SIM_CMUX_DLCI_DATA + 1]; /*!< Command channels, index is DLCI, `0` without multiplexer */
+    uint8_t out_dlci;                         /*!< Channel for responses of command being processed */
+    uint8_t ip_up;                            /*!< PDP context is active */
+    uint8_t cipmux;                           /*!< Multi-connection mode, set with `AT+CIPMUX` */
+    uint8_t cipmode;                          /*!< Transparent mode, set with `AT+CIPMODE` */
+    sim_conn_t conns[LWCELL_CFG_MAX_CONNS];   /*!< Modem connections */
+
+    uint8_t mux;   /*!< Multiplexer mode is active */
+    size_t mux_n1; /*!< Maximal information field length */
+    struct {
+        uint8_t state;                 /*!< Receive state, `0` when waiting for flag */
+        uint8_t addr;                  /*!< Address field */
+        uint8_t ctrl;                  /*!< Control field */
+        uint8_t fcs;                   /*!< Running frame check sequence */
+        size_t len;                    /*!< Information field length */
+        size_t ptr;                    /*!< Number of received information bytes */
+        uint8_t data[SIM_CMUX_MAX_N1]; /*!< Information field */
+    } mux_rx;                          /*!< Frame being received from host */
+    uint64_t mux_errors;               /*!< Number of invalid frames received from host */
+
+    uint64_t rx_discard; /*!< Bytes received by discard endpoint */
+    uint64_t rx_stream;  /*!< Bytes received by stream endpoint */
+    uint64_t rx_mqtt;    /*!< Bytes received by MQTT broker */
+
+    lwcell_modem_sim_mqtt_stats_t mqtt_stats; /*!< MQTT broker statistics, protected by mutex */
+    char mqtt_session[SIM_MQTT_TOPIC_LEN];    /*!< Client ID of persistent session on broker, empty when none */
+
+    struct {
+        uint8_t tcp;        /*!< TCP connection to broker is open with `AT+MIPSTART` */
+        uint8_t refuse;     /*!< Broker refuses client configured with `AT+MCONFIG` */
+        uint8_t connected;  /*!< Native MQTT session is connected with `AT+MCONNECT` */
+        char sub[64];       /*!< Subscribed topic, empty when none */
+        char pub[64];       /*!< Topic of message being received with `AT+MPUBEX` */
+    } mqtt;                 /*!< Native MQTT session state */
+
+    struct {
+        uint8_t init;       /*!< HTTP service is initialized with `AT+HTTPINIT` */
+        char url[128];      /*!< Resource URL */
+        uint32_t brk;       /*!< First byte of requested range */
+        uint32_t brkend;    /*!< Last byte of requested range */
+        uint32_t body_len;  /*!< Length of body of last request, ready to be read */
+        uint32_t actions;   /*!< Number of requests, used for failure injection */
+        uint32_t post_len;  /*!< Length of POST body received with `AT+HTTPDATA` */
+        uint8_t post_bad;   /*!< POST body does not match expected content */
+        char resp[16];      /*!< Response body of POST request, `NULL` terminated */
+    } http;                 /*!< HTTP service state */
+} sim = {
+    .cfg = {.baudrate = 115200, .max_baudrate = 921600, .proc_delay_us = 1000, .rtt_us = 100000},
+    .cipmux = 1,
+};
+
+/**
+ * \brief           Get monotonic time in units of nanoseconds
+ * \return          Current time
+ */
+uint64_t
+lwcell_modem_sim_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * \brief           Get CPU time of calling thread in units of nanoseconds
+ * \return          Thread CPU time
+ */
+static uint64_t
+prv_thread_cpu_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * \brief           Get time to transfer bytes over UART
+ * \param[in]       len: Number of bytes
+ * \param[in]       baudrate: UART baudrate
+ * \return          Time in units of nanoseconds
+ */
+static uint64_t
+prv_uart_ns(size_t len, uint32_t baudrate) {
+    return (uint64_t)len * 10000000000ULL / LWCELL_MAX(baudrate, 1);
+}
+
+/**
+ * \brief           Allocate new packet
+ * \param[in]       at: Packet time
+ * \param[in]       data: Packet data, may be `NULL` to leave data uninitialized
+ * \param[in]       len: Length of data
+ * \return          New packet on success, `NULL` otherwise
+ */
+static sim_pkt_t*
+prv_pkt_new(uint64_t at, const void* data, size_t len) {
+    sim_pkt_t* p;
+
+    if ((p = malloc(sizeof(*p) + len)) != NULL) {
+        p->next = NULL;
+        p->at = at;
+        p->len = len;
+        p->ptr = 0;
+        if (data != NULL) {
+            memcpy(p->data, data, len);
+        }
+    }
+    return p;
+}
+
+/**
+ * \brief           Free list of packets
+ * \param[in]       p: First packet in the list
+ */
+static void
+prv_pkt_free_list(sim_pkt_t* p) {
+    while (p != NULL) {
+        sim_pkt_t* n = p->next;
+        free(p);
+        p = n;
+    }
+}
+
+/**
+ * \brief           Update multiplexer frame check sequence with new byte
+ * \param[in]       fcs: Current value
+ * \param[in]       ch: New byte
+ * \return          Updated value
+ */
+static uint8_t
+prv_fcs_update(uint8_t fcs, uint8_t ch) {
+    fcs ^= ch;
+    for (size_t i = 0; i < 8; ++i) {
+        fcs = (fcs & 0x01) ? (uint8_t)((fcs >> 1) ^ 0xE0) : (uint8_t)(fcs >> 1);
+    }
+    return fcs;
+}
+
+/**
+ * \brief           Queue packet from modem to host, keeping queue sorted by time.
+ *                  Packet being delivered is never split by new one.
+ *                  Called from modem thread only
+ * \param[in]       p: Packet to queue
+ */
+static void
+prv_queue_pkt(sim_pkt_t* p) {
+    sim_pkt_t** pp;
+
+    p->baudrate = sim.modem_baudrate;
+    for (pp = &sim.tx_head; *pp != NULL && ((*pp)->ptr > 0 || (*pp)->at <= p->at); pp = &(*pp)->next) {}
+    p->next = *pp;
+    *pp = p;
+}
+
+/**
+ * \brief           Queue single multiplexer frame from modem to host
+ * \param[in]       at: Time when frame is ready to be sent
+ * \param[in]       dlci: Channel DLCI
+ * \param[in]       cr: Command/response bit value
+ * \param[in]       ctrl: Control field
+ * \param[in]       data: Information field
+ * \param[in]       len: Length of information field
+ */
+static void
+prv_out_frame(uint64_t at, uint8_t dlci, uint8_t cr, uint8_t ctrl, const void* data, size_t len) {
+    sim_pkt_t* p;
+    size_t hdr_len = len > 0x7F ? 5 : 4;
+    uint8_t fcs = 0xFF;
+
+    if ((p = prv_pkt_new(at, NULL, hdr_len + len + 2)) == NULL) {
+        return;
+    }
+    p->dlci = dlci;
+    p->data[0] = SIM_CMUX_FLAG;
+    p->data[1] = (uint8_t)((dlci << 2) | (cr ? SIM_CMUX_CR : 0) | 0x01);
+    p->data[2] = ctrl;
+    if (len > 0x7F) {
+        p->data[3] = (uint8_t)(len << 1);
+        p->data[4] = (uint8_t)(len >> 7);
+    } else {
+        p->data[3] = (uint8_t)((len << 1) | 0x01);
+    }
+    for (size_t i = 1; i < hdr_len; ++i) {
+        fcs = prv_fcs_update(fcs, p->data[i]);
+    }
+    if (len > 0) {
+        memcpy(&p->data[hdr_len], data, len);
+    }
+    p->data[hdr_len + len] = (uint8_t)(0xFF - fcs);
+    p->data[hdr_len + len + 1] = SIM_CMUX_FLAG;
+    prv_queue_pkt(p);
+}
+
+/**
+ * \brief           Queue data from modem to host, packed to frames when multiplexer is active
+ * \param[in]       at: Time when modem starts sending data
+ * \param[in]       dlci: Channel DLCI, used in multiplexer mode only
+ * \param[in]       data: Data to send
+ * \param[in]       len: Length of data
+ */
+static void
+prv_out_data(uint64_t at, uint8_t dlci, const void* data, size_t len) {
+    if (sim.mux) {
+        for (size_t off = 0; off < len; off += sim.mux_n1) {
+            prv_out_frame(at, dlci, 0, SIM_CMUX_UIH, &((const uint8_t*)data)[off], LWCELL_MIN(len - off, sim.mux_n1));
+        }
+    } else {
+        sim_pkt_t* p;
+
+        if ((p = prv_pkt_new(at, data, len)) != NULL) {
+            p->dlci = dlci;
+            prv_queue_pkt(p);
+        }
+    }
+}
+
+/**
+ * \brief           Queue formatted response from modem to host, on channel of command being processed
+ * \param[in]       at: Time when modem starts sending response
+ * \param[in]       fmt: Format string
+ */
+static void
+prv_out(uint64_t at, const char* fmt, ...) {
+    char str[128];
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = vsnprintf(str, sizeof(str), fmt, args);
+    va_end(args);
+    if (len > 0) {
+        prv_out_data(at, sim.out_dlci, str, LWCELL_MIN((size_t)len, sizeof(str) - 1));
+    }
+}
+
+/**
+ * \brief           Queue received connection data from modem to host,
+ *                  on channel used to open connection
+ * \param[in]       num: Connection number
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data
+ * \param[in]       at: Time when data were received from network
+ */
+static void
+prv_out_receive(uint8_t num, const void* data, size_t len, uint64_t at) {
+    uint8_t buff[32 + LWCELL_CFG_CONN_MAX_DATA_LEN];
+    size_t hdr_len;
+
+    if (sim.conns[num].transparent) {
+        prv_out_data(at, sim.conns[num].dlci, data, len);
+        return;
+    }
+    len = LWCELL_MIN(len, LWCELL_CFG_CONN_MAX_DATA_LEN);
+    hdr_len = (size_t)sprintf((char*)buff, "+RECEIVE,%u,%u:\r\n", (unsigned)num, (unsigned)len);
+    memcpy(&buff[hdr_len], data, len);
+    prv_out_data(at, sim.conns[num].dlci, buff, hdr_len + len);
+}
+
+/**
+ * \brief           Process data on stream endpoint
+ * \param[in]       num: Connection number
+ * \param[in]       c: Connection handle
+ * \param[in]       at: Time when data arrived to remote side
+ */
+static void
+prv_endpoint_stream(uint8_t num, sim_conn_t* c, uint64_t at) {
+    uint8_t chunk[LWCELL_CFG_CONN_MAX_DATA_LEN];
+    uint64_t t;
+
+    while (c->buff_len >= 8) {
+        size_t total;
+
+        if (memcmp(c->buff, "GET", 3) == 0) {
+            total = (size_t)c->buff[4] | (size_t)c->buff[5] << 8 | (size_t)c->buff[6] << 16
+                    | (size_t)c->buff[7] << 24;
+
+            /*
+             * By default network delivers chunks at UART speed, so latency is not dominated by queueing.
+             * In burst mode, all data arrive to modem at once and wait for UART
+             */
+            t = at + (uint64_t)sim.cfg.rtt_us * 500;
+            for (size_t off = 0; off < total; off += LWCELL_CFG_CONN_MAX_DATA_LEN) {
+                size_t len = LWCELL_MIN(total - off, LWCELL_CFG_CONN_MAX_DATA_LEN);
+
+                memset(chunk, 's', len);
+                memcpy(chunk, &t, LWCELL_MIN(len, sizeof(t)));
+                prv_out_receive(num, chunk, len, t);
+                if (!(c->buff[3] & LWCELL_MODEM_SIM_STREAM_BURST)) {
+                    t += prv_uart_ns(len + 20, sim.modem_baudrate);
+                }
+            }
+        }
+        memmove(c->buff, &c->buff[8], c->buff_len - 8);
+        c->buff_len -= 8;
+    }
+}
+
+/**
+ * \brief           Decode MQTT variable byte integer
+ * \param[in]       data: Encoded data
+ * \param[in]       len: Number of available bytes
+ * \param[out]      val: Decoded value
+ * \return          Number of used bytes, `0` when integer is not complete
+ */
+static size_t
+prv_mqtt_varint(const uint8_t* data, size_t len, size_t* val) {
+    *val = 0;
+    for (size_t i = 0; i < len && i < 4; ++i) {
+        *val |= (size_t)(data[i] & 0x7F) << (7 * i);
+        if (!(data[i] & 0x80)) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Send message back to publishing client with `QoS 0`
+ * \param[in]       num: Connection number
+ * \param[in]       c: Connection handle
+ * \param[in]       topic: Topic of message
+ * \param[in]       topic_len: Length of topic
+ * \param[in]       payload: Message payload
+ * \param[in]       payload_len: Length of payload
+ * \param[in]       at: Time when message is sent
+ */
+static void
+prv_mqtt_echo(uint8_t num, const sim_conn_t* c, const char* topic, size_t topic_len, const uint8_t* payload,
+              size_t payload_len, uint64_t at) {
+    uint8_t pkt[SIM_CONN_BUFF_LEN + SIM_MQTT_TOPIC_LEN + 8];
+    size_t rem_len = 2 + topic_len + c->mqtt.v5 + payload_len, len = 0;
+
+    pkt[len++] = 0x30;
+    do {
+        pkt[len++] = (uint8_t)((rem_len & 0x7F) | (rem_len > 0x7F ? 0x80 : 0x00));
+        rem_len >>= 7;
+    } while (rem_len > 0);
+    pkt[len++] = (uint8_t)(topic_len >> 8);
+    pkt[len++] = (uint8_t)topic_len;
+    memcpy(&pkt[len], topic, topic_len);
+    len += topic_len;
+    if (c->mqtt.v5) {
+        pkt[len++] = 0x00; /* No properties */
+    }
+    memcpy(&pkt[len], payload, payload_len);
+    len += payload_len;
+    for (size_t off = 0; off < len; off += LWCELL_CFG_CONN_MAX_DATA_LEN) {
+        prv_out_receive(num, &pkt[off], LWCELL_MIN(len - off, LWCELL_CFG_CONN_MAX_DATA_LEN), at);
+    }
+}
+
+/**
+ * \brief           Process `PUBLISH` packet on MQTT broker endpoint
+ * \param[in]       num: Connection number
+ * \param[in]       c: Connection handle, packet starts at the beginning of reassembly buffer
+ * \param[in]       hdr_len: Length of fixed header
+ * \param[in]       pkt_len: Length of packet
+ * \param[in]       len: Number of packet bytes in reassembly buffer, lower than `pkt_len` for skipped packet
+ * \param[out]      resp: Acknowledge to send, at least `4` bytes long
+ * \param[in]       at: Time when response is sent
+ * \return          Length of acknowledge, `0` when none is sent
+ */
+static size_t
+prv_endpoint_mqtt_publish(uint8_t num, sim_conn_t* c, size_t hdr_len, size_t pkt_len, size_t len, uint8_t* resp,
+                          uint64_t at) {
+    const uint8_t* p = c->buff;
+    uint8_t qos = (p[0] >> 1) & 0x03, dup = (p[0] >> 3) & 0x01, aliased = 0;
+    size_t pos = hdr_len, topic_len, id = 0, props_len, alias = 0;
+    const char* topic;
+
+    if (pos + 2 > len || pos + 2 + (topic_len = SIM_U16(&p[pos])) + (qos > 0 ? 2 : 0) > len) {
+        return 0; /* Header does not fit reassembly buffer */
+    }
+    topic = (const char*)&p[pos + 2];
+    pos += 2 + topic_len;
+    if (qos > 0) {
+        id = SIM_U16(&p[pos]);
+        pos += 2;
+    }
+    if (c->mqtt.v5) {
+        pos += prv_mqtt_varint(&p[pos], len - pos, &props_len);
+        /* Topic alias is the only property sent by client */
+        if (props_len == 3 && pos + 3 <= len && p[pos] == 0x23) {
+            alias = SIM_U16(&p[pos + 1]);
+        }
+        pos += props_len;
+        if (alias > 0 && alias <= LWCELL_MODEM_SIM_MQTT_ALIAS_MAX) {
+            if (topic_len > 0 && topic_len < SIM_MQTT_TOPIC_LEN) {
+                memcpy(c->mqtt.alias[alias - 1], topic, topic_len);
+                c->mqtt.alias[alias - 1][topic_len] = '\0';
+            } else if (topic_len == 0) {
+                topic = c->mqtt.alias[alias - 1];
+                topic_len = strlen(topic);
+                aliased = topic_len > 0;
+            }
+        }
+    }
+
+    pthread_mutex_lock(&sim.mutex);
+    ++sim.mqtt_stats.publish;
+    sim.mqtt_stats.dup += dup;
+    sim.mqtt_stats.alias += aliased;
+    pthread_mutex_unlock(&sim.mutex);
+
+    if (len == pkt_len && pos <= pkt_len && topic_len >= sizeof(LWCELL_MODEM_SIM_MQTT_ECHO) - 1
+        && !strncmp(topic, LWCELL_MODEM_SIM_MQTT_ECHO, sizeof(LWCELL_MODEM_SIM_MQTT_ECHO) - 1)) {
+        prv_mqtt_echo(num, c, topic, topic_len, &p[pos], pkt_len - pos, at);
+    }
+
+    /* Message without topic is not acknowledged */
+    if (qos == 0 || topic_len == 0
+        || (!dup && topic_len >= sizeof(LWCELL_MODEM_SIM_MQTT_DUP) - 1
+            && !strncmp(topic, LWCELL_MODEM_SIM_MQTT_DUP, sizeof(LWCELL_MODEM_SIM_MQTT_DUP) - 1))) {
+        return 0;
+    }
+    resp[0] = qos == 1 ? 0x40 : 0x50, resp[1] = 0x02, resp[2] = (uint8_t)(id >> 8), resp[3] = (uint8_t)id;
+    return 4;
+}
+
+/**
+ * \brief           Process `CONNECT` packet on MQTT broker endpoint
+ * \param[in]       c: Connection handle, packet starts at the beginning of reassembly buffer
+ * \param[in]       hdr_len: Length of fixed header
+ * \param[in]       rem_len: Remaining length of packet
+ * \param[out]      resp: `CONNACK` packet, at least `8` bytes long
+ * \return          Length of `CONNACK` packet
+ */
+static size_t
+prv_endpoint_mqtt_connect(sim_conn_t* c, size_t hdr_len, size_t rem_len, uint8_t* resp) {
+    const uint8_t* p = &c->buff[hdr_len];
+    char id[SIM_MQTT_TOPIC_LEN] = "";
+    size_t pos = 10, props_len = 0, id_len;
+    uint8_t clean, present = 0;
+
+    memset(&c->mqtt, 0x00, sizeof(c->mqtt));
+    c->mqtt.v5 = rem_len > 6 && p[6] == 5;
+    clean = rem_len > 7 && (p[7] & 0x02);
+    if (c->mqtt.v5 && pos < rem_len) {
+        pos += prv_mqtt_varint(&p[pos], rem_len - pos, &props_len);
+        pos += props_len;
+    }
+    if (pos + 2 <= rem_len && (id_len = SIM_U16(&p[pos])) < sizeof(id) && pos + 2 + id_len <= rem_len) {
+        memcpy(id, &p[pos + 2], id_len);
+        id[id_len] = '\0';
+    }
+    c->mqtt.no_ping = !strcmp(id, LWCELL_MODEM_SIM_MQTT_NO_PING_ID);
+
+    /* Only one persistent session is kept */
+    if (!clean) {
+        present = id[0] != '\0' && !strcmp(id, sim.mqtt_session);
+        strcpy(sim.mqtt_session, id);
+    } else if (!strcmp(id, sim.mqtt_session)) {
+        sim.mqtt_session[0] = '\0';
+    }
+
+    resp[0] = 0x20, resp[2] = present, resp[3] = 0x00;
+    if (c->mqtt.v5) {
+        resp[1] = 0x06, resp[4] = 0x03; /* Topic alias maximum property */
+        resp[5] = 0x22, resp[6] = 0x00, resp[7] = LWCELL_MODEM_SIM_MQTT_ALIAS_MAX;
+        return 8;
+    }
+    resp[1] = 0x02;
+    return 4;
+}
+
+/**
+ * \brief           Process data on MQTT broker endpoint
+ * \param[in]       num: Connection number
+ * \param[in]       c: Connection handle
+ * \param[in]       at: Time when data arrived to remote side
+ */
+static void
+prv_endpoint_mqtt(uint8_t num, sim_conn_t* c, uint64_t at) {
+    uint8_t resp[8];
+    size_t hdr_len, rem_len, resp_len, pkt_len;
+
+    at += (uint64_t)sim.cfg.rtt_us * 500;
+    while (c->buff_len >= 2) {
+        if ((hdr_len = prv_mqtt_varint(&c->buff[1], c->buff_len - 1, &rem_len)) == 0) {
+            break;
+        }
+        ++hdr_len;
+        pkt_len = hdr_len + rem_len;
+        if (pkt_len > sizeof(c->buff)) {
+            /* Packet too big for the model, acknowledge it when received completely */
+            if (c->buff_len == sizeof(c->buff)) {
+                c->mqtt.ack_len = 0;
+                if ((c->buff[0] >> 4) == 3) {
+                    c->mqtt.ack_len = prv_endpoint_mqtt_publish(num, c, hdr_len, pkt_len, c->buff_len, c->mqtt.ack, at);
+                }
+                c->mqtt.skip = pkt_len - c->buff_len;
+                c->buff_len = 0;
+            }
+            break;
+        } else if (pkt_len > c->buff_len) {
+            break;
+        }
+
+        /* Prepare response */
+        resp_len = 0;
+        switch (c->buff[0] >> 4) {
+            case 1: /* CONNECT -> CONNACK */
+                resp_len = prv_endpoint_mqtt_connect(c, hdr_len, rem_len, resp);
+                break;
+            case 3: /* PUBLISH -> PUBACK or PUBREC */
+                resp_len = prv_endpoint_mqtt_publish(num, c, hdr_len, pkt_len, pkt_len, resp, at);
+                break;
+            case 6: /* PUBREL -> PUBCOMP */
+                resp[0] = 0x70, resp[1] = 0x02, resp[2] = c->buff[2], resp[3] = c->buff[3];
+                resp_len = 4;
+                break;
+            case 8: /* SUBSCRIBE -> SUBACK, granting requested QoS of single topic */
+                resp[0] = 0x90, resp[1] = 0x03, resp[2] = c->buff[hdr_len], resp[3] = c->buff[hdr_len + 1];
+                resp[4] = c->buff[pkt_len - 1] & 0x03;
+                resp_len = 5;
+                if (c->mqtt.v5) {
+                    resp[1] = 0x04, resp[5] = resp[4], resp[4] = 0x00; /* No properties */
+                    resp_len = 6;
+                }
+                break;
+            case 10: /* UNSUBSCRIBE -> UNSUBACK */
+                resp[0] = 0xB0, resp[1] = 0x02, resp[2] = c->buff[hdr_len], resp[3] = c->buff[hdr_len + 1];
+                resp_len = 4;
+                if (c->mqtt.v5) {
+                    resp[1] = 0x04, resp[4] = 0x00, resp[5] = 0x00; /* No properties, success */
+                    resp_len = 6;
+                }
+                break;
+            case 12: /* PINGREQ -> PINGRESP */
+                pthread_mutex_lock(&sim.mutex);
+                ++sim.mqtt_stats.pingreq;
+                pthread_mutex_unlock(&sim.mutex);
+                if (!c->mqtt.no_ping) {
+                    resp[0] = 0xD0, resp[1] = 0x00;
+                    resp_len = 2;
+                }
+                break;
+            default: break;
+        }
+        if (resp_len > 0) {
+            prv_out_receive(num, resp, resp_len, at);
+        }
+        memmove(c->buff, &c->buff[pkt_len], c->buff_len - pkt_len);
+        c->buff_len -= pkt_len;
+    }
+}
+
+/**
+ * \brief           Process data received by remote endpoint
+ * \param[in]       num: Connection number
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data
+ * \param[in]       at: Time when data arrived to remote side
+ */
+static void
+prv_endpoint_input(uint8_t num, const uint8_t* data, size_t len, uint64_t at) {
+    sim_conn_t* c = &sim.conns[num];
+
+    pthread_mutex_lock(&sim.mutex);
+    switch (c->port) {
+        case LWCELL_MODEM_SIM_PORT_DISCARD: sim.rx_discard += len; break;
+        case LWCELL_MODEM_SIM_PORT_STREAM: sim.rx_stream += len; break;
+        case LWCELL_MODEM_SIM_PORT_MQTT: sim.rx_mqtt += len; break;
+        default: break;
+    }
+    pthread_mutex_unlock(&sim.mutex);
+
+    if (c->port == LWCELL_MODEM_SIM_PORT_DISCARD) {
+        return;
+    }
+    while (len > 0) {
+        size_t n;
+
+        /* Rest of packet too big for reassembly buffer */
+        if (c->mqtt.skip > 0) {
+            n = LWCELL_MIN(len, c->mqtt.skip);
+            c->mqtt.skip -= n;
+            data += n;
+            len -= n;
+            if (c->mqtt.skip == 0 && c->mqtt.ack_len > 0) {
+                prv_out_receive(num, c->mqtt.ack, c->mqtt.ack_len, at + (uint64_t)sim.cfg.rtt_us * 500);
+                c->mqtt.ack_len = 0;
+            }
+            continue;
+        }
+        n = LWCELL_MIN(len, sizeof(c->buff) - c->buff_len);
+        memcpy(&c->buff[c->buff_len], data, n);
+        c->buff_len += n;
+        data += n;
+        len -= n;
+        if (c->port == LWCELL_MODEM_SIM_PORT_STREAM) {
+            prv_endpoint_stream(num, c, at);
+        } else if (c->port == LWCELL_MODEM_SIM_PORT_MQTT) {
+            prv_endpoint_mqtt(num, c, at);
+        }
+        if (n == 0) {
+            break; /* Endpoint does not accept more data */
+        }
+    }
+}
+
+/**
+ * \brief           Parse connection number at the beginning of parameters
+ * \param[in]       str: Parameters string
+ * \return          Connection number, or `LWCELL_CFG_MAX_CONNS` if invalid
+ */
+static uint8_t
+prv_parse_conn_num(const char* str) {
+    int num = atoi(str);
+
+    return num >= 0 && num < LWCELL_CFG_MAX_CONNS ? (uint8_t)num : LWCELL_CFG_MAX_CONNS;
+}
+
+/**
+ * \brief           Copy quoted string parameter
+ * \param[out]      dst: Output buffer
+ * \param[in]       dst_len: Length of output buffer
+ * \param[in]       str: Parameters string, starting with opening quote
+ * \return          Pointer to character after closing quote, `NULL` on failure
+ */
+static const char*
+prv_parse_quoted(char* dst, size_t dst_len, const char* str) {
+    const char* end;
+
+    if (*str != '"' || (end = strchr(&str[1], '"')) == NULL || (size_t)(end - str - 1) >= dst_len) {
+        return NULL;
+    }
+    memcpy(dst, &str[1], (size_t)(end - str - 1));
+    dst[end - str - 1] = '\0';
+    return &end[1];
+}
+
+/**
+ * \brief           Deliver message published over native MQTT session,
+ *                  echoed back by the broker when topic is subscribed
+ * \param[in]       data: Message payload
+ * \param[in]       len: Length of payload
+ * \param[in]       at: Time when message arrived to the broker
+ */
+static void
+prv_mqtt_publish(const void* data, size_t len, uint64_t at) {
+    uint8_t buff[96 + LWCELL_CFG_CONN_MAX_DATA_LEN];
+    size_t hdr_len;
+
+    pthread_mutex_lock(&sim.mutex);
+    sim.rx_mqtt += len;
+    pthread_mutex_unlock(&sim.mutex);
+    if (sim.mqtt.sub[0] == '\0' || strcmp(sim.mqtt.sub, sim.mqtt.pub) != 0) {
+        return;
+    }
+    len = LWCELL_MIN(len, LWCELL_CFG_CONN_MAX_DATA_LEN);
+    hdr_len = (size_t)sprintf((char*)buff, "\r\n+MSUB: \"%s\",%u byte,", sim.mqtt.pub, (unsigned)len);
+    memcpy(&buff[hdr_len], data, len);
+    memcpy(&buff[hdr_len + len], "\r\n", 2);
+    prv_out_data(at + (uint64_t)sim.cfg.rtt_us * 500, sim.out_dlci, buff, hdr_len + len + 2);
+}
+
+/**
+ * \brief           Get parameter of resource URL, in format `name=<number>`
+ * \param[in]       name: Parameter name, including `=` character
+ * \return          Parameter value, `0` if not present
+ */
+static uint32_t
+prv_http_url_param(const char* name) {
+    const char* p = strstr(sim.http.url, name);
+
+    return p != NULL ? (uint32_t)strtoul(&p[strlen(name)], NULL, 10) : 0;
+}
+
+/**
+ * \brief           Process `HTTP GET` request on HTTP server endpoint
+ * \param[in]       at: Time when request has been sent
+ */
+static void
+prv_http_action(uint64_t at) {
+    uint32_t res_len = prv_http_url_param("len="), fail = prv_http_url_param("fail="), end;
+
+    ++sim.http.actions;
+    sim.http.body_len = 0;
+    sim.http.resp[0] = '\0';
+    if (fail > 0 && (sim.http.actions % fail) == 0) {
+        prv_out(at, "\r\n+HTTPACTION: 0,601,0\r\n"); /* Network error */
+    } else if (sim.http.brk >= res_len) {
+        prv_out(at, "\r\n+HTTPACTION: 0,416,0\r\n");
+    } else {
+        end = LWCELL_MIN(sim.http.brkend, res_len - 1);
+        sim.http.body_len = end - sim.http.brk + 1;
+        prv_out(at, "\r\n+HTTPACTION: 0,206,%u\r\n", (unsigned)sim.http.body_len);
+    }
+}
+
+/**
+ * \brief           Process `HTTP POST` request on HTTP server endpoint.
+ *                  Response body is decimal number of received body bytes
+ * \param[in]       at: Time when request has been sent
+ */
+static void
+prv_http_post(uint64_t at) {
+    sprintf(sim.http.resp, "%u", (unsigned)sim.http.post_len);
+    sim.http.body_len = (uint32_t)strlen(sim.http.resp);
+    prv_out(at, "\r\n+HTTPACTION: 1,%u,%u\r\n", sim.http.post_bad ? 400U : 200U, (unsigned)sim.http.body_len);
+}
+
+/**
+ * \brief           Send body of last HTTP request. For `GET` request,
+ *                  byte at offset `n` of the resource has value `LWCELL_MODEM_SIM_HTTP_BYTE(n)`
+ * \param[in]       at: Time when modem starts sending data
+ */
+static void
+prv_http_read(uint64_t at) {
+    uint8_t* buff;
+    size_t hdr_len;
+
+    if ((buff = malloc(32 + sim.http.body_len)) == NULL) {
+        prv_out(at, "\r\nERROR\r\n");
+        return;
+    }
+    hdr_len = (size_t)sprintf((char*)buff, "\r\n+HTTPREAD: %u\r\n", (unsigned)sim.http.body_len);
+    for (uint32_t i = 0; i < sim.http.body_len; ++i) {
+        buff[hdr_len + i] =
+            sim.http.resp[0] != '\0' ? (uint8_t)sim.http.resp[i] : LWCELL_MODEM_SIM_HTTP_BYTE(sim.http.brk + i);
+    }
+    memcpy(&buff[hdr_len + sim.http.body_len], "\r\nOK\r\n", 6);
+    prv_out_data(at, sim.out_dlci, buff, hdr_len + sim.http.body_len + 6);
+    free(buff);
+}
+
+/**
+ * \brief           Process single AT command line
+ * \param[in]       ch: Command channel
+ * \param[in]       line: Command line, without line ending
+ * \param[in]       t: Time when line has been received
+ */
+static void
+prv_process_cmd(sim_chan_t* ch, const char* line, uint64_t t) {
+    uint64_t at = t + (uint64_t)sim.cfg.proc_delay_us * 1000;
+    uint64_t rtt = (uint64_t)sim.cfg.rtt_us * 1000;
+    const char* cmd;
+    uint8_t num;
+
+    if (strncmp(line, "AT", 2) != 0) {
+        return;
+    }
+    cmd = &line[2];
+    if (!strncmp(cmd, "+CFUN=1,1", 9)) {
+        prv_out(at, "\r\nOK\r\n");
+        sim.modem_baudrate = sim.saved_baudrate; /* Modem restarts with saved baudrate */
+        sim.mux = 0;
+        sim.ip_up = 0;
+        sim.cipmux = 1;
+        sim.cipmode = 0;
+        memset(&sim.mqtt, 0x00, sizeof(sim.mqtt));
+        memset(&sim.http, 0x00, sizeof(sim.http));
+        for (size_t i = 0; i < LWCELL_ARRAYSIZE(sim.conns); ++i) {
+            sim.conns[i].active = 0;
+            sim.conns[i].transparent = 0;
+        }
+    } else if (!strncmp(cmd, "+IPR=", 5)) {
+        uint32_t baudrate = (uint32_t)atol(&cmd[5]);
+
+        if (baudrate == 0 || (sim.cfg.max_baudrate > 0 && baudrate > sim.cfg.max_baudrate)) {
+            prv_out(at, "\r\nERROR\r\n");
+        } else {
+            prv_out(at, "\r\nOK\r\n");
+            sim.modem_baudrate = baudrate; /* New baudrate applies after response */
+        }
+    } else if (!strncmp(cmd, "+CMUX=", 6)) {
+        const char* p = &cmd[6];
+        size_t n1 = 31;
+
+        /* Only basic mode is supported, N1 is 4th parameter */
+        for (uint8_t field = 0; *p != '\0'; ++p) {
+            if (*p == ',' && ++field == 3) {
+                n1 = (size_t)atoi(&p[1]);
+                break;
+            }
+        }
+        if (cmd[6] != '0' || n1 == 0 || n1 > SIM_CMUX_MAX_N1) {
+            prv_out(at, "\r\nERROR\r\n");
+        } else {
+            prv_out(at, "\r\nOK\r\n");
+            sim.mux = 1; /* Frames are used after response */
+            sim.mux_n1 = n1;
+            sim.mux_rx.state = 0;
+            memset(sim.chans, 0x00, sizeof(sim.chans));
+        }
+    } else if (!strncmp(cmd, "+CSQ", 4)) {
+        prv_out(at, "\r\n+CSQ: 20,0\r\n\r\nOK\r\n");
+    } else if (!strncmp(cmd, "&W", 2)) {
+        sim.saved_baudrate = sim.modem_baudrate;
+        prv_out(at, "\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+CPIN?", 6)) {
+        prv_out(at, "\r\n+CPIN: READY\r\n\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+CGMI", 5)) {
+        prv_out(at, "\r\nSIMCOM_LTD\r\n\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+CGMM", 5)) {
+        prv_out(at, "\r\nSIMCOM_SIM800\r\n\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+CGSN", 5)) {
+        prv_out(at, "\r\n869000000000001\r\n\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+CCID", 5)) {
+        prv_out(at, "\r\n89860000000000000001\r\n\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+CIMI", 5)) {
+        prv_out(at, "\r\n460000000000001\r\n\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+CGMR", 5)) {
+        prv_out(at, "\r\nRevision:1418B05SIM800L24\r\n\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+CIPSHUT", 8)) {
+        sim.ip_up = 0;
+        for (size_t i = 0; i < LWCELL_ARRAYSIZE(sim.conns); ++i) {
+            sim.conns[i].active = 0;
+            sim.conns[i].transparent = 0;
+        }
+        prv_out(at, "\r\nSHUT OK\r\n");
+    } else if (!strncmp(cmd, "+CIPMUX=", 8)) {
+        sim.cipmux = (uint8_t)atoi(&cmd[8]);
+        prv_out(at, "\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+CIPMODE=", 9)) {
+        sim.cipmode = (uint8_t)atoi(&cmd[9]);
+        prv_out(at, "\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+CIICR", 6)) {
+        sim.ip_up = 1;
+        prv_out(at, "\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+CIFSR", 6)) {
+        prv_out(at, "\r\n10.0.0.2\r\n");
+    } else if (!strncmp(cmd, "+CIPSTATUS", 10)) {
+        if (!sim.ip_up) {
+            prv_out(at, "\r\nOK\r\n\r\nSTATE: IP INITIAL\r\n");
+        } else {
+            prv_out(at, "\r\nOK\r\n\r\nSTATE: IP STATUS\r\n");
+            for (size_t i = 0; i < LWCELL_ARRAYSIZE(sim.conns); ++i) {
+                if (sim.conns[i].active) {
+                    prv_out(at, "C: %u,0,\"TCP\",\"10.0.0.1\",\"%u\",\"CONNECTED\"\r\n", (unsigned)i,
+                            (unsigned)sim.conns[i].port);
+                } else {
+                    prv_out(at, "C: %u,,\"\",\"\",\"\",\"INITIAL\"\r\n", (unsigned)i);
+                }
+            }
+        }
+    } else if (!strncmp(cmd, "+CIPSTART=", 10) && !sim.cipmux) {
+        const char* port = strrchr(cmd, ',');
+
+        if (port == NULL) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        prv_out(at, "\r\nOK\r\n");
+        if (sim.conns[0].active) {
+            prv_out(at, "\r\nALREADY CONNECT\r\n");
+        } else {
+            sim.conns[0].active = 1;
+            sim.conns[0].port = (uint16_t)atoi(&port[port[1] == '"' ? 2 : 1]);
+            sim.conns[0].buff_len = 0;
+            memset(&sim.conns[0].mqtt, 0x00, sizeof(sim.conns[0].mqtt));
+            sim.conns[0].dlci = sim.out_dlci;
+            sim.conns[0].transparent = sim.cipmode;
+            if (sim.cipmode) {
+                ch->mode = SIM_MODE_TRANSPARENT;
+                prv_out(at + rtt, "\r\nCONNECT\r\n");
+            } else {
+                prv_out(at + rtt, "\r\nCONNECT OK\r\n");
+            }
+        }
+    } else if (!strncmp(cmd, "+CIPSTART=", 10)) {
+        const char* port = strrchr(cmd, ',');
+
+        num = prv_parse_conn_num(&cmd[10]);
+        if (num >= LWCELL_CFG_MAX_CONNS || port == NULL) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        prv_out(at, "\r\nOK\r\n");
+        if (sim.conns[num].active) {
+            prv_out(at, "\r\n%u, ALREADY CONNECT\r\n", (unsigned)num);
+        } else {
+            sim.conns[num].active = 1;
+            sim.conns[num].port = (uint16_t)atoi(&port[port[1] == '"' ? 2 : 1]);
+            sim.conns[num].buff_len = 0;
+            memset(&sim.conns[num].mqtt, 0x00, sizeof(sim.conns[num].mqtt));
+            sim.conns[num].dlci = sim.out_dlci;
+            prv_out(at + rtt, "\r\n%u, CONNECT OK\r\n", (unsigned)num);
+        }
+    } else if (!strncmp(cmd, "+CIPSEND=", 9)) {
+        const char* len = strchr(cmd, ',');
+
+        num = prv_parse_conn_num(&cmd[9]);
+        if (num >= LWCELL_CFG_MAX_CONNS || !sim.conns[num].active || len == NULL || atoi(&len[1]) <= 0
+            || atoi(&len[1]) > LWCELL_CFG_CONN_MAX_DATA_LEN) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        ch->data_conn = num;
+        ch->data_exp = (size_t)atoi(&len[1]);
+        ch->data_len = 0;
+        ch->mode = SIM_MODE_DATA;
+        prv_out(at, "\r\n> ");
+    } else if (!strncmp(cmd, "+CIPCLOSE=", 10)) {
+        num = prv_parse_conn_num(&cmd[10]);
+        if (num >= LWCELL_CFG_MAX_CONNS || !sim.conns[num].active) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        sim.conns[num].active = 0;
+        prv_out(at, "\r\n%u, CLOSE OK\r\n", (unsigned)num);
+    } else if (!strcmp(cmd, "+CIPCLOSE") && !sim.cipmux) {
+        if (!sim.conns[0].active) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        sim.conns[0].active = 0;
+        sim.conns[0].transparent = 0;
+        prv_out(at, "\r\nCLOSE OK\r\n");
+    } else if (!strncmp(cmd, "+MCONFIG=", 9)) {
+        sim.mqtt.refuse = !strncmp(&cmd[9], "\"" LWCELL_MODEM_SIM_MQTT_REFUSED_ID "\"",
+                                   sizeof(LWCELL_MODEM_SIM_MQTT_REFUSED_ID) + 1);
+        prv_out(at, "\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+MIPSTART=", 10)) {
+        if (sim.mqtt.tcp) {
+            prv_out(at, "\r\nERROR\r\n"); /* Previous connection was not closed */
+            return;
+        }
+        sim.mqtt.tcp = 1;
+        prv_out(at, "\r\nOK\r\n");
+        prv_out(at + rtt, "\r\nCONNECT OK\r\n");
+    } else if (!strncmp(cmd, "+MCONNECT=", 10)) {
+        if (!sim.mqtt.tcp) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        sim.mqtt.connected = !sim.mqtt.refuse;
+        prv_out(at, "\r\nOK\r\n");
+        prv_out(at + rtt, sim.mqtt.refuse ? "\r\nCONNACK REFUSED\r\n" : "\r\nCONNACK OK\r\n");
+    } else if (!strncmp(cmd, "+MIPCLOSE", 9)) {
+        sim.mqtt.tcp = 0;
+        sim.mqtt.connected = 0;
+        sim.mqtt.sub[0] = '\0';
+        prv_out(at, "\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+MSUB=", 6)) {
+        if (!sim.mqtt.connected || prv_parse_quoted(sim.mqtt.sub, sizeof(sim.mqtt.sub), &cmd[6]) == NULL) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        prv_out(at, "\r\nOK\r\n");
+        prv_out(at + rtt, "\r\nSUBACK\r\n");
+    } else if (!strncmp(cmd, "+MUNSUB=", 8)) {
+        if (!sim.mqtt.connected) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        sim.mqtt.sub[0] = '\0';
+        prv_out(at, "\r\nOK\r\n");
+        prv_out(at + rtt, "\r\nUNSUBACK\r\n");
+    } else if (!strncmp(cmd, "+MPUBEX=", 8)) {
+        const char* len = strrchr(cmd, ',');
+
+        if (!sim.mqtt.connected || prv_parse_quoted(sim.mqtt.pub, sizeof(sim.mqtt.pub), &cmd[8]) == NULL
+            || len == NULL || atoi(&len[1]) <= 0 || atoi(&len[1]) > LWCELL_CFG_CONN_MAX_DATA_LEN) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        ch->data_exp = (size_t)atoi(&len[1]);
+        ch->data_len = 0;
+        ch->mode = SIM_MODE_MQTT_PUB;
+        prv_out(at, "\r\n> ");
+    } else if (!strncmp(cmd, "+MPUB=", 6)) {
+        if (!sim.mqtt.connected || prv_parse_quoted(sim.mqtt.pub, sizeof(sim.mqtt.pub), &cmd[6]) == NULL) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        prv_out(at, "\r\nOK\r\n");
+        prv_mqtt_publish(NULL, 0, at);
+    } else if (!strncmp(cmd, "+MDISCONNECT", 12)) {
+        sim.mqtt.connected = 0;
+        sim.mqtt.sub[0] = '\0';
+        prv_out(at, "\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+HTTPINIT", 9)) {
+        if (sim.http.init) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        sim.http.init = 1;
+        sim.http.brk = 0;
+        sim.http.brkend = UINT32_MAX;
+        sim.http.body_len = 0;
+        prv_out(at, "\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+HTTPTERM", 9)) {
+        if (!sim.http.init) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        sim.http.init = 0;
+        prv_out(at, "\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+HTTPPARA=", 10)) {
+        const char* p = &cmd[10];
+
+        if (!sim.http.init) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        if (!strncmp(p, "\"URL\",", 6)) {
+            if (prv_parse_quoted(sim.http.url, sizeof(sim.http.url), &p[6]) == NULL) {
+                prv_out(at, "\r\nERROR\r\n");
+                return;
+            }
+        } else if (!strncmp(p, "\"BREAK\",", 8)) {
+            sim.http.brk = (uint32_t)strtoul(&p[8], NULL, 10);
+        } else if (!strncmp(p, "\"BREAKEND\",", 11)) {
+            sim.http.brkend = (uint32_t)strtoul(&p[11], NULL, 10);
+        }
+        prv_out(at, "\r\nOK\r\n");
+    } else if (!strncmp(cmd, "+HTTPACTION=0", 13)) {
+        if (!sim.http.init) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        prv_out(at, "\r\nOK\r\n");
+        prv_http_action(at + rtt);
+    } else if (!strncmp(cmd, "+HTTPDATA=", 10)) {
+        long len = atol(&cmd[10]);
+
+        if (!sim.http.init || len <= 0 || len > 319488) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        ch->data_exp = (size_t)len;
+        ch->data_len = 0;
+        ch->mode = SIM_MODE_HTTP_DATA;
+        sim.http.post_len = 0;
+        sim.http.post_bad = 0;
+        prv_out(at, "\r\nDOWNLOAD\r\n");
+    } else if (!strncmp(cmd, "+HTTPACTION=1", 13)) {
+        if (!sim.http.init || sim.http.post_len == 0) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        prv_out(at, "\r\nOK\r\n");
+        prv_http_post(at + rtt);
+    } else if (!strncmp(cmd, "+HTTPREAD", 9)) {
+        if (!sim.http.init || sim.http.body_len == 0) {
+            prv_out(at, "\r\nERROR\r\n");
+            return;
+        }
+        prv_http_read(at);
+    } else if (!strncmp(cmd, "D*99", 4)) {
+        ch->mode = SIM_MODE_PPP;
+        prv_out(at + rtt, "\r\nCONNECT 115200\r\n");
+    } else if (!strncmp(cmd, "+CMGS=", 6)) {
+        ch->mode = SIM_MODE_SMS;
+        prv_out(at, "\r\n> ");
+    } else {
+        prv_out(at, "\r\nOK\r\n");
+    }
+}
+
+/**
+ * \brief           Process data received by modem from host on command channel
+ * \param[in]       dlci: Channel DLCI, `0` when multiplexer is not active
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data
+ * \param[in]       t: Time when data have been received
+ */
+static void
+prv_chan_input(uint8_t dlci, const uint8_t* data, size_t len, uint64_t t) {
+    uint64_t at = t + (uint64_t)sim.cfg.proc_delay_us * 1000;
+    uint64_t rtt = (uint64_t)sim.cfg.rtt_us * 1000;
+    sim_chan_t* c = &sim.chans[dlci];
+
+    sim.out_dlci = dlci;
+    if (c->mode == SIM_MODE_TRANSPARENT || c->mode == SIM_MODE_PPP) {
+        /* Escape sequence is sent alone, surrounded by guard time on both sides */
+        if (len == 3 && !memcmp(data, "+++", 3)) {
+            prv_out(at + SIM_ESCAPE_GUARD_NS, "\r\nOK\r\n");
+            c->mode = SIM_MODE_CMD;
+        } else if (c->mode == SIM_MODE_PPP) {
+            prv_out_data(at + rtt, dlci, data, len);
+        } else {
+            prv_endpoint_input(0, data, len, at + rtt / 2);
+        }
+        return;
+    }
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t ch = data[i];
+
+        switch (c->mode) {
+            case SIM_MODE_CMD: {
+                if (ch == '\n') {
+                    c->line[c->line_len] = '\0';
+                    if (c->line_len > 0) {
+                        prv_process_cmd(c, c->line, t);
+                    }
+                    c->line_len = 0;
+                } else if (ch != '\r' && c->line_len < sizeof(c->line) - 1) {
+                    c->line[c->line_len++] = (char)ch;
+                }
+                break;
+            }
+            case SIM_MODE_DATA: {
+                size_t tocopy = LWCELL_MIN(len - i, c->data_exp - c->data_len);
+
+                memcpy(&c->data[c->data_len], &data[i], tocopy);
+                c->data_len += tocopy;
+                i += tocopy - 1;
+                if (c->data_len == c->data_exp) {
+                    /* Acknowledge is received from remote side after full round-trip, before its response */
+                    prv_out(at + rtt, "\r\n%u, SEND OK\r\n", (unsigned)c->data_conn);
+                    prv_endpoint_input(c->data_conn, c->data, c->data_len, at + rtt / 2);
+                    c->mode = SIM_MODE_CMD;
+                }
+                break;
+            }
+            case SIM_MODE_MQTT_PUB: {
+                size_t tocopy = LWCELL_MIN(len - i, c->data_exp - c->data_len);
+
+                memcpy(&c->data[c->data_len], &data[i], tocopy);
+                c->data_len += tocopy;
+                i += tocopy - 1;
+                if (c->data_len == c->data_exp) {
+                    prv_out(at, "\r\nOK\r\n");
+                    prv_mqtt_publish(c->data, c->data_len, at);
+                    c->mode = SIM_MODE_CMD;
+                }
+                break;
+            }
+            case SIM_MODE_HTTP_DATA: {
+                size_t tocopy = LWCELL_MIN(len - i, c->data_exp - c->data_len);
+
+                /* Body is not stored, only verified against expected content */
+                for (size_t k = 0; k < tocopy; ++k) {
+                    if (data[i + k] != LWCELL_MODEM_SIM_HTTP_BYTE(c->data_len + k)) {
+                        sim.http.post_bad = 1;
+                    }
+                }
+                c->data_len += tocopy;
+                i += tocopy - 1;
+                if (c->data_len == c->data_exp) {
+                    sim.http.post_len = (uint32_t)c->data_len;
+                    prv_out(at, "\r\nOK\r\n");
+                    c->mode = SIM_MODE_CMD;
+                }
+                break;
+            }
+            case SIM_MODE_SMS: {
+                if (ch == 0x1A) {
+                    prv_out(at + rtt, "\r\n+CMGS: 1\r\n\r\nOK\r\n");
+                    c->mode = SIM_MODE_CMD;
+                } else if (ch == 0x1B) {
+                    prv_out(at, "\r\nOK\r\n");
+                    c->mode = SIM_MODE_CMD;
+                }
+                break;
+            }
+            default: break;
+        }
+    }
+}
+
+/**
+ * \brief           Process valid multiplexer frame received from host
+ * \param[in]       t: Time when frame has been received
+ */
+static void
+prv_mux_frame(uint64_t t) {
+    uint64_t at = t + (uint64_t)sim.cfg.proc_delay_us * 1000;
+    uint8_t dlci = sim.mux_rx.addr >> 2;
+    uint8_t type = sim.mux_rx.ctrl & (uint8_t)~SIM_CMUX_PF;
+
+    if (type == SIM_CMUX_SABM || type == SIM_CMUX_DISC) {
+        prv_out_frame(at, dlci, 1, SIM_CMUX_UA | SIM_CMUX_PF, NULL, 0);
+        if (type == SIM_CMUX_DISC && dlci == 0) {
+            sim.mux = 0;
+        }
+    } else if (type == SIM_CMUX_UIH && dlci == 0) {
+        /* Respond to control channel commands with the same message */
+        if (sim.mux_rx.len >= 2 && (sim.mux_rx.data[0] & SIM_CMUX_CR)) {
+            sim.mux_rx.data[0] &= (uint8_t)~SIM_CMUX_CR;
+            prv_out_frame(at, 0, 0, SIM_CMUX_UIH, sim.mux_rx.data, sim.mux_rx.len);
+            if ((sim.mux_rx.data[0] >> 2) == SIM_CMUX_MSG_CLD) {
+                sim.mux = 0;
+            }
+        }
+    } else if (type == SIM_CMUX_UIH && dlci <= SIM_CMUX_DLCI_DATA) {
+        prv_chan_input(dlci, sim.mux_rx.data, sim.mux_rx.len, t);
+    }
+}
+
+/**
+ * \brief           Process data received by modem from host
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data
+ * \param[in]       t: Time when data have been received
+ */
+static void
+prv_modem_input(const uint8_t* data, size_t len, uint64_t t) {
+    if (!sim.mux) {
+        prv_chan_input(0, data, len, t);
+        return;
+    }
+    for (size_t i = 0; i < len && sim.mux; ++i) {
+        uint8_t ch = data[i];
+
+        switch (sim.mux_rx.state) {
+            case 0: /* Opening flag */
+                sim.mux_rx.state = ch == SIM_CMUX_FLAG;
+                break;
+            case 1: /* Address, flags may repeat */
+                if (ch != SIM_CMUX_FLAG) {
+                    sim.mux_rx.addr = ch;
+                    sim.mux_rx.fcs = prv_fcs_update(0xFF, ch);
+                    sim.mux_rx.state = 2;
+                }
+                break;
+            case 2: /* Control */
+                sim.mux_rx.ctrl = ch;
+                sim.mux_rx.fcs = prv_fcs_update(sim.mux_rx.fcs, ch);
+                sim.mux_rx.state = 3;
+                break;
+            case 3: /* Length, one or two bytes */
+            case 4:
+                sim.mux_rx.fcs = prv_fcs_update(sim.mux_rx.fcs, ch);
+                if (sim.mux_rx.state == 3) {
+                    sim.mux_rx.len = ch >> 1;
+                    sim.mux_rx.ptr = 0;
+                    if (!(ch & 0x01)) {
+                        sim.mux_rx.state = 4;
+                        break;
+                    }
+                } else {
+                    sim.mux_rx.len |= (size_t)ch << 7;
+                }
+                sim.mux_rx.state = sim.mux_rx.len > 0 ? 5 : 6;
+                break;
+            case 5: /* Information field */
+                if (sim.mux_rx.ptr < sizeof(sim.mux_rx.data)) {
+                    sim.mux_rx.data[sim.mux_rx.ptr] = ch;
+                }
+                if (++sim.mux_rx.ptr == sim.mux_rx.len) {
+                    sim.mux_rx.state = 6;
+                }
+                break;
+            case 6: /* Frame check sequence */
+                sim.mux_rx.fcs = prv_fcs_update(sim.mux_rx.fcs, ch);
+                sim.mux_rx.state = 7;
+                break;
+            case 7: /* Closing flag */
+                if (ch == SIM_CMUX_FLAG && sim.mux_rx.fcs == 0xCF && sim.mux_rx.len <= sizeof(sim.mux_rx.data)) {
+                    prv_mux_frame(t);
+                } else {
+                    ++sim.mux_errors;
+                }
+                sim.mux_rx.state = ch == SIM_CMUX_FLAG;
+                break;
+            default: break;
+        }
+    }
+}
+
+/**
+ * \brief           Move first ready frame of command channel to the front of queue.
+ *                  Multiplexer shares UART between channels frame by frame,
+ *                  command responses do not wait for all queued connection data
+ */
+static void
+prv_tx_select(void) {
+    sim_pkt_t **pp, *p;
+    uint64_t t;
+
+    if (!sim.mux || sim.tx_head == NULL || sim.tx_head->ptr > 0 || sim.tx_head->dlci != SIM_CMUX_DLCI_DATA) {
+        return;
+    }
+    t = LWCELL_MAX(sim.tx_head->at, sim.tx_line_free);
+    for (pp = &sim.tx_head->next; *pp != NULL && (*pp)->at <= t; pp = &(*pp)->next) {
+        if ((*pp)->dlci != SIM_CMUX_DLCI_DATA) {
+            p = *pp;
+            *pp = p->next;
+            p->next = sim.tx_head;
+            sim.tx_head = p;
+            return;
+        }
+    }
+}
+
+/**
+ * \brief           Modem thread
+ * \param[in]       arg: Thread argument, not used
+ * \return          `NULL`
+ */
+static void*
+prv_modem_thread(void* arg) {
+    struct timespec ts;
+    uint64_t now, next;
+    uint32_t host_baudrate;
+
+    LWCELL_UNUSED(arg);
+    pthread_mutex_lock(&sim.mutex);
+    while (sim.running) {
+        /* Process data received from host */
+        now = lwcell_modem_sim_now_ns();
+        while (sim.rx_head != NULL && sim.rx_head->at <= now) {
+            sim_pkt_t* p = sim.rx_head;
+
+            if ((sim.rx_head = p->next) == NULL) {
+                sim.rx_tail = NULL;
+            }
+            pthread_mutex_unlock(&sim.mutex);
+            if (p->baudrate == sim.modem_baudrate) {
+                prv_modem_input(p->data, p->len, p->at);
+            }
+            free(p);
+            pthread_mutex_lock(&sim.mutex);
+        }
+        host_baudrate = sim.host_baudrate;
+        pthread_mutex_unlock(&sim.mutex);
+
+        /* Send data to host, paced by baudrate */
+        next = UINT64_MAX;
+        while (prv_tx_select(), sim.tx_head != NULL) {
+            sim_pkt_t* p = sim.tx_head;
+            size_t len = LWCELL_MIN(p->len - p->ptr, SIM_INPUT_CHUNK_LEN);
+            uint64_t done = LWCELL_MAX(p->at, sim.tx_line_free) + prv_uart_ns(len, p->baudrate);
+            uint64_t cpu = 0;
+
+            if (done > lwcell_modem_sim_now_ns()) {
+                next = done;
+                break;
+            }
+            sim.tx_line_free = done;
+            if (p->baudrate == host_baudrate) {
+                cpu = prv_thread_cpu_ns();
+                lwcell_input_process(&p->data[p->ptr], len);
+                cpu = prv_thread_cpu_ns() - cpu;
+            }
+            p->ptr += len;
+            if (p->ptr == p->len) {
+                sim.tx_head = p->next;
+                free(p);
+            }
+            pthread_mutex_lock(&sim.mutex);
+            sim.input_cpu_ns += cpu;
+            pthread_mutex_unlock(&sim.mutex);
+        }
+
+        /* Sleep until next event */
+        pthread_mutex_lock(&sim.mutex);
+        if (sim.rx_head != NULL) {
+            next = LWCELL_MIN(next, sim.rx_head->at);
+        }
+        if (sim.running && next > lwcell_modem_sim_now_ns()) {
+            if (next == UINT64_MAX) {
+                pthread_cond_wait(&sim.cond, &sim.mutex);
+            } else {
+                ts.tv_sec = (time_t)(next / 1000000000ULL);
+                ts.tv_nsec = (long)(next % 1000000000ULL);
+                pthread_cond_timedwait(&sim.cond, &sim.mutex, &ts);
+            }
+        }
+    }
+    pthread_mutex_unlock(&sim.mutex);
+    return NULL;
+}
+
+/**
+ * \brief           Send data to modem, paced by baudrate.
+ *                  Function does not block, as UART driver with DMA would do
+ * \param[in]       data: Data to send
+ * \param[in]       len: Number of bytes to send
+ * \return          Number of bytes sent
+ */
+static size_t
+prv_send_fn(const void* data, size_t len) {
+    sim_pkt_t* p;
+    uint64_t now;
+
+    if (data == NULL || len == 0) {
+        return 0;
+    }
+    pthread_mutex_lock(&sim.mutex);
+    now = lwcell_modem_sim_now_ns();
+    sim.rx_line_free = LWCELL_MAX(now, sim.rx_line_free) + prv_uart_ns(len, sim.host_baudrate);
+    if ((p = prv_pkt_new(sim.rx_line_free, data, len)) != NULL) {
+        p->baudrate = sim.host_baudrate;
+        if (sim.rx_tail != NULL) {
+            sim.rx_tail->next = p;
+        } else {
+            sim.rx_head = p;
+        }
+        sim.rx_tail = p;
+        pthread_cond_signal(&sim.cond);
+    }
+    pthread_mutex_unlock(&sim.mutex);
+    return p != NULL ? len : 0;
+}
+
+/**
+ * \brief           Change host UART baudrate
+ * \param[in]       baudrate: New baudrate
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+prv_reconfigure_fn(uint32_t baudrate) {
+    pthread_mutex_lock(&sim.mutex);
+    sim.host_baudrate = baudrate;
+    pthread_mutex_unlock(&sim.mutex);
+    return 1;
+}
+
+/**
+ * \brief           Initialize low-level communication and start modem thread,
+ *                  called by \ref lwcell_init only
+ * \param[in]       ll: Low-level structure
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_ll_init(lwcell_ll_t* ll) {
+    pthread_condattr_t attr;
+
+    if (!sim.started) {
+        sim.host_baudrate = sim.cfg.baudrate;
+        sim.modem_baudrate = sim.cfg.modem_baudrate > 0 ? sim.cfg.modem_baudrate : sim.cfg.baudrate;
+        sim.saved_baudrate = sim.modem_baudrate;
+        pthread_mutex_init(&sim.mutex, NULL);
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&sim.cond, &attr);
+        pthread_condattr_destroy(&attr);
+        sim.running = 1;
+        if (pthread_create(&sim.thread, NULL, prv_modem_thread, NULL) != 0) {
+            return lwcellERR;
+        }
+        sim.started = 1;
+    }
+    ll->send_fn = prv_send_fn;
+    ll->reconfigure_fn = prv_reconfigure_fn;
+    ll->uart.baudrate = sim.host_baudrate; /* Start with last used baudrate, as driver would restore it from memory */
+    return lwcellOK;
+}
+
+/**
+ * \brief           Deinitialize low-level communication
+ * \param[in]       ll: Low-level structure
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_ll_deinit(lwcell_ll_t* ll) {
+    LWCELL_UNUSED(ll);
+    lwcell_modem_sim_stop();
+    return lwcellOK;
+}
+
+/**
+ * \brief           Set modem configuration. Must be called before \ref lwcell_init
+ * \param[in]       cfg: New configuration
+ */
+void
+lwcell_modem_sim_set_config(const lwcell_modem_sim_cfg_t* cfg) {
+    sim.cfg = *cfg;
+}
+
+/**
+ * \brief           Stop modem thread and release pending data
+ */
+void
+lwcell_modem_sim_stop(void) {
+    if (!sim.started) {
+        return;
+    }
+    pthread_mutex_lock(&sim.mutex);
+    sim.running = 0;
+    pthread_cond_signal(&sim.cond);
+    pthread_mutex_unlock(&sim.mutex);
+    pthread_join(sim.thread, NULL);
+    sim.started = 0;
+
+    prv_pkt_free_list(sim.rx_head);
+    prv_pkt_free_list(sim.tx_head);
+    sim.rx_head = sim.rx_tail = sim.tx_head = NULL;
+    sim.mux = 0;
+    memset(sim.chans, 0x00, sizeof(sim.chans));
+}
+
+/**
+ * \brief           Get CPU time spent by modem model itself,
+ *                  excluding time spent in library input function
+ * \return          CPU time in units of nanoseconds
+ */
+uint64_t
+lwcell_modem_sim_get_cpu_ns(void) {
+    struct timespec ts;
+    clockid_t cid;
+    uint64_t cpu = 0;
+
+    if (sim.started && pthread_getcpuclockid(sim.thread, &cid) == 0 && clock_gettime(cid, &ts) == 0) {
+        cpu = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+        pthread_mutex_lock(&sim.mutex);
+        cpu -= LWCELL_MIN(cpu, sim.input_cpu_ns);
+        pthread_mutex_unlock(&sim.mutex);
+    }
+    return cpu;
+}
+
+/**
+ * \brief           Get current host UART baudrate
+ * \return          Baudrate
+ */
+uint32_t
+lwcell_modem_sim_get_baudrate(void) {
+    uint32_t baudrate;
+
+    pthread_mutex_lock(&sim.mutex);
+    baudrate = sim.host_baudrate;
+    pthread_mutex_unlock(&sim.mutex);
+    return baudrate;
+}
+
+/**
+ * \brief           Get number of bytes received by remote endpoint
+ * \param[in]       port: Endpoint port
+ * \return          Number of received bytes
+ */
+uint64_t
+lwcell_modem_sim_get_rx_bytes(uint16_t port) {
+    uint64_t bytes = 0;
+
+    pthread_mutex_lock(&sim.mutex);
+    switch (port) {
+        case LWCELL_MODEM_SIM_PORT_DISCARD: bytes = sim.rx_discard; break;
+        case LWCELL_MODEM_SIM_PORT_STREAM: bytes = sim.rx_stream; break;
+        case LWCELL_MODEM_SIM_PORT_MQTT: bytes = sim.rx_mqtt; break;
+        default: break;
+    }
+    pthread_mutex_unlock(&sim.mutex);
+    return bytes;
+}
+
+/**
+ * \brief           Get MQTT broker statistics
+ * \param[out]      stats: Output statistics
+ */
+void
+lwcell_modem_sim_get_mqtt_stats(lwcell_modem_sim_mqtt_stats_t* stats) {
+    pthread_mutex_lock(&sim.mutex);
+    *stats = sim.mqtt_stats;
+    pthread_mutex_unlock(&sim.mutex);
+}
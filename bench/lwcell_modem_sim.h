@@ -0,0 +1,116 @@
+/**
+ * \file            lwcell_modem_sim.h
+ * \brief           Simulated modem link for end-to-end benchmarks
+ */
+#ifndef LWCELL_MODEM_SIM_HDR_H
+#define LWCELL_MODEM_SIM_HDR_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Port of remote endpoint discarding all received data
+ */
+#define LWCELL_MODEM_SIM_PORT_DISCARD  9
+
+/**
+ * \brief           Port of remote endpoint streaming data on request.
+ *
+ * Request is `8` bytes long: `GET` followed by flags byte
+ * and little-endian 32-bit number of bytes to stream back.
+ * Each streamed chunk starts with 64-bit time in units of nanoseconds,
+ * when chunk has been received by the modem from the network.
+ */
+#define LWCELL_MODEM_SIM_PORT_STREAM   19
+
+/**
+ * \brief           Stream request flag: all data arrive to the modem at once,
+ *                  limited only by the UART between modem and host
+ */
+#define LWCELL_MODEM_SIM_STREAM_BURST  0x01
+
+/**
+ * \brief           Port of minimal MQTT broker, acknowledging all requests
+ *
+ * Broker accepts MQTT 3.1.1 and MQTT 5.0 clients and allows up to
+ * \ref LWCELL_MODEM_SIM_MQTT_ALIAS_MAX topic aliases.
+ * Message to unknown topic alias is not acknowledged.
+ * Session is present when client connects without clean session flag
+ * and previous client with the same identifier did the same.
+ * Packets bigger than reassembly buffer of the model are acknowledged, but not processed otherwise.
+ */
+#define LWCELL_MODEM_SIM_PORT_MQTT     1883
+
+/**
+ * \brief           Topic prefix of messages sent back to publishing client with `QoS 0`,
+ *                  as if client was subscribed to them
+ */
+#define LWCELL_MODEM_SIM_MQTT_ECHO     "echo/"
+
+/**
+ * \brief           Topic prefix of `QoS > 0` messages acknowledged only when received with `DUP` flag,
+ *                  first transmission is lost
+ */
+#define LWCELL_MODEM_SIM_MQTT_DUP      "dup/"
+
+/**
+ * \brief           Client ID whose `PINGREQ` packets broker does not answer
+ */
+#define LWCELL_MODEM_SIM_MQTT_NO_PING_ID "noping"
+
+/**
+ * \brief           Maximal number of topic aliases of MQTT 5.0 client
+ */
+#define LWCELL_MODEM_SIM_MQTT_ALIAS_MAX 4
+
+/**
+ * \brief           Client ID refused by native MQTT stack of the modem with `CONNACK` error
+ */
+#define LWCELL_MODEM_SIM_MQTT_REFUSED_ID "refused"
+
+/**
+ * \brief           Value of byte at `offset` of resource served by simulated HTTP server.
+ *
+ * Resource length is set in the URL with `len=<bytes>` parameter,
+ * `fail=<n>` parameter makes every `n`-th request fail with network error `601`.
+ * Body of `POST` request must follow the same pattern, from offset `0`.
+ */
+#define LWCELL_MODEM_SIM_HTTP_BYTE(offset) ((uint8_t)((offset) ^ ((offset) >> 8)))
+
+/**
+ * \brief           MQTT broker statistics
+ */
+typedef struct {
+    uint32_t publish; /*!< Number of received `PUBLISH` packets */
+    uint32_t dup;     /*!< Number of received `PUBLISH` packets with `DUP` flag */
+    uint32_t alias;   /*!< Number of received `PUBLISH` packets with topic replaced by known alias */
+    uint32_t pingreq; /*!< Number of received `PINGREQ` packets */
+} lwcell_modem_sim_mqtt_stats_t;
+
+/**
+ * \brief           Simulated modem configuration
+ */
+typedef struct {
+    uint32_t baudrate;       /*!< Initial host UART baudrate, 10 bits per byte */
+    uint32_t modem_baudrate; /*!< Initial modem UART baudrate, set to `0` to use host baudrate */
+    uint32_t max_baudrate;   /*!< Maximal baudrate accepted by `AT+IPR` command, set to `0` for no limit */
+    uint32_t proc_delay_us;  /*!< Modem processing delay before each response, in units of microseconds */
+    uint32_t rtt_us;         /*!< Round-trip time of the radio link, in units of microseconds */
+} lwcell_modem_sim_cfg_t;
+
+void lwcell_modem_sim_set_config(const lwcell_modem_sim_cfg_t* cfg);
+void lwcell_modem_sim_stop(void);
+uint64_t lwcell_modem_sim_now_ns(void);
+uint64_t lwcell_modem_sim_get_cpu_ns(void);
+uint64_t lwcell_modem_sim_get_rx_bytes(uint16_t port);
+uint32_t lwcell_modem_sim_get_baudrate(void);
+void lwcell_modem_sim_get_mqtt_stats(lwcell_modem_sim_mqtt_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWCELL_MODEM_SIM_HDR_H */
@@ -33,6 +33,34 @@
  */
 #include "lwcell/apps/lwcell_mqtt_client.h"
 #include "lwcell/lwcell.h"
+#include "lwcell/lwcell_timeout.h"
+
+#if !LWCELL_CFG_MQTT || __DOXYGEN__
+
+/**
+ * \brief           Subscription of client, restored when server has no session
+ *                  or routing received messages to its handler
+ */
+typedef struct lwcell_mqtt_sub {
+    struct lwcell_mqtt_sub* next; /*!< Next subscription on a list */
+    const char* topic;            /*!< Topic filter, stored in the same memory block right after structure */
+    uint16_t topic_len;           /*!< Length of topic filter */
+    lwcell_mqtt_qos_t qos;        /*!< Requested quality of service */
+    uint8_t restore;              /*!< Set to `1` when subscribe must be sent again */
+    lwcell_mqtt_sub_fn fn;        /*!< Handler for received messages or `NULL` */
+    void* fn_arg;                 /*!< Handler argument */
+} lwcell_mqtt_sub_t;
+
+/**
+ * \brief           Node of topic filter tree, one per topic level
+ */
+typedef struct lwcell_mqtt_topic_node {
+    struct lwcell_mqtt_topic_node* next;     /*!< Next node on the same level */
+    struct lwcell_mqtt_topic_node* children; /*!< First node of next level */
+    lwcell_mqtt_sub_t* sub;                  /*!< Subscription with topic filter ending at this node or `NULL` */
+    const char* name;                        /*!< Level name, stored in the same memory block right after structure */
+    uint16_t name_len;                       /*!< Length of level name */
+} lwcell_mqtt_topic_node_t;
 
 /**
  * \brief           MQTT client connection
@@ -42,20 +70,62 @@ typedef struct lwcell_mqtt_client {
     const lwcell_mqtt_client_info_t* info; /*!< Connection info */
     lwcell_mqtt_state_t conn_state;        /*!< MQTT connection state */
 
-    uint32_t poll_time; /*!< Poll time, increased every 500ms */
+    uint16_t keep_alive;         /*!< Keep-alive in units of seconds, may be set by MQTT 5.0 server */
+    uint32_t last_sent_time;     /*!< Time of last data sent to server in units of milliseconds */
+    uint8_t is_keep_alive_armed; /*!< Flag if keep-alive timeout is active */
+    uint8_t is_ping_pending;     /*!< Set to `1` when PINGREQ was sent and PINGRESP is expected */
 
     lwcell_mqtt_evt_t evt;     /*!< MQTT event callback */
     lwcell_mqtt_evt_fn evt_fn; /*!< Event callback function */
 
     lwcell_buff_t tx_buff; /*!< Buffer for raw output data to transmit */
 
-    uint8_t is_sending;     /*!< Flag if we are sending data currently */
+    uint8_t sends;          /*!< Number of sends queued to connection and not yet finished */
     uint32_t sent_total;    /*!< Total number of bytes sent so far on connection */
     uint32_t written_total; /*!< Total number of bytes written into send buffer and queued for send */
 
+    uint8_t is_streaming; /*!< Set to `1` between publish begin and end, other packets wait meanwhile */
+    uint32_t stream_left; /*!< Number of streamed publish payload bytes not written yet */
+    void* stream_arg;     /*!< User argument of streamed publish message */
+    uint32_t acks[LWCELL_CFG_MQTT_MAX_REQUESTS]; /*!< Acknowledges waiting for output buffer,
+                                                        packet type in upper and packet ID in lower 16 bits */
+    uint16_t acks_cnt;                           /*!< Number of waiting acknowledges */
+
     uint16_t last_packet_id; /*!< Packet ID used on last packet */
 
-    lwcell_mqtt_request_t requests[LWCELL_CFG_MQTT_MAX_REQUESTS]; /*!< List of requests */
+    lwcell_mqtt_request_t requests[LWCELL_CFG_MQTT_MAX_REQUESTS]; /*!< List of requests. Request with packet ID
+                                                                        is at index of packet ID modulo array size */
+    uint16_t inflight;           /*!< Number of `QoS > 0` publish messages waiting for acknowledge */
+    uint8_t is_retransmit_armed; /*!< Flag if retransmission timeout is active */
+    uint16_t resends;            /*!< Number of requests to send again when session is resumed */
+
+    const lwcell_mqtt_store_t* store; /*!< Store for messages that cannot be sent immediately */
+    void* store_arg;                  /*!< Store argument */
+    uint8_t store_pending;            /*!< Flag if store may contain messages */
+    lwcell_mqtt_sub_t* subs;          /*!< Subscriptions of persistent session or with handler */
+    uint16_t resubs;                  /*!< Number of subscriptions to restore */
+    lwcell_mqtt_topic_node_t* router; /*!< Topic filter tree of subscriptions with handler */
+    uint8_t is_routing;               /*!< Set to `1` while received message is routed to handlers */
+    uint8_t router_prune;             /*!< Set to `1` when tree must be pruned after routing */
+
+#if LWCELL_CFG_MQTT_V5 || __DOXYGEN__
+    uint8_t is_v5;            /*!< Set to `1` when client uses MQTT 5.0 */
+    uint16_t inflight_max;    /*!< Maximal number of `QoS > 0` messages waiting for acknowledge, limited by server */
+    uint32_t max_packet_size; /*!< Maximal packet size accepted by server or `0` if not limited */
+#if LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX || __DOXYGEN__
+    uint16_t topic_alias_max; /*!< Maximal topic alias accepted by server */
+    char* topic_aliases[LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX]; /*!< Topics with assigned alias, alias is index plus one */
+#endif /* LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX || __DOXYGEN__ */
+#endif /* LWCELL_CFG_MQTT_V5 || __DOXYGEN__ */
+    uint8_t disconnect_reason; /*!< Reason code of disconnect received from server */
+
+#if LWCELL_CFG_MQTT_MGR || __DOXYGEN__
+    struct lwcell_mqtt_mgr* mgr;         /*!< Manager owning the client or `NULL` */
+    struct lwcell_mqtt_client* mgr_next; /*!< Next client of manager */
+    struct lwcell_mqtt_client* failover; /*!< Client taking over queued messages when connection closes or `NULL` */
+    uint8_t mgr_weight;                  /*!< Number of maximal data length blocks sent per scheduling round */
+    uint8_t is_send_waiting;             /*!< Set to `1` when client has data waiting for send of manager */
+#endif /* LWCELL_CFG_MQTT_MGR || __DOXYGEN__ */
 
     uint8_t* rx_buff;   /*!< Raw RX buffer */
     size_t rx_buff_len; /*!< Length of raw RX buffer */
@@ -65,10 +135,25 @@ typedef struct lwcell_mqtt_client {
     uint32_t msg_rem_len;     /*!< Remaining length value of current message */
     uint8_t msg_rem_len_mult; /*!< Multiplier for remaining length */
     uint32_t msg_curr_pos;    /*!< Current buffer write pointer */
+    lwcell_pbuf_p msg_pbuf;   /*!< Packet buffer holding current message or `NULL` when it is in RX buffer */
 
     void* arg; /*!< User argument */
 } lwcell_mqtt_client_t;
 
+#if LWCELL_CFG_MQTT_MGR || __DOXYGEN__
+/**
+ * \brief           MQTT client manager
+ */
+typedef struct lwcell_mqtt_mgr {
+    uint8_t* pool;                /*!< Buffer memory of all clients */
+    size_t pool_len;              /*!< Length of buffer memory */
+    lwcell_mqtt_client_p clients; /*!< List of clients */
+    lwcell_mqtt_client_p next;    /*!< Client served first in next scheduling round */
+    size_t clients_cnt;           /*!< Number of clients */
+    uint8_t sends;                /*!< Number of sends of all clients queued to connections */
+} lwcell_mqtt_mgr_t;
+#endif /* LWCELL_CFG_MQTT_MGR || __DOXYGEN__ */
+
 /* Tracing debug message */
 #define LWCELL_CFG_DBG_MQTT_TRACE         (LWCELL_CFG_DBG_MQTT | LWCELL_DBG_TYPE_TRACE)
 #define LWCELL_CFG_DBG_MQTT_STATE         (LWCELL_CFG_DBG_MQTT | LWCELL_DBG_TYPE_STATE)
@@ -104,21 +189,48 @@ typedef enum {
 #define MQTT_FLAG_CONNECT_WILL          0x04 /*!< Packet contains will topic and will message */
 #define MQTT_FLAG_CONNECT_CLEAN_SESSION 0x02 /*!< Start with clean session of this client */
 
+/* MQTT 5.0 properties used by client */
+#define MQTT_PROP_SESSION_EXPIRY        0x11 /*!< Session expiry interval, 4-byte integer */
+#define MQTT_PROP_SERVER_KEEP_ALIVE     0x13 /*!< Keep-alive set by server, 2-byte integer */
+#define MQTT_PROP_RECEIVE_MAX           0x21 /*!< Receive maximum, 2-byte integer */
+#define MQTT_PROP_TOPIC_ALIAS_MAX       0x22 /*!< Topic alias maximum, 2-byte integer */
+#define MQTT_PROP_TOPIC_ALIAS           0x23 /*!< Topic alias, 2-byte integer */
+#define MQTT_PROP_MAX_PACKET_SIZE       0x27 /*!< Maximum packet size, 4-byte integer */
+
+/* Maximal value of remaining length field */
+#define MQTT_MAX_REM_LEN                0x0FFFFFFFUL
+
+/* Reason code reported when request failed without reply from server */
+#define MQTT_REASON_UNSPECIFIED         0x80
+
 /* Parser states */
 #define MQTT_PARSER_STATE_INIT          0x00 /*!< MQTT parser in initialized state */
 #define MQTT_PARSER_STATE_CALC_REM_LEN  0x01 /*!< MQTT parser in calculating remaining length state */
 #define MQTT_PARSER_STATE_READ_REM      0x02 /*!< MQTT parser in reading remaining bytes state */
+#define MQTT_PARSER_STATE_STREAM        0x03 /*!< MQTT parser in streaming publish payload state */
 
 /* Get packet type from incoming byte */
 #define MQTT_RCV_GET_PACKET_TYPE(d)     ((mqtt_msg_type_t)(((d) >> 0x04) & 0x0F))
 #define MQTT_RCV_GET_PACKET_QOS(d)      ((lwcell_mqtt_qos_t)(((d) >> 0x01) & 0x03))
 #define MQTT_RCV_GET_PACKET_DUP(d)      (((d) >> 0x03) & 0x01)
 
+#if LWCELL_CFG_MQTT_V5
+#define MQTT_IS_V5(client)              ((client)->is_v5)
+#define MQTT_INFLIGHT_MAX(client)       ((client)->inflight_max)
+#else
+#define MQTT_IS_V5(client)              0
+#define MQTT_INFLIGHT_MAX(client)       LWCELL_CFG_MQTT_MAX_INFLIGHT
+#endif /* LWCELL_CFG_MQTT_V5 */
+
 /* Requests status */
 #define MQTT_REQUEST_FLAG_IN_USE        0x01 /*!< Request object is allocated and in use */
 #define MQTT_REQUEST_FLAG_PENDING       0x02 /*!< Request object is pending waiting for response from server */
 #define MQTT_REQUEST_FLAG_SUBSCRIBE     0x04 /*!< Request object has subscribe type */
 #define MQTT_REQUEST_FLAG_UNSUBSCRIBE   0x08 /*!< Request object has unsubscribe type */
+#define MQTT_REQUEST_FLAG_PUBLISH_QOS   0x10 /*!< Request object is publish with `QoS > 0` */
+#define MQTT_REQUEST_FLAG_PUBREL        0x20 /*!< Publish received from server, waiting for publish complete */
+#define MQTT_REQUEST_FLAG_RESEND        0x40 /*!< Request must be sent again when session is resumed */
+#define MQTT_REQUEST_FLAG_INTERNAL      0x80 /*!< Request created by client itself, user is not notified */
 
 #if LWCELL_CFG_DBG
 
@@ -149,15 +261,24 @@ prv_mqtt_evt_fn_default(lwcell_mqtt_client_p client, lwcell_mqtt_evt_t* evt) {
 }
 
 /**
- * \brief           Create new message ID
+ * \brief           Create new message ID for request at specific index
+ *
+ * Packet ID is next one after last used, matching `index` in modulo of number of requests,
+ * so that request is found directly from packet ID of received acknowledge
+ *
  * \param[in]       client: MQTT client
+ * \param[in]       index: Request index in requests array
  * \return          New packet ID
  */
 static uint16_t
-prv_create_packet_id(lwcell_mqtt_client_p client) {
-    if (++client->last_packet_id == 0) {
-        client->last_packet_id = 1;
+prv_create_packet_id(lwcell_mqtt_client_p client, size_t index) {
+    uint32_t id = (uint32_t)client->last_packet_id + 1;
+
+    id += (index + LWCELL_CFG_MQTT_MAX_REQUESTS - id % LWCELL_CFG_MQTT_MAX_REQUESTS) % LWCELL_CFG_MQTT_MAX_REQUESTS;
+    if (id > 0xFFFF) { /* Start from beginning, ID 0 is not allowed */
+        id = index > 0 ? index : LWCELL_CFG_MQTT_MAX_REQUESTS;
     }
+    client->last_packet_id = LWCELL_U16(id);
     return client->last_packet_id;
 }
 
@@ -170,12 +291,12 @@ prv_create_packet_id(lwcell_mqtt_client_p client) {
 /**
  * \brief           Create and return new request object
  * \param[in]       client: MQTT client
- * \param[in]       packet_id: Packet ID for QoS `1` or `2`
+ * \param[in]       with_packet_id: Set to `1` to create packet ID for request, used for QoS `1` or `2`
  * \param[in]       arg: User optional argument for identifying packets
  * \return          Pointer to new request ready to use or `NULL` if no available memory
  */
 static lwcell_mqtt_request_t*
-prv_request_create(lwcell_mqtt_client_p client, uint16_t packet_id, void* arg) {
+prv_request_create(lwcell_mqtt_client_p client, uint8_t with_packet_id, void* arg) {
     lwcell_mqtt_request_t* request;
     uint16_t i;
 
@@ -187,9 +308,12 @@ prv_request_create(lwcell_mqtt_client_p client, uint16_t packet_id, void* arg) {
         }
     }
     if (request != NULL) {
-        request->packet_id = packet_id;             /* Set request packet ID */
-        request->arg = arg;                         /* Set user argument */
+        request->packet_id = with_packet_id ? prv_create_packet_id(client, i) : 0; /* Set request packet ID */
+        request->arg = arg;                                                       /* Set user argument */
         request->status = MQTT_REQUEST_FLAG_IN_USE; /* Reset everything at this point */
+        request->packet = NULL;
+        request->packet_len = 0;
+        request->retransmits = 0;
     }
     return request;
 }
@@ -201,8 +325,14 @@ prv_request_create(lwcell_mqtt_client_p client, uint16_t packet_id, void* arg) {
  */
 static void
 prv_request_delete(lwcell_mqtt_client_p client, lwcell_mqtt_request_t* request) {
+    if ((request->status & MQTT_REQUEST_FLAG_PUBLISH_QOS) && client->inflight > 0) {
+        --client->inflight;
+    }
+    if ((request->status & MQTT_REQUEST_FLAG_RESEND) && client->resends > 0) {
+        --client->resends;
+    }
+    lwcell_mem_free_s((void**)&request->packet);
     request->status = 0; /* Reset status to make request unused */
-    LWCELL_UNUSED(client);
 }
 
 /**
@@ -225,6 +355,16 @@ prv_request_set_pending(lwcell_mqtt_client_p client, lwcell_mqtt_request_t* requ
  */
 static lwcell_mqtt_request_t*
 prv_request_get_pending(lwcell_mqtt_client_p client, int32_t pkt_id) {
+    /* Request with packet ID is always at the same index */
+    if (pkt_id > 0) {
+        lwcell_mqtt_request_t* request = &client->requests[(uint16_t)pkt_id % LWCELL_CFG_MQTT_MAX_REQUESTS];
+
+        if ((request->status & MQTT_REQUEST_FLAG_PENDING) && request->packet_id == (uint16_t)pkt_id) {
+            return request;
+        }
+        return NULL;
+    }
+
     /* Try to find a new request which does not have IN_USE flag set */
     for (size_t i = 0; i < LWCELL_CFG_MQTT_MAX_REQUESTS; ++i) {
         if ((client->requests[i].status & MQTT_REQUEST_FLAG_PENDING)
@@ -243,6 +383,9 @@ prv_request_get_pending(lwcell_mqtt_client_p client, int32_t pkt_id) {
  */
 static void
 prv_request_send_err_callback(lwcell_mqtt_client_p client, uint8_t status, void* arg) {
+    if (status & MQTT_REQUEST_FLAG_INTERNAL) { /* Request not started by user */
+        return;
+    }
     if (status & MQTT_REQUEST_FLAG_SUBSCRIBE) {
         client->evt.type = LWCELL_MQTT_EVT_SUBSCRIBE;
     } else if (status & MQTT_REQUEST_FLAG_UNSUBSCRIBE) {
@@ -254,9 +397,11 @@ prv_request_send_err_callback(lwcell_mqtt_client_p client, uint8_t status, void*
     if (client->evt.type == LWCELL_MQTT_EVT_PUBLISH) {
         client->evt.evt.publish.arg = arg;
         client->evt.evt.publish.res = lwcellERR;
+        client->evt.evt.publish.reason = MQTT_REASON_UNSPECIFIED;
     } else {
         client->evt.evt.sub_unsub_scribed.arg = arg;
         client->evt.evt.sub_unsub_scribed.res = lwcellERR;
+        client->evt.evt.sub_unsub_scribed.reason = MQTT_REASON_UNSPECIFIED;
     }
     client->evt_fn(client, &client->evt);
 }
@@ -278,7 +423,7 @@ prv_request_send_err_callback(lwcell_mqtt_client_p client, uint8_t status, void*
  */
 static void
 prv_write_fixed_header(lwcell_mqtt_client_p client, mqtt_msg_type_t type, uint8_t dup, lwcell_mqtt_qos_t qos,
-                       uint8_t retain, uint16_t rem_len) {
+                       uint8_t retain, uint32_t rem_len) {
     uint8_t b;
 
     /*
@@ -343,6 +488,22 @@ prv_write_data(lwcell_mqtt_client_p client, const void* data, size_t len) {
     lwcell_buff_write(&client->tx_buff, data, len); /* Write raw data to buffer */
 }
 
+/**
+ * \brief           Get raw length of packet, including packet start byte and encoded remaining length
+ * \param[in]       rem_len: Remaining length of packet
+ * \return          Raw packet length in units of bytes
+ */
+static uint32_t
+prv_get_raw_len(uint32_t rem_len) {
+    uint32_t total_len = rem_len + 1; /* Remaining length + first (packet start) byte */
+
+    do { /* Calculate bytes for encoding remaining length itself */
+        ++total_len;
+        rem_len >>= 7; /* Encoded with 7 bits per byte */
+    } while (rem_len > 0);
+    return total_len;
+}
+
 /**
  * \brief           Check if output buffer has enough memory to handle
  *                  all bytes required to encode packet to RAW format
@@ -353,20 +514,19 @@ prv_write_data(lwcell_mqtt_client_p client, const void* data, size_t len) {
  * \param[in]       rem_len: Remaining length of packet
  * \return          Number of required RAW bytes or `0` if no memory available
  */
-static uint16_t
-prv_output_check_enough_memory(lwcell_mqtt_client_p client, uint16_t rem_len) {
-    uint16_t total_len = rem_len + 1; /* Remaining length + first (packet start) byte */
-
-    do { /* Calculate bytes for encoding remaining length itself */
-        ++total_len;
-        rem_len >>= 7; /* Encoded with 7 bits per byte */
-    } while (rem_len > 0);
+static uint32_t
+prv_output_check_enough_memory(lwcell_mqtt_client_p client, uint32_t rem_len) {
+    uint32_t total_len = prv_get_raw_len(rem_len);
 
-    return LWCELL_U16(lwcell_buff_get_free(&client->tx_buff)) >= total_len ? total_len : 0;
+    if (client->is_streaming) {
+        return 0; /* Packets must not be written in the middle of streamed publish message */
+    }
+    return lwcell_buff_get_free(&client->tx_buff) >= total_len ? total_len : 0;
 }
 
 /**
- * \brief           Write and send acknowledge/record
+ * \brief           Write and send acknowledge/record.
+ *                  Response is queued when output buffer is full or streamed publish message is being written
  * \param[in]       client: MQTT client
  * \param[in]       msg_type: Message type to respond
  * \param[in]       pkt_id: Packet ID to send response for
@@ -376,13 +536,17 @@ prv_output_check_enough_memory(lwcell_mqtt_client_p client, uint16_t rem_len) {
 static uint8_t
 prv_write_ack_rec_rel_resp(lwcell_mqtt_client_p client, mqtt_msg_type_t msg_type, uint16_t pkt_id,
                            lwcell_mqtt_qos_t qos) {
-    if (prv_output_check_enough_memory(client, 2)) {            /* Check memory for response packet */
+    if (client->acks_cnt == 0 && prv_output_check_enough_memory(client, 2)) { /* Check memory for response packet */
         prv_write_fixed_header(client, msg_type, 0, qos, 0, 2); /* Write fixed header with 2 more bytes for packet id */
         prv_write_u16(client, pkt_id);                          /* Write packet ID */
         prv_send_data(client);                                  /* Flush data to output */
         LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Response %s written to output memory\r\n",
                      prv_mqtt_msg_type_to_str(msg_type));
         return 1;
+    } else if (client->acks_cnt < LWCELL_ARRAYSIZE(client->acks)) {
+        /* Response is written later, when output buffer is released */
+        client->acks[client->acks_cnt++] = (uint32_t)msg_type << 16 | pkt_id;
+        return 1;
     } else {
         LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] No memory to write %s packet\r\n",
                      prv_mqtt_msg_type_to_str(msg_type));
@@ -390,6 +554,26 @@ prv_write_ack_rec_rel_resp(lwcell_mqtt_client_p client, mqtt_msg_type_t msg_type
     return 0;
 }
 
+/**
+ * \brief           Write queued acknowledges to output buffer and send them
+ * \param[in]       client: MQTT client
+ */
+static void
+prv_write_acks_queued(lwcell_mqtt_client_p client) {
+    uint16_t i;
+
+    for (i = 0; i < client->acks_cnt && lwcell_buff_get_free(&client->tx_buff) >= 4; ++i) {
+        prv_write_fixed_header(client, (mqtt_msg_type_t)(client->acks[i] >> 16), 0, LWCELL_MQTT_QOS_AT_MOST_ONCE, 0,
+                               2);
+        prv_write_u16(client, LWCELL_U16(client->acks[i] & 0xFFFF));
+    }
+    if (i > 0) {
+        client->acks_cnt -= i;
+        memmove(client->acks, &client->acks[i], client->acks_cnt * sizeof(client->acks[0]));
+        prv_send_data(client);
+    }
+}
+
 /**
  * \brief           Write string to output buffer
  * \param[in]       client: MQTT client
@@ -402,31 +586,281 @@ prv_write_string(lwcell_mqtt_client_p client, const char* str, uint16_t len) {
     lwcell_buff_write(&client->tx_buff, str, len); /* Write string to buffer */
 }
 
+#if LWCELL_CFG_MQTT_V5 || __DOXYGEN__
+
 /**
- * \brief           Send the actual data to the remote
+ * \brief           Write 32-bit value in MSB first format to output buffer
  * \param[in]       client: MQTT client
+ * \param[in]       num: Number to write
  */
 static void
-prv_send_data(lwcell_mqtt_client_p client) {
-    size_t len;
-    const void* addr;
+prv_write_u32(lwcell_mqtt_client_p client, uint32_t num) {
+    prv_write_u16(client, LWCELL_U16(num >> 16));
+    prv_write_u16(client, LWCELL_U16(num & 0xFFFF));
+}
 
-    if (client->is_sending) { /* We are currently sending data */
-        return;
+/**
+ * \brief           Read variable byte integer
+ * \param[in]       data: Input data
+ * \param[in]       len: Length of input data
+ * \param[out]      num: Output variable to save decoded number to
+ * \return          Number of bytes used to encode number, `0` if not complete or invalid
+ */
+static size_t
+prv_read_varint(const uint8_t* data, size_t len, uint32_t* num) {
+    *num = 0;
+    for (size_t i = 0; i < len && i < 4; ++i) {
+        *num |= (uint32_t)(data[i] & 0x7F) << (7 * i);
+        if (!(data[i] & 0x80)) {
+            return i + 1;
+        }
     }
+    return 0;
+}
 
-    len = lwcell_buff_get_linear_block_read_length(&client->tx_buff); /* Get length of linear memory */
-    if (len > 0) {                                                   /* Anything to send? */
-        lwcellr_t res;
-        addr = lwcell_buff_get_linear_block_read_address(&client->tx_buff); /* Get address of linear memory */
-        if ((res = lwcell_conn_send(client->conn, addr, len, NULL, 0)) == lwcellOK) {
-            client->written_total += len; /* Increase number of bytes written to queue */
-            client->is_sending = 1;       /* Remember active sending flag */
-        } else {
-            LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE_WARNING, "[LWCELL MQTT] Cannot send data with error: %d\r\n",
-                         (int)res);
+/**
+ * \brief           Get total size of MQTT 5.0 properties, including their length field
+ * \param[in]       data: Start of properties length field
+ * \param[in]       len: Length of data available
+ * \return          Size of properties in units of bytes, limited to `len`
+ */
+static size_t
+prv_get_props_size(const uint8_t* data, size_t len) {
+    uint32_t props_len;
+    size_t n;
+
+    if ((n = prv_read_varint(data, len, &props_len)) == 0) {
+        return len;
+    }
+    return LWCELL_MIN(len, n + props_len);
+}
+
+/**
+ * \brief           Read next MQTT 5.0 property
+ * \param[in]       data: Properties, without length field
+ * \param[in]       len: Length of properties
+ * \param[in,out]   pos: Position of property, set to position of next property on success
+ * \param[out]      id: Property identifier
+ * \param[out]      value: Value of integer property, `0` for other types
+ * \return          `1` on success, `0` when there is no more valid property
+ */
+static uint8_t
+prv_prop_read(const uint8_t* data, size_t len, size_t* pos, uint8_t* id, uint32_t* value) {
+    size_t p = *pos, size = 0, strings = 0;
+
+    if (p >= len) {
+        return 0;
+    }
+    *id = data[p++];
+    *value = 0;
+    switch (*id) {
+        case 0x01: /* Payload format indicator */
+        case 0x17: /* Request problem information */
+        case 0x19: /* Request response information */
+        case 0x24: /* Maximum QoS */
+        case 0x25: /* Retain available */
+        case 0x28: /* Wildcard subscription available */
+        case 0x29: /* Subscription identifier available */
+        case 0x2A: /* Shared subscription available */ size = 1; break;
+        case MQTT_PROP_SERVER_KEEP_ALIVE:
+        case MQTT_PROP_RECEIVE_MAX:
+        case MQTT_PROP_TOPIC_ALIAS_MAX:
+        case MQTT_PROP_TOPIC_ALIAS: size = 2; break;
+        case 0x02: /* Message expiry interval */
+        case 0x18: /* Will delay interval */
+        case MQTT_PROP_SESSION_EXPIRY:
+        case MQTT_PROP_MAX_PACKET_SIZE: size = 4; break;
+        case 0x0B: /* Subscription identifier */
+            if ((size = prv_read_varint(&data[p], len - p, value)) == 0) {
+                return 0;
+            }
+            *pos = p + size;
+            return 1;
+        case 0x26: /* User property is string pair */ strings = 2; break;
+        case 0x03: /* Content type */
+        case 0x08: /* Response topic */
+        case 0x09: /* Correlation data */
+        case 0x12: /* Assigned client identifier */
+        case 0x15: /* Authentication method */
+        case 0x16: /* Authentication data */
+        case 0x1A: /* Response information */
+        case 0x1C: /* Server reference */
+        case 0x1F: /* Reason string */ strings = 1; break;
+        default: return 0;
+    }
+    if (strings == 0) { /* Integer value */
+        if (p + size > len) {
+            return 0;
         }
-    } else {
+        for (size_t i = 0; i < size; ++i) {
+            *value = *value << 8 | data[p + i];
+        }
+    }
+    for (; strings > 0; --strings) { /* String or binary data with 2-byte length */
+        if (p + size + 2 > len) {
+            return 0;
+        }
+        size += 2 + ((size_t)data[p + size] << 8 | data[p + size + 1]);
+        if (p + size > len) {
+            return 0;
+        }
+    }
+    *pos = p + size;
+    return 1;
+}
+
+#if LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX || __DOXYGEN__
+
+/**
+ * \brief           Get topic alias for publish message, assigning new alias on first use of topic.
+ *
+ * Aliases are never reassigned during connection,
+ * message retransmitted without topic string is always delivered to the same topic.
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic name
+ * \param[in]       len_topic: Length of topic
+ * \param[out]      is_new: Set to `1` when alias was assigned now and must be sent together with topic
+ * \return          Topic alias or `0` when topic is sent without alias
+ */
+static uint16_t
+prv_topic_alias_get(lwcell_mqtt_client_p client, const char* topic, uint16_t len_topic, uint8_t* is_new) {
+    size_t i, max = LWCELL_MIN(client->topic_alias_max, LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX);
+
+    *is_new = 0;
+    for (i = 0; i < max && client->topic_aliases[i] != NULL; ++i) {
+        if (!strncmp(client->topic_aliases[i], topic, len_topic) && client->topic_aliases[i][len_topic] == '\0') {
+            return LWCELL_U16(i + 1);
+        }
+    }
+    if (i < max && (client->topic_aliases[i] = lwcell_mem_malloc(len_topic + 1)) != NULL) {
+        LWCELL_MEMCPY(client->topic_aliases[i], topic, len_topic);
+        client->topic_aliases[i][len_topic] = '\0';
+        *is_new = 1;
+        return LWCELL_U16(i + 1);
+    }
+    return 0;
+}
+
+/**
+ * \brief           Delete topic aliases of connection
+ * \param[in]       client: MQTT client
+ * \param[in]       from: First alias to delete, `1` to delete all of them
+ */
+static void
+prv_topic_alias_delete(lwcell_mqtt_client_p client, uint16_t from) {
+    for (size_t i = from - 1; i < LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX; ++i) {
+        lwcell_mem_free_s((void**)&client->topic_aliases[i]);
+    }
+}
+
+#endif /* LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX || __DOXYGEN__ */
+
+#endif /* LWCELL_CFG_MQTT_V5 || __DOXYGEN__ */
+
+/**
+ * \brief           Check if packet exceeds maximum packet size accepted by server
+ * \param[in]       client: MQTT client
+ * \param[in]       rem_len: Remaining length of packet
+ * \return          `1` if packet is too big, `0` otherwise
+ */
+static uint8_t
+prv_is_packet_too_big(lwcell_mqtt_client_p client, uint32_t rem_len) {
+#if LWCELL_CFG_MQTT_V5
+    return client->max_packet_size > 0 && prv_get_raw_len(rem_len) > client->max_packet_size;
+#else
+    LWCELL_UNUSED(client);
+    LWCELL_UNUSED(rem_len);
+    return 0;
+#endif /* LWCELL_CFG_MQTT_V5 */
+}
+
+/**
+ * \brief           Queue data written to output buffer, but not queued yet, to connection
+ * \param[in]       client: MQTT client
+ * \param[in]       max_len: Maximal number of bytes to queue
+ * \return          `1` when send was queued, `0` otherwise
+ */
+static uint8_t
+prv_send_queue(lwcell_mqtt_client_p client, size_t max_len) {
+    size_t len, full, queued, pos, part;
+    lwcellr_t res;
+
+    full = lwcell_buff_get_full(&client->tx_buff);
+
+    /*
+     * Bytes between read pointer and "queued" are already in connection send queue,
+     * only data written after them are sent now.
+     *
+     * While other sends are in progress, wait for more data to coalesce
+     * small packets into single send command.
+     */
+    queued = (size_t)(client->written_total - client->sent_total);
+    len = full - queued;
+    if (len == 0 || client->sends >= LWCELL_CFG_MQTT_MAX_SENDS
+        || (client->sends > 0 && len < LWCELL_CFG_MQTT_TX_COALESCE_LEN)) {
+        return 0;
+    }
+    len = LWCELL_MIN(len, max_len);
+
+    /* Send both parts of wrapped buffer with single command */
+    pos = (client->tx_buff.r + queued) % client->tx_buff.size;
+    part = LWCELL_MIN(len, client->tx_buff.size - pos);
+    if ((res = lwcell_conn_send_parts(client->conn, &client->tx_buff.buff[pos], part,
+                                      part < len ? client->tx_buff.buff : NULL, len - part, NULL, 0))
+        == lwcellOK) {
+        client->written_total += len; /* Increase number of bytes written to queue */
+        ++client->sends;              /* One more send in progress */
+        return 1;
+    }
+    LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE_WARNING, "[LWCELL MQTT] Cannot send data with error: %d\r\n", (int)res);
+    return 0;
+}
+
+#if LWCELL_CFG_MQTT_MGR || __DOXYGEN__
+
+/**
+ * \brief           Queue data of manager clients to connections, while manager has sends available.
+ *
+ * Clients waiting for send are served in round-robin order,
+ * each may queue up to its weight of \ref LWCELL_CFG_CONN_MAX_DATA_LEN blocks per round.
+ *
+ * \param[in]       mgr: MQTT client manager
+ */
+static void
+prv_mgr_schedule(lwcell_mqtt_mgr_p mgr) {
+    lwcell_mqtt_client_p c;
+    uint8_t queued;
+
+    do {
+        queued = 0;
+        for (size_t i = 0; i < mgr->clients_cnt && mgr->sends < LWCELL_CFG_MQTT_MAX_SENDS; ++i) {
+            c = mgr->next;
+            mgr->next = c->mgr_next != NULL ? c->mgr_next : mgr->clients;
+            if (!c->is_send_waiting) {
+                continue;
+            }
+            c->is_send_waiting = 0;
+            if (prv_send_queue(c, (size_t)c->mgr_weight * LWCELL_CFG_CONN_MAX_DATA_LEN)) {
+                ++mgr->sends;
+                queued = 1;
+
+                /* Rest of data waits for next round */
+                c->is_send_waiting = lwcell_buff_get_full(&c->tx_buff) > (size_t)(c->written_total - c->sent_total);
+            }
+        }
+    } while (queued && mgr->sends < LWCELL_CFG_MQTT_MAX_SENDS);
+}
+
+#endif /* LWCELL_CFG_MQTT_MGR || __DOXYGEN__ */
+
+/**
+ * \brief           Send the actual data to the remote
+ * \param[in]       client: MQTT client
+ */
+static void
+prv_send_data(lwcell_mqtt_client_p client) {
+    if (lwcell_buff_get_full(&client->tx_buff) == 0) {
         /*
          * If buffer is empty, reset it to default state (read & write pointers)
          * This is to make sure everytime function needs to send data,
@@ -434,7 +868,16 @@ prv_send_data(lwcell_mqtt_client_p client) {
          * Effectively this means faster transmission of MQTT packets and lower latency.
          */
         lwcell_buff_reset(&client->tx_buff);
+        return;
+    }
+#if LWCELL_CFG_MQTT_MGR
+    if (client->mgr != NULL) {
+        client->is_send_waiting = 1; /* Manager decides when data are sent */
+        prv_mgr_schedule(client->mgr);
+        return;
     }
+#endif /* LWCELL_CFG_MQTT_MGR */
+    prv_send_queue(client, SIZE_MAX);
 }
 
 /**
@@ -456,91 +899,843 @@ prv_mqtt_close(lwcell_mqtt_client_p client) {
 }
 
 /**
- * \brief           Subscribe/Unsubscribe to/from MQTT topic
+ * \brief           Send unacknowledged packet of request again
+ * \param[in]       client: MQTT client
+ * \param[in]       request: Request waiting for acknowledge
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+prv_request_retransmit(lwcell_mqtt_client_p client, lwcell_mqtt_request_t* request) {
+    if (request->status & MQTT_REQUEST_FLAG_PUBREL) {
+        if (!prv_write_ack_rec_rel_resp(client, MQTT_MSG_TYPE_PUBREL, request->packet_id, (lwcell_mqtt_qos_t)1)) {
+            return 0;
+        }
+    } else if (request->packet != NULL && !client->is_streaming
+               && lwcell_buff_get_free(&client->tx_buff) >= request->packet_len) {
+        request->packet[0] |= 0x08; /* Set DUP flag in fixed header */
+        prv_write_data(client, request->packet, request->packet_len);
+        prv_send_data(client);
+    } else {
+        return 0;
+    }
+    LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Retransmitting pkt_id: %d\r\n", (int)request->packet_id);
+    return 1;
+}
+
+#if LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT || __DOXYGEN__
+
+static void prv_retransmit_timeout_fn(void* arg);
+
+/**
+ * \brief           Start retransmission timeout if not active yet
+ * \param[in]       client: MQTT client
+ * \param[in]       time: Time in units of milliseconds until timeout
+ */
+static void
+prv_retransmit_start(lwcell_mqtt_client_p client, uint32_t time) {
+    if (!client->is_retransmit_armed && lwcell_timeout_add(time, prv_retransmit_timeout_fn, client) == lwcellOK) {
+        client->is_retransmit_armed = 1;
+    }
+}
+
+/**
+ * \brief           Retransmission timeout callback,
+ *                  sending again all messages not acknowledged in time
+ *
+ * MQTT 5.0 does not allow sending message again on the same connection,
+ * timeouts are only counted and message is sent again on next connection.
+ *
+ * \param[in]       arg: MQTT client
+ */
+static void
+prv_retransmit_timeout_fn(void* arg) {
+    lwcell_mqtt_client_p client = arg;
+    lwcell_mqtt_request_t* request;
+    uint32_t now, elapsed, next = LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT;
+    uint8_t any = 0;
+
+    client->is_retransmit_armed = 0;
+    if (client->conn_state != LWCELL_MQTT_CONNECTED) {
+        return;
+    }
+    now = lwcell_sys_now();
+    for (size_t i = 0; i < LWCELL_CFG_MQTT_MAX_REQUESTS; ++i) {
+        request = &client->requests[i];
+        if (!(request->status & MQTT_REQUEST_FLAG_PENDING) || !(request->status & MQTT_REQUEST_FLAG_PUBLISH_QOS)
+            || (request->status & MQTT_REQUEST_FLAG_RESEND)
+            || (request->packet == NULL && !(request->status & MQTT_REQUEST_FLAG_PUBREL))) {
+            continue; /* Streamed message has no packet copy and is not sent again */
+        }
+        any = 1;
+        elapsed = now - request->timeout_start_time;
+        if (elapsed >= LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT) {
+            if (request->retransmits >= LWCELL_CFG_MQTT_MAX_RETRANSMITS) {
+                LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE_WARNING,
+                             "[LWCELL MQTT] No acknowledge for pkt_id: %d. Manually closing down..\r\n",
+                             (int)request->packet_id);
+                prv_mqtt_close(client); /* Pending requests are reported in closed callback */
+                return;
+            }
+            if (MQTT_IS_V5(client) || prv_request_retransmit(client, request)) {
+                request->timeout_start_time = now;
+                ++request->retransmits;
+            } else {
+                next = LWCELL_MIN(next, LWCELL_CFG_CONN_POLL_INTERVAL); /* No memory, try again soon */
+            }
+        } else {
+            next = LWCELL_MIN(next, LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT - elapsed);
+        }
+    }
+    if (any) {
+        prv_retransmit_start(client, next);
+    }
+}
+
+#endif /* LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT || __DOXYGEN__ */
+
+static void prv_keep_alive_timeout_fn(void* arg);
+
+/**
+ * \brief           Start keep-alive timeout if not active yet
+ * \param[in]       client: MQTT client
+ * \param[in]       time: Time in units of milliseconds until timeout
+ */
+static void
+prv_keep_alive_start(lwcell_mqtt_client_p client, uint32_t time) {
+    if (!client->is_keep_alive_armed && lwcell_timeout_add(time, prv_keep_alive_timeout_fn, client) == lwcellOK) {
+        client->is_keep_alive_armed = 1;
+    }
+}
+
+/**
+ * \brief           Keep-alive timeout callback.
+ *                  Sends PINGREQ when nothing was sent for keep-alive interval
+ *                  and closes connection when PINGRESP is not received in half of the interval
+ * \param[in]       arg: MQTT client
+ */
+static void
+prv_keep_alive_timeout_fn(void* arg) {
+    lwcell_mqtt_client_p client = arg;
+    uint32_t interval = (uint32_t)client->keep_alive * 1000, elapsed;
+
+    client->is_keep_alive_armed = 0;
+    if (client->conn_state != LWCELL_MQTT_CONNECTED || interval == 0) {
+        return;
+    }
+    if (client->is_ping_pending) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE_WARNING, "[LWCELL MQTT] No PINGRESP received. Manually closing down..\r\n");
+        prv_mqtt_close(client); /* Pending requests are reported in closed callback */
+        return;
+    }
+
+    /* Timer is not restarted on every send, only time of last send is updated */
+    elapsed = lwcell_sys_now() - client->last_sent_time;
+    if (elapsed < interval) {
+        prv_keep_alive_start(client, interval - elapsed);
+    } else if (prv_output_check_enough_memory(client, 0)) { /* Check if memory available in output buffer */
+        prv_write_fixed_header(client, MQTT_MSG_TYPE_PINGREQ, 0, (lwcell_mqtt_qos_t)0, 0, 0);
+        prv_send_data(client);
+        client->is_ping_pending = 1;
+        prv_keep_alive_start(client, interval / 2); /* Deadline for PINGRESP */
+
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Sending PINGREQ packet\r\n");
+    } else {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE_WARNING, "[LWCELL MQTT] No memory to send PINGREQ packet\r\n");
+        prv_keep_alive_start(client, LWCELL_CFG_CONN_POLL_INTERVAL); /* Try again soon */
+    }
+}
+
+/**
+ * \brief           Write subscribe or unsubscribe packet to output buffer and send it
  * \param[in]       client: MQTT client
  * \param[in]       topic: MQTT topic to (un)subscribe
+ * \param[in]       len_topic: Length of topic
  * \param[in]       qos: Quality of service, used only on subscribe part
  * \param[in]       arg: Custom argument
  * \param[in]       sub: Status set to `1` on subscribe or `0` on unsubscribe
+ * \param[in]       flags: Additional request flags
  * \return          `1` on success, `0` otherwise
  */
 static uint8_t
-prv_sub_unsub(lwcell_mqtt_client_p client, const char* topic, lwcell_mqtt_qos_t qos, void* arg, uint8_t sub) {
+prv_write_sub_unsub(lwcell_mqtt_client_p client, const char* topic, uint16_t len_topic, lwcell_mqtt_qos_t qos,
+                    void* arg, uint8_t sub, uint8_t flags) {
     lwcell_mqtt_request_t* request;
     uint32_t rem_len;
-    uint16_t len_topic, pkt_id;
-    uint8_t ret = 0;
-
-    if ((len_topic = LWCELL_U16(strlen(topic))) == 0) {
-        return 0;
-    }
+    uint16_t pkt_id;
 
     /*
      * Calculate remaining length of packet
      *
-     * rem_len = 2 (topic_len) + topic_len + 2 (pkt_id) + qos (if sub)
+     * rem_len = 2 (topic_len) + topic_len + 2 (pkt_id) + qos (if sub) + 1 (properties length, MQTT 5.0)
      */
-    rem_len = 2 + len_topic + 2;
+    rem_len = 2 + len_topic + 2 + MQTT_IS_V5(client);
     if (sub) {
         ++rem_len;
     }
 
-    lwcell_core_lock();
-    if (client->conn_state == LWCELL_MQTT_CONNECTED
-        && prv_output_check_enough_memory(client, rem_len)) { /* Check if enough memory to write packet data */
-        pkt_id = prv_create_packet_id(client);                /* Create new packet ID */
+    if (prv_output_check_enough_memory(client, rem_len)) { /* Check if enough memory to write packet data */
         /* Create request for packet */
-        if ((request = prv_request_create(client, pkt_id, arg)) != NULL) { /* Do we have a request */
+        if ((request = prv_request_create(client, 1, arg)) != NULL) { /* Do we have a request */
+            pkt_id = request->packet_id;
             prv_write_fixed_header(client, sub ? MQTT_MSG_TYPE_SUBSCRIBE : MQTT_MSG_TYPE_UNSUBSCRIBE, 0,
                                    (lwcell_mqtt_qos_t)1, 0, rem_len);
-            prv_write_u16(client, pkt_id);              /* Write packet ID */
+            prv_write_u16(client, pkt_id); /* Write packet ID */
+            if (MQTT_IS_V5(client)) {
+                prv_write_u8(client, 0); /* No properties */
+            }
             prv_write_string(client, topic, len_topic); /* Write topic string to packet */
             if (sub) {                                  /* Send quality of service only on subscribe */
                 prv_write_u8(client, LWCELL_MIN(LWCELL_U8(qos),
                                                LWCELL_U8(LWCELL_MQTT_QOS_EXACTLY_ONCE))); /* Write quality of service */
             }
 
-            request->status |= sub ? MQTT_REQUEST_FLAG_SUBSCRIBE : MQTT_REQUEST_FLAG_UNSUBSCRIBE;
+            request->status |= (sub ? MQTT_REQUEST_FLAG_SUBSCRIBE : MQTT_REQUEST_FLAG_UNSUBSCRIBE) | flags;
             prv_request_set_pending(client, request); /* Set request as pending waiting for server reply */
             prv_send_data(client);                    /* Try to send data */
-            ret = 1;
+            return 1;
         }
     }
-    lwcell_core_unlock();
-    return ret;
+    return 0;
 }
 
 /**
- * \brief           Process incoming fully received message
- * \param[in]       client: MQTT client
- * \return          `1` on success, `0` otherwise
+ * \brief           Find node for topic level in list of nodes
+ * \param[in]       list: First node on a level
+ * \param[in]       name: Level name
+ * \param[in]       len: Length of level name
+ * \return          Node on success, `NULL` otherwise
  */
-static uint8_t
-prv_mqtt_process_incoming_message(lwcell_mqtt_client_p client) {
-    mqtt_msg_type_t msg_type;
-    lwcell_mqtt_qos_t qos;
-    uint16_t pkt_id;
-
-    msg_type = MQTT_RCV_GET_PACKET_TYPE(client->msg_hdr_byte); /* Get packet type from message header byte */
+static lwcell_mqtt_topic_node_t*
+prv_router_find(lwcell_mqtt_topic_node_t* list, const char* name, size_t len) {
+    for (; list != NULL; list = list->next) {
+        if (list->name_len == len && !strncmp(list->name, name, len)) {
+            break;
+        }
+    }
+    return list;
+}
 
-    /* Debug message */
-    LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_STATE, "[LWCELL MQTT] Processing packet type %s\r\n",
+/**
+ * \brief           Delete nodes without subscription and children
+ * \param[in,out]   list: Pointer to first node on a level
+ */
+static void
+prv_router_prune(lwcell_mqtt_topic_node_t** list) {
+    lwcell_mqtt_topic_node_t* n;
+
+    while ((n = *list) != NULL) {
+        prv_router_prune(&n->children);
+        if (n->sub == NULL && n->children == NULL) {
+            *list = n->next;
+            lwcell_mem_free_s((void**)&n);
+        } else {
+            list = &n->next;
+        }
+    }
+}
+
+/**
+ * \brief           Delete all nodes of topic filter tree
+ * \param[in,out]   list: Pointer to first node on a level
+ */
+static void
+prv_router_free(lwcell_mqtt_topic_node_t** list) {
+    lwcell_mqtt_topic_node_t* n;
+
+    while ((n = *list) != NULL) {
+        *list = n->next;
+        prv_router_free(&n->children);
+        lwcell_mem_free_s((void**)&n);
+    }
+}
+
+/**
+ * \brief           Set subscription of node for its topic filter, creating missing nodes
+ * \param[in]       client: MQTT client
+ * \param[in]       s: Subscription to set or `NULL` to clear it
+ * \param[in]       topic: Topic filter
+ * \param[in]       len: Length of topic filter
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+prv_router_set(lwcell_mqtt_client_p client, lwcell_mqtt_sub_t* s, const char* topic, size_t len) {
+    lwcell_mqtt_topic_node_t **list = &client->router, *n = NULL;
+    size_t pos = 0, end;
+
+    for (;;) {
+        for (end = pos; end < len && topic[end] != '/'; ++end) {}
+        if ((n = prv_router_find(*list, &topic[pos], end - pos)) == NULL) {
+            if (s == NULL || (n = lwcell_mem_calloc(1, sizeof(*n) + end - pos)) == NULL) {
+                break;
+            }
+            LWCELL_MEMCPY(n + 1, &topic[pos], end - pos);
+            n->name = (const char*)(n + 1);
+            n->name_len = LWCELL_U16(end - pos);
+            n->next = *list;
+            *list = n;
+        }
+        if (end == len) {
+            n->sub = s;
+            break;
+        }
+        list = &n->children;
+        pos = end + 1;
+    }
+    if (s == NULL || n == NULL) {
+        /* Delete nodes left without subscription, but not while tree is walked */
+        if (client->is_routing) {
+            client->router_prune = 1;
+        } else {
+            prv_router_prune(&client->router);
+        }
+    }
+    return n != NULL;
+}
+
+/**
+ * \brief           Call handler of subscription
+ * \param[in]       client: MQTT client
+ * \param[in]       s: Subscription or `NULL`
+ * \param[in]       evt: Publish receive event
+ * \return          `1` if handler was called, `0` otherwise
+ */
+static size_t
+prv_router_call(lwcell_mqtt_client_p client, lwcell_mqtt_sub_t* s, lwcell_mqtt_evt_t* evt) {
+    if (s == NULL || s->fn == NULL) {
+        return 0;
+    }
+    s->fn(client, evt, s->fn_arg);
+    return 1;
+}
+
+/**
+ * \brief           Call handlers of all topic filters on a level matching topic.
+ *
+ * Every level of topic is compared only with nodes of the same level,
+ * time is proportional to topic depth and not to number of subscriptions.
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       list: First node on a level
+ * \param[in]       topic: Topic of received message
+ * \param[in]       len: Length of topic
+ * \param[in]       pos: Position of current level in topic
+ * \param[in]       evt: Publish receive event
+ * \return          Number of called handlers
+ */
+static size_t
+prv_router_match(lwcell_mqtt_client_p client, lwcell_mqtt_topic_node_t* list, const char* topic, size_t len,
+                 size_t pos, lwcell_mqtt_evt_t* evt) {
+    size_t end, cnt = 0;
+    uint8_t wildcard; /* Wildcards do not match topics starting with `$` */
+
+    wildcard = pos > 0 || len == 0 || topic[0] != '$';
+    for (end = pos; end < len && topic[end] != '/'; ++end) {}
+    for (lwcell_mqtt_topic_node_t* n = list; n != NULL; n = n->next) {
+        if (n->name_len == 1 && n->name[0] == '#') {
+            if (wildcard) {
+                cnt += prv_router_call(client, n->sub, evt);
+            }
+        } else if ((n->name_len == 1 && n->name[0] == '+' && wildcard)
+                   || (n->name_len == end - pos && !strncmp(n->name, &topic[pos], end - pos))) {
+            if (end == len) {
+                lwcell_mqtt_topic_node_t* h;
+
+                cnt += prv_router_call(client, n->sub, evt);
+
+                /* Multi-level wildcard matches also its parent level */
+                if ((h = prv_router_find(n->children, "#", 1)) != NULL) {
+                    cnt += prv_router_call(client, h->sub, evt);
+                }
+            } else {
+                cnt += prv_router_match(client, n->children, topic, len, end + 1, evt);
+            }
+        }
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Route received publish message to handlers of matching subscriptions
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Publish receive event
+ * \return          Number of called handlers
+ */
+static size_t
+prv_router_dispatch(lwcell_mqtt_client_p client, lwcell_mqtt_evt_t* evt) {
+    size_t cnt;
+
+    client->is_routing = 1; /* Handlers may (un)subscribe, keep nodes until done */
+    cnt = prv_router_match(client, client->router, (const char*)evt->evt.publish_recv.topic,
+                           evt->evt.publish_recv.topic_len, 0, evt);
+    client->is_routing = 0;
+    if (client->router_prune) {
+        client->router_prune = 0;
+        prv_router_prune(&client->router);
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Add or remove subscription of persistent session or with handler
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic filter
+ * \param[in]       len_topic: Length of topic filter
+ * \param[in]       qos: Quality of service
+ * \param[in]       fn: Handler for received messages or `NULL`
+ * \param[in]       fn_arg: Handler argument
+ * \param[in]       sub: Set to `1` to add subscription, `0` to remove it
+ */
+static void
+prv_subs_update(lwcell_mqtt_client_p client, const char* topic, uint16_t len_topic, lwcell_mqtt_qos_t qos,
+                lwcell_mqtt_sub_fn fn, void* fn_arg, uint8_t sub) {
+    lwcell_mqtt_sub_t *s, *s_prev = NULL;
+
+    for (s = client->subs; s != NULL; s_prev = s, s = s->next) {
+        if (s->topic_len == len_topic && !strncmp(s->topic, topic, len_topic)) {
+            break;
+        }
+    }
+    if (s != NULL) {
+        if (sub) {
+            s->qos = qos; /* Subscribed again, update quality of service */
+            if (s->fn != NULL && fn == NULL) {
+                prv_router_set(client, NULL, topic, len_topic);
+            }
+        } else {
+            if (s_prev != NULL) {
+                s_prev->next = s->next;
+            } else {
+                client->subs = s->next;
+            }
+            if (s->restore) {
+                --client->resubs;
+            }
+            if (s->fn != NULL) {
+                prv_router_set(client, NULL, topic, len_topic);
+            }
+            lwcell_mem_free_s((void**)&s);
+        }
+    } else if (sub && (s = lwcell_mem_calloc(1, sizeof(*s) + len_topic)) != NULL) {
+        LWCELL_MEMCPY(s + 1, topic, len_topic);
+        s->topic = (const char*)(s + 1);
+        s->topic_len = len_topic;
+        s->qos = qos;
+        s->next = client->subs;
+        client->subs = s;
+    } else if (sub) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE_WARNING, "[LWCELL MQTT] No memory to save subscription\r\n");
+    }
+    if (sub && s != NULL) {
+        s->fn = fn;
+        s->fn_arg = fn_arg;
+        if (fn != NULL && !prv_router_set(client, s, topic, len_topic)) {
+            s->fn = NULL;
+            LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE_WARNING, "[LWCELL MQTT] No memory to route subscription\r\n");
+        }
+    }
+}
+
+/**
+ * \brief           Delete all saved subscriptions and their routes
+ * \param[in]       client: MQTT client
+ */
+static void
+prv_subs_free(lwcell_mqtt_client_p client) {
+    lwcell_mqtt_sub_t* s;
+
+    while ((s = client->subs) != NULL) {
+        client->subs = s->next;
+        lwcell_mem_free_s((void**)&s);
+    }
+    client->resubs = 0;
+    prv_router_free(&client->router);
+}
+
+/**
+ * \brief           Delete session state kept from previous connection,
+ *                  notifying user about failed requests
+ * \param[in]       client: MQTT client
+ */
+static void
+prv_session_clear(lwcell_mqtt_client_p client) {
+    for (size_t i = 0; i < LWCELL_CFG_MQTT_MAX_REQUESTS; ++i) {
+        lwcell_mqtt_request_t* request = &client->requests[i];
+
+        if (request->status & MQTT_REQUEST_FLAG_IN_USE) {
+            uint8_t status = request->status;
+
+            prv_request_delete(client, request);
+            prv_request_send_err_callback(client, status, request->arg);
+        }
+    }
+    client->resends = 0;
+    prv_subs_free(client);
+}
+
+/**
+ * \brief           Encode publish packet with topic string to memory
+ * \param[out]      d: Memory to write packet to. Set to `NULL` to get packet length only
+ * \param[in]       hdr: Packet start byte with publish flags
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       len_topic: Length of topic
+ * \param[in]       pkt_id: Packet ID, written only when `QoS > 0`
+ * \param[in]       props: Set to `1` to write empty MQTT 5.0 properties, `0` otherwise
+ * \param[in]       payload: Message data
+ * \param[in]       payload_len: Length of payload data
+ * \return          Raw packet length in units of bytes
+ */
+static uint32_t
+prv_publish_encode(uint8_t* d, uint8_t hdr, const char* topic, uint16_t len_topic, uint16_t pkt_id, uint8_t props,
+                   const void* payload, uint32_t payload_len) {
+    uint8_t has_pkt_id = (hdr & 0x06) != 0;
+    uint32_t rem_len = 2 + len_topic + (has_pkt_id ? 2 : 0) + props + payload_len;
+    uint32_t raw_len = prv_get_raw_len(rem_len);
+
+    if (d == NULL) {
+        return raw_len;
+    }
+    *d++ = hdr;
+    do { /* Encode remaining length */
+        *d++ = LWCELL_U8((rem_len & 0x7F) | (rem_len > 0x7F ? 0x80 : 0));
+        rem_len >>= 7;
+    } while (rem_len > 0);
+    *d++ = LWCELL_U8(len_topic >> 8);
+    *d++ = LWCELL_U8(len_topic & 0xFF);
+    LWCELL_MEMCPY(d, topic, len_topic);
+    d += len_topic;
+    if (has_pkt_id) {
+        *d++ = LWCELL_U8(pkt_id >> 8);
+        *d++ = LWCELL_U8(pkt_id & 0xFF);
+    }
+    if (props) {
+        *d++ = 0x00; /* No properties */
+    }
+    if (payload_len > 0) {
+        LWCELL_MEMCPY(d, payload, payload_len);
+    }
+    return raw_len;
+}
+
+/**
+ * \brief           Put publish message to message store.
+ *
+ * Record consists of user argument followed by raw publish packet in MQTT 3.1.1 format with packet ID set to `0`.
+ * Packet ID and MQTT 5.0 properties are added when message is taken from the store and sent,
+ * hence record does not depend on protocol version of the client sending it.
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       len_topic: Length of topic
+ * \param[in]       payload: Message data
+ * \param[in]       payload_len: Length of payload data
+ * \param[in]       qos: Quality of service, `1` or `2`
+ * \param[in]       retain: Retain parameter value
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+prv_store_push(lwcell_mqtt_client_p client, const char* topic, uint16_t len_topic, const void* payload,
+               uint16_t payload_len, uint8_t qos, uint8_t retain, void* arg) {
+    uint8_t hdr = LWCELL_U8(MQTT_MSG_TYPE_PUBLISH) << 0x04 | LWCELL_U8(qos & 0x03) << 0x01 | LWCELL_U8(!!retain);
+    size_t rec_len;
+    uint8_t* rec;
+    lwcellr_t res;
+
+    payload_len = payload != NULL ? payload_len : 0;
+    rec_len = sizeof(arg) + prv_publish_encode(NULL, hdr, topic, len_topic, 0, 0, payload, payload_len);
+    if ((rec = lwcell_mem_malloc(rec_len)) == NULL) {
+        return lwcellERRMEM;
+    }
+    LWCELL_MEMCPY(rec, &arg, sizeof(arg));
+    prv_publish_encode(rec + sizeof(arg), hdr, topic, len_topic, 0, 0, payload, payload_len);
+    if ((res = client->store->push_fn(client->store_arg, rec, rec_len)) == lwcellOK) {
+        client->store_pending = 1;
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Publish message stored, QoS: %d\r\n", (int)qos);
+    }
+    lwcell_mem_free_s((void**)&rec);
+    return res;
+}
+
+/**
+ * \brief           Send oldest message from message store
+ * \param[in]       client: MQTT client
+ * \return          `1` when message was sent and next one may follow, `0` otherwise
+ */
+static uint8_t
+prv_store_send_next(lwcell_mqtt_client_p client) {
+    lwcell_mqtt_request_t* request;
+    size_t rec_len, pkt_len, pos, topic_len;
+    uint32_t raw_len = 0;
+    uint8_t *rec, *pkt, *out;
+    void* arg;
+
+    if ((rec_len = client->store->peek_fn(client->store_arg, NULL, 0)) == 0) {
+        client->store_pending = 0;
+        return 0;
+    }
+    pkt_len = rec_len - sizeof(arg);
+    if (rec_len <= sizeof(arg) + 4 || lwcell_buff_get_free(&client->tx_buff) < pkt_len
+        || (rec = lwcell_mem_malloc(rec_len)) == NULL) {
+        return 0;
+    }
+    client->store->peek_fn(client->store_arg, rec, rec_len);
+    LWCELL_MEMCPY(&arg, rec, sizeof(arg));
+
+    /* Skip packet start byte and remaining length to get topic, packet ID follows it */
+    pkt = rec + sizeof(arg);
+    for (pos = 1; pos < pkt_len && (pkt[pos] & 0x80); ++pos) {}
+    pos += 1;
+    topic_len = pos + 2 <= pkt_len ? ((size_t)pkt[pos] << 8 | pkt[pos + 1]) : 0;
+    if (topic_len > 0 && pos + 2 + topic_len + 2 <= pkt_len) {
+        raw_len = prv_publish_encode(NULL, pkt[0], NULL, LWCELL_U16(topic_len), 0, MQTT_IS_V5(client), NULL,
+                                     pkt_len - (pos + 2 + topic_len + 2));
+    }
+    if (raw_len == 0 || raw_len > UINT16_MAX) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE_WARNING, "[LWCELL MQTT] Invalid message in store, skipped\r\n");
+        client->store->pop_fn(client->store_arg);
+        lwcell_mem_free_s((void**)&rec);
+        return 1;
+    }
+    if (lwcell_buff_get_free(&client->tx_buff) < raw_len || (out = lwcell_mem_malloc(raw_len)) == NULL) {
+        lwcell_mem_free_s((void**)&rec);
+        return 0;
+    }
+    if ((request = prv_request_create(client, 1, arg)) == NULL) {
+        lwcell_mem_free_s((void**)&out);
+        lwcell_mem_free_s((void**)&rec);
+        return 0;
+    }
+    prv_publish_encode(out, pkt[0], (const char*)&pkt[pos + 2], LWCELL_U16(topic_len), request->packet_id,
+                       MQTT_IS_V5(client), &pkt[pos + 2 + topic_len + 2], pkt_len - (pos + 2 + topic_len + 2));
+    lwcell_mem_free_s((void**)&rec);
+    prv_write_data(client, out, raw_len);
+    client->store->pop_fn(client->store_arg);
+
+    request->status |= MQTT_REQUEST_FLAG_PUBLISH_QOS;
+    ++client->inflight;
+    if (LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT > 0 || client->info->persistent_session) {
+        request->packet = out; /* Keep packet copy to send it again */
+        request->packet_len = LWCELL_U16(raw_len);
+    } else {
+        lwcell_mem_free_s((void**)&out);
+    }
+    prv_request_set_pending(client, request);
+    LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Stored message sent with pkt_id: %d\r\n",
+                 (int)request->packet_id);
+    return 1;
+}
+
+/**
+ * \brief           Get request waiting to be sent again with oldest packet ID
+ * \param[in]       client: MQTT client
+ * \return          Request on success, `NULL` otherwise
+ */
+static lwcell_mqtt_request_t*
+prv_request_get_oldest_resend(lwcell_mqtt_client_p client) {
+    lwcell_mqtt_request_t* oldest = NULL;
+    uint16_t age, oldest_age = 0;
+
+    for (size_t i = 0; i < LWCELL_CFG_MQTT_MAX_REQUESTS; ++i) {
+        if (client->requests[i].status & MQTT_REQUEST_FLAG_RESEND) {
+            age = LWCELL_U16(client->last_packet_id - client->requests[i].packet_id); /* Last created has age 0 */
+            if (oldest == NULL || age > oldest_age) {
+                oldest = &client->requests[i];
+                oldest_age = age;
+            }
+        }
+    }
+    return oldest;
+}
+
+/**
+ * \brief           Send data waiting for active session, in order:
+ *                  queued acknowledges, subscriptions to restore, unacknowledged messages of resumed session and stored messages
+ *
+ * Function stops on first packet that does not fit to output buffer or request list
+ * and is called again when memory is released.
+ *
+ * \param[in]       client: MQTT client
+ */
+static void
+prv_output_pending(lwcell_mqtt_client_p client) {
+    lwcell_mqtt_request_t* request;
+    uint8_t sent = 0;
+
+    if (client->conn_state != LWCELL_MQTT_CONNECTED || client->is_streaming) {
+        return;
+    }
+    prv_write_acks_queued(client);
+    if (client->acks_cnt > 0) {
+        return;
+    }
+    for (lwcell_mqtt_sub_t* s = client->subs; client->resubs > 0 && s != NULL; s = s->next) {
+        if (s->restore) {
+            if (!prv_write_sub_unsub(client, s->topic, s->topic_len, s->qos, NULL, 1, MQTT_REQUEST_FLAG_INTERNAL)) {
+                return;
+            }
+            s->restore = 0;
+            --client->resubs;
+        }
+    }
+    while (client->resends > 0 && (request = prv_request_get_oldest_resend(client)) != NULL) {
+        if (!prv_request_retransmit(client, request)) {
+            return;
+        }
+        request->status &= ~MQTT_REQUEST_FLAG_RESEND;
+        request->timeout_start_time = lwcell_sys_now();
+        request->retransmits = 0;
+        --client->resends;
+    }
+    while (client->store != NULL && client->store_pending && client->inflight < MQTT_INFLIGHT_MAX(client)
+           && prv_store_send_next(client)) {
+        sent = 1;
+    }
+    if (sent) {
+        prv_send_data(client);
+    }
+#if LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT
+    if (client->inflight > 0) {
+        prv_retransmit_start(client, LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT);
+    }
+#endif /* LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT */
+}
+
+/**
+ * \brief           Subscribe/Unsubscribe to/from MQTT topic
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: MQTT topic to (un)subscribe
+ * \param[in]       qos: Quality of service, used only on subscribe part
+ * \param[in]       fn: Handler for messages matching topic filter or `NULL`, used only on subscribe part
+ * \param[in]       fn_arg: Handler argument
+ * \param[in]       arg: Custom argument
+ * \param[in]       sub: Status set to `1` on subscribe or `0` on unsubscribe
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+prv_sub_unsub(lwcell_mqtt_client_p client, const char* topic, lwcell_mqtt_qos_t qos, lwcell_mqtt_sub_fn fn,
+              void* fn_arg, void* arg, uint8_t sub) {
+    uint16_t len_topic;
+    uint8_t ret = 0;
+
+    if ((len_topic = LWCELL_U16(strlen(topic))) == 0) {
+        return 0;
+    }
+
+    lwcell_core_lock();
+    if (client->conn_state == LWCELL_MQTT_CONNECTED) {
+        ret = prv_write_sub_unsub(client, topic, len_topic, qos, arg, sub, 0);
+        if (ret && (client->info->persistent_session || fn != NULL || !sub)) {
+            /* Remember subscription to restore it or to route messages to its handler */
+            prv_subs_update(client, topic, len_topic, qos, fn, fn_arg, sub);
+        }
+    }
+    lwcell_core_unlock();
+    return ret;
+}
+
+#if LWCELL_CFG_MQTT_V5 || __DOXYGEN__
+
+/**
+ * \brief           Process MQTT 5.0 connect acknowledge properties and reason code
+ * \param[in]       client: MQTT client
+ * \return          Connection status with reason code mapped to MQTT 3.1.1 return code
+ */
+static lwcell_mqtt_conn_status_t
+prv_process_connack_v5(lwcell_mqtt_client_p client) {
+    size_t pos = 0, len = 0, n = 0;
+    uint32_t value;
+    uint8_t id;
+
+    if (client->msg_rem_len > 2) {
+        uint32_t props_len;
+
+        n = prv_read_varint(&client->rx_buff[2], client->msg_rem_len - 2, &props_len);
+        len = n > 0 ? LWCELL_MIN(props_len, client->msg_rem_len - 2 - n) : 0;
+    }
+    while (prv_prop_read(&client->rx_buff[2 + n], len, &pos, &id, &value)) {
+        switch (id) {
+            case MQTT_PROP_RECEIVE_MAX:
+                client->inflight_max = LWCELL_U16(LWCELL_MIN(value, LWCELL_CFG_MQTT_MAX_INFLIGHT));
+                break;
+            case MQTT_PROP_MAX_PACKET_SIZE: client->max_packet_size = value; break;
+            case MQTT_PROP_SERVER_KEEP_ALIVE: client->keep_alive = LWCELL_U16(value); break;
+#if LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX
+            case MQTT_PROP_TOPIC_ALIAS_MAX: client->topic_alias_max = LWCELL_U16(value); break;
+#endif /* LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX */
+            default: break;
+        }
+    }
+    LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] CONNACK reason: 0x%02X, receive max: %d, packet size: %d\r\n",
+                 (unsigned)client->rx_buff[1], (int)client->inflight_max, (int)client->max_packet_size);
+
+    switch (client->rx_buff[1]) {
+        case 0x00: return LWCELL_MQTT_CONN_STATUS_ACCEPTED;
+        case 0x84: return LWCELL_MQTT_CONN_STATUS_REFUSED_PROTOCOL_VERSION;
+        case 0x85: return LWCELL_MQTT_CONN_STATUS_REFUSED_ID;
+        case 0x86: return LWCELL_MQTT_CONN_STATUS_REFUSED_USER_PASS;
+        case 0x87: return LWCELL_MQTT_CONN_STATUS_REFUSED_NOT_AUTHORIZED;
+        default: return LWCELL_MQTT_CONN_STATUS_REFUSED_SERVER;
+    }
+}
+
+#endif /* LWCELL_CFG_MQTT_V5 || __DOXYGEN__ */
+
+/**
+ * \brief           Process incoming fully received message
+ * \param[in]       client: MQTT client
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+prv_mqtt_process_incoming_message(lwcell_mqtt_client_p client) {
+    mqtt_msg_type_t msg_type;
+    lwcell_mqtt_qos_t qos;
+    uint16_t pkt_id;
+
+    msg_type = MQTT_RCV_GET_PACKET_TYPE(client->msg_hdr_byte); /* Get packet type from message header byte */
+
+    /* Debug message */
+    LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_STATE, "[LWCELL MQTT] Processing packet type %s\r\n",
                  prv_mqtt_msg_type_to_str(msg_type));
 
     /* Check received packet type */
     switch (msg_type) {
         case MQTT_MSG_TYPE_CONNACK: {
             lwcell_mqtt_conn_status_t err = (lwcell_mqtt_conn_status_t)client->rx_buff[1];
+            uint8_t session_present;
+
             if (client->conn_state == LWCELL_MQTT_CONNECTING) {
+#if LWCELL_CFG_MQTT_V5
+                if (client->is_v5) {
+                    err = prv_process_connack_v5(client);
+                }
+#endif /* LWCELL_CFG_MQTT_V5 */
                 if (err == LWCELL_MQTT_CONN_STATUS_ACCEPTED) {
                     client->conn_state = LWCELL_MQTT_CONNECTED;
+                    if (client->keep_alive > 0) {
+                        prv_keep_alive_start(client, (uint32_t)client->keep_alive * 1000);
+                    }
+                }
+                session_present = err == LWCELL_MQTT_CONN_STATUS_ACCEPTED && (client->rx_buff[0] & 0x01);
+                LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE,
+                             "[LWCELL MQTT] CONNACK received with result: %d, session present: %d\r\n", (int)err,
+                             (int)session_present);
+
+                /* Server has no session, all subscriptions must be made again */
+                if (err == LWCELL_MQTT_CONN_STATUS_ACCEPTED && !session_present) {
+                    client->resubs = 0;
+                    for (lwcell_mqtt_sub_t* s = client->subs; s != NULL; s = s->next) {
+                        s->restore = 1;
+                        ++client->resubs;
+                    }
                 }
-                LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] CONNACK received with result: %d\r\n", (int)err);
 
                 /* Notify user layer */
                 client->evt.type = LWCELL_MQTT_EVT_CONNECT;
                 client->evt.evt.connect.status = err;
+                client->evt.evt.connect.session_present = session_present;
+                client->evt.evt.connect.reason = client->rx_buff[1];
                 client->evt_fn(client, &client->evt);
+                prv_output_pending(client); /* Send data waiting for session */
             } else {
                 /* Protocol violation here */
                 LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE,
@@ -567,6 +1762,11 @@ prv_mqtt_process_incoming_message(lwcell_mqtt_client_p client) {
             } else {
                 pkt_id = 0; /* No packet ID */
             }
+#if LWCELL_CFG_MQTT_V5
+            if (client->is_v5) { /* Properties are not used by client */
+                data += prv_get_props_size(data, client->msg_rem_len - (data - client->rx_buff));
+            }
+#endif /* LWCELL_CFG_MQTT_V5 */
             data_len = client->msg_rem_len - (data - client->rx_buff); /* Calculate length of remaining data */
 
             LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE,
@@ -595,12 +1795,19 @@ prv_mqtt_process_incoming_message(lwcell_mqtt_client_p client) {
             client->evt.evt.publish_recv.payload_len = data_len;
             client->evt.evt.publish_recv.dup = dup;
             client->evt.evt.publish_recv.qos = qos;
-            client->evt_fn(client, &client->evt);
+            client->evt.evt.publish_recv.pbuf = client->msg_pbuf;
+
+            /* Messages without matching subscription handler go to client callback */
+            if (client->router == NULL || prv_router_dispatch(client, &client->evt) == 0) {
+                client->evt_fn(client, &client->evt);
+            }
             break;
         }
         case MQTT_MSG_TYPE_PINGRESP: { /* Respond to PINGREQ received */
             LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Ping response received\r\n");
 
+            client->is_ping_pending = 0;
+
             client->evt.type = LWCELL_MQTT_EVT_KEEP_ALIVE;
             client->evt_fn(client, &client->evt);
             break;
@@ -611,9 +1818,54 @@ prv_mqtt_process_incoming_message(lwcell_mqtt_client_p client) {
         case MQTT_MSG_TYPE_PUBREL:
         case MQTT_MSG_TYPE_PUBACK:
         case MQTT_MSG_TYPE_PUBCOMP: {
+            uint8_t reason = 0;
+
             pkt_id = client->rx_buff[0] << 8 | client->rx_buff[1]; /* Get packet ID */
 
-            if (msg_type == MQTT_MSG_TYPE_PUBREC) { /* Publish record received from server */
+            /*
+             * Return code of SUBACK follows packet ID,
+             * reason code of MQTT 5.0 acknowledge follows packet ID or properties of (UN)SUBACK
+             */
+            if (msg_type == MQTT_MSG_TYPE_SUBACK || MQTT_IS_V5(client)) {
+                size_t pos = 2;
+
+#if LWCELL_CFG_MQTT_V5
+                if (client->is_v5 && (msg_type == MQTT_MSG_TYPE_SUBACK || msg_type == MQTT_MSG_TYPE_UNSUBACK)
+                    && client->msg_rem_len > pos) {
+                    pos += prv_get_props_size(&client->rx_buff[pos], client->msg_rem_len - pos);
+                }
+#endif /* LWCELL_CFG_MQTT_V5 */
+                if (client->msg_rem_len > pos) {
+                    reason = client->rx_buff[pos];
+                }
+            }
+
+            if (msg_type == MQTT_MSG_TYPE_PUBREC && reason >= 0x80) { /* Server refused MQTT 5.0 publish */
+                lwcell_mqtt_request_t* request;
+
+                if ((request = prv_request_get_pending(client, pkt_id)) != NULL
+                    && (request->status & MQTT_REQUEST_FLAG_PUBLISH_QOS)) {
+                    void* arg = request->arg;
+
+                    prv_request_delete(client, request);
+                    client->evt.type = LWCELL_MQTT_EVT_PUBLISH;
+                    client->evt.evt.publish.arg = arg;
+                    client->evt.evt.publish.res = lwcellERR;
+                    client->evt.evt.publish.reason = reason;
+                    client->evt_fn(client, &client->evt);
+                    prv_output_pending(client);
+                }
+            } else if (msg_type == MQTT_MSG_TYPE_PUBREC) { /* Publish record received from server */
+                lwcell_mqtt_request_t* request;
+
+                /* Publish will not be sent again, wait for publish complete */
+                if ((request = prv_request_get_pending(client, pkt_id)) != NULL
+                    && (request->status & MQTT_REQUEST_FLAG_PUBLISH_QOS)) {
+                    lwcell_mem_free_s((void**)&request->packet);
+                    request->status |= MQTT_REQUEST_FLAG_PUBREL;
+                    request->timeout_start_time = lwcell_sys_now();
+                    request->retransmits = 0;
+                }
                 prv_write_ack_rec_rel_resp(client, MQTT_MSG_TYPE_PUBREL, pkt_id,
                                            (lwcell_mqtt_qos_t)1); /* Send back publish release message */
             } else if (msg_type == MQTT_MSG_TYPE_PUBREL) {       /* Publish release was received */
@@ -631,11 +1883,16 @@ prv_mqtt_process_incoming_message(lwcell_mqtt_client_p client) {
                  * waiting for final acknowledge, otherwise there is protocol violation
                  */
                 if ((request = prv_request_get_pending(client, pkt_id)) != NULL) {
-                    if (msg_type == MQTT_MSG_TYPE_SUBACK || msg_type == MQTT_MSG_TYPE_UNSUBACK) {
+                    if (request->status & MQTT_REQUEST_FLAG_INTERNAL) {
+                        /* Subscription restored by the client, user is not notified */
+                        LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Subscription restored, result: %d\r\n",
+                                     (int)reason);
+                    } else if (msg_type == MQTT_MSG_TYPE_SUBACK || msg_type == MQTT_MSG_TYPE_UNSUBACK) {
                         client->evt.type =
                             msg_type == MQTT_MSG_TYPE_SUBACK ? LWCELL_MQTT_EVT_SUBSCRIBE : LWCELL_MQTT_EVT_UNSUBSCRIBE;
                         client->evt.evt.sub_unsub_scribed.arg = request->arg;
-                        client->evt.evt.sub_unsub_scribed.res = client->rx_buff[2] < 3 ? lwcellOK : lwcellERR;
+                        client->evt.evt.sub_unsub_scribed.res = reason < 0x80 ? lwcellOK : lwcellERR;
+                        client->evt.evt.sub_unsub_scribed.reason = reason;
                         client->evt_fn(client, &client->evt);
 
                         /*
@@ -645,10 +1902,12 @@ prv_mqtt_process_incoming_message(lwcell_mqtt_client_p client) {
                     } else if (msg_type == MQTT_MSG_TYPE_PUBCOMP || msg_type == MQTT_MSG_TYPE_PUBACK) {
                         client->evt.type = LWCELL_MQTT_EVT_PUBLISH;
                         client->evt.evt.publish.arg = request->arg;
-                        client->evt.evt.publish.res = lwcellOK;
+                        client->evt.evt.publish.res = reason < 0x80 ? lwcellOK : lwcellERR;
+                        client->evt.evt.publish.reason = reason;
                         client->evt_fn(client, &client->evt);
                     }
                     prv_request_delete(client, request); /* Delete request object */
+                    prv_output_pending(client);          /* Request slot is free for pending data */
                 } else {
                     /* Protocol violation at this point! */
                     LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE,
@@ -657,11 +1916,89 @@ prv_mqtt_process_incoming_message(lwcell_mqtt_client_p client) {
             }
             break;
         }
+        case MQTT_MSG_TYPE_DISCONNECT: { /* MQTT 5.0 server closes connection */
+            client->disconnect_reason = client->msg_rem_len > 0 ? client->rx_buff[0] : 0;
+            LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] DISCONNECT received with reason: %d\r\n",
+                         (int)client->disconnect_reason);
+            prv_mqtt_close(client);
+            break;
+        }
         default: return 0;
     }
     return 1;
 }
 
+/**
+ * \brief           Get length of publish variable header in RX buffer, with topic, packet ID and properties
+ * \param[in]       client: MQTT client
+ * \param[in]       avail: Number of bytes already written to RX buffer
+ * \return          Variable header length in units of bytes, `0` if not known yet
+ */
+static size_t
+prv_publish_get_hdr_len(lwcell_mqtt_client_p client, size_t avail) {
+    size_t len = 2 + ((size_t)client->rx_buff[0] << 8 | client->rx_buff[1])
+                 + (MQTT_RCV_GET_PACKET_QOS(client->msg_hdr_byte) > 0 ? 2 : 0);
+
+#if LWCELL_CFG_MQTT_V5
+    if (client->is_v5) { /* Properties length follows packet ID */
+        uint32_t props_len;
+        size_t n;
+
+        if (avail <= len || (n = prv_read_varint(&client->rx_buff[len], avail - len, &props_len)) == 0) {
+            return 0;
+        }
+        len += n + props_len;
+    }
+#else
+    LWCELL_UNUSED(avail);
+#endif /* LWCELL_CFG_MQTT_V5 */
+    return len;
+}
+
+/**
+ * \brief           Start streaming reception of publish message too big for RX buffer.
+ *                  Variable header is in RX buffer, payload is reported directly from received data
+ * \param[in]       client: MQTT client
+ */
+static void
+prv_publish_stream_start(lwcell_mqtt_client_p client) {
+    size_t hdr_len = prv_publish_get_hdr_len(client, client->msg_curr_pos);
+
+    LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Publish packet stream start, data_len: %d\r\n",
+                 (int)(client->msg_rem_len - hdr_len));
+
+    client->evt.type = LWCELL_MQTT_EVT_PUBLISH_RECV_START;
+    client->evt.evt.publish_recv.topic = &client->rx_buff[2];
+    client->evt.evt.publish_recv.topic_len = (size_t)client->rx_buff[0] << 8 | client->rx_buff[1];
+    client->evt.evt.publish_recv.payload = NULL;
+    client->evt.evt.publish_recv.payload_len = client->msg_rem_len - hdr_len;
+    client->evt.evt.publish_recv.dup = MQTT_RCV_GET_PACKET_DUP(client->msg_hdr_byte);
+    client->evt.evt.publish_recv.qos = MQTT_RCV_GET_PACKET_QOS(client->msg_hdr_byte);
+    client->evt.evt.publish_recv.pbuf = NULL;
+    client->evt_fn(client, &client->evt);
+}
+
+/**
+ * \brief           Finish streaming reception of publish message
+ * \param[in]       client: MQTT client
+ * \param[in]       res: \ref lwcellOK when all payload was received, member of \ref lwcellr_t otherwise
+ */
+static void
+prv_publish_stream_end(lwcell_mqtt_client_p client, lwcellr_t res) {
+    lwcell_mqtt_qos_t qos = MQTT_RCV_GET_PACKET_QOS(client->msg_hdr_byte);
+
+    /* Acknowledge only after application received complete payload */
+    if (res == lwcellOK && qos > 0) {
+        size_t pos = 2 + ((size_t)client->rx_buff[0] << 8 | client->rx_buff[1]); /* Packet ID follows topic */
+
+        prv_write_ack_rec_rel_resp(client, qos == 1 ? MQTT_MSG_TYPE_PUBACK : MQTT_MSG_TYPE_PUBREC,
+                                   LWCELL_U16(client->rx_buff[pos] << 8 | client->rx_buff[pos + 1]), qos);
+    }
+    client->evt.type = LWCELL_MQTT_EVT_PUBLISH_RECV_END;
+    client->evt.evt.publish_recv_end.res = res;
+    client->evt_fn(client, &client->evt);
+}
+
 /**
  * \brief           Parse incoming buffer data and try to construct clean packet from it
  * \param[in]       client: MQTT client
@@ -718,12 +2055,14 @@ prv_mqtt_parse_incoming(lwcell_mqtt_client_p client, lwcell_pbuf_p pbuf) {
                                 /* Set new client pointer */
                                 client->rx_buff = &d[idx + 1]; /* Data are one byte after */
                                 client->rx_buff_len = client->msg_rem_len;
+                                client->msg_pbuf = pbuf;
 
                                 prv_mqtt_process_incoming_message(client); /* Process new message */
 
                                 /* Reset to previous values */
                                 client->rx_buff = tmp_ptr;
                                 client->rx_buff_len = tmp_len;
+                                client->msg_pbuf = NULL;
                                 client->parser_state = MQTT_PARSER_STATE_INIT;
 
                                 idx +=
@@ -745,6 +2084,18 @@ prv_mqtt_parse_incoming(lwcell_mqtt_client_p client, lwcell_pbuf_p pbuf) {
                     }
                     ++client->msg_curr_pos;
 
+                    /*
+                     * Publish message too big for RX buffer is streamed to application,
+                     * as soon as its variable header is in the buffer
+                     */
+                    if (client->msg_rem_len > client->rx_buff_len && client->msg_curr_pos >= 2
+                        && client->msg_curr_pos <= client->rx_buff_len
+                        && MQTT_RCV_GET_PACKET_TYPE(client->msg_hdr_byte) == MQTT_MSG_TYPE_PUBLISH
+                        && client->msg_curr_pos == prv_publish_get_hdr_len(client, client->msg_curr_pos)) {
+                        prv_publish_stream_start(client);
+                        client->parser_state = MQTT_PARSER_STATE_STREAM;
+                    }
+
                     /* We reached end of received characters? */
                     if (client->msg_curr_pos == client->msg_rem_len) {
                         if (client->msg_curr_pos
@@ -762,6 +2113,25 @@ prv_mqtt_parse_incoming(lwcell_mqtt_client_p client, lwcell_pbuf_p pbuf) {
                     }
                     break;
                 }
+                case MQTT_PARSER_STATE_STREAM: { /* Report payload directly from received buffer */
+                    size_t len = LWCELL_MIN(buff_len - idx, (size_t)(client->msg_rem_len - client->msg_curr_pos));
+
+                    client->evt.type = LWCELL_MQTT_EVT_PUBLISH_RECV_DATA;
+                    client->evt.evt.publish_recv_data.payload = &d[idx];
+                    client->evt.evt.publish_recv_data.len = len;
+                    client->evt.evt.publish_recv_data.offset =
+                        client->msg_curr_pos
+                        - prv_publish_get_hdr_len(client, LWCELL_MIN(client->msg_curr_pos, client->rx_buff_len));
+                    client->evt_fn(client, &client->evt);
+
+                    client->msg_curr_pos += len;
+                    idx += len - 1; /* Skip fragment, idx is increased again in for loop */
+                    if (client->msg_curr_pos == client->msg_rem_len) {
+                        prv_publish_stream_end(client, lwcellOK);
+                        client->parser_state = MQTT_PARSER_STATE_INIT;
+                    }
+                    break;
+                }
                 default: client->parser_state = MQTT_PARSER_STATE_INIT;
             }
         }
@@ -782,9 +2152,23 @@ prv_mqtt_parse_incoming(lwcell_mqtt_client_p client, lwcell_pbuf_p pbuf) {
 static void
 prv_mqtt_connected_cb(lwcell_mqtt_client_p client) {
     uint16_t rem_len, len_id, len_pass = 0, len_user = 0, len_will_topic = 0, len_will_message = 0;
-    uint8_t flags = 0;
+    uint8_t flags = 0, props_len = 0;
 
-    flags |= MQTT_FLAG_CONNECT_CLEAN_SESSION; /* Start as clean session */
+    if (!client->info->persistent_session) {
+        flags |= MQTT_FLAG_CONNECT_CLEAN_SESSION; /* Start as clean session */
+        prv_session_clear(client);                /* Nothing to resume from previous connection */
+    }
+    client->keep_alive = client->info->keep_alive;
+    client->disconnect_reason = 0;
+#if LWCELL_CFG_MQTT_V5
+    /* Limits of previous connection do not apply anymore */
+    client->inflight_max = LWCELL_CFG_MQTT_MAX_INFLIGHT;
+    client->max_packet_size = 0;
+#if LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX
+    client->topic_alias_max = 0;
+    prv_topic_alias_delete(client, 1);
+#endif /* LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX */
+#endif /* LWCELL_CFG_MQTT_V5 */
 
     /*
      * Remaining length consist of fixed header data
@@ -797,6 +2181,16 @@ prv_mqtt_connected_cb(lwcell_mqtt_client_p client) {
     len_id = LWCELL_U16(strlen(client->info->id)); /* Get cliend ID length */
     rem_len += len_id + 2;                        /* Add client id length including length entries */
 
+    if (MQTT_IS_V5(client)) {
+        if (client->info->persistent_session) {
+            props_len += 5; /* Session expiry interval, session is kept after disconnect */
+        }
+        if (client->info->max_packet_size > 0) {
+            props_len += 5; /* Maximum packet size */
+        }
+        rem_len += 1 + props_len; /* Properties with length */
+    }
+
     if (client->info->will_topic != NULL && client->info->will_message != NULL) {
         flags |= MQTT_FLAG_CONNECT_WILL;
         flags |= LWCELL_MIN(LWCELL_U8(client->info->will_qos), 2) << 0x03; /* Set qos to flags */
@@ -806,6 +2200,7 @@ prv_mqtt_connected_cb(lwcell_mqtt_client_p client) {
 
         rem_len += len_will_topic + 2;   /* Add will topic parameter */
         rem_len += len_will_message + 2; /* Add will message parameter */
+        rem_len += MQTT_IS_V5(client);   /* Add will properties length */
     }
 
     if (client->info->user != NULL) {        /* Check for username */
@@ -829,11 +2224,27 @@ prv_mqtt_connected_cb(lwcell_mqtt_client_p client) {
     /* Write everything to output buffer */
     prv_write_fixed_header(client, MQTT_MSG_TYPE_CONNECT, 0, (lwcell_mqtt_qos_t)0, 0, rem_len);
     prv_write_string(client, "MQTT", 4);                                    /* Protocol name */
-    prv_write_u8(client, 4);                                                /* Protocol version */
+    prv_write_u8(client, MQTT_IS_V5(client) ? 5 : 4);                       /* Protocol version */
     prv_write_u8(client, flags);                                            /* Flags for CONNECT message */
     prv_write_u16(client, client->info->keep_alive);                        /* Keep alive timeout in units of seconds */
+#if LWCELL_CFG_MQTT_V5
+    if (client->is_v5) {
+        prv_write_u8(client, props_len); /* Properties length */
+        if (client->info->persistent_session) {
+            prv_write_u8(client, MQTT_PROP_SESSION_EXPIRY);
+            prv_write_u32(client, 0xFFFFFFFF); /* Session does not expire */
+        }
+        if (client->info->max_packet_size > 0) {
+            prv_write_u8(client, MQTT_PROP_MAX_PACKET_SIZE);
+            prv_write_u32(client, client->info->max_packet_size);
+        }
+    }
+#endif /* LWCELL_CFG_MQTT_V5 */
     prv_write_string(client, client->info->id, len_id);                     /* This is client ID string */
     if (flags & MQTT_FLAG_CONNECT_WILL) {                                   /* Check for will topic */
+        if (MQTT_IS_V5(client)) {
+            prv_write_u8(client, 0); /* No will properties */
+        }
         prv_write_string(client, client->info->will_topic, len_will_topic); /* Write topic to packet */
         prv_write_string(client, client->info->will_message, len_will_message); /* Write message to packet */
     }
@@ -846,7 +2257,8 @@ prv_mqtt_connected_cb(lwcell_mqtt_client_p client) {
 
     client->parser_state = MQTT_PARSER_STATE_INIT; /* Reset parser state */
 
-    client->poll_time = 0;                      /* Reset kep alive time */
+    client->last_sent_time = lwcell_sys_now();  /* Reset keep-alive time */
+    client->is_ping_pending = 0;
     client->conn_state = LWCELL_MQTT_CONNECTING; /* MQTT is connecting to server */
 
     prv_send_data(client); /* Flush and send the actual data */
@@ -876,10 +2288,17 @@ static uint8_t
 prv_mqtt_data_sent_cb(lwcell_mqtt_client_p client, size_t sent_len, uint8_t successful) {
     lwcell_mqtt_request_t* request;
 
-    client->is_sending = 0; /* We are not sending anymore */
+    if (client->sends > 0) {
+        --client->sends; /* One send less in progress */
+#if LWCELL_CFG_MQTT_MGR
+        if (client->mgr != NULL) {
+            --client->mgr->sends;
+        }
+#endif /* LWCELL_CFG_MQTT_MGR */
+    }
     client->sent_total += sent_len;
 
-    client->poll_time = 0; /* Reset kep alive time */
+    client->last_sent_time = lwcell_sys_now(); /* Reset keep-alive time */
 
     /*
      * In case transmit was not successful,
@@ -909,55 +2328,162 @@ prv_mqtt_data_sent_cb(lwcell_mqtt_client_p client, size_t sent_len, uint8_t succ
         client->evt.type = LWCELL_MQTT_EVT_PUBLISH;
         client->evt.evt.publish.arg = arg;
         client->evt.evt.publish.res = lwcellOK;
+        client->evt.evt.publish.reason = 0;
+        client->evt_fn(client, &client->evt);
+    }
+
+    /* Ask for more payload of streamed publish message */
+    if (client->is_streaming && client->stream_left > 0 && lwcell_buff_get_free(&client->tx_buff) > 0) {
+        client->evt.type = LWCELL_MQTT_EVT_PUBLISH_WRITE;
+        client->evt.evt.publish_write.arg = client->stream_arg;
+        client->evt.evt.publish_write.len = LWCELL_MIN(lwcell_buff_get_free(&client->tx_buff), client->stream_left);
+        client->evt.evt.publish_write.left = client->stream_left;
         client->evt_fn(client, &client->evt);
     }
-    prv_send_data(client); /* Try to send more */
+    prv_output_pending(client); /* Output buffer has free space for pending data */
+    prv_send_data(client);      /* Try to send more */
+#if LWCELL_CFG_MQTT_MGR
+    if (client->mgr != NULL) {
+        prv_mgr_schedule(client->mgr); /* Released send may be used by other client */
+    }
+#endif /* LWCELL_CFG_MQTT_MGR */
     return 1;
 }
 
+#if LWCELL_CFG_MQTT_MGR || __DOXYGEN__
+
 /**
- * \brief           Poll for client connection
- *                  Called every LWCELL_CFG_CONN_POLL_INTERVAL ms when MQTT client TCP connection is established
- * \param[in]       client: MQTT client
+ * \brief           Write packet copy of unacknowledged message as record to message store of other client
+ * \param[in]       from: Client the request belongs to
+ * \param[in]       to: Client to store message to
+ * \param[in]       request: Request with packet copy
  * \return          `1` on success, `0` otherwise
  */
-static uint8_t
-prv_mqtt_poll_cb(lwcell_mqtt_client_p client) {
-    ++client->poll_time;
+static uint8_t
+prv_mgr_store_request(lwcell_mqtt_client_p from, lwcell_mqtt_client_p to, lwcell_mqtt_request_t* request) {
+    const uint8_t* pkt = request->packet;
+    size_t pos, topic_len, data_pos, rec_len;
+    uint8_t hdr = pkt[0] & ~0x08; /* Message is new for other server */
+    uint8_t* rec;
+    lwcellr_t res;
+
+    /* Record has packet in MQTT 3.1.1 format, empty MQTT 5.0 properties are removed */
+    for (pos = 1; pos < request->packet_len && (pkt[pos] & 0x80); ++pos) {}
+    pos += 1;
+    topic_len = pos + 2 <= request->packet_len ? ((size_t)pkt[pos] << 8 | pkt[pos + 1]) : 0;
+    data_pos = pos + 2 + topic_len + 2 + MQTT_IS_V5(from);
+    if (topic_len == 0 || data_pos > request->packet_len || (MQTT_IS_V5(from) && pkt[data_pos - 1] != 0)) {
+        return 0;
+    }
+    rec_len = sizeof(request->arg)
+              + prv_publish_encode(NULL, hdr, NULL, LWCELL_U16(topic_len), 0, 0, NULL, request->packet_len - data_pos);
+    if ((rec = lwcell_mem_malloc(rec_len)) == NULL) {
+        return 0;
+    }
+    LWCELL_MEMCPY(rec, &request->arg, sizeof(request->arg));
+    prv_publish_encode(rec + sizeof(request->arg), hdr, (const char*)&pkt[pos + 2], LWCELL_U16(topic_len), 0, 0,
+                       &pkt[data_pos], request->packet_len - data_pos);
+    res = to->store->push_fn(to->store_arg, rec, rec_len);
+    lwcell_mem_free_s((void**)&rec);
+    return res == lwcellOK;
+}
+
+/**
+ * \brief           Move unacknowledged and stored `QoS > 0` messages of disconnected client
+ *                  to message store of other client, oldest first.
+ *
+ * Unacknowledged message is moved only when its packet copy is kept,
+ * for retransmission or persistent session. Moving stops on first message that cannot be moved.
+ *
+ * \param[in]       from: Disconnected client to take messages from
+ * \param[in]       to: Client to move messages to
+ * \return          Number of moved messages
+ */
+static size_t
+prv_mgr_migrate(lwcell_mqtt_client_p from, lwcell_mqtt_client_p to) {
+    lwcell_mqtt_request_t *request, *r;
+    size_t moved = 0, rec_len;
+    uint16_t age, oldest_age = 0;
+    uint8_t* rec;
+    lwcellr_t res;
+
+    if (to->store == NULL) {
+        return 0;
+    }
+    do {
+        request = NULL;
+        for (size_t i = 0; i < LWCELL_CFG_MQTT_MAX_REQUESTS; ++i) {
+            r = &from->requests[i];
+            if ((r->status & MQTT_REQUEST_FLAG_PUBLISH_QOS) && !(r->status & MQTT_REQUEST_FLAG_PUBREL)
+                && r->packet != NULL) {
+                age = LWCELL_U16(from->last_packet_id - r->packet_id);
+                if (request == NULL || age > oldest_age) {
+                    request = r;
+                    oldest_age = age;
+                }
+            }
+        }
+        if (request != NULL) {
+            if (!prv_mgr_store_request(from, to, request)) {
+                break;
+            }
+            prv_request_delete(from, request); /* Message continues with other client */
+            ++moved;
+        }
+    } while (request != NULL);
+
+    /* Stored messages follow unacknowledged ones */
+    if (request == NULL && from->store != NULL && (from->store != to->store || from->store_arg != to->store_arg)) {
+        while ((rec_len = from->store->peek_fn(from->store_arg, NULL, 0)) > 0
+               && (rec = lwcell_mem_malloc(rec_len)) != NULL) {
+            from->store->peek_fn(from->store_arg, rec, rec_len);
+            res = to->store->push_fn(to->store_arg, rec, rec_len);
+            lwcell_mem_free_s((void**)&rec);
+            if (res != lwcellOK) {
+                break;
+            }
+            from->store->pop_fn(from->store_arg);
+            ++moved;
+        }
+    }
+    if (moved > 0) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] %d messages moved to other client\r\n", (int)moved);
+        to->store_pending = 1;
+        prv_output_pending(to);
+    }
+    return moved;
+}
+
+/**
+ * \brief           Remove client from manager
+ * \param[in]       client: Manager client to remove
+ */
+static void
+prv_mgr_unlink(lwcell_mqtt_client_p client) {
+    lwcell_mqtt_mgr_p mgr = client->mgr;
 
-    if (client->conn_state == LWCELL_MQTT_CONN_DISCONNECTING) {
-        return 0;
+    lwcell_core_lock();
+    for (lwcell_mqtt_client_p* c = &mgr->clients; *c != NULL; c = &(*c)->mgr_next) {
+        if (*c == client) {
+            *c = client->mgr_next;
+            break;
+        }
     }
-
-    /*
-     * Check for keep-alive time if equal or greater than
-     * keep alive time. In that case, send packet
-     * to make sure we are still alive
-     */
-    if (client->info->keep_alive /* Keep alive must be enabled */
-        /* Poll time is in units of LWCELL_CFG_CONN_POLL_INTERVAL milliseconds,
-           while keep_alive is in units of seconds */
-        && (client->poll_time * LWCELL_CFG_CONN_POLL_INTERVAL) >= (uint32_t)(client->info->keep_alive * 1000)) {
-
-        if (prv_output_check_enough_memory(client, 0)) { /* Check if memory available in output buffer */
-            prv_write_fixed_header(client, MQTT_MSG_TYPE_PINGREQ, 0, (lwcell_mqtt_qos_t)0, 0,
-                                   0); /* Write PINGREQ command to output buffer */
-            prv_send_data(client);     /* Force send data */
-            client->poll_time = 0;     /* Reset polling time */
-
-            LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Sending PINGREQ packet\r\n");
-        } else {
-            LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE_WARNING, "[LWCELL MQTT] No memory to send PINGREQ packet\r\n");
+    for (lwcell_mqtt_client_p c = mgr->clients; c != NULL; c = c->mgr_next) {
+        if (c->failover == client) {
+            c->failover = NULL;
         }
     }
-
-    /*
-     * Process all active packets and
-     * check for timeout if there was no reply from MQTT server
-     */
-    return 1;
+    if (mgr->next == client) {
+        mgr->next = client->mgr_next != NULL ? client->mgr_next : mgr->clients;
+    }
+    mgr->sends -= client->sends;
+    --mgr->clients_cnt;
+    lwcell_core_unlock();
 }
 
+#endif /* LWCELL_CFG_MQTT_MGR || __DOXYGEN__ */
+
 /**
  * \brief           Connection closed callback
  * \param[in]       client: MQTT client
@@ -973,33 +2499,79 @@ prv_mqtt_closed_cb(lwcell_mqtt_client_p client, lwcellr_t res, uint8_t forced) {
     LWCELL_UNUSED(res);
     LWCELL_UNUSED(forced);
 
-    /*
-     * Call user function only if connection was closed
-     * when we are connected or in disconnecting mode
-     */
     client->conn_state = LWCELL_MQTT_CONN_DISCONNECTED; /* Connection is disconnected, ready to be established again */
-    client->evt.evt.disconnect.is_accepted =
-        state == LWCELL_MQTT_CONNECTED || state == LWCELL_MQTT_CONN_DISCONNECTING; /* Set connection state */
-    client->evt.type = LWCELL_MQTT_EVT_DISCONNECT; /* Connection disconnected from server */
-    client->evt_fn(client, &client->evt);         /* Notify upper layer about closed connection */
-    client->conn = NULL;                          /* Reset connection handle */
+    client->conn = NULL;                               /* Reset connection handle */
+#if LWCELL_CFG_MQTT_MGR
+    if (client->failover != NULL) {
+        prv_mgr_migrate(client, client->failover); /* Backup client continues with queued messages */
+    }
+#endif /* LWCELL_CFG_MQTT_MGR */
 
     /* Check all requests */
-    while ((request = prv_request_get_pending(client, -1)) != NULL) {
-        uint8_t status = request->status;
-        void* arg = request->arg;
+    for (size_t i = 0; i < LWCELL_CFG_MQTT_MAX_REQUESTS; ++i) {
+        uint8_t status;
+        void* arg;
+
+        request = &client->requests[i];
+        status = request->status;
+        arg = request->arg;
+        if (!(status & MQTT_REQUEST_FLAG_IN_USE)) {
+            continue;
+        }
 
+        /* Unacknowledged publish is sent again when persistent session is resumed */
+        if (client->info->persistent_session && (status & MQTT_REQUEST_FLAG_PUBLISH_QOS)
+            && (request->packet != NULL || (status & MQTT_REQUEST_FLAG_PUBREL))) {
+            if (!(status & MQTT_REQUEST_FLAG_RESEND)) {
+                request->status |= MQTT_REQUEST_FLAG_RESEND;
+                ++client->resends;
+            }
+            continue;
+        }
         prv_request_delete(client, request);                /* Delete request */
         prv_request_send_err_callback(client, status, arg); /* Send error callback to user */
     }
-    LWCELL_MEMSET(client->requests, 0x00, sizeof(client->requests));
+#if LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT
+    if (client->is_retransmit_armed) {
+        lwcell_timeout_remove_arg(prv_retransmit_timeout_fn, client);
+        client->is_retransmit_armed = 0;
+    }
+#endif /* LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT */
+    if (client->is_keep_alive_armed) {
+        lwcell_timeout_remove_arg(prv_keep_alive_timeout_fn, client);
+        client->is_keep_alive_armed = 0;
+    }
 
-    client->is_sending = client->sent_total = client->written_total = 0;
+    if (client->parser_state == MQTT_PARSER_STATE_STREAM) {
+        prv_publish_stream_end(client, lwcellCLOSED); /* Application must discard partial payload */
+    }
+#if LWCELL_CFG_MQTT_MGR
+    if (client->mgr != NULL) {
+        client->mgr->sends -= client->sends;
+        client->is_send_waiting = 0;
+    }
+#endif /* LWCELL_CFG_MQTT_MGR */
+    client->sends = client->sent_total = client->written_total = 0;
+    client->is_streaming = 0;
+    client->stream_left = 0;
+    client->acks_cnt = 0;
     client->parser_state = MQTT_PARSER_STATE_INIT;
     lwcell_buff_reset(&client->tx_buff); /* Reset TX buffer */
+#if LWCELL_CFG_MQTT_MGR
+    if (client->mgr != NULL) {
+        prv_mgr_schedule(client->mgr); /* Sends of closed connection are available to other clients */
+    }
+#endif /* LWCELL_CFG_MQTT_MGR */
 
-    LWCELL_UNUSED(forced);
-
+    /*
+     * Notify user as last step, client may be deleted
+     * by other thread as soon as disconnect event is received
+     */
+    client->evt.evt.disconnect.is_accepted =
+        state == LWCELL_MQTT_CONNECTED || state == LWCELL_MQTT_CONN_DISCONNECTING; /* Set connection state */
+    client->evt.evt.disconnect.reason = client->disconnect_reason;
+    client->evt.type = LWCELL_MQTT_EVT_DISCONNECT; /* Connection disconnected from server */
+    client->evt_fn(client, &client->evt);         /* Notify upper layer about closed connection */
     return 1;
 }
 
@@ -1034,9 +2606,16 @@ prv_mqtt_conn_cb(lwcell_evt_t* evt) {
             lwcell_mqtt_client_p client;
             if ((client = lwcell_evt_conn_error_get_arg(evt)) != NULL) {
                 client->conn_state = LWCELL_MQTT_CONN_DISCONNECTED; /* Set back to disconnected state */
+#if LWCELL_CFG_MQTT_MGR
+                if (client->failover != NULL) {
+                    prv_mgr_migrate(client, client->failover); /* Stored messages go to backup client */
+                }
+#endif /* LWCELL_CFG_MQTT_MGR */
                 /* Notify user upper layer */
                 client->evt.type = LWCELL_MQTT_EVT_CONNECT;
                 client->evt.evt.connect.status = LWCELL_MQTT_CONN_STATUS_TCP_FAILED; /* TCP connection failed */
+                client->evt.evt.connect.session_present = 0;
+                client->evt.evt.connect.reason = 0;
                 client->evt_fn(client, &client->evt); /* Notify upper layer about closed connection */
             }
             break;
@@ -1061,12 +2640,6 @@ prv_mqtt_conn_cb(lwcell_evt_t* evt) {
             break;
         }
 
-        /* Periodic poll for connection */
-        case LWCELL_EVT_CONN_POLL: {
-            prv_mqtt_poll_cb(client);
-            break;
-        }
-
         /* Connection closed */
         case LWCELL_EVT_CONN_CLOSE: {
             prv_mqtt_closed_cb(client, lwcell_evt_conn_close_get_result(evt) == lwcellOK,
@@ -1113,8 +2686,22 @@ lwcell_mqtt_client_new(size_t tx_buff_len, size_t rx_buff_len) {
 void
 lwcell_mqtt_client_delete(lwcell_mqtt_client_p client) {
     if (client != NULL) {
-        lwcell_mem_free_s((void**)&client->rx_buff);
-        lwcell_buff_free(&client->tx_buff);
+        for (size_t i = 0; i < LWCELL_CFG_MQTT_MAX_REQUESTS; ++i) {
+            lwcell_mem_free_s((void**)&client->requests[i].packet); /* Packets kept for persistent session */
+        }
+        prv_subs_free(client);
+#if LWCELL_CFG_MQTT_V5 && LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX
+        prv_topic_alias_delete(client, 1);
+#endif /* LWCELL_CFG_MQTT_V5 && LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX */
+#if LWCELL_CFG_MQTT_MGR
+        if (client->mgr != NULL) {
+            prv_mgr_unlink(client); /* Buffers are part of manager pool, region is free again */
+        } else
+#endif /* LWCELL_CFG_MQTT_MGR */
+        {
+            lwcell_mem_free_s((void**)&client->rx_buff);
+            lwcell_buff_free(&client->tx_buff);
+        }
         lwcell_mem_free_s((void**)&client);
     }
 }
@@ -1139,10 +2726,19 @@ lwcell_mqtt_client_connect(lwcell_mqtt_client_p client, const char* host, lwcell
     LWCELL_ASSERT(port > 0);
     LWCELL_ASSERT(info != NULL);
 
+#if !LWCELL_CFG_MQTT_V5
+    if (info->version == 5) { /* MQTT 5.0 is not enabled */
+        return lwcellERR;
+    }
+#endif /* !LWCELL_CFG_MQTT_V5 */
+
     lwcell_core_lock();
     if (lwcell_network_is_attached(LWCELL_PDP_SOCKET) && client->conn_state == LWCELL_MQTT_CONN_DISCONNECTED) {
         client->info = info; /* Save client info parameters */
         client->evt_fn = evt_fn != NULL ? evt_fn : prv_mqtt_evt_fn_default;
+#if LWCELL_CFG_MQTT_V5
+        client->is_v5 = info->version == 5;
+#endif /* LWCELL_CFG_MQTT_V5 */
 
         /* Start a new connection in non-blocking mode */
         if ((res = lwcell_conn_start(&client->conn, LWCELL_CONN_TYPE_TCP, host, port, client, prv_mqtt_conn_cb, 0))
@@ -1181,7 +2777,32 @@ lwcell_mqtt_client_disconnect(lwcell_mqtt_client_p client) {
  */
 lwcellr_t
 lwcell_mqtt_client_subscribe(lwcell_mqtt_client_p client, const char* topic, lwcell_mqtt_qos_t qos, void* arg) {
-    return prv_sub_unsub(client, topic, qos, arg, 1) == 1 ? lwcellOK : lwcellERR; /* Subscribe to topic */
+    return prv_sub_unsub(client, topic, qos, NULL, NULL, arg, 1) == 1 ? lwcellOK : lwcellERR; /* Subscribe to topic */
+}
+
+/**
+ * \brief           Subscribe to MQTT topic with handler for received messages.
+ *
+ * Received publish messages with topic matching topic filter are passed to `fn` instead of client callback,
+ * \ref LWCELL_MQTT_EVT_PUBLISH_RECV is sent to client callback only when no filter matches.
+ * Topic filter may contain `+` and `#` wildcards, every matching handler is called.
+ *
+ * \note            Handler is removed on unsubscribe and when clean session starts
+ * \note            Messages received in fragments are not routed,
+ *                      \ref LWCELL_MQTT_EVT_PUBLISH_RECV_START and following events go to client callback
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic filter to subscribe to
+ * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwcell_mqtt_qos_t
+ * \param[in]       fn: Handler for received messages, called from the same context as client callback.
+ *                      Set to `NULL` to pass messages to client callback
+ * \param[in]       fn_arg: Custom argument passed to handler
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_mqtt_client_subscribe_ex(lwcell_mqtt_client_p client, const char* topic, lwcell_mqtt_qos_t qos,
+                                lwcell_mqtt_sub_fn fn, void* fn_arg, void* arg) {
+    return prv_sub_unsub(client, topic, qos, fn, fn_arg, arg, 1) == 1 ? lwcellOK : lwcellERR;
 }
 
 /**
@@ -1193,8 +2814,9 @@ lwcell_mqtt_client_subscribe(lwcell_mqtt_client_p client, const char* topic, lwc
  */
 lwcellr_t
 lwcell_mqtt_client_unsubscribe(lwcell_mqtt_client_p client, const char* topic, void* arg) {
-    return prv_sub_unsub(client, topic, (lwcell_mqtt_qos_t)0, arg, 0) == 1 ? lwcellOK
-                                                                          : lwcellERR; /* Unsubscribe from topic */
+    return prv_sub_unsub(client, topic, (lwcell_mqtt_qos_t)0, NULL, NULL, arg, 0) == 1
+               ? lwcellOK
+               : lwcellERR; /* Unsubscribe from topic */
 }
 
 /**
@@ -1204,8 +2826,13 @@ lwcell_mqtt_client_unsubscribe(lwcell_mqtt_client_p client, const char* topic, v
  * \param[in]       payload: Message data
  * \param[in]       payload_len: Length of payload data
  * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwcell_mqtt_qos_t enumeration
- * \param[in]       retain: Retian parameter value
+ * \param[in]       retain: Retain parameter value
  * \param[in]       arg: User custom argument used in callback
+ * \note            When message store is set with \ref lwcell_mqtt_client_set_store,
+ *                  `QoS > 0` messages that cannot be sent immediately are stored and sent later in the same order,
+ *                  also when client is not connected
+ * \note            Message with raw packet longer than `65535` bytes is rejected with \ref lwcellERRPAR,
+ *                  use \ref lwcell_mqtt_client_publish_begin for it
  * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
  */
 lwcellr_t
@@ -1213,9 +2840,9 @@ lwcell_mqtt_client_publish(lwcell_mqtt_client_p client, const char* topic, const
                           lwcell_mqtt_qos_t qos, uint8_t retain, void* arg) {
     lwcellr_t res = lwcellOK;
     lwcell_mqtt_request_t* request = NULL;
-    uint32_t rem_len, raw_len;
-    uint16_t len_topic, pkt_id;
-    uint8_t qos_u8 = LWCELL_U8(qos);
+    uint32_t rem_len, raw_len, send_len;
+    uint16_t len_topic, pkt_id, alias = 0;
+    uint8_t qos_u8 = LWCELL_MIN(LWCELL_U8(qos), LWCELL_U8(LWCELL_MQTT_QOS_EXACTLY_ONCE)), use_store, alias_new = 0;
 
     if ((len_topic = LWCELL_U16(strlen(topic))) == 0) { /* Topic length */
         return lwcellERR;
@@ -1225,47 +2852,262 @@ lwcell_mqtt_client_publish(lwcell_mqtt_client_p client, const char* topic, const
      * Calculate remaining length of packet
      *
      * rem_len = 2 (topic_len) + topic_len + payload_len + 2 (pkt_id, only if qos > 0)
+     *              + 1 (properties length, MQTT 5.0)
      */
     rem_len = 2 + len_topic + (payload != NULL ? payload_len : 0) + (qos_u8 > 0 ? 2 : 0);
 
     lwcell_core_lock();
-    if (client->conn_state != LWCELL_MQTT_CONNECTED) {
+    rem_len += MQTT_IS_V5(client);
+    send_len = rem_len;
+#if LWCELL_CFG_MQTT_V5 && LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX
+    if (client->is_v5 && client->conn_state == LWCELL_MQTT_CONNECTED
+        && (alias = prv_topic_alias_get(client, topic, len_topic, &alias_new)) > 0) {
+        send_len += 3; /* Topic alias property */
+        if (!alias_new) {
+            send_len -= len_topic; /* Alias known to server replaces topic string */
+        }
+    }
+#endif /* LWCELL_CFG_MQTT_V5 && LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX */
+    use_store = qos_u8 > 0 && client->store != NULL;
+    if (use_store) {
+        prv_output_pending(client); /* Messages stored before must be sent first */
+    }
+    if (prv_get_raw_len(LWCELL_MAX(rem_len, send_len)) > UINT16_MAX) {
+        /* Length of packet copy for retransmission and store is 16-bit */
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE_WARNING, "[LWCELL MQTT] Publish message too long\r\n");
+        res = lwcellERRPAR;
+    } else if (prv_is_packet_too_big(client, LWCELL_MAX(rem_len, send_len))) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE_WARNING, "[LWCELL MQTT] Publish message exceeds server packet size\r\n");
+        res = lwcellERR;
+    } else if (use_store
+               && (client->conn_state != LWCELL_MQTT_CONNECTED || client->store_pending || client->resends > 0
+                   || client->inflight >= MQTT_INFLIGHT_MAX(client)
+                   || !prv_output_check_enough_memory(client, rem_len))) {
+        /* Cannot be sent now, it is sent from the store later */
+        res = prv_store_push(client, topic, len_topic, payload, payload_len, qos_u8, retain, arg);
+    } else if (client->conn_state != LWCELL_MQTT_CONNECTED) {
         res = lwcellCLOSED;
-    } else if ((raw_len = prv_output_check_enough_memory(client, rem_len)) != 0) {
-        pkt_id = qos_u8 > 0 ? prv_create_packet_id(client) : 0; /* Create new packet ID */
-        request = prv_request_create(client, pkt_id, arg);      /* Create request for packet */
+    } else if (qos_u8 > 0 && client->inflight >= MQTT_INFLIGHT_MAX(client)) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Too many messages waiting for acknowledge\r\n");
+        res = lwcellERRMEM;
+    } else if ((raw_len = prv_output_check_enough_memory(client, send_len)) != 0) {
+        request = prv_request_create(client, qos_u8 > 0, arg); /* Create request for packet */
+
+        /*
+         * Keep copy of packet to send it again if not acknowledged.
+         * Copy always carries topic string without topic alias,
+         * as it may be sent on next connection where aliases are not known to server
+         */
+        if (request != NULL && qos_u8 > 0
+            && (LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT > 0 || client->info->persistent_session)
+            && (request->packet = lwcell_mem_malloc(prv_get_raw_len(rem_len))) == NULL) {
+            prv_request_delete(client, request);
+            request = NULL;
+        }
         if (request != NULL) {
+            pkt_id = request->packet_id;
             /*
              * Set expected number of bytes we should send before
              * we can say that this packet was sent.
              * Used in case QoS is set to 0 where packet notification
              * is not received by server. In this case, wait
-             * number of bytes sent before notifying user about success
+             * number of bytes sent before notifying user about success.
+             * Data still waiting in buffer, queued or not, are sent before this packet.
              */
-            request->expected_sent_len = client->written_total + raw_len;
+            request->expected_sent_len = client->sent_total + lwcell_buff_get_full(&client->tx_buff) + raw_len;
 
-            prv_write_fixed_header(client, MQTT_MSG_TYPE_PUBLISH, 0,
-                                   (lwcell_mqtt_qos_t)LWCELL_MIN(qos_u8, LWCELL_U8(LWCELL_MQTT_QOS_EXACTLY_ONCE)), retain,
-                                   rem_len);
-            prv_write_string(client, topic, len_topic); /* Write topic string to packet */
+            prv_write_fixed_header(client, MQTT_MSG_TYPE_PUBLISH, 0, (lwcell_mqtt_qos_t)qos_u8, retain, send_len);
+            if (alias > 0 && !alias_new) {
+                prv_write_u16(client, 0); /* Empty topic, server uses topic of alias */
+            } else {
+                prv_write_string(client, topic, len_topic); /* Write topic string to packet */
+            }
             if (qos_u8) {
                 prv_write_u16(client, pkt_id); /* Write packet ID */
             }
+            if (MQTT_IS_V5(client)) {
+                prv_write_u8(client, alias > 0 ? 3 : 0); /* Properties length */
+                if (alias > 0) {
+                    prv_write_u8(client, MQTT_PROP_TOPIC_ALIAS);
+                    prv_write_u16(client, alias);
+                }
+            }
             if (payload != NULL && payload_len) {
                 prv_write_data(client, payload, payload_len); /* Write RAW topic payload */
             }
+            if (qos_u8 > 0) {
+                request->status |= MQTT_REQUEST_FLAG_PUBLISH_QOS;
+                ++client->inflight;
+                if (request->packet != NULL) {
+                    request->packet_len = LWCELL_U16(prv_publish_encode(
+                        request->packet,
+                        LWCELL_U8(MQTT_MSG_TYPE_PUBLISH) << 0x04 | qos_u8 << 0x01 | LWCELL_U8(!!retain), topic,
+                        len_topic, pkt_id, MQTT_IS_V5(client), payload, payload != NULL ? payload_len : 0));
+                }
+#if LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT
+                prv_retransmit_start(client, LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT);
+#endif /* LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT */
+            }
             prv_request_set_pending(client, request); /* Set request as pending waiting for server reply */
             prv_send_data(client);                    /* Try to send data */
             LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Pkt publish start. QoS: %d, pkt_id: %d\r\n",
                          (int)qos_u8, (int)pkt_id);
         } else {
             LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] No free request available to publish message\r\n");
-            res = lwcellERRMEM;
+            res = use_store
+                      ? prv_store_push(client, topic, len_topic, payload, payload_len, qos_u8, retain, arg)
+                      : lwcellERRMEM;
         }
     } else {
         LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Not enough memory to publish message\r\n");
         res = lwcellERRMEM;
     }
+#if LWCELL_CFG_MQTT_V5 && LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX
+    if (alias_new && request == NULL) {
+        prv_topic_alias_delete(client, alias); /* Server did not receive the alias */
+    }
+#endif /* LWCELL_CFG_MQTT_V5 && LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX */
+    lwcell_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Start publish message with payload written in parts.
+ *
+ * Fixed header, topic and packet ID are written immediately, only they must fit to TX buffer.
+ * Payload is then written with \ref lwcell_mqtt_client_publish_write as TX buffer is sent,
+ * \ref LWCELL_MQTT_EVT_PUBLISH_WRITE event reports when more payload can be written.
+ * Message is finished with \ref lwcell_mqtt_client_publish_end.
+ * Other packets, such as publish messages and acknowledges, wait until message is finished.
+ *
+ * \note            Message with `QoS > 0` is not kept for retransmission and is not resumed with persistent session,
+ *                  it fails with \ref LWCELL_MQTT_EVT_PUBLISH event when connection closes before acknowledge
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       payload_len: Total length of payload in units of bytes
+ * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwcell_mqtt_qos_t enumeration
+ * \param[in]       retain: Retian parameter value
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_mqtt_client_publish_begin(lwcell_mqtt_client_p client, const char* topic, uint32_t payload_len,
+                                 lwcell_mqtt_qos_t qos, uint8_t retain, void* arg) {
+    lwcell_mqtt_request_t* request;
+    lwcellr_t res = lwcellOK;
+    uint32_t rem_len, raw_len;
+    uint16_t len_topic;
+    uint8_t qos_u8 = LWCELL_MIN(LWCELL_U8(qos), LWCELL_U8(LWCELL_MQTT_QOS_EXACTLY_ONCE));
+
+    if ((len_topic = LWCELL_U16(strlen(topic))) == 0 || payload_len > MQTT_MAX_REM_LEN - 5 - len_topic) {
+        return lwcellERRPAR;
+    }
+
+    lwcell_core_lock();
+    rem_len = 2 + len_topic + (qos_u8 > 0 ? 2 : 0) + MQTT_IS_V5(client) + payload_len;
+    raw_len = prv_get_raw_len(rem_len);
+    if (client->conn_state != LWCELL_MQTT_CONNECTED) {
+        res = lwcellCLOSED;
+    } else if (client->is_streaming) {
+        res = lwcellINPROG;
+    } else if (prv_is_packet_too_big(client, rem_len)) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE_WARNING, "[LWCELL MQTT] Publish message exceeds server packet size\r\n");
+        res = lwcellERR;
+    } else if ((qos_u8 > 0 && (client->inflight >= MQTT_INFLIGHT_MAX(client) || client->store_pending))
+               || client->acks_cnt > 0
+               || lwcell_buff_get_free(&client->tx_buff) < raw_len - payload_len
+               || (request = prv_request_create(client, qos_u8 > 0, arg)) == NULL) {
+        res = lwcellERRMEM;
+    } else {
+        /* Request is finished when all bytes, including payload not written yet, are sent */
+        request->expected_sent_len = client->sent_total + lwcell_buff_get_full(&client->tx_buff) + raw_len;
+
+        prv_write_fixed_header(client, MQTT_MSG_TYPE_PUBLISH, 0, (lwcell_mqtt_qos_t)qos_u8, retain, rem_len);
+        prv_write_string(client, topic, len_topic);
+        if (qos_u8 > 0) {
+            prv_write_u16(client, request->packet_id);
+            request->status |= MQTT_REQUEST_FLAG_PUBLISH_QOS;
+            ++client->inflight;
+        }
+        if (MQTT_IS_V5(client)) {
+            prv_write_u8(client, 0); /* Properties length */
+        }
+        client->is_streaming = 1;
+        client->stream_left = payload_len;
+        client->stream_arg = arg;
+        prv_request_set_pending(client, request);
+        prv_send_data(client);
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Pkt publish stream start. QoS: %d, len: %d\r\n",
+                     (int)qos_u8, (int)payload_len);
+    }
+    lwcell_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Write part of payload of message started with \ref lwcell_mqtt_client_publish_begin
+ *
+ * Data are copied to TX buffer, as much as it has free space.
+ * Call function again on \ref LWCELL_MQTT_EVT_PUBLISH_WRITE event to write the rest.
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       data: Payload data to write
+ * \param[in]       len: Length of data, must not exceed number of payload bytes not written yet
+ * \param[out]      bw: Pointer to output variable to save number of bytes written. Can be set to `NULL`
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_mqtt_client_publish_write(lwcell_mqtt_client_p client, const void* data, size_t len, size_t* bw) {
+    lwcellr_t res = lwcellOK;
+    size_t written = 0;
+
+    lwcell_core_lock();
+    if (!client->is_streaming) {
+        res = lwcellERR;
+    } else if (len > client->stream_left) {
+        res = lwcellERRPAR;
+    } else {
+        written = LWCELL_MIN(len, lwcell_buff_get_free(&client->tx_buff));
+        prv_write_data(client, data, written);
+        client->stream_left -= LWCELL_U32(written);
+        prv_send_data(client);
+    }
+    lwcell_core_unlock();
+    if (bw != NULL) {
+        *bw = written;
+    }
+    return res;
+}
+
+/**
+ * \brief           Finish message started with \ref lwcell_mqtt_client_publish_begin.
+ *
+ * When payload was not written completely, message cannot be finished and connection is closed.
+ * Result of publish is reported with \ref LWCELL_MQTT_EVT_PUBLISH event.
+ *
+ * \param[in]       client: MQTT client
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_mqtt_client_publish_end(lwcell_mqtt_client_p client) {
+    lwcellr_t res = lwcellOK;
+
+    lwcell_core_lock();
+    if (!client->is_streaming) {
+        res = lwcellERR;
+    } else {
+        client->is_streaming = 0;
+        if (client->stream_left > 0) {
+            LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE_WARNING,
+                         "[LWCELL MQTT] Publish stream ended %d bytes early. Manually closing down..\r\n",
+                         (int)client->stream_left);
+            prv_mqtt_close(client); /* Request is reported in closed callback */
+            res = lwcellERR;
+        } else {
+            prv_output_pending(client); /* Send packets delayed by the message */
+            prv_send_data(client);
+        }
+    }
     lwcell_core_unlock();
     return res;
 }
@@ -1285,6 +3127,98 @@ lwcell_mqtt_client_is_connected(lwcell_mqtt_client_p client) {
     return res;
 }
 
+/**
+ * \brief           Store record to RAM ring buffer
+ * \param[in]       arg: Ring buffer handle
+ * \param[in]       data: Record data
+ * \param[in]       len: Record length in units of bytes
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+prv_store_ram_push(void* arg, const void* data, size_t len) {
+    lwcell_buff_t* buff = arg;
+
+    if (lwcell_buff_get_free(buff) < sizeof(len) + len) {
+        return lwcellERRMEM;
+    }
+    lwcell_buff_write(buff, &len, sizeof(len)); /* Length prefix */
+    lwcell_buff_write(buff, data, len);
+    return lwcellOK;
+}
+
+/**
+ * \brief           Read oldest record from RAM ring buffer
+ * \param[in]       arg: Ring buffer handle
+ * \param[out]      data: Output memory or `NULL`
+ * \param[in]       size: Size of output memory
+ * \return          Record length, `0` if empty
+ */
+static size_t
+prv_store_ram_peek(void* arg, void* data, size_t size) {
+    lwcell_buff_t* buff = arg;
+    size_t len;
+
+    if (lwcell_buff_peek(buff, 0, &len, sizeof(len)) != sizeof(len)) {
+        return 0;
+    }
+    if (data != NULL) {
+        lwcell_buff_peek(buff, sizeof(len), data, LWCELL_MIN(len, size));
+    }
+    return len;
+}
+
+/**
+ * \brief           Remove oldest record from RAM ring buffer
+ * \param[in]       arg: Ring buffer handle
+ */
+static void
+prv_store_ram_pop(void* arg) {
+    lwcell_buff_t* buff = arg;
+    size_t len;
+
+    if (lwcell_buff_peek(buff, 0, &len, sizeof(len)) == sizeof(len)) {
+        lwcell_buff_skip(buff, sizeof(len) + len);
+    }
+}
+
+/**
+ * \brief           Message store in RAM, using ring buffer.
+ *
+ * Store argument is pointer to \ref lwcell_buff_t, initialized by user with \ref lwcell_buff_init.
+ * Each record uses additional `sizeof(size_t)` bytes of the buffer.
+ */
+const lwcell_mqtt_store_t lwcell_mqtt_store_ram = {
+    .push_fn = prv_store_ram_push,
+    .peek_fn = prv_store_ram_peek,
+    .pop_fn = prv_store_ram_pop,
+};
+
+/**
+ * \brief           Set message store for outgoing `QoS > 0` messages that cannot be sent immediately.
+ *
+ * Stored messages are sent in order as soon as connection, output buffer and in-flight window allow it.
+ * Use together with \ref lwcell_mqtt_client_info_t::persistent_session to keep messages across reconnects.
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       store: Message store functions, set to `NULL` to disable the store.
+ *                      Use \ref lwcell_mqtt_store_ram for RAM ring buffer store
+ * \param[in]       arg: Store argument passed to all store functions
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_mqtt_client_set_store(lwcell_mqtt_client_p client, const lwcell_mqtt_store_t* store, void* arg) {
+    LWCELL_ASSERT(client != NULL);
+    LWCELL_ASSERT(store == NULL || (store->push_fn != NULL && store->peek_fn != NULL && store->pop_fn != NULL));
+
+    lwcell_core_lock();
+    client->store = store;
+    client->store_arg = arg;
+    client->store_pending = store != NULL; /* Store may already have records */
+    prv_output_pending(client);
+    lwcell_core_unlock();
+    return lwcellOK;
+}
+
 /**
  * \brief           Set user argument on client
  * \param[in]       client: MQTT client handle
@@ -1306,3 +3240,169 @@ void*
 lwcell_mqtt_client_get_arg(lwcell_mqtt_client_p client) {
     return client->arg;
 }
+
+#if LWCELL_CFG_MQTT_MGR || __DOXYGEN__
+
+/**
+ * \brief           Create new MQTT client manager
+ * \param[in]       pool_len: Length of memory pool for TX and RX buffers of all manager clients in units of bytes
+ * \return          Manager handle on success, `NULL` otherwise
+ */
+lwcell_mqtt_mgr_p
+lwcell_mqtt_mgr_new(size_t pool_len) {
+    lwcell_mqtt_mgr_p mgr;
+
+    if ((mgr = lwcell_mem_calloc(1, sizeof(*mgr))) != NULL) {
+        mgr->pool_len = pool_len;
+        if ((mgr->pool = lwcell_mem_malloc(pool_len)) == NULL) {
+            lwcell_mem_free_s((void**)&mgr);
+        }
+    }
+    return mgr;
+}
+
+/**
+ * \brief           Delete manager and all its clients
+ * \note            All manager clients must be disconnected
+ * \param[in]       mgr: Manager handle
+ */
+void
+lwcell_mqtt_mgr_delete(lwcell_mqtt_mgr_p mgr) {
+    if (mgr != NULL) {
+        while (mgr->clients != NULL) {
+            lwcell_mqtt_client_delete(mgr->clients);
+        }
+        lwcell_mem_free_s((void**)&mgr->pool);
+        lwcell_mem_free_s((void**)&mgr);
+    }
+}
+
+/**
+ * \brief           Find free region of manager pool
+ *
+ * Region of each client holds its TX buffer followed by RX buffer.
+ * Free region starts at beginning of pool or at end of region of other client,
+ * hence regions of deleted clients are reused, together with free memory next to them.
+ *
+ * \param[in]       mgr: Manager handle
+ * \param[in]       len: Length of region in units of bytes
+ * \return          Lowest offset of free region in pool, `pool_len` when there is none
+ */
+static size_t
+prv_mgr_pool_find(lwcell_mqtt_mgr_p mgr, size_t len) {
+    lwcell_mqtt_client_p c = NULL, o;
+    size_t off, start, best = mgr->pool_len;
+
+    do {
+        off = c != NULL ? (size_t)(c->tx_buff.buff - mgr->pool) + c->tx_buff.size + c->rx_buff_len : 0;
+        if (off < best && len <= mgr->pool_len - off) {
+            for (o = mgr->clients; o != NULL; o = o->mgr_next) {
+                start = (size_t)(o->tx_buff.buff - mgr->pool);
+                if (start < off + len && off < start + o->tx_buff.size + o->rx_buff_len) {
+                    break; /* Overlaps region of other client */
+                }
+            }
+            if (o == NULL) {
+                best = off;
+            }
+        }
+        c = c != NULL ? c->mgr_next : mgr->clients;
+    } while (c != NULL);
+    return best;
+}
+
+/**
+ * \brief           Create new MQTT client owned by manager.
+ *
+ * TX and RX buffers are taken from manager pool and are given back when client is deleted
+ * with \ref lwcell_mqtt_client_delete.
+ * Client is used with the same functions as client created with \ref lwcell_mqtt_client_new
+ *
+ * \param[in]       mgr: Manager handle
+ * \param[in]       tx_buff_len: Length of raw data output buffer
+ * \param[in]       rx_buff_len: Length of raw data input buffer
+ * \param[in]       weight: Send share of client, in blocks of \ref LWCELL_CFG_CONN_MAX_DATA_LEN bytes per round.
+ *                      Value `0` is treated as `1`
+ * \return          Client handle on success, `NULL` otherwise
+ */
+lwcell_mqtt_client_p
+lwcell_mqtt_mgr_client_new(lwcell_mqtt_mgr_p mgr, size_t tx_buff_len, size_t rx_buff_len, uint8_t weight) {
+    lwcell_mqtt_client_p client = NULL, *last;
+    size_t off;
+
+    if (mgr == NULL || tx_buff_len == 0 || rx_buff_len == 0) {
+        return NULL;
+    }
+    lwcell_core_lock();
+    if ((off = prv_mgr_pool_find(mgr, tx_buff_len + rx_buff_len)) < mgr->pool_len
+        && (client = lwcell_mem_calloc(1, sizeof(*client))) != NULL) {
+        client->conn_state = LWCELL_MQTT_CONN_DISCONNECTED;
+        client->tx_buff.buff = &mgr->pool[off];
+        client->tx_buff.size = tx_buff_len;
+        client->rx_buff = &mgr->pool[off + tx_buff_len];
+        client->rx_buff_len = rx_buff_len;
+        client->mgr = mgr;
+        client->mgr_weight = weight > 0 ? weight : 1;
+
+        /* Append to keep scheduling order of creation */
+        for (last = &mgr->clients; *last != NULL; last = &(*last)->mgr_next) {}
+        *last = client;
+        if (mgr->next == NULL) {
+            mgr->next = client;
+        }
+        ++mgr->clients_cnt;
+    }
+    lwcell_core_unlock();
+    return client;
+}
+
+/**
+ * \brief           Set backup client to take over queued messages when client connection closes.
+ *
+ * Unacknowledged messages with packet copy and messages in client store are moved
+ * to store of backup client, see \ref lwcell_mqtt_client_set_store. Backup client sends them
+ * when connected and reports them with its own events. `QoS 2` messages may be delivered twice,
+ * once by each server
+ *
+ * \param[in]       client: Manager client handle
+ * \param[in]       backup: Client of the same manager or `NULL` to disable failover
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t otherwise
+ */
+lwcellr_t
+lwcell_mqtt_mgr_set_failover(lwcell_mqtt_client_p client, lwcell_mqtt_client_p backup) {
+    if (client == NULL || client->mgr == NULL || backup == client
+        || (backup != NULL && backup->mgr != client->mgr)) {
+        return lwcellERRPAR;
+    }
+    lwcell_core_lock();
+    client->failover = backup;
+    lwcell_core_unlock();
+    return lwcellOK;
+}
+
+/**
+ * \brief           Move queued messages of disconnected client to other client of the same manager
+ * \param[in]       from: Disconnected manager client
+ * \param[in]       to: Client with message store to take messages
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t otherwise
+ */
+lwcellr_t
+lwcell_mqtt_mgr_migrate(lwcell_mqtt_client_p from, lwcell_mqtt_client_p to) {
+    lwcellr_t res = lwcellOK;
+
+    if (from == NULL || to == NULL || from == to || from->mgr == NULL || from->mgr != to->mgr) {
+        return lwcellERRPAR;
+    }
+    lwcell_core_lock();
+    if (from->conn_state != LWCELL_MQTT_CONN_DISCONNECTED || to->store == NULL) {
+        res = lwcellERR;
+    } else {
+        prv_mgr_migrate(from, to);
+    }
+    lwcell_core_unlock();
+    return res;
+}
+
+#endif /* LWCELL_CFG_MQTT_MGR || __DOXYGEN__ */
+
+#endif /* !LWCELL_CFG_MQTT || __DOXYGEN__ */
@@ -52,6 +52,8 @@ struct lwcell_mqtt_client_api {
     uint8_t release_sem;                   /*!< Set to `1` to release semaphore */
     lwcell_mqtt_conn_status_t connect_resp; /*!< Response when connecting to server */
     lwcellr_t sub_pub_resp;                 /*!< Subscribe/Unsubscribe/Publish response */
+    lwcell_mqtt_client_api_overflow_t overflow; /*!< Policy when receive queue is full */
+    lwcell_mqtt_client_api_stats_t stats;       /*!< Receive statistics */
 } lwcell_mqtt_client_api_t;
 
 /**
@@ -71,6 +73,38 @@ prv_release_sem(lwcell_mqtt_client_api_p client) {
     }
 }
 
+/**
+ * \brief           Put entry to receive queue, applying overflow policy when queue is full
+ * \param[in]       client: Client handle
+ * \param[in]       msg: Received buffer or closed event entry
+ * \return          `1` if entry was put to queue, `0` otherwise
+ */
+static uint8_t
+prv_rcv_put(lwcell_mqtt_client_api_p client, void* msg) {
+    void* old;
+
+    if (lwcell_sys_mbox_putnow(&client->rcv_mbox, msg)) {
+        return 1;
+    }
+    switch (client->overflow) {
+        case LWCELL_MQTT_CLIENT_API_OVERFLOW_DROP_OLDEST: {
+            /* Receiving thread may empty the queue meanwhile */
+            do {
+                if (lwcell_sys_mbox_getnow(&client->rcv_mbox, &old)) {
+                    if ((uint8_t*)old != (uint8_t*)&mqtt_closed) {
+                        lwcell_mqtt_client_api_buf_free(old);
+                    }
+                    ++client->stats.dropped_oldest;
+                }
+            } while (!lwcell_sys_mbox_putnow(&client->rcv_mbox, msg));
+            return 1;
+        }
+        default: break;
+    }
+    ++client->stats.dropped_newest;
+    return 0;
+}
+
 /**
  * \brief           MQTT event callback function
  */
@@ -117,36 +151,52 @@ prv_mqtt_evt(lwcell_mqtt_client_p client, lwcell_mqtt_evt_t* evt) {
             const uint8_t* payload = lwcell_mqtt_client_evt_publish_recv_get_payload(client, evt);
             size_t payload_len = lwcell_mqtt_client_evt_publish_recv_get_payload_len(client, evt);
             lwcell_mqtt_qos_t qos = lwcell_mqtt_client_evt_publish_recv_get_qos(client, evt);
+#if LWCELL_CFG_MQTT_API_ZERO_COPY
+            lwcell_pbuf_p pbuf = lwcell_mqtt_client_evt_publish_recv_get_pbuf(client, evt);
+#else  /* LWCELL_CFG_MQTT_API_ZERO_COPY */
+            lwcell_pbuf_p pbuf = NULL;
+#endif /* !LWCELL_CFG_MQTT_API_ZERO_COPY */
 
             /* Print debug message */
             LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_API_TRACE, "[MQTT API] New publish received on topic %.*s\r\n",
                          (int)topic_len, topic);
 
-            /* Calculate memory sizes */
+            /* Calculate memory sizes, payload in packet buffer is only referenced */
             buf_size = LWCELL_MEM_ALIGN(sizeof(*buf));
             topic_size = LWCELL_MEM_ALIGN(sizeof(*topic) * (topic_len + 1));
-            payload_size = LWCELL_MEM_ALIGN(sizeof(*payload) * (payload_len + 1));
+            payload_size = pbuf != NULL ? 0 : LWCELL_MEM_ALIGN(sizeof(*payload) * (payload_len + 1));
 
             size = buf_size + topic_size + payload_size;
             if ((buf = lwcell_mem_malloc(size)) != NULL) {
                 LWCELL_MEMSET(buf, 0x00, size);
                 buf->topic = (void*)((uint8_t*)buf + buf_size);
-                buf->payload = (void*)((uint8_t*)buf + buf_size + topic_size);
                 buf->topic_len = topic_len;
                 buf->payload_len = payload_len;
                 buf->qos = qos;
 
                 /* Copy content to new memory */
                 LWCELL_MEMCPY(buf->topic, topic, sizeof(*topic) * topic_len);
-                LWCELL_MEMCPY(buf->payload, payload, sizeof(*payload) * payload_len);
+                if (pbuf != NULL && lwcell_pbuf_ref(pbuf) == lwcellOK) {
+                    buf->payload = (uint8_t*)payload;
+                    buf->pbuf = pbuf;
+                } else {
+                    buf->payload = (void*)((uint8_t*)buf + buf_size + topic_size);
+                    LWCELL_MEMCPY(buf->payload, payload, sizeof(*payload) * payload_len);
+                }
 
                 /* Write to receive queue */
-                if (!lwcell_sys_mbox_putnow(&api_client->rcv_mbox, buf)) {
+                if (prv_rcv_put(api_client, buf)) {
+                    ++api_client->stats.received;
+                    if (buf->pbuf != NULL) {
+                        ++api_client->stats.zero_copy;
+                    }
+                } else {
                     LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_API_TRACE_WARNING,
                                  "[MQTT API] Cannot put new received MQTT publish to queue\r\n");
-                    lwcell_mem_free_s((void**)&buf);
+                    lwcell_mqtt_client_api_buf_free(buf);
                 }
             } else {
+                ++api_client->stats.dropped_mem;
                 LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_API_TRACE_WARNING,
                              "[MQTT API] Cannot allocate memory for packet buffer of size %d bytes\r\n", (int)size);
             }
@@ -183,7 +233,7 @@ prv_mqtt_evt(lwcell_mqtt_client_p client, lwcell_mqtt_evt_t* evt) {
 
             /* Write to receive mbox to wakeup receive thread */
             if (is_accepted && lwcell_sys_mbox_isvalid(&api_client->rcv_mbox)) {
-                lwcell_sys_mbox_putnow(&api_client->rcv_mbox, &mqtt_closed);
+                prv_rcv_put(api_client, &mqtt_closed);
             }
             prv_release_sem(api_client); /* Release semaphore */
             break;
@@ -334,6 +384,27 @@ lwcell_mqtt_client_api_close(lwcell_mqtt_client_api_p client) {
  */
 lwcellr_t
 lwcell_mqtt_client_api_subscribe(lwcell_mqtt_client_api_p client, const char* topic, lwcell_mqtt_qos_t qos) {
+    return lwcell_mqtt_client_api_subscribe_ex(client, topic, qos, NULL, NULL);
+}
+
+/**
+ * \brief           Subscribe to topic with handler for received messages.
+ *
+ * Messages matching topic filter are passed to handler and are not available
+ * with \ref lwcell_mqtt_client_api_receive.
+ *
+ * \note            Handler is called from the stack thread and must not call blocking API functions
+ * \param[in]       client: MQTT API client handle
+ * \param[in]       topic: Topic filter to subscribe on, may contain `+` and `#` wildcards
+ * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwcell_mqtt_qos_t
+ * \param[in]       fn: Handler for received messages. Set to `NULL` to receive them with
+ *                      \ref lwcell_mqtt_client_api_receive
+ * \param[in]       arg: Custom argument passed to handler
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t otherwise
+ */
+lwcellr_t
+lwcell_mqtt_client_api_subscribe_ex(lwcell_mqtt_client_api_p client, const char* topic, lwcell_mqtt_qos_t qos,
+                                    lwcell_mqtt_sub_fn fn, void* arg) {
     lwcellr_t res = lwcellERR;
 
     LWCELL_ASSERT(client != NULL);
@@ -342,7 +413,7 @@ lwcell_mqtt_client_api_subscribe(lwcell_mqtt_client_api_p client, const char* to
     lwcell_sys_mutex_lock(&client->mutex);
     lwcell_sys_sem_wait(&client->sync_sem, 0);
     client->release_sem = 1;
-    if (lwcell_mqtt_client_subscribe(client->mc, topic, qos, NULL) == lwcellOK) {
+    if (lwcell_mqtt_client_subscribe_ex(client->mc, topic, qos, fn, arg, NULL) == lwcellOK) {
         lwcell_sys_sem_wait(&client->sync_sem, 0);
         res = client->sub_pub_resp;
     } else {
@@ -481,5 +552,42 @@ lwcell_mqtt_client_api_receive(lwcell_mqtt_client_api_p client, lwcell_mqtt_clie
  */
 void
 lwcell_mqtt_client_api_buf_free(lwcell_mqtt_client_api_buf_p p) {
+    if (p != NULL && p->pbuf != NULL) {
+        lwcell_pbuf_free_s(&p->pbuf); /* Release referenced packet buffer */
+    }
     lwcell_mem_free_s((void**)&p);
 }
+
+/**
+ * \brief           Set policy for received messages when receive queue is full
+ * \param[in]       client: MQTT API client handle
+ * \param[in]       overflow: Overflow policy. This parameter can be a value of \ref lwcell_mqtt_client_api_overflow_t
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t otherwise
+ */
+lwcellr_t
+lwcell_mqtt_client_api_set_overflow(lwcell_mqtt_client_api_p client, lwcell_mqtt_client_api_overflow_t overflow) {
+    LWCELL_ASSERT(client != NULL);
+    LWCELL_ASSERT(overflow <= LWCELL_MQTT_CLIENT_API_OVERFLOW_DROP_OLDEST);
+
+    lwcell_core_lock();
+    client->overflow = overflow;
+    lwcell_core_unlock();
+    return lwcellOK;
+}
+
+/**
+ * \brief           Get receive statistics with drop counters
+ * \param[in]       client: MQTT API client handle
+ * \param[out]      stats: Pointer to output statistics structure
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t otherwise
+ */
+lwcellr_t
+lwcell_mqtt_client_api_get_stats(lwcell_mqtt_client_api_p client, lwcell_mqtt_client_api_stats_t* stats) {
+    LWCELL_ASSERT(client != NULL);
+    LWCELL_ASSERT(stats != NULL);
+
+    lwcell_core_lock();
+    *stats = client->stats;
+    lwcell_core_unlock();
+    return lwcellOK;
+}
@@ -0,0 +1,647 @@
+/**
+ * \file            lwcell_mqtt_client_native.c
+ * \brief           MQTT client over native MQTT of device
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "lwcell/apps/lwcell_mqtt_client.h"
+#include "lwcell/lwcell.h"
+#include "lwcell/lwcell_private.h"
+
+#if LWCELL_CFG_MQTT || __DOXYGEN__
+
+#if !LWCELL_CFG_NETWORK
+#error "LWCELL_CFG_NETWORK must be enabled for native MQTT!"
+#endif /* !LWCELL_CFG_NETWORK */
+
+#if !LWCELL_CFG_USE_API_FUNC_EVT
+#error "LWCELL_CFG_USE_API_FUNC_EVT must be enabled for native MQTT!"
+#endif /* !LWCELL_CFG_USE_API_FUNC_EVT */
+
+struct lwcell_mqtt_client;
+
+/**
+ * \brief           MQTT request object, waiting for device to execute command
+ */
+typedef struct {
+    uint8_t status;                    /*!< Entry status flag for in use and request type */
+    struct lwcell_mqtt_client* client; /*!< MQTT client which created request */
+    void* arg;                         /*!< User defined argument */
+    char* data;                        /*!< Copy of topic and payload, valid until command is executed */
+} lwcell_mqtt_native_request_t;
+
+/**
+ * \brief           MQTT client connection
+ */
+typedef struct lwcell_mqtt_client {
+    const lwcell_mqtt_client_info_t* info; /*!< Connection info */
+    lwcell_mqtt_state_t conn_state;        /*!< MQTT connection state */
+
+    lwcell_mqtt_evt_t evt;     /*!< MQTT event callback */
+    lwcell_mqtt_evt_fn evt_fn; /*!< Event callback function */
+
+    size_t tx_buff_len; /*!< Maximal length of topic and payload of published message */
+
+    lwcell_mqtt_native_request_t requests[LWCELL_CFG_MQTT_MAX_REQUESTS]; /*!< List of requests */
+
+    uint8_t* rx_buff;   /*!< Buffer for topic and payload of received message */
+    size_t rx_buff_len; /*!< Length of RX buffer */
+
+    void* arg; /*!< User argument */
+} lwcell_mqtt_client_t;
+
+/* Tracing debug message */
+#define LWCELL_CFG_DBG_MQTT_TRACE       (LWCELL_CFG_DBG_MQTT | LWCELL_DBG_TYPE_TRACE)
+
+/* Requests status */
+#define MQTT_REQUEST_FLAG_IN_USE        0x01 /*!< Request object is allocated and in use */
+#define MQTT_REQUEST_FLAG_SUBSCRIBE     0x04 /*!< Request object has subscribe type */
+#define MQTT_REQUEST_FLAG_UNSUBSCRIBE   0x08 /*!< Request object has unsubscribe type */
+
+/**
+ * \brief           Default event callback function
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: MQTT event
+ */
+static void
+prv_mqtt_evt_fn_default(lwcell_mqtt_client_p client, lwcell_mqtt_evt_t* evt) {
+    LWCELL_UNUSED(client);
+    LWCELL_UNUSED(evt);
+}
+
+/**
+ * \brief           Set client to disconnected state and notify user
+ * \param[in]       client: MQTT client
+ */
+static void
+prv_mqtt_closed(lwcell_mqtt_client_p client) {
+    lwcell_mqtt_state_t state = client->conn_state;
+
+    client->conn_state = LWCELL_MQTT_CONN_DISCONNECTED; /* Ready to be connected again */
+    client->evt.evt.disconnect.is_accepted = state == LWCELL_MQTT_CONNECTED || state == LWCELL_MQTT_CONN_DISCONNECTING;
+    client->evt.evt.disconnect.reason = 0;
+    client->evt.type = LWCELL_MQTT_EVT_DISCONNECT;
+    client->evt_fn(client, &client->evt);
+}
+
+/**
+ * \brief           Message received on native session
+ * \param[in]       topic: Topic name
+ * \param[in]       topic_len: Length of topic name
+ * \param[in]       payload: Message payload
+ * \param[in]       payload_len: Length of payload
+ * \param[in]       arg: MQTT client
+ */
+static void
+prv_session_recv_fn(const char* topic, size_t topic_len, const void* payload, size_t payload_len, void* arg) {
+    lwcell_mqtt_client_p client = arg;
+
+    LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Publish received on topic %.*s, %d byte(s)\r\n",
+                  (int)topic_len, topic, (int)payload_len);
+
+    client->evt.type = LWCELL_MQTT_EVT_PUBLISH_RECV;
+    client->evt.evt.publish_recv.topic = (const uint8_t*)topic;
+    client->evt.evt.publish_recv.topic_len = topic_len;
+    client->evt.evt.publish_recv.payload = payload;
+    client->evt.evt.publish_recv.payload_len = payload_len;
+    client->evt.evt.publish_recv.dup = 0;
+    client->evt.evt.publish_recv.qos = LWCELL_MQTT_QOS_AT_MOST_ONCE; /* Not reported by device */
+    client->evt.evt.publish_recv.pbuf = NULL;
+    client->evt_fn(client, &client->evt);
+}
+
+/**
+ * \brief           Native session closed by device or network
+ * \param[in]       arg: MQTT client
+ */
+static void
+prv_session_closed_fn(void* arg) {
+    lwcell_mqtt_client_p client = arg;
+
+    LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Session closed by device\r\n");
+    if (client->conn_state != LWCELL_MQTT_CONN_DISCONNECTED) {
+        prv_mqtt_closed(client);
+    }
+}
+
+/**
+ * \brief           Connect command finished
+ * \param[in]       res: Command result
+ * \param[in]       arg: MQTT client
+ */
+static void
+prv_connect_evt_fn(lwcellr_t res, void* arg) {
+    lwcell_mqtt_client_p client = arg;
+
+    if (client->conn_state != LWCELL_MQTT_CONN_CONNECTING) {
+        return; /* Disconnect requested meanwhile, it notifies user */
+    }
+    client->evt.type = LWCELL_MQTT_EVT_CONNECT;
+    client->evt.evt.connect.session_present = 0; /* Not reported by the modem */
+    client->evt.evt.connect.reason = 0;
+    if (res == lwcellOK) {
+        client->conn_state = LWCELL_MQTT_CONNECTED;
+        client->evt.evt.connect.status = LWCELL_MQTT_CONN_STATUS_ACCEPTED;
+    } else {
+        client->conn_state = LWCELL_MQTT_CONN_DISCONNECTED;
+        client->evt.evt.connect.status = res == lwcellERRCONNFAIL || res == lwcellTIMEOUT
+                                             ? LWCELL_MQTT_CONN_STATUS_TCP_FAILED
+                                             : LWCELL_MQTT_CONN_STATUS_REFUSED_SERVER;
+    }
+    LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Connect finished with status: %d\r\n",
+                  (int)client->evt.evt.connect.status);
+    client->evt_fn(client, &client->evt);
+
+    /*
+     * Refused client has its TCP connection already closed by the stack,
+     * report it the same way as software client does on connection close
+     */
+    if (client->evt.evt.connect.status == LWCELL_MQTT_CONN_STATUS_REFUSED_SERVER
+        && client->conn_state == LWCELL_MQTT_CONN_DISCONNECTED) {
+        client->evt.evt.disconnect.is_accepted = 0;
+        client->evt.evt.disconnect.reason = 0;
+        client->evt.type = LWCELL_MQTT_EVT_DISCONNECT;
+        client->evt_fn(client, &client->evt);
+    }
+}
+
+/**
+ * \brief           Disconnect command finished
+ * \param[in]       res: Command result
+ * \param[in]       arg: MQTT client
+ */
+static void
+prv_disconnect_evt_fn(lwcellr_t res, void* arg) {
+    lwcell_mqtt_client_p client = arg;
+
+    LWCELL_UNUSED(res);
+    if (client->conn_state != LWCELL_MQTT_CONN_DISCONNECTED) {
+        prv_mqtt_closed(client);
+    }
+}
+
+/**
+ * \brief           Subscribe, unsubscribe or publish command finished
+ * \param[in]       res: Command result
+ * \param[in]       arg: Request object
+ */
+static void
+prv_request_evt_fn(lwcellr_t res, void* arg) {
+    lwcell_mqtt_native_request_t* request = arg;
+    lwcell_mqtt_client_p client = request->client;
+    uint8_t status = request->status;
+    void* req_arg = request->arg;
+
+    lwcell_mem_free_s((void**)&request->data);
+    request->status = 0; /* Request is free again */
+
+    if (status & (MQTT_REQUEST_FLAG_SUBSCRIBE | MQTT_REQUEST_FLAG_UNSUBSCRIBE)) {
+        client->evt.type =
+            (status & MQTT_REQUEST_FLAG_SUBSCRIBE) ? LWCELL_MQTT_EVT_SUBSCRIBE : LWCELL_MQTT_EVT_UNSUBSCRIBE;
+        client->evt.evt.sub_unsub_scribed.arg = req_arg;
+        client->evt.evt.sub_unsub_scribed.res = res;
+        client->evt.evt.sub_unsub_scribed.reason = 0;
+    } else {
+        client->evt.type = LWCELL_MQTT_EVT_PUBLISH;
+        client->evt.evt.publish.arg = req_arg;
+        client->evt.evt.publish.res = res;
+        client->evt.evt.publish.reason = 0;
+    }
+    client->evt_fn(client, &client->evt);
+}
+
+/**
+ * \brief           Send connect command to device in non-blocking mode
+ * \param[in]       client: MQTT client with connection info
+ * \param[in]       host: Host address for server
+ * \param[in]       port: Host port number
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+prv_send_connect_cmd(lwcell_mqtt_client_p client, const char* host, lwcell_port_t port) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_MSG_VAR_ALLOC(msg, 0);
+    LWCELL_MSG_VAR_SET_EVT(msg, prv_connect_evt_fn, client);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_MQTT_CONNECT;
+    LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_MCONFIG;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.host = host;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.port = port;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.id = client->info->id;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.user = client->info->user;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.pass = client->info->pass;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.will_topic = client->info->will_topic;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.will_message = client->info->will_message;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.will_qos = LWCELL_U8(client->info->will_qos);
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.keep_alive = client->info->keep_alive;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.clean_session = !client->info->persistent_session;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.buff = client->rx_buff;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.buff_len = client->rx_buff_len;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.recv_fn = prv_session_recv_fn;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.closed_fn = prv_session_closed_fn;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_connect.arg = client;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 60000);
+}
+
+/**
+ * \brief           Send disconnect command to device in non-blocking mode
+ * \param[in]       client: MQTT client
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+prv_send_disconnect_cmd(lwcell_mqtt_client_p client) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_MSG_VAR_ALLOC(msg, 0);
+    LWCELL_MSG_VAR_SET_EVT(msg, prv_disconnect_evt_fn, client);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_MQTT_DISCONNECT;
+    LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_MDISCONNECT;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 10000);
+}
+
+/**
+ * \brief           Send topic command to device in non-blocking mode
+ * \param[in]       request: Request object with copy of topic and payload
+ * \param[in]       cmd: Command to execute
+ * \param[in]       len: Length of payload, only for publish
+ * \param[in]       qos: Quality of service
+ * \param[in]       retain: Retain flag, only for publish
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+prv_send_topic_cmd(lwcell_mqtt_native_request_t* request, lwcell_cmd_t cmd, size_t len, uint8_t qos,
+                   uint8_t retain) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_MSG_VAR_ALLOC(msg, 0);
+    LWCELL_MSG_VAR_SET_EVT(msg, prv_request_evt_fn, request);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = cmd;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_topic.topic = request->data;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_topic.data = &request->data[strlen(request->data) + 1];
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_topic.len = len;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_topic.qos = qos;
+    LWCELL_MSG_VAR_REF(msg).msg.mqtt_topic.retain = retain;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 10000);
+}
+
+/**
+ * \brief           Create request and send topic command for it
+ * \param[in]       client: MQTT client
+ * \param[in]       cmd: Command to execute
+ * \param[in]       flags: Request type flags
+ * \param[in]       topic: Topic name
+ * \param[in]       payload: Message payload, only for publish
+ * \param[in]       len: Length of payload
+ * \param[in]       qos: Quality of service
+ * \param[in]       retain: Retain flag, only for publish
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+prv_topic_request(lwcell_mqtt_client_p client, lwcell_cmd_t cmd, uint8_t flags, const char* topic,
+                  const void* payload, size_t len, lwcell_mqtt_qos_t qos, uint8_t retain, void* arg) {
+    lwcell_mqtt_native_request_t* request = NULL;
+    size_t len_topic;
+    lwcellr_t res;
+
+    if ((len_topic = strlen(topic)) == 0) {
+        return lwcellERR;
+    }
+    if (payload == NULL) {
+        len = 0;
+    }
+
+    lwcell_core_lock();
+    if (client->conn_state != LWCELL_MQTT_CONNECTED) {
+        res = lwcellCLOSED;
+    } else if (len_topic + len > client->tx_buff_len) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_MQTT_TRACE, "[LWCELL MQTT] Message does not fit TX buffer length\r\n");
+        res = lwcellERRMEM;
+    } else {
+        for (size_t i = 0; i < LWCELL_CFG_MQTT_MAX_REQUESTS; ++i) {
+            if (!(client->requests[i].status & MQTT_REQUEST_FLAG_IN_USE)) {
+                request = &client->requests[i];
+                break;
+            }
+        }
+        res = lwcellERRMEM;
+        if (request != NULL && (request->data = lwcell_mem_malloc(len_topic + 1 + len)) != NULL) {
+            /* Command is executed later, keep copy of topic and payload */
+            LWCELL_MEMCPY(request->data, topic, len_topic + 1);
+            if (len > 0) {
+                LWCELL_MEMCPY(&request->data[len_topic + 1], payload, len);
+            }
+            request->status = MQTT_REQUEST_FLAG_IN_USE | flags;
+            request->client = client;
+            request->arg = arg;
+            if ((res = prv_send_topic_cmd(request, cmd, len, LWCELL_U8(qos), retain)) != lwcellOK) {
+                lwcell_mem_free_s((void**)&request->data);
+                request->status = 0;
+            }
+        }
+        LWCELL_DEBUGW(LWCELL_CFG_DBG_MQTT_TRACE, res != lwcellOK, "[LWCELL MQTT] Cannot start request: %d\r\n",
+                      (int)res);
+    }
+    lwcell_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Allocate a new MQTT client structure
+ * \param[in]       tx_buff_len: Maximal length of topic and payload of published message
+ * \param[in]       rx_buff_len: Length of buffer for topic and payload of received message.
+ *                      Longer messages are skipped
+ * \return          Pointer to new allocated MQTT client structure or `NULL` on failure
+ */
+lwcell_mqtt_client_t*
+lwcell_mqtt_client_new(size_t tx_buff_len, size_t rx_buff_len) {
+    lwcell_mqtt_client_p client;
+
+    if ((client = lwcell_mem_calloc(1, sizeof(*client))) != NULL) {
+        client->conn_state = LWCELL_MQTT_CONN_DISCONNECTED; /* Set to disconnected mode */
+        client->tx_buff_len = tx_buff_len;
+        client->rx_buff_len = rx_buff_len;
+        if ((client->rx_buff = lwcell_mem_malloc(rx_buff_len)) == NULL) {
+            lwcell_mem_free_s((void**)&client);
+        }
+    }
+    return client;
+}
+
+/**
+ * \brief           Delete MQTT client structure
+ * \note            MQTT client must be disconnected first
+ * \param[in]       client: MQTT client
+ */
+void
+lwcell_mqtt_client_delete(lwcell_mqtt_client_p client) {
+    if (client != NULL) {
+        lwcell_mem_free_s((void**)&client->rx_buff);
+        lwcell_mem_free_s((void**)&client);
+    }
+}
+
+/**
+ * \brief           Connect to MQTT server
+ * \note            Device opens TCP connection and sends CONNECT packet to server
+ * \param[in]       client: MQTT client
+ * \param[in]       host: Host address for server
+ * \param[in]       port: Host port number
+ * \param[in]       evt_fn: Callback function for all events on this MQTT client
+ * \param[in]       info: Information structure for connection
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_mqtt_client_connect(lwcell_mqtt_client_p client, const char* host, lwcell_port_t port, lwcell_mqtt_evt_fn evt_fn,
+                           const lwcell_mqtt_client_info_t* info) {
+    lwcellr_t res = lwcellERR;
+
+    LWCELL_ASSERT(client != NULL);
+    LWCELL_ASSERT(host != NULL);
+    LWCELL_ASSERT(port > 0);
+    LWCELL_ASSERT(info != NULL);
+
+    if (info->version == 5) { /* Device stack supports MQTT 3.1.1 only */
+        return lwcellERR;
+    }
+
+    lwcell_core_lock();
+    if (lwcell_network_is_attached(LWCELL_PDP_SOCKET) && client->conn_state == LWCELL_MQTT_CONN_DISCONNECTED
+        && !lwcell.m.mqtt.active) {
+        client->info = info; /* Save client info parameters */
+        client->evt_fn = evt_fn != NULL ? evt_fn : prv_mqtt_evt_fn_default;
+
+        if ((res = prv_send_connect_cmd(client, host, port)) == lwcellOK) {
+            client->conn_state = LWCELL_MQTT_CONN_CONNECTING;
+        }
+    }
+    lwcell_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Disconnect from MQTT server
+ * \param[in]       client: MQTT client
+ * \return          \ref lwcellOK if request sent to queue or member of \ref lwcellr_t otherwise
+ */
+lwcellr_t
+lwcell_mqtt_client_disconnect(lwcell_mqtt_client_p client) {
+    lwcellr_t res = lwcellERR;
+
+    lwcell_core_lock();
+    if (client->conn_state != LWCELL_MQTT_CONN_DISCONNECTED && client->conn_state != LWCELL_MQTT_CONN_DISCONNECTING) {
+        if ((res = prv_send_disconnect_cmd(client)) == lwcellOK) {
+            client->conn_state = LWCELL_MQTT_CONN_DISCONNECTING;
+        }
+    }
+    lwcell_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Subscribe to MQTT topic
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic name to subscribe to
+ * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwcell_mqtt_qos_t
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_mqtt_client_subscribe(lwcell_mqtt_client_p client, const char* topic, lwcell_mqtt_qos_t qos, void* arg) {
+    return prv_topic_request(client, LWCELL_CMD_MSUB, MQTT_REQUEST_FLAG_SUBSCRIBE, topic, NULL, 0, qos, 0, arg);
+}
+
+/**
+ * \brief           Subscribe to MQTT topic with handler for received messages
+ * \note            Modem client does not route messages to handlers,
+ *                      function fails when `fn` is set
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic filter to subscribe to
+ * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwcell_mqtt_qos_t
+ * \param[in]       fn: Handler for received messages. Must be set to `NULL`
+ * \param[in]       fn_arg: Custom argument passed to handler
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_mqtt_client_subscribe_ex(lwcell_mqtt_client_p client, const char* topic, lwcell_mqtt_qos_t qos,
+                                lwcell_mqtt_sub_fn fn, void* fn_arg, void* arg) {
+    LWCELL_UNUSED(fn_arg);
+    if (fn != NULL) {
+        return lwcellERR;
+    }
+    return lwcell_mqtt_client_subscribe(client, topic, qos, arg);
+}
+
+/**
+ * \brief           Unsubscribe from MQTT topic
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic name to unsubscribe from
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_mqtt_client_unsubscribe(lwcell_mqtt_client_p client, const char* topic, void* arg) {
+    return prv_topic_request(client, LWCELL_CMD_MUNSUB, MQTT_REQUEST_FLAG_UNSUBSCRIBE, topic, NULL, 0,
+                             LWCELL_MQTT_QOS_AT_MOST_ONCE, 0, arg);
+}
+
+/**
+ * \brief           Publish a new message on specific topic
+ * \note            \ref LWCELL_MQTT_EVT_PUBLISH event is sent for every quality of service,
+ *                  when device accepted the message
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       payload: Message data
+ * \param[in]       payload_len: Length of payload data
+ * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwcell_mqtt_qos_t enumeration
+ * \param[in]       retain: Retian parameter value
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_mqtt_client_publish(lwcell_mqtt_client_p client, const char* topic, const void* payload, uint16_t payload_len,
+                           lwcell_mqtt_qos_t qos, uint8_t retain, void* arg) {
+    return prv_topic_request(client, LWCELL_CMD_MPUB, 0, topic, payload, payload_len,
+                             (lwcell_mqtt_qos_t)LWCELL_MIN(LWCELL_U8(qos), LWCELL_U8(LWCELL_MQTT_QOS_EXACTLY_ONCE)),
+                             LWCELL_U8(retain > 0), arg);
+}
+
+/**
+ * \brief           Start publish message with payload written in parts.
+ * \note            Not supported with native MQTT stack, device requires whole payload with single command
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       payload_len: Total length of payload in units of bytes
+ * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwcell_mqtt_qos_t enumeration
+ * \param[in]       retain: Retain parameter value
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref lwcellERR
+ */
+lwcellr_t
+lwcell_mqtt_client_publish_begin(lwcell_mqtt_client_p client, const char* topic, uint32_t payload_len,
+                                 lwcell_mqtt_qos_t qos, uint8_t retain, void* arg) {
+    LWCELL_UNUSED(client);
+    LWCELL_UNUSED(topic);
+    LWCELL_UNUSED(payload_len);
+    LWCELL_UNUSED(qos);
+    LWCELL_UNUSED(retain);
+    LWCELL_UNUSED(arg);
+    return lwcellERR;
+}
+
+/**
+ * \brief           Write part of payload of message started with \ref lwcell_mqtt_client_publish_begin
+ * \note            Not supported with native MQTT stack
+ * \param[in]       client: MQTT client
+ * \param[in]       data: Payload data to write
+ * \param[in]       len: Length of data
+ * \param[out]      bw: Pointer to output variable to save number of bytes written. Can be set to `NULL`
+ * \return          \ref lwcellERR
+ */
+lwcellr_t
+lwcell_mqtt_client_publish_write(lwcell_mqtt_client_p client, const void* data, size_t len, size_t* bw) {
+    LWCELL_UNUSED(client);
+    LWCELL_UNUSED(data);
+    LWCELL_UNUSED(len);
+    if (bw != NULL) {
+        *bw = 0;
+    }
+    return lwcellERR;
+}
+
+/**
+ * \brief           Finish message started with \ref lwcell_mqtt_client_publish_begin
+ * \note            Not supported with native MQTT stack
+ * \param[in]       client: MQTT client
+ * \return          \ref lwcellERR
+ */
+lwcellr_t
+lwcell_mqtt_client_publish_end(lwcell_mqtt_client_p client) {
+    LWCELL_UNUSED(client);
+    return lwcellERR;
+}
+
+/**
+ * \brief           Test if client is connected to server and accepted to MQTT protocol
+ * \param[in]       client: MQTT client
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwcell_mqtt_client_is_connected(lwcell_mqtt_client_p client) {
+    uint8_t res;
+    lwcell_core_lock();
+    res = LWCELL_U8(client->conn_state == LWCELL_MQTT_CONNECTED);
+    lwcell_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Set message store for outgoing messages
+ * \note            Not supported by native backend, modem keeps the session itself
+ * \param[in]       client: MQTT client
+ * \param[in]       store: Message store functions
+ * \param[in]       arg: Store argument
+ * \return          \ref lwcellERR as not supported
+ */
+lwcellr_t
+lwcell_mqtt_client_set_store(lwcell_mqtt_client_p client, const lwcell_mqtt_store_t* store, void* arg) {
+    LWCELL_UNUSED(client);
+    LWCELL_UNUSED(store);
+    LWCELL_UNUSED(arg);
+    return lwcellERR;
+}
+
+/**
+ * \brief           Set user argument on client
+ * \param[in]       client: MQTT client handle
+ * \param[in]       arg: User argument
+ */
+void
+lwcell_mqtt_client_set_arg(lwcell_mqtt_client_p client, void* arg) {
+    lwcell_core_lock();
+    client->arg = arg;
+    lwcell_core_unlock();
+}
+
+/**
+ * \brief           Get user argument on client
+ * \param[in]       client: MQTT client handle
+ * \return          User argument
+ */
+void*
+lwcell_mqtt_client_get_arg(lwcell_mqtt_client_p client) {
+    return client->arg;
+}
+
+#endif /* LWCELL_CFG_MQTT || __DOXYGEN__ */
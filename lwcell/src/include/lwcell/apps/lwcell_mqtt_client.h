@@ -67,6 +67,13 @@ struct lwcell_mqtt_client;
  */
 typedef struct lwcell_mqtt_client* lwcell_mqtt_client_p;
 
+struct lwcell_mqtt_mgr;
+
+/**
+ * \brief           Pointer to \ref lwcell_mqtt_mgr_t structure
+ */
+typedef struct lwcell_mqtt_mgr* lwcell_mqtt_mgr_p;
+
 /**
  * \brief           State of MQTT client
  */
@@ -93,6 +100,15 @@ typedef struct {
     const char* will_topic;     /*!< Will topic */
     const char* will_message;   /*!< Will message */
     lwcell_mqtt_qos_t will_qos; /*!< Will topic quality of service */
+
+    uint8_t persistent_session; /*!< Set to `1` to connect without clean session flag and keep session on reconnect.
+                                        Unacknowledged messages are sent again after reconnect
+                                        and subscriptions are restored when server has no session */
+
+    uint8_t version;          /*!< Protocol version, `5` for MQTT 5.0 or `0` for MQTT 3.1.1.
+                                        MQTT 5.0 requires \ref LWCELL_CFG_MQTT_V5 enabled */
+    uint32_t max_packet_size; /*!< Maximal packet size accepted by client, sent to server with MQTT 5.0.
+                                        Set to `0` for no limit */
 } lwcell_mqtt_client_info_t;
 
 /**
@@ -107,6 +123,9 @@ typedef struct {
                                                     on connection before we can say "packet was sent". */
 
     uint32_t timeout_start_time; /*!< Timeout start time in units of milliseconds */
+    uint8_t* packet;             /*!< Copy of raw publish packet for retransmission or `NULL` if not stored */
+    uint16_t packet_len;         /*!< Length of raw publish packet in units of bytes */
+    uint8_t retransmits;         /*!< Number of retransmissions of the packet */
 } lwcell_mqtt_request_t;
 
 /**
@@ -121,6 +140,13 @@ typedef enum {
                                                             you may not receive event, even if packet was successfully sent,
                                                             thus do not rely on this event for packet with `qos = LWCELL_MQTT_QOS_AT_MOST_ONCE` */
     LWCELL_MQTT_EVT_PUBLISH_RECV, /*!< MQTT client received a publish message from server */
+    LWCELL_MQTT_EVT_PUBLISH_RECV_START, /*!< MQTT client started to receive publish message too big for RX buffer.
+                                                    Event uses `publish_recv` parameters with `payload` set to `NULL`
+                                                    and `payload_len` set to total payload length */
+    LWCELL_MQTT_EVT_PUBLISH_RECV_DATA,  /*!< Fragment of publish message payload, started with \ref LWCELL_MQTT_EVT_PUBLISH_RECV_START */
+    LWCELL_MQTT_EVT_PUBLISH_RECV_END,   /*!< Publish message payload received completely or reception aborted */
+    LWCELL_MQTT_EVT_PUBLISH_WRITE,      /*!< Output buffer has space for more payload of message
+                                                    started with \ref lwcell_mqtt_client_publish_begin */
     LWCELL_MQTT_EVT_DISCONNECT,   /*!< MQTT client disconnected from MQTT server */
     LWCELL_MQTT_EVT_KEEP_ALIVE,   /*!< MQTT keep-alive sent to server and reply received */
 } lwcell_mqtt_evt_type_t;
@@ -147,21 +173,26 @@ typedef struct {
     union {
         struct {
             lwcell_mqtt_conn_status_t status; /*!< Connection status with MQTT */
+            uint8_t session_present;          /*!< Set to `1` when server resumed previous session */
+            uint8_t reason;                   /*!< Return code of MQTT 3.1.1 or reason code of MQTT 5.0 server */
         } connect;                            /*!< Event for connecting to server */
 
         struct {
             uint8_t is_accepted; /*!< Status if client was accepted to MQTT prior disconnect event */
+            uint8_t reason;      /*!< Reason code of MQTT 5.0 server disconnect or `0` */
         } disconnect;            /*!< Event for disconnecting from server */
 
         struct {
             void* arg;       /*!< User argument for callback function */
             lwcellr_t res;   /*!< Response status */
+            uint8_t reason;  /*!< Granted quality of service or reason code from server */
         } sub_unsub_scribed; /*!< Event for (un)subscribe to/from topics */
 
         struct {
-            void* arg;     /*!< User argument for callback function */
-            lwcellr_t res; /*!< Response status */
-        } publish;         /*!< Published event */
+            void* arg;      /*!< User argument for callback function */
+            lwcellr_t res;  /*!< Response status */
+            uint8_t reason; /*!< Reason code of MQTT 5.0 server acknowledge or `0` */
+        } publish;          /*!< Published event */
 
         struct {
             const uint8_t* topic;  /*!< Pointer to topic identifier */
@@ -170,7 +201,26 @@ typedef struct {
             size_t payload_len;    /*!< Length of topic payload */
             uint8_t dup;           /*!< Duplicate flag if message was sent again */
             lwcell_mqtt_qos_t qos; /*!< Received packet quality of service */
+            lwcell_pbuf_p pbuf;    /*!< Packet buffer holding topic and payload or `NULL` if they are in client memory.
+                                        Use \ref lwcell_pbuf_ref to keep data valid after event callback */
         } publish_recv;            /*!< Publish received event */
+
+        struct {
+            const void* payload; /*!< Payload fragment, valid only during event callback */
+            size_t len;          /*!< Length of payload fragment */
+            size_t offset;       /*!< Offset of fragment from beginning of payload */
+        } publish_recv_data;     /*!< Publish payload fragment received event */
+
+        struct {
+            lwcellr_t res; /*!< \ref lwcellOK when all payload was received,
+                                    \ref lwcellCLOSED when connection closed during reception */
+        } publish_recv_end; /*!< Publish payload reception finished event */
+
+        struct {
+            void* arg;       /*!< User argument used on \ref lwcell_mqtt_client_publish_begin */
+            size_t len;      /*!< Number of payload bytes that can be written now */
+            uint32_t left;   /*!< Number of payload bytes not written yet */
+        } publish_write;     /*!< Publish payload write event */
     } evt;                         /*!< Event data parameters */
 } lwcell_mqtt_evt_t;
 
@@ -181,6 +231,54 @@ typedef struct {
  */
 typedef void (*lwcell_mqtt_evt_fn)(lwcell_mqtt_client_p client, lwcell_mqtt_evt_t* evt);
 
+/**
+ * \brief           Subscription handler for received publish messages matching its topic filter
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: \ref LWCELL_MQTT_EVT_PUBLISH_RECV event
+ * \param[in]       arg: Handler argument set on subscribe
+ */
+typedef void (*lwcell_mqtt_sub_fn)(lwcell_mqtt_client_p client, lwcell_mqtt_evt_t* evt, void* arg);
+
+/**
+ * \brief           Store record at the end of message store
+ * \param[in]       arg: Store argument
+ * \param[in]       data: Record data
+ * \param[in]       len: Record length in units of bytes
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+typedef lwcellr_t (*lwcell_mqtt_store_push_fn)(void* arg, const void* data, size_t len);
+
+/**
+ * \brief           Read oldest record from message store without removing it
+ * \param[in]       arg: Store argument
+ * \param[out]      data: Output memory to copy record to. Set to `NULL` to get record length only
+ * \param[in]       size: Size of output memory in units of bytes
+ * \return          Length of oldest record in units of bytes, `0` if store is empty
+ */
+typedef size_t (*lwcell_mqtt_store_peek_fn)(void* arg, void* data, size_t size);
+
+/**
+ * \brief           Remove oldest record from message store
+ * \param[in]       arg: Store argument
+ */
+typedef void (*lwcell_mqtt_store_pop_fn)(void* arg);
+
+/**
+ * \brief           Message store for outgoing `QoS > 0` messages, that cannot be sent immediately.
+ *
+ * Records are opaque to the store and must be returned in the same order as stored.
+ * Functions are called with core locked, store must not call MQTT client functions.
+ */
+typedef struct {
+    lwcell_mqtt_store_push_fn push_fn; /*!< Store record at the end */
+    lwcell_mqtt_store_peek_fn peek_fn; /*!< Read oldest record */
+    lwcell_mqtt_store_pop_fn pop_fn;   /*!< Remove oldest record */
+} lwcell_mqtt_store_t;
+
+#if !LWCELL_CFG_MQTT || __DOXYGEN__
+extern const lwcell_mqtt_store_t lwcell_mqtt_store_ram;
+#endif /* !LWCELL_CFG_MQTT || __DOXYGEN__ */
+
 lwcell_mqtt_client_p lwcell_mqtt_client_new(size_t tx_buff_len, size_t rx_buff_len);
 void lwcell_mqtt_client_delete(lwcell_mqtt_client_p client);
 
@@ -191,14 +289,31 @@ uint8_t lwcell_mqtt_client_is_connected(lwcell_mqtt_client_p client);
 
 lwcellr_t lwcell_mqtt_client_subscribe(lwcell_mqtt_client_p client, const char* topic, lwcell_mqtt_qos_t qos,
                                        void* arg);
+lwcellr_t lwcell_mqtt_client_subscribe_ex(lwcell_mqtt_client_p client, const char* topic, lwcell_mqtt_qos_t qos,
+                                          lwcell_mqtt_sub_fn fn, void* fn_arg, void* arg);
 lwcellr_t lwcell_mqtt_client_unsubscribe(lwcell_mqtt_client_p client, const char* topic, void* arg);
 
 lwcellr_t lwcell_mqtt_client_publish(lwcell_mqtt_client_p client, const char* topic, const void* payload, uint16_t len,
                                      lwcell_mqtt_qos_t qos, uint8_t retain, void* arg);
+lwcellr_t lwcell_mqtt_client_publish_begin(lwcell_mqtt_client_p client, const char* topic, uint32_t payload_len,
+                                           lwcell_mqtt_qos_t qos, uint8_t retain, void* arg);
+lwcellr_t lwcell_mqtt_client_publish_write(lwcell_mqtt_client_p client, const void* data, size_t len, size_t* bw);
+lwcellr_t lwcell_mqtt_client_publish_end(lwcell_mqtt_client_p client);
+
+lwcellr_t lwcell_mqtt_client_set_store(lwcell_mqtt_client_p client, const lwcell_mqtt_store_t* store, void* arg);
 
 void* lwcell_mqtt_client_get_arg(lwcell_mqtt_client_p client);
 void lwcell_mqtt_client_set_arg(lwcell_mqtt_client_p client, void* arg);
 
+#if (!LWCELL_CFG_MQTT && LWCELL_CFG_MQTT_MGR) || __DOXYGEN__
+lwcell_mqtt_mgr_p lwcell_mqtt_mgr_new(size_t pool_len);
+void lwcell_mqtt_mgr_delete(lwcell_mqtt_mgr_p mgr);
+lwcell_mqtt_client_p lwcell_mqtt_mgr_client_new(lwcell_mqtt_mgr_p mgr, size_t tx_buff_len, size_t rx_buff_len,
+                                                uint8_t weight);
+lwcellr_t lwcell_mqtt_mgr_set_failover(lwcell_mqtt_client_p client, lwcell_mqtt_client_p backup);
+lwcellr_t lwcell_mqtt_mgr_migrate(lwcell_mqtt_client_p from, lwcell_mqtt_client_p to);
+#endif /* (!LWCELL_CFG_MQTT && LWCELL_CFG_MQTT_MGR) || __DOXYGEN__ */
+
 /**
  * \}
  */
@@ -62,8 +62,30 @@ typedef struct lwcell_mqtt_client_api_buf {
     uint8_t* payload;      /*!< Payload data */
     size_t payload_len;    /*!< Payload length */
     lwcell_mqtt_qos_t qos; /*!< Quality of service */
+    lwcell_pbuf_p pbuf;    /*!< Packet buffer referenced by payload or `NULL` if payload is copied */
 } lwcell_mqtt_client_api_buf_t;
 
+/**
+ * \brief           Policy for received message when receive queue is full.
+ *
+ * Library thread never waits for application, as modem keeps delivering connection data meanwhile
+ */
+typedef enum {
+    LWCELL_MQTT_CLIENT_API_OVERFLOW_DROP_NEWEST = 0x00, /*!< Received message is dropped */
+    LWCELL_MQTT_CLIENT_API_OVERFLOW_DROP_OLDEST,        /*!< Oldest message in queue is dropped to make space */
+} lwcell_mqtt_client_api_overflow_t;
+
+/**
+ * \brief           MQTT API receive statistics
+ */
+typedef struct {
+    uint32_t received;       /*!< Number of messages put to receive queue */
+    uint32_t zero_copy;      /*!< Number of messages put to receive queue without payload copy */
+    uint32_t dropped_newest; /*!< Number of received messages dropped as queue was full */
+    uint32_t dropped_oldest; /*!< Number of queued messages dropped to make space for new ones */
+    uint32_t dropped_mem;    /*!< Number of received messages dropped due to memory allocation failure */
+} lwcell_mqtt_client_api_stats_t;
+
 /**
  * \brief           Pointer to \ref lwcell_mqtt_client_api structure
  */
@@ -80,6 +102,8 @@ lwcell_mqtt_conn_status_t lwcell_mqtt_client_api_connect(lwcell_mqtt_client_api_
                                                          lwcell_port_t port, const lwcell_mqtt_client_info_t* info);
 lwcellr_t lwcell_mqtt_client_api_close(lwcell_mqtt_client_api_p client);
 lwcellr_t lwcell_mqtt_client_api_subscribe(lwcell_mqtt_client_api_p client, const char* topic, lwcell_mqtt_qos_t qos);
+lwcellr_t lwcell_mqtt_client_api_subscribe_ex(lwcell_mqtt_client_api_p client, const char* topic, lwcell_mqtt_qos_t qos,
+                                              lwcell_mqtt_sub_fn fn, void* arg);
 lwcellr_t lwcell_mqtt_client_api_unsubscribe(lwcell_mqtt_client_api_p client, const char* topic);
 lwcellr_t lwcell_mqtt_client_api_publish(lwcell_mqtt_client_api_p client, const char* topic, const void* data,
                                          size_t btw, lwcell_mqtt_qos_t qos, uint8_t retain);
@@ -87,6 +111,9 @@ uint8_t lwcell_mqtt_client_api_is_connected(lwcell_mqtt_client_api_p client);
 lwcellr_t lwcell_mqtt_client_api_receive(lwcell_mqtt_client_api_p client, lwcell_mqtt_client_api_buf_p* p,
                                          uint32_t timeout);
 void lwcell_mqtt_client_api_buf_free(lwcell_mqtt_client_api_buf_p p);
+lwcellr_t lwcell_mqtt_client_api_set_overflow(lwcell_mqtt_client_api_p client,
+                                              lwcell_mqtt_client_api_overflow_t overflow);
+lwcellr_t lwcell_mqtt_client_api_get_stats(lwcell_mqtt_client_api_p client, lwcell_mqtt_client_api_stats_t* stats);
 
 /**
  * \}
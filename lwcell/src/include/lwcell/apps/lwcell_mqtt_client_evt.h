@@ -73,6 +73,24 @@ extern "C" {
  */
 #define lwcell_mqtt_client_evt_connect_get_status(client, evt) ((lwcell_mqtt_conn_status_t)(evt)->evt.connect.status)
 
+/**
+ * \brief           Check if server resumed previous session of client
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          `1` if session is present, `0` otherwise
+ * \hideinitializer
+ */
+#define lwcell_mqtt_client_evt_connect_is_session_present(client, evt) ((uint8_t)(evt)->evt.connect.session_present)
+
+/**
+ * \brief           Get return code of MQTT 3.1.1 or reason code of MQTT 5.0 connect acknowledge
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Code received from server, `0` on success
+ * \hideinitializer
+ */
+#define lwcell_mqtt_client_evt_connect_get_reason(client, evt)         ((uint8_t)(evt)->evt.connect.reason)
+
 /**
  * \}
  */
@@ -95,6 +113,15 @@ extern "C" {
 #define lwcell_mqtt_client_evt_disconnect_is_accepted(client, evt)                                                     \
     ((lwcell_mqtt_conn_status_t)(evt)->evt.disconnect.is_accepted)
 
+/**
+ * \brief           Get reason code of disconnect sent by MQTT 5.0 server
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Reason code or `0` if server did not send disconnect
+ * \hideinitializer
+ */
+#define lwcell_mqtt_client_evt_disconnect_get_reason(client, evt)      ((uint8_t)(evt)->evt.disconnect.reason)
+
 /**
  * \}
  */
@@ -125,6 +152,15 @@ extern "C" {
  */
 #define lwcell_mqtt_client_evt_subscribe_get_result(client, evt)       ((lwcellr_t)(evt)->evt.sub_unsub_scribed.res)
 
+/**
+ * \brief           Get granted quality of service or failure reason code of subscribe event
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Granted quality of service, or reason code `0x80` or above on failure
+ * \hideinitializer
+ */
+#define lwcell_mqtt_client_evt_subscribe_get_reason(client, evt)       ((uint8_t)(evt)->evt.sub_unsub_scribed.reason)
+
 /**
  * \brief           Get user argument used on \ref lwcell_mqtt_client_unsubscribe
  * \param[in]       client: MQTT client
@@ -143,6 +179,15 @@ extern "C" {
  */
 #define lwcell_mqtt_client_evt_unsubscribe_get_result(client, evt)     ((lwcellr_t)(evt)->evt.sub_unsub_scribed.res)
 
+/**
+ * \brief           Get reason code of MQTT 5.0 unsubscribe acknowledge
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Reason code, `0` on success or with MQTT 3.1.1
+ * \hideinitializer
+ */
+#define lwcell_mqtt_client_evt_unsubscribe_get_reason(client, evt)     ((uint8_t)(evt)->evt.sub_unsub_scribed.reason)
+
 /**
  * \}
  */
@@ -210,6 +255,68 @@ extern "C" {
  */
 #define lwcell_mqtt_client_evt_publish_recv_get_qos(client, evt)      ((evt)->evt.publish_recv.qos)
 
+/**
+ * \brief           Get packet buffer holding topic and payload of received publish packet
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Packet buffer or `NULL` if topic and payload are in client memory
+ * \hideinitializer
+ */
+#define lwcell_mqtt_client_evt_publish_recv_get_pbuf(client, evt)     ((lwcell_pbuf_p)(evt)->evt.publish_recv.pbuf)
+
+/**
+ * \}
+ */
+
+/**
+ * \anchor          LWCELL_APP_MQTT_CLIENT_EVT_PUBLISH_RECV_STREAM
+ * \name            Publish receive stream events
+ * \{
+ *
+ * \note            Use these functions on \ref LWCELL_MQTT_EVT_PUBLISH_RECV_DATA and
+ *                  \ref LWCELL_MQTT_EVT_PUBLISH_RECV_END events.
+ *                  Topic, total length and quality of service are available on \ref LWCELL_MQTT_EVT_PUBLISH_RECV_START
+ *                  with \ref LWCELL_APP_MQTT_CLIENT_EVT_PUBLISH_RECV functions
+ */
+
+/**
+ * \brief           Get payload fragment of received publish packet
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Payload fragment
+ * \hideinitializer
+ */
+#define lwcell_mqtt_client_evt_publish_recv_data_get_payload(client, evt)                                              \
+    ((const void*)(evt)->evt.publish_recv_data.payload)
+
+/**
+ * \brief           Get length of payload fragment
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Fragment length
+ * \hideinitializer
+ */
+#define lwcell_mqtt_client_evt_publish_recv_data_get_len(client, evt) (LWCELL_SZ((evt)->evt.publish_recv_data.len))
+
+/**
+ * \brief           Get offset of payload fragment from beginning of payload
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Fragment offset
+ * \hideinitializer
+ */
+#define lwcell_mqtt_client_evt_publish_recv_data_get_offset(client, evt)                                               \
+    (LWCELL_SZ((evt)->evt.publish_recv_data.offset))
+
+/**
+ * \brief           Get result of payload reception
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t otherwise
+ * \hideinitializer
+ */
+#define lwcell_mqtt_client_evt_publish_recv_end_get_result(client, evt) ((lwcellr_t)(evt)->evt.publish_recv_end.res)
+
 /**
  * \}
  */
@@ -240,6 +347,54 @@ extern "C" {
 */
 #define lwcell_mqtt_client_evt_publish_get_result(client, evt)        ((lwcellr_t)(evt)->evt.publish.res)
 
+/**
+ * \brief           Get reason code of MQTT 5.0 publish acknowledge
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Reason code, `0` on success or with MQTT 3.1.1
+ * \hideinitializer
+ */
+#define lwcell_mqtt_client_evt_publish_get_reason(client, evt)         ((uint8_t)(evt)->evt.publish.reason)
+
+/**
+ * \}
+ */
+
+/**
+ * \anchor          LWCELL_APP_MQTT_CLIENT_EVT_PUBLISH_WRITE
+ * \name            Publish write event
+ * \{
+ *
+ * \note            Use these functions on \ref LWCELL_MQTT_EVT_PUBLISH_WRITE event
+ */
+
+/**
+ * \brief           Get user argument used on \ref lwcell_mqtt_client_publish_begin
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          User argument
+ * \hideinitializer
+ */
+#define lwcell_mqtt_client_evt_publish_write_get_argument(client, evt) ((void*)(evt)->evt.publish_write.arg)
+
+/**
+ * \brief           Get number of payload bytes that can be written with \ref lwcell_mqtt_client_publish_write
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Number of bytes
+ * \hideinitializer
+ */
+#define lwcell_mqtt_client_evt_publish_write_get_len(client, evt)      (LWCELL_SZ((evt)->evt.publish_write.len))
+
+/**
+ * \brief           Get number of payload bytes not written yet
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Number of bytes
+ * \hideinitializer
+ */
+#define lwcell_mqtt_client_evt_publish_write_get_left(client, evt)     ((uint32_t)(evt)->evt.publish_write.left)
+
 /**
  * \}
  */
@@ -0,0 +1,95 @@
+/**
+ * \file            lwcell_cmd_stats.h
+ * \brief           Command latency statistics
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWCELL_CMD_STATS_HDR_H
+#define LWCELL_CMD_STATS_HDR_H
+
+#include "lwcell/lwcell_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWCELL
+ * \defgroup        LWCELL_CMD_STATS Command statistics
+ * \brief           Command latency statistics and AT round-trip timing
+ * \{
+ *
+ * Every command is timestamped when it is put to producer queue,
+ * when producer thread takes it from the queue and when it completes.
+ * Every AT step (sub-command) is timestamped when first byte is sent to AT port,
+ * when first response byte is received and when final `OK` or `ERROR` is received.
+ *
+ * Histograms use `log2` buckets in units of milliseconds.
+ * Bucket `0` counts times below `1 ms`, bucket `n` counts times in range `[2^(n-1), 2^n) ms`
+ * and last bucket counts all longer times.
+ */
+
+/**
+ * \brief           Statistics for single command type
+ * \note            All times are in units of milliseconds
+ */
+typedef struct {
+    /* Command, as requested by API function */
+    uint32_t count;                                           /*!< Number of finished commands */
+    uint32_t errors;                                          /*!< Number of commands finished with error */
+    uint32_t timeouts;                                        /*!< Number of commands finished with timeout */
+    uint32_t queue_wait_total;                                /*!< Total time waiting in producer queue */
+    uint32_t queue_wait_max;                                  /*!< Maximal time waiting in producer queue */
+    uint32_t exec_total;                                      /*!< Total time from dequeue to completion */
+    uint32_t exec_max;                                        /*!< Maximal time from dequeue to completion */
+    uint32_t queue_wait_hist[LWCELL_CFG_CMD_STATS_HIST_SIZE]; /*!< Histogram of time waiting in producer queue */
+
+    /* AT step, sent as part of any command sequence */
+    uint32_t step_count;                                 /*!< Number of AT steps with final response */
+    uint32_t step_errors;                                /*!< Number of AT steps finished with `ERROR` */
+    uint32_t first_resp_total;                           /*!< Total time from first byte sent to first byte received */
+    uint32_t modem_total;                                /*!< Total time from first byte sent to final response */
+    uint32_t modem_max;                                  /*!< Maximal time from first byte sent to final response */
+    uint32_t modem_hist[LWCELL_CFG_CMD_STATS_HIST_SIZE]; /*!< Histogram of time from first byte sent to final response */
+} lwcell_cmd_stats_t;
+
+size_t lwcell_cmd_stats_get_count(void);
+lwcellr_t lwcell_cmd_stats_get(size_t cmd, lwcell_cmd_stats_t* stats);
+lwcellr_t lwcell_cmd_stats_reset(void);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWCELL_CMD_STATS_HDR_H */
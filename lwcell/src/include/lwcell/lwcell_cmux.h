@@ -0,0 +1,73 @@
+/**
+ * \file            lwcell_cmux.h
+ * \brief           AT port multiplexer, 3GPP TS 27.010
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWCELL_CMUX_HDR_H
+#define LWCELL_CMUX_HDR_H
+
+#include "lwcell/lwcell_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWCELL
+ * \defgroup        LWCELL_CMUX AT port multiplexer
+ * \brief           3GPP TS 27.010 basic mode multiplexer with separate AT and data channels
+ * \{
+ *
+ * Multiplexer runs between low-level AT port and input processing.
+ * It is started by reset sequence, when \ref LWCELL_CFG_CMUX is enabled,
+ * and opens `3` channels:
+ *
+ *  - DLCI `0`: Multiplexer control channel
+ *  - DLCI `1`: AT commands, responses and URCs
+ *  - DLCI `2`: Connection and HTTP data commands, including received data
+ *
+ * Every channel has its own receive line buffer and parser state,
+ * hence partially received connection data on data channel do not block lines on AT channel.
+ *
+ * \note            Commands are still executed one by one by producer thread
+ */
+
+uint8_t lwcell_cmux_is_active(void);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWCELL_CMUX_HDR_H */
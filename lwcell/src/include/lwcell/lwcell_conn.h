@@ -51,6 +51,8 @@ lwcellr_t lwcell_conn_start(lwcell_conn_p* conn, lwcell_conn_type_t type, const
                           void* const arg, lwcell_evt_fn conn_evt_fn, const uint32_t blocking);
 lwcellr_t lwcell_conn_close(lwcell_conn_p conn, const uint32_t blocking);
 lwcellr_t lwcell_conn_send(lwcell_conn_p conn, const void* data, size_t btw, size_t* const bw, const uint32_t blocking);
+lwcellr_t lwcell_conn_send_parts(lwcell_conn_p conn, const void* data, size_t btw, const void* data2, size_t btw2,
+                                size_t* const bw, const uint32_t blocking);
 lwcellr_t lwcell_conn_sendto(lwcell_conn_p conn, const lwcell_ip_t* const ip, lwcell_port_t port, const void* data,
                            size_t btw, size_t* bw, const uint32_t blocking);
 lwcellr_t lwcell_conn_set_arg(lwcell_conn_p conn, void* const arg);
@@ -64,6 +66,7 @@ lwcell_conn_p lwcell_conn_get_from_evt(lwcell_evt_t* evt);
 lwcellr_t lwcell_conn_write(lwcell_conn_p conn, const void* data, size_t btw, uint8_t flush, size_t* const mem_available);
 lwcellr_t lwcell_conn_recved(lwcell_conn_p conn, lwcell_pbuf_p pbuf);
 size_t lwcell_conn_get_total_recved_count(lwcell_conn_p conn);
+size_t lwcell_conn_get_total_sent_count(lwcell_conn_p conn);
 
 uint8_t lwcell_conn_get_remote_ip(lwcell_conn_p conn, lwcell_ip_t* ip);
 lwcell_port_t lwcell_conn_get_remote_port(lwcell_conn_p conn);
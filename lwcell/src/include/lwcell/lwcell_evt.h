@@ -48,9 +48,15 @@ extern "C" {
  */
 
 lwcellr_t lwcell_evt_register(lwcell_evt_fn fn);
+lwcellr_t lwcell_evt_register_mask(lwcell_evt_fn fn, lwcell_evt_mask_t mask);
 lwcellr_t lwcell_evt_unregister(lwcell_evt_fn fn);
 lwcell_evt_type_t lwcell_evt_get_type(lwcell_evt_t* cc);
 
+#if LWCELL_CFG_EVT_DISPATCH || __DOXYGEN__
+lwcellr_t lwcell_evt_dispatch_set_policy(lwcell_evt_type_t type, lwcell_evt_dispatch_policy_t policy);
+lwcellr_t lwcell_evt_dispatch_get_stats(lwcell_evt_dispatch_stats_t* stats);
+#endif /* LWCELL_CFG_EVT_DISPATCH || __DOXYGEN__ */
+
 /**
  * \anchor          LWCELL_EVT_RESET
  * \name            Reset event
@@ -257,6 +263,19 @@ lwcellr_t lwcell_evt_operator_scan_get_result(lwcell_evt_t* cc);
 lwcell_operator_t* lwcell_evt_operator_scan_get_entries(lwcell_evt_t* cc);
 size_t lwcell_evt_operator_scan_get_length(lwcell_evt_t* cc);
 
+/**
+ * \}
+ */
+
+/**
+ * \anchor          LWCELL_EVT_HTTP_POST_PROGRESS
+ * \name            HTTP POST progress
+ * \brief           Event helper functions for \ref LWCELL_EVT_HTTP_POST_PROGRESS event
+ */
+
+uint32_t lwcell_evt_http_post_progress_get_sent(lwcell_evt_t* cc);
+uint32_t lwcell_evt_http_post_progress_get_total(lwcell_evt_t* cc);
+
 /**
  * \}
  */
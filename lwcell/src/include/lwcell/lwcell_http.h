@@ -146,6 +146,34 @@ typedef enum {
     LWCELL_HTTPCONN_TYPE_HTTPS = LWCELL_CONN_TYPE_HTTPS,
 }lwcell_httpconn_type_t;
 
+/**
+ * \brief           Callback function for body data of range request
+ *
+ * Function is called from processing thread for every received packet buffer.
+ * Buffer is freed by the stack after function returns,
+ * use \ref lwcell_pbuf_ref to keep it for later processing.
+ *
+ * \param[in]       pbuf: Packet buffer with body data
+ * \param[in]       offset: Offset of first byte in `pbuf`, relative to the beginning of the resource
+ * \param[in]       arg: User argument
+ * \return          \ref lwcellOK to continue receiving, any other value to skip remaining data of the range
+ */
+typedef lwcellr_t (*lwcell_http_range_fn)(lwcell_pbuf_p pbuf, uint32_t offset, void* arg);
+
+/**
+ * \brief           Callback function producing body of POST request
+ *
+ * Function is called from processing thread, while device waits for body data,
+ * and must not call any blocking API function.
+ *
+ * \param[out]      buff: Buffer to fill with body data
+ * \param[in]       btw: Number of bytes to write to `buff`
+ * \param[in]       offset: Offset of first byte to write, relative to the beginning of the body
+ * \param[in]       arg: User argument
+ * \return          Number of bytes written to `buff`. Any value lower than `btw` aborts the request
+ */
+typedef size_t (*lwcell_http_body_fn)(void* buff, size_t btw, uint32_t offset, void* arg);
+
 
 lwcellr_t lwcell_http_request_attach(void);
 lwcellr_t lwcell_http_request_detach(void);
@@ -160,6 +188,20 @@ lwcellr_t lwcell_http_client_close(lwcell_http_client_p client);
 
 lwcellr_t lwcell_http_client_write(lwcell_http_client_p client, const void* data, size_t btw);
 
+lwcellr_t lwcell_http_get_range(const char* url, uint32_t offset, uint32_t len, lwcell_http_range_fn recv_fn,
+                                void* arg, uint16_t* status, const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg,
+                                const uint32_t blocking);
+lwcellr_t lwcell_http_download(const char* url, uint32_t offset, uint32_t range_len, lwcell_http_range_fn recv_fn,
+                               void* arg, uint32_t* downloaded);
+lwcellr_t lwcell_http_post(const char* url, const char* content_type, uint32_t len, lwcell_http_body_fn body_fn,
+                           void* body_arg, lwcell_http_range_fn recv_fn, void* recv_arg, uint16_t* status,
+                           const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+lwcellr_t lwcell_http_post_pbuf(const char* url, const char* content_type, lwcell_pbuf_p pbuf,
+                                lwcell_http_range_fn recv_fn, void* recv_arg, uint16_t* status,
+                                const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+lwcellr_t lwcell_http_set_keep_alive(uint32_t idle_time);
+lwcellr_t lwcell_http_session_close(const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+
 
 /**
  * \}
@@ -45,6 +45,7 @@
 #include "lwcell/lwcell_opt.h"
 #include "lwcell/lwcell_pbuf.h"
 #include "lwcell/lwcell_sim.h"
+#include "lwcell/lwcell_trace.h"
 #include "lwcell/lwcell_types.h"
 #include "lwcell/lwcell_utils.h"
 #include "system/lwcell_sys.h"
@@ -67,6 +68,24 @@
 #if LWCELL_CFG_USSD || __DOXYGEN__
 #include "lwcell/lwcell_ussd.h"
 #endif /* LWCELL_CFG_USSD || __DOXYGEN__ */
+#if LWCELL_CFG_CMD_STATS || __DOXYGEN__
+#include "lwcell/lwcell_cmd_stats.h"
+#endif /* LWCELL_CFG_CMD_STATS || __DOXYGEN__ */
+#if LWCELL_CFG_STATS || __DOXYGEN__
+#include "lwcell/lwcell_stats.h"
+#endif /* LWCELL_CFG_STATS || __DOXYGEN__ */
+#if LWCELL_CFG_CMUX || __DOXYGEN__
+#include "lwcell/lwcell_cmux.h"
+#endif /* LWCELL_CFG_CMUX || __DOXYGEN__ */
+#if LWCELL_CFG_TRANSPARENT || __DOXYGEN__
+#include "lwcell/lwcell_transparent.h"
+#endif /* LWCELL_CFG_TRANSPARENT || __DOXYGEN__ */
+#if LWCELL_CFG_PPP || __DOXYGEN__
+#include "lwcell/lwcell_ppp.h"
+#endif /* LWCELL_CFG_PPP || __DOXYGEN__ */
+#if LWCELL_CFG_HTTP || __DOXYGEN__
+#include "lwcell/lwcell_http.h"
+#endif /* LWCELL_CFG_HTTP || __DOXYGEN__ */
 
 #ifdef __cplusplus
 extern "C" {
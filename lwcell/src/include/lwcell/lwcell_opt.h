@@ -165,6 +165,66 @@
 #define LWCELL_CFG_AT_PORT_BAUDRATE 115200
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` automatic AT port baudrate negotiation in reset sequence
+ *
+ * When enabled and \ref lwcell_ll_t.reconfigure_fn is set by low-level driver,
+ * reset sequence first probes device with `AT` command on current,
+ * \ref LWCELL_CFG_AT_PORT_BAUDRATE_MAX and \ref LWCELL_CFG_AT_PORT_BAUDRATE baudrates.
+ * After reset, device is switched to \ref LWCELL_CFG_AT_PORT_BAUDRATE_MAX with `AT+IPR` command,
+ * new baudrate is verified with `AT` command and saved to device with `AT&W` command.
+ * On verification failure, previous baudrate is restored.
+ *
+ * \note            Low-level driver may restore baudrate saved in non-volatile memory
+ *                  to \ref lwcell_ll_t.uart.baudrate in \ref lwcell_ll_init,
+ *                  to skip probing on next boot. Driver is informed about every change
+ *                  with \ref lwcell_ll_t.reconfigure_fn callback
+ */
+#ifndef LWCELL_CFG_AT_PORT_AUTOBAUD
+#define LWCELL_CFG_AT_PORT_AUTOBAUD 0
+#endif
+
+/**
+ * \brief           Maximal baudrate, set to device by \ref LWCELL_CFG_AT_PORT_AUTOBAUD feature
+ */
+#ifndef LWCELL_CFG_AT_PORT_BAUDRATE_MAX
+#define LWCELL_CFG_AT_PORT_BAUDRATE_MAX 921600
+#endif
+
+/**
+ * \brief           Time in units of milliseconds to wait for response
+ *                  to single `AT` probe command during baudrate negotiation
+ */
+#ifndef LWCELL_CFG_AT_PORT_PROBE_TIMEOUT
+#define LWCELL_CFG_AT_PORT_PROBE_TIMEOUT 300
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` 3GPP TS 27.010 (GSM 07.10) multiplexer on AT port
+ *
+ * When enabled, reset sequence switches device to basic mode multiplexer with `AT+CMUX` command
+ * as last step and opens control, AT and data channels.
+ * Connection and HTTP data commands are sent over data channel, all other commands over AT channel.
+ * Each channel has its own receive buffer and parser context,
+ * so received connection data no longer delay responses and URCs on AT channel.
+ *
+ * \note            When device refuses multiplexer mode, library continues without it
+ * \sa              lwcell_cmux_is_active
+ */
+#ifndef LWCELL_CFG_CMUX
+#define LWCELL_CFG_CMUX 0
+#endif
+
+/**
+ * \brief           Maximal information field length of multiplexer frame, `N1` parameter of `AT+CMUX` command
+ *
+ * It defines size of transmit and receive frame buffers.
+ * Feature must be enabled with \ref LWCELL_CFG_CMUX
+ */
+#ifndef LWCELL_CFG_CMUX_N1
+#define LWCELL_CFG_CMUX_N1 127
+#endif
+
 /**
  * \brief           Buffer size for received data waiting to be processed
  * \note            When server mode is active and a lot of connections are in queue
@@ -383,6 +443,74 @@
 #define LWCELL_CFG_AT_ECHO 0
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` command latency statistics
+ *
+ * When enabled, every command and every AT step is timestamped
+ * and results are accumulated to per-command histograms.
+ * Use \ref lwcell_cmd_stats_get to read them.
+ *
+ * \note            Statistics table is allocated statically for all command types
+ */
+#ifndef LWCELL_CFG_CMD_STATS
+#define LWCELL_CFG_CMD_STATS 0
+#endif
+
+/**
+ * \brief           Number of `log2` buckets in command latency histograms
+ *
+ * Feature must be enabled with \ref LWCELL_CFG_CMD_STATS
+ */
+#ifndef LWCELL_CFG_CMD_STATS_HIST_SIZE
+#define LWCELL_CFG_CMD_STATS_HIST_SIZE 12
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` throughput counters
+ *
+ * When enabled, library counts bytes on AT port, parsed lines,
+ * connection data and command results.
+ * Use \ref lwcell_stats_get or \ref lwcell_stats_get_delta to read them.
+ */
+#ifndef LWCELL_CFG_STATS
+#define LWCELL_CFG_STATS 0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` binary trace ring buffer
+ *
+ * Trace records are compact binary entries, written without string formatting.
+ * They are cheap enough to be kept enabled in production builds.
+ *
+ * \sa              LWCELL_TRACE
+ */
+#ifndef LWCELL_CFG_TRACE
+#define LWCELL_CFG_TRACE 0
+#endif
+
+/**
+ * \brief           Number of records in trace ring buffer
+ *
+ * \note            Value must be power of `2`
+ *
+ * Feature must be enabled with \ref LWCELL_CFG_TRACE
+ */
+#ifndef LWCELL_CFG_TRACE_BUFF_SIZE
+#define LWCELL_CFG_TRACE_BUFF_SIZE 256
+#endif
+
+/**
+ * \brief           Timestamp source for trace records
+ *
+ * By default, milliseconds from system port are used.
+ * It can be set to hardware cycle counter for better resolution.
+ *
+ * Feature must be enabled with \ref LWCELL_CFG_TRACE
+ */
+#ifndef LWCELL_CFG_TRACE_TIMESTAMP
+#define LWCELL_CFG_TRACE_TIMESTAMP() lwcell_sys_now()
+#endif
+
 /**
  * \}
  */
@@ -446,6 +574,43 @@
 #define LWCELL_THREAD_PROCESS_HOOK()
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` deferred event dispatch thread
+ *
+ * When enabled, events to registered callbacks are copied to a bounded queue
+ * and delivered from separate thread, so that slow application callbacks
+ * do not stall AT port parsing.
+ *
+ * \note            Deferred callbacks are called without core lock being held.
+ *                  Delivery mode is configurable per event type with \ref lwcell_evt_dispatch_set_policy
+ *
+ * \note            This mode can only be used when \ref LWCELL_CFG_OS is enabled
+ */
+#ifndef LWCELL_CFG_EVT_DISPATCH
+#define LWCELL_CFG_EVT_DISPATCH 0
+#endif
+
+/**
+ * \brief           Number of events that can wait in dispatch queue at the same time
+ *
+ * Feature must be enabled with \ref LWCELL_CFG_EVT_DISPATCH
+ */
+#ifndef LWCELL_CFG_EVT_DISPATCH_QUEUE_SIZE
+#define LWCELL_CFG_EVT_DISPATCH_QUEUE_SIZE 16
+#endif
+
+/**
+ * \brief           Default dispatch policy for global events
+ *
+ * Connection events are always delivered synchronously by default
+ * and must be moved to dispatch thread with \ref lwcell_evt_dispatch_set_policy.
+ *
+ * Feature must be enabled with \ref LWCELL_CFG_EVT_DISPATCH
+ */
+#ifndef LWCELL_CFG_EVT_DISPATCH_POLICY_DEFAULT
+#define LWCELL_CFG_EVT_DISPATCH_POLICY_DEFAULT LWCELL_EVT_DISPATCH_POLICY_SYNC_ON_FULL
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` custom memory byte pool extension for ThreadX port
  *
@@ -547,6 +712,96 @@
 #define LWCELL_CFG_MQTT_MAX_REQUESTS 8
 #endif
 
+/**
+ * \brief           Maximal number of `QoS > 0` publish messages waiting for acknowledge from server
+ *
+ * When limit is reached, \ref lwcell_mqtt_client_publish returns \ref lwcellERRMEM
+ * for `QoS > 0` messages until acknowledge is received.
+ * Set it lower than \ref LWCELL_CFG_MQTT_MAX_REQUESTS to keep requests available
+ * for subscribe and `QoS 0` messages.
+ */
+#ifndef LWCELL_CFG_MQTT_MAX_INFLIGHT
+#define LWCELL_CFG_MQTT_MAX_INFLIGHT LWCELL_CFG_MQTT_MAX_REQUESTS
+#endif
+
+/**
+ * \brief           Time in units of milliseconds to wait for acknowledge
+ *                  before `QoS > 0` publish message or publish release is sent again
+ *
+ * Publish messages are resent with `DUP` flag set.
+ * MQTT 5.0 client does not send messages again on the same connection,
+ * it only waits for acknowledge up to \ref LWCELL_CFG_MQTT_MAX_RETRANSMITS timeouts.
+ * Copy of each `QoS > 0` publish message is kept in memory until acknowledged.
+ * Set to `0` to disable retransmission
+ */
+#ifndef LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT
+#define LWCELL_CFG_MQTT_RETRANSMIT_TIMEOUT 0
+#endif
+
+/**
+ * \brief           Maximal number of retransmissions of single message
+ *
+ * Connection is closed when message is not acknowledged after last retransmission,
+ * or after the same number of timeouts with MQTT 5.0
+ */
+#ifndef LWCELL_CFG_MQTT_MAX_RETRANSMITS
+#define LWCELL_CFG_MQTT_MAX_RETRANSMITS 3
+#endif
+
+/**
+ * \brief           Maximal number of send commands MQTT client queues to connection at a time
+ *
+ * Values above `1` let client queue next packets while previous are being sent,
+ * instead of waiting for send confirmation of each command.
+ */
+#ifndef LWCELL_CFG_MQTT_MAX_SENDS
+#define LWCELL_CFG_MQTT_MAX_SENDS 2
+#endif
+
+/**
+ * \brief           Minimal number of bytes waiting in MQTT output buffer
+ *                  before client queues another send while previous one is still in progress
+ *
+ * Small packets written in the meantime are coalesced and sent with single command
+ * once previous send completes.
+ */
+#ifndef LWCELL_CFG_MQTT_TX_COALESCE_LEN
+#define LWCELL_CFG_MQTT_TX_COALESCE_LEN LWCELL_CFG_CONN_MAX_DATA_LEN
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` MQTT 5.0 protocol in MQTT client.
+ *
+ * When enabled, client connects with MQTT 5.0
+ * if \ref lwcell_mqtt_client_info_t::version is set to `5`, otherwise MQTT 3.1.1 is used.
+ */
+#ifndef LWCELL_CFG_MQTT_V5
+#define LWCELL_CFG_MQTT_V5 0
+#endif
+
+/**
+ * \brief           Maximal number of MQTT 5.0 topic aliases used on publish
+ *
+ * First published topics are assigned an alias, up to limit set by server,
+ * and following messages on the same topic are sent without topic string.
+ * Each alias keeps copy of its topic in memory for connection lifetime.
+ * Set to `0` to disable topic aliases
+ */
+#ifndef LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX
+#define LWCELL_CFG_MQTT_TOPIC_ALIAS_MAX 4
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` MQTT client manager.
+ *
+ * Manager owns several MQTT clients, allocates their buffers from single memory pool,
+ * shares \ref LWCELL_CFG_MQTT_MAX_SENDS send commands between them by weight
+ * and moves queued messages to backup client when connection closes
+ */
+#ifndef LWCELL_CFG_MQTT_MGR
+#define LWCELL_CFG_MQTT_MGR 0
+#endif
+
 /**
  * \brief           Size of MQTT API message queue for received messages
  *
@@ -555,6 +810,18 @@
 #define LWCELL_CFG_MQTT_API_MBOX_SIZE 8
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` zero-copy receive buffers in MQTT API.
+ *
+ * When enabled, received payload is not copied to new memory,
+ * buffer references packet buffer received from connection instead.
+ * Payload is then not `NULL` terminated, use its length.
+ * Payload is copied when message was reassembled from multiple packet buffers.
+ */
+#ifndef LWCELL_CFG_MQTT_API_ZERO_COPY
+#define LWCELL_CFG_MQTT_API_ZERO_COPY 0
+#endif
+
 /**
  * \brief           Set debug level for MQTT client module
  *
@@ -607,6 +874,65 @@
 #define LWCELL_CFG_CONN 0
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` transparent mode (`AT+CIPMODE=1`) for single connection.
+ *
+ * In transparent mode device is switched to single connection and data mode,
+ * raw connection data are exchanged with device without `AT+CIPSEND` and `+RECEIVE` framing.
+ * Connection API can not be used during transparent session.
+ *
+ * \note            \ref LWCELL_CFG_CONN must be enabled to use transparent mode
+ * \sa              lwcell_transparent_start
+ */
+#ifndef LWCELL_CFG_TRANSPARENT
+#define LWCELL_CFG_TRANSPARENT 0
+#endif
+
+/**
+ * \brief           Guard time in units of milliseconds before and after `+++` escape sequence,
+ *                  used to return from data mode to command mode
+ *
+ * Value must not be lower than guard time configured in device.
+ * Feature must be enabled with \ref LWCELL_CFG_TRANSPARENT
+ */
+#ifndef LWCELL_CFG_TRANSPARENT_GUARD_TIME
+#define LWCELL_CFG_TRANSPARENT_GUARD_TIME 1000
+#endif
+
+/**
+ * \brief           Time in units of milliseconds received characters matching start of `CLOSED` notification
+ *                  are kept back in data mode, waiting for the rest of notification
+ *
+ * Characters are passed to application as connection data when notification does not follow in this time.
+ * Feature must be enabled with \ref LWCELL_CFG_TRANSPARENT
+ */
+#ifndef LWCELL_CFG_TRANSPARENT_HOLD_TIME
+#define LWCELL_CFG_TRANSPARENT_HOLD_TIME 20
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` PPP data mode for external IP stack.
+ *
+ * Device dials packet data call with `ATD*99#` and PPP byte stream is exchanged
+ * with network interface of application IP stack, such as lwIP `pppos`.
+ * When \ref LWCELL_CFG_CMUX is enabled, PPP uses data channel and AT commands remain available.
+ *
+ * \sa              lwcell_ppp_start
+ */
+#ifndef LWCELL_CFG_PPP
+#define LWCELL_CFG_PPP 0
+#endif
+
+/**
+ * \brief           Guard time in units of milliseconds before and after `+++` escape sequence,
+ *                  used when PPP data mode is stopped while link is still up
+ *
+ * Feature must be enabled with \ref LWCELL_CFG_PPP
+ */
+#ifndef LWCELL_CFG_PPP_GUARD_TIME
+#define LWCELL_CFG_PPP_GUARD_TIME 1000
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` SMS API.
  *
@@ -640,6 +966,75 @@
 #define LWCELL_CFG_HTTP 0
 #endif
 
+/**
+ * \brief           Number of attempts to get the same range again in \ref lwcell_http_download,
+ *                  before download fails
+ *
+ * Counter is reset after every range, where at least one byte has been received.
+ */
+#ifndef LWCELL_CFG_HTTP_DOWNLOAD_RETRIES
+#define LWCELL_CFG_HTTP_DOWNLOAD_RETRIES 3
+#endif
+
+/**
+ * \brief           Length of HTTP POST body segment in units of bytes
+ *
+ * Body is requested from application and written to device one segment at a time,
+ * only one segment is allocated during upload.
+ * \ref LWCELL_EVT_HTTP_POST_PROGRESS event is sent after every segment.
+ */
+#ifndef LWCELL_CFG_HTTP_POST_SEGMENT_LEN
+#define LWCELL_CFG_HTTP_POST_SEGMENT_LEN 512
+#endif
+
+/**
+ * \brief           Maximal length of HTTP POST body accepted by `AT+HTTPDATA` command
+ *
+ * Default value matches HTTP data buffer of SIM800 series
+ */
+#ifndef LWCELL_CFG_HTTP_POST_MAX_LEN
+#define LWCELL_CFG_HTTP_POST_MAX_LEN 319488
+#endif
+
+/**
+ * \brief           Default time in units of milliseconds to keep HTTP service of device initialized
+ *                  after request has finished
+ *
+ * Service is not terminated with `AT+HTTPTERM` after successful request,
+ * next request reuses it and sends only parameters, which have changed since previous request.
+ * Service is terminated when no request has been started within this time.
+ * Set to `0` to initialize and terminate service for every request.
+ *
+ * Value can be changed at runtime with \ref lwcell_http_set_keep_alive
+ */
+#ifndef LWCELL_CFG_HTTP_KEEP_ALIVE
+#define LWCELL_CFG_HTTP_KEEP_ALIVE 0
+#endif
+
+/**
+ * \brief           Maximal length of URL and content type remembered by kept HTTP service,
+ *                  including `NULL` termination
+ *
+ * Longer values are sent to device for every request
+ */
+#ifndef LWCELL_CFG_HTTP_SESSION_PARAM_LEN
+#define LWCELL_CFG_HTTP_SESSION_PARAM_LEN 128
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` native MQTT of device.
+ *
+ * When enabled, \ref LWCELL_APP_MQTT_CLIENT uses MQTT stack of device (`AT+MCONFIG`, `AT+MIPSTART`, `AT+MPUB`, ...)
+ * instead of MQTT protocol implementation over connection API.
+ * MQTT framing, keep-alive and TCP buffering are handled by device, received messages are reported by `+MSUB`.
+ * Device supports one MQTT session at a time.
+ *
+ * \note            \ref LWCELL_CFG_NETWORK and \ref LWCELL_CFG_USE_API_FUNC_EVT must be enabled to use native MQTT
+ */
+#ifndef LWCELL_CFG_MQTT
+#define LWCELL_CFG_MQTT 0
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` FTP API.
  *
@@ -743,6 +1138,9 @@ void *  my_memset(void* dst, int b, size_t len);
 #if LWCELL_CFG_INPUT_USE_PROCESS
 #error "LWCELL_CFG_INPUT_USE_PROCESS may only be enabled when OS is used!"
 #endif /* LWCELL_CFG_INPUT_USE_PROCESS */
+#if LWCELL_CFG_EVT_DISPATCH
+#error "LWCELL_CFG_EVT_DISPATCH may only be enabled when OS is used!"
+#endif /* LWCELL_CFG_EVT_DISPATCH */
 #endif /* !LWCELL_CFG_OS */
 
 #endif /* !__DOXYGEN__ */
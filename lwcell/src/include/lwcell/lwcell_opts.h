@@ -68,7 +68,9 @@
 /// TODO: 应用层协议配置
 #define LWCELL_CFG_PROTOCOL          1
 #define LWCELL_CFG_HTTP              1
+#ifndef LWCELL_CFG_MQTT
 #define LWCELL_CFG_MQTT              0
+#endif
 #define LWCELL_CFG_FTP               0
 
 
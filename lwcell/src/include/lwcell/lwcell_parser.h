@@ -69,12 +69,21 @@ uint8_t lwcelli_parse_cipstatus_conn(const char* str, uint8_t is_conn_line, uint
 
 uint8_t lwcelli_parse_ipd(const char* str);
 
+#if LWCELL_CFG_MQTT
+uint8_t lwcelli_parse_msub(const char* str);
+#endif /* LWCELL_CFG_MQTT */
+
 uint8_t lwcell_parse_sapbr(const char *str, int *s);
 
 uint8_t lwcell_parse_httpread(const char* str);
 
 uint8_t lwcell_parse_httpaction(const char *str, int *code, int *dl);
 
+#if LWCELL_CFG_HTTP
+uint8_t lwcelli_parse_httpaction_range(const char* str);
+uint8_t lwcelli_parse_httpread_range(const char* str);
+#endif /* LWCELL_CFG_HTTP */
+
 #if defined(__cplusplus)
 }
 #endif /* defined(__cplusplus) */
@@ -0,0 +1,133 @@
+/**
+ * \file            lwcell_ppp.h
+ * \brief           PPP data mode API
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWCELL_PPP_HDR_H
+#define LWCELL_PPP_HDR_H
+
+#include "lwcell/lwcell_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWCELL
+ * \defgroup        LWCELL_PPP PPP data mode API
+ * \brief           Packet data call with PPP handled by external IP stack
+ * \{
+ *
+ * PPP session sets PDP context with `AT+CGDCONT` and dials packet data call with `ATD*99#`.
+ * When device replies with `CONNECT`, PPP byte stream is exchanged with network interface of application,
+ * which passes it to PPP implementation of its IP stack, such as lwIP `pppos`.
+ * Library does not parse PPP frames, IP stack is responsible for link negotiation, sockets and TLS.
+ *
+ * When \ref LWCELL_CFG_CMUX is enabled and multiplexer data channel is open,
+ * PPP runs on data channel. AT channel stays in command mode and library keeps handling
+ * network registration, signal quality, SMS and other commands during PPP session.
+ * Without multiplexer, AT port is occupied by PPP and other commands are rejected until session is stopped.
+ *
+ * Session normally ends when IP stack terminates PPP link and device replies with `NO CARRIER`.
+ * \ref lwcell_ppp_stop sends `+++` escape sequence with guard time and hangs up data call,
+ * when device is still in PPP mode.
+ *
+ * Example glue code for lwIP `pppos` interface, with `LWIP_TCPIP_CORE_LOCKING_INPUT` disabled:
+ *
+ * \code{c}
+static ppp_pcb* ppp;
+static struct netif ppp_netif;
+
+static u32_t
+ppp_output_cb(ppp_pcb* pcb, const void* data, u32_t len, void* ctx) {
+    return (u32_t)lwcell_ppp_output(data, len);
+}
+
+static void
+ppp_input_fn(const void* data, size_t len, void* arg) {
+    pppos_input_tcpip(ppp, (const u8_t*)data, (int)len);
+}
+
+static void
+ppp_link_fn(uint8_t up, void* arg) {
+    if (up) {
+        ppp_connect(ppp, 0);
+    }
+}
+
+static const lwcell_ppp_netif_t netif = {
+    .input_fn = ppp_input_fn,
+    .link_fn = ppp_link_fn,
+};
+
+ppp = pppos_create(&ppp_netif, ppp_output_cb, ppp_status_cb, NULL);
+lwcell_ppp_start("internet", &netif, NULL, NULL, NULL, 1);
+ * \endcode
+ */
+
+/**
+ * \brief           Network interface of external IP stack.
+ *
+ * Functions are called from processing thread with core locked.
+ * They must not block and must not call blocking library functions.
+ */
+typedef struct {
+    /**
+     * \brief       Pass PPP data received from device to IP stack
+     * \param[in]   data: Received data
+     * \param[in]   len: Length of data in units of bytes
+     * \param[in]   arg: User argument
+     */
+    void (*input_fn)(const void* data, size_t len, void* arg);
+
+    /**
+     * \brief       PPP data mode status has changed
+     * \param[in]   up: `1` when device entered PPP data mode, `0` when it left it
+     * \param[in]   arg: User argument
+     */
+    void (*link_fn)(uint8_t up, void* arg);
+} lwcell_ppp_netif_t;
+
+lwcellr_t lwcell_ppp_start(const char* apn, const lwcell_ppp_netif_t* netif, void* const arg,
+                           const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+size_t lwcell_ppp_output(const void* data, size_t len);
+lwcellr_t lwcell_ppp_stop(const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+uint8_t lwcell_ppp_is_active(void);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWCELL_PPP_HDR_H */
@@ -42,6 +42,8 @@
 #include "lwcell/lwcell_opt.h"
 #include "lwcell/lwcell_parser.h"
 #include "lwcell/lwcell_timeout.h"
+#include "lwcell/lwcell_stats.h"
+#include "lwcell/lwcell_trace.h"
 #include "lwcell/lwcell_types.h"
 #include "lwcell/lwcell_unicode.h"
 
@@ -63,6 +65,10 @@ typedef enum {
     /* Basic AT commands */
     LWCELL_CMD_RESET,                  /*!< Reset device */
     LWCELL_CMD_RESET_DEVICE_FIRST_CMD, /*!< Reset device first driver specific command */
+    LWCELL_CMD_AT_PORT_PROBE,          /*!< Probe device with `AT` command during baudrate negotiation */
+    LWCELL_CMD_AT_PORT_VERIFY,         /*!< Verify communication with `AT` command after baudrate change */
+    LWCELL_CMD_CMUX_SET,               /*!< Enter multiplexer mode with `AT+CMUX` command */
+    LWCELL_CMD_CMUX_SABM,              /*!< Open multiplexer channel with `SABM` frame */
     LWCELL_CMD_ATE0,                   /*!< Disable ECHO mode on AT commands */
     LWCELL_CMD_ATE1,                   /*!< Enable ECHO mode on AT commands */
     LWCELL_CMD_GSLP,                   /*!< Set GSM to sleep mode */
@@ -80,6 +86,15 @@ typedef enum {
     LWCELL_CMD_CIPRXGET_SET,
     LWCELL_CMD_CSTT_SET,
 
+    LWCELL_CMD_TRANSPARENT_START,  /*!< Start transparent mode session */
+    LWCELL_CMD_TRANSPARENT_STOP,   /*!< Stop transparent mode session */
+    LWCELL_CMD_TRANSPARENT_ESCAPE, /*!< Send `+++` escape sequence with guard time */
+
+    LWCELL_CMD_PPP_START,   /*!< Start PPP data mode session */
+    LWCELL_CMD_PPP_STOP,    /*!< Stop PPP data mode session */
+    LWCELL_CMD_CGDCONT_SET, /*!< Define PDP context used by packet data call */
+    LWCELL_CMD_PPP_DIAL,    /*!< Dial packet data call with `ATD*99#` */
+
     LWCELL_CMD_CCID_GET,
     LWCELL_CMD_ICCID_GET,
 
@@ -289,8 +304,21 @@ typedef enum {
     LWCELL_CMD_HTTPHEAD,
     LWCELL_CMD_HTTPSCONT,
     LWCELL_CMD_HTTPTERM,
-
-    LWCELL_CMD_MQTT_ENABLE,
+    LWCELL_CMD_HTTP_GET_RANGE, /*!< Get range of HTTP resource with `AT+HTTPPARA="BREAK"` and `"BREAKEND"` */
+    LWCELL_CMD_HTTP_POST,      /*!< HTTP POST with body written in segments after `AT+HTTPDATA` */
+    LWCELL_CMD_HTTPPARA_CONTENT,
+    LWCELL_CMD_HTTP_SESSION_CLOSE, /*!< Terminate HTTP service kept initialized between requests */
+
+    LWCELL_CMD_MQTT_CONNECT,    /*!< Connect native MQTT session to broker */
+    LWCELL_CMD_MQTT_DISCONNECT, /*!< Disconnect native MQTT session from broker */
+    LWCELL_CMD_MCONFIG,         /*!< Set MQTT client identifier, credentials and will */
+    LWCELL_CMD_MIPSTART,        /*!< Open TCP connection to MQTT broker */
+    LWCELL_CMD_MCONNECT,        /*!< Send MQTT connect request to broker */
+    LWCELL_CMD_MSUB,            /*!< Subscribe to MQTT topic */
+    LWCELL_CMD_MUNSUB,          /*!< Unsubscribe from MQTT topic */
+    LWCELL_CMD_MPUB,            /*!< Publish MQTT message */
+    LWCELL_CMD_MDISCONNECT,     /*!< Send MQTT disconnect request to broker */
+    LWCELL_CMD_MIPCLOSE,        /*!< Close TCP connection to MQTT broker */
 
 
     LWCELL_CMD_END, /*!< Last CMD entry */
@@ -321,6 +349,7 @@ typedef struct lwcell_conn {
     lwcell_linbuff_t buff; /*!< Linear buffer structure */
 
     size_t total_recved; /*!< Total number of bytes received */
+    size_t total_sent;   /*!< Total number of bytes successfully sent */
 
     union {
         struct {
@@ -372,6 +401,27 @@ typedef enum {
     LWCELL_CONN_CONNECT_ALREADY, /*!< Already connected */
 } lwcell_conn_connect_res_t;
 
+#if LWCELL_CFG_MQTT || __DOXYGEN__
+
+/**
+ * \brief           Callback for message received on native MQTT session
+ * \param[in]       topic: Topic name, not `NULL` terminated
+ * \param[in]       topic_len: Length of topic name
+ * \param[in]       payload: Message payload
+ * \param[in]       payload_len: Length of payload
+ * \param[in]       arg: Session callbacks argument
+ */
+typedef void (*lwcell_mqtt_session_recv_fn)(const char* topic, size_t topic_len, const void* payload,
+                                            size_t payload_len, void* arg);
+
+/**
+ * \brief           Callback for native MQTT session closed by device or network
+ * \param[in]       arg: Session callbacks argument
+ */
+typedef void (*lwcell_mqtt_session_closed_fn)(void* arg);
+
+#endif /* LWCELL_CFG_MQTT || __DOXYGEN__ */
+
 /**
  * \brief           Message queue structure to share between threads
  */
@@ -385,6 +435,17 @@ typedef struct lwcell_msg {
     lwcellr_t res;        /*!< Result of message operation */
     lwcellr_t (*fn)(struct lwcell_msg*); /*!< Processing callback function to process packet */
 
+#if LWCELL_CFG_CMD_STATS || __DOXYGEN__
+    struct {
+        uint32_t t_enqueue;   /*!< Time when message was put to producer queue */
+        uint32_t t_dequeue;   /*!< Time when producer thread started processing message */
+        uint32_t t_step;      /*!< Time when first byte of current AT step was sent */
+        uint32_t t_step_resp; /*!< Time when first response byte of current AT step was received */
+        uint8_t step_active;  /*!< Set to `1` when AT step was sent and final response is expected */
+        uint8_t step_resp;    /*!< Set to `1` when first response byte of current AT step was received */
+    } stats;                  /*!< Command timing statistics */
+#endif                        /* LWCELL_CFG_CMD_STATS || __DOXYGEN__ */
+
 #if LWCELL_CFG_USE_API_FUNC_EVT
     lwcell_api_cmd_evt_fn evt_fn; /*!< Command callback API function */
     void* evt_arg;               /*!< Command callback API callback parameter */
@@ -393,7 +454,15 @@ typedef struct lwcell_msg {
     union {
         struct {
             uint32_t delay; /*!< Delay to use before sending first reset AT command */
-        } reset;            /*!< Reset device */
+#if LWCELL_CFG_AT_PORT_AUTOBAUD || __DOXYGEN__
+            uint32_t baudrate_prev; /*!< AT port baudrate before negotiation or last change */
+            uint8_t probe_idx;      /*!< Index of currently probed baudrate */
+            uint8_t ipr_failed;     /*!< Set to `1` when device stopped responding after baudrate change */
+#endif                              /* LWCELL_CFG_AT_PORT_AUTOBAUD || __DOXYGEN__ */
+#if LWCELL_CFG_CMUX || __DOXYGEN__
+            uint8_t cmux_dlci; /*!< Multiplexer channel being opened */
+#endif                         /* LWCELL_CFG_CMUX || __DOXYGEN__ */
+        } reset;                    /*!< Reset device */
 
         struct {
             uint32_t baudrate; /*!< Baudrate for AT port */
@@ -469,6 +538,74 @@ typedef struct lwcell_msg {
             uint8_t num;                       /*!< Connection number used for start */
             lwcell_conn_connect_res_t conn_res; /*!< Connection result status */
         } conn_start;                          /*!< Structure for starting new connection */
+#if LWCELL_CFG_TRANSPARENT || __DOXYGEN__
+        struct {
+            const char* apn;                    /*!< APN address */
+            const char* user;                   /*!< APN username */
+            const char* pass;                   /*!< APN password */
+            lwcell_conn_type_t type;            /*!< Connection type */
+            const char* host;                   /*!< Host to use for connection */
+            lwcell_port_t port;                 /*!< Remote port used for connection */
+            lwcell_transparent_recv_fn recv_fn; /*!< Receive callback */
+            void* arg;                          /*!< Receive callback argument */
+            lwcell_conn_connect_res_t conn_res; /*!< Connection result status */
+        } transparent_start;                    /*!< Start transparent mode session */
+#endif /* LWCELL_CFG_TRANSPARENT || __DOXYGEN__ */
+#if LWCELL_CFG_PPP || __DOXYGEN__
+        struct {
+            const char* apn;                 /*!< APN address */
+            const lwcell_ppp_netif_t* netif; /*!< Network interface of IP stack */
+            void* arg;                       /*!< Network interface argument */
+        } ppp_start;                         /*!< Start PPP data mode session */
+#endif /* LWCELL_CFG_PPP || __DOXYGEN__ */
+#if LWCELL_CFG_MQTT || __DOXYGEN__
+        struct {
+            const char* host;                        /*!< Broker host address */
+            lwcell_port_t port;                      /*!< Broker port */
+            const char* id;                          /*!< Client identifier */
+            const char* user;                        /*!< Authentication username */
+            const char* pass;                        /*!< Authentication password */
+            const char* will_topic;                  /*!< Will topic, `NULL` when not used */
+            const char* will_message;                /*!< Will message */
+            uint8_t will_qos;                        /*!< Will quality of service */
+            uint16_t keep_alive;                     /*!< Keep-alive interval in units of seconds */
+            uint8_t clean_session;                   /*!< Set to `1` to start clean session */
+            uint8_t* buff;                           /*!< Receive buffer for topic and payload */
+            size_t buff_len;                         /*!< Length of receive buffer */
+            lwcell_mqtt_session_recv_fn recv_fn;     /*!< Message receive callback */
+            lwcell_mqtt_session_closed_fn closed_fn; /*!< Session closed callback */
+            void* arg;                               /*!< Callbacks argument */
+        } mqtt_connect;                              /*!< Connect native MQTT session */
+
+        struct {
+            const char* topic; /*!< Topic name */
+            const void* data;  /*!< Message payload, only for publish */
+            size_t len;        /*!< Length of payload */
+            uint8_t qos;       /*!< Quality of service */
+            uint8_t retain;    /*!< Retain flag, only for publish */
+        } mqtt_topic;          /*!< Subscribe, unsubscribe or publish on native MQTT session */
+#endif /* LWCELL_CFG_MQTT || __DOXYGEN__ */
+#if LWCELL_CFG_HTTP || __DOXYGEN__
+        struct {
+            const char* url;              /*!< Resource URL */
+            uint32_t offset;              /*!< Offset of first byte of the range */
+            uint32_t len;                 /*!< Length of the range */
+            const char* content_type;     /*!< Content type of request body, `NULL` when not set */
+            lwcell_http_body_fn body_fn;  /*!< Request body producer */
+            void* body_arg;               /*!< Request body producer argument */
+            uint32_t body_len;            /*!< Length of request body */
+            uint32_t body_sent;           /*!< Number of body bytes written to device */
+            uint8_t body_failed;          /*!< Request body producer failed, body is not sent to server */
+            lwcell_http_range_fn recv_fn; /*!< Body data callback, `NULL` to skip response body */
+            void* arg;                    /*!< Callback argument */
+            uint16_t* status;             /*!< Pointer to output HTTP status code */
+            uint16_t code;                /*!< HTTP status code reported by device */
+            size_t data_len;              /*!< Length of body reported by device */
+            uint8_t is_init;              /*!< HTTP service of device is initialized for this request */
+            uint8_t init_retry;           /*!< Service initialization has been retried */
+            lwcellr_t res;                /*!< Result of request, reported after service is terminated */
+        } http_req;                       /*!< HTTP request with body exchanged in segments */
+#endif /* LWCELL_CFG_HTTP || __DOXYGEN__ */
 
         struct {
             lwcell_conn_t* conn; /*!< Pointer to connection to close */
@@ -480,6 +617,8 @@ typedef struct lwcell_msg {
             size_t btw;                  /*!< Number of remaining bytes to write */
             size_t ptr;                  /*!< Current write pointer for data */
             const uint8_t* data;         /*!< Data to send */
+            size_t data_len;             /*!< Length of `data`, further bytes are taken from `data2` */
+            const uint8_t* data2;        /*!< Second part of data to send, `NULL` when not used */
             size_t sent;                 /*!< Number of bytes sent in last packet */
             size_t sent_all;             /*!< Number of bytes sent all together */
             uint8_t tries;               /*!< Number of tries used for last packet */
@@ -625,6 +764,170 @@ typedef struct lwcell_evt_func {
     lwcell_evt_fn fn;             /*!< Function pointer itself */
 } lwcell_evt_func_t;
 
+#if LWCELL_CFG_EVT_DISPATCH || __DOXYGEN__
+
+/**
+ * \brief           Deferred event entry, waiting in dispatch queue
+ */
+typedef struct {
+    lwcell_evt_t evt;      /*!< Copy of event data at the time event occurred */
+#if LWCELL_CFG_CONN || __DOXYGEN__
+    lwcell_conn_p conn;    /*!< Connection for connection event, `NULL` for global event */
+    lwcell_evt_fn conn_fn; /*!< Connection callback function to call */
+    uint8_t conn_val_id;   /*!< Connection validation ID at the time event occurred */
+#endif                     /* LWCELL_CFG_CONN || __DOXYGEN__ */
+} lwcell_evt_dispatch_entry_t;
+
+/**
+ * \brief           Deferred event dispatch structure
+ */
+typedef struct {
+    lwcell_sys_mbox_t mbox;                                                  /*!< Dispatch thread message queue */
+    lwcell_sys_thread_t thread;                                              /*!< Dispatch thread handle */
+    lwcell_sys_mutex_t mutex;                                                /*!< Protects callback list walk */
+    lwcell_evt_dispatch_entry_t entries[LWCELL_CFG_EVT_DISPATCH_QUEUE_SIZE]; /*!< Queue entries */
+    size_t w;                                                                /*!< Index of next entry to write */
+    uint8_t policy[LWCELL_EVT_END];                                          /*!< Dispatch policy per event type */
+    lwcell_evt_dispatch_stats_t stats;                                       /*!< Queue statistics */
+} lwcell_evt_dispatch_t;
+
+#endif /* LWCELL_CFG_EVT_DISPATCH || __DOXYGEN__ */
+
+#if LWCELL_CFG_CMUX || __DOXYGEN__
+
+/**
+ * \brief           Multiplexer frame receive state
+ */
+typedef enum {
+    LWCELL_CMUX_RX_FLAG = 0x00, /*!< Waiting for opening flag */
+    LWCELL_CMUX_RX_ADDR,        /*!< Waiting for address field */
+    LWCELL_CMUX_RX_CTRL,        /*!< Waiting for control field */
+    LWCELL_CMUX_RX_LEN1,        /*!< Waiting for first length byte */
+    LWCELL_CMUX_RX_LEN2,        /*!< Waiting for second length byte */
+    LWCELL_CMUX_RX_DATA,        /*!< Receiving information field */
+    LWCELL_CMUX_RX_FCS,         /*!< Waiting for frame check sequence */
+    LWCELL_CMUX_RX_END,         /*!< Waiting for closing flag */
+} lwcell_cmux_rx_state_t;
+
+/**
+ * \brief           Multiplexer structure
+ */
+typedef struct {
+    uint8_t active;    /*!< Multiplexer mode is active on AT port */
+    uint8_t dlc_open;  /*!< Bit mask of open channels, bit position is channel DLCI */
+    uint8_t sabm_dlci; /*!< DLCI of channel waiting for `UA` or `DM` response */
+    uint8_t sabm_pend; /*!< Set to `1` when `SABM` frame is waiting for response */
+
+    struct {
+        lwcell_cmux_rx_state_t state;     /*!< Frame receive state */
+        uint8_t addr;                     /*!< Address field */
+        uint8_t ctrl;                     /*!< Control field */
+        uint8_t fcs;                      /*!< Running frame check sequence */
+        size_t len;                       /*!< Length of information field */
+        size_t ptr;                       /*!< Number of received information bytes */
+        uint8_t data[LWCELL_CFG_CMUX_N1]; /*!< Information field */
+    } rx;                                 /*!< Receive frame */
+
+    struct {
+        uint8_t dlci;                     /*!< Channel of buffered data */
+        size_t len;                       /*!< Number of buffered bytes */
+        uint8_t data[LWCELL_CFG_CMUX_N1]; /*!< Data waiting for flush */
+    } tx;                                 /*!< Transmit frame */
+} lwcell_cmux_t;
+
+#endif /* LWCELL_CFG_CMUX || __DOXYGEN__ */
+
+#if LWCELL_CFG_TRANSPARENT || __DOXYGEN__
+
+/**
+ * \brief           Transparent mode session state
+ */
+typedef struct {
+    uint8_t data_mode;                  /*!< Device is in data mode, all received bytes belong to connection */
+    lwcell_transparent_recv_fn recv_fn; /*!< Receive callback */
+    void* arg;                          /*!< Receive callback argument */
+    uint8_t closed_match;               /*!< Number of received characters matching `CLOSED` notification */
+} lwcell_transparent_t;
+
+#endif /* LWCELL_CFG_TRANSPARENT || __DOXYGEN__ */
+
+#if LWCELL_CFG_PPP || __DOXYGEN__
+
+/**
+ * \brief           PPP data mode session state
+ */
+typedef struct {
+    uint8_t data_mode;               /*!< Device is in PPP data mode */
+    uint8_t dlci;                    /*!< Multiplexer channel used by PPP, `0` when PPP uses AT port */
+    const lwcell_ppp_netif_t* netif; /*!< Network interface of IP stack */
+    void* arg;                       /*!< Network interface argument */
+    uint8_t nc_match;                /*!< Number of received characters matching `NO CARRIER` notification */
+} lwcell_ppp_t;
+
+#endif /* LWCELL_CFG_PPP || __DOXYGEN__ */
+
+#if LWCELL_CFG_HTTP || __DOXYGEN__
+
+/**
+ * \brief           Body of HTTP range being received with `AT+HTTPREAD`
+ */
+typedef struct {
+    uint8_t read;                 /*!< Reading body data */
+    uint8_t failed;               /*!< Body data were lost due to memory allocation failure */
+    size_t rem_len;               /*!< Remaining bytes to read */
+    uint32_t offset;              /*!< Offset of next byte, relative to the beginning of the resource */
+    lwcell_pbuf_p buff;           /*!< Buffer being filled, `NULL` when data are skipped */
+    size_t buff_ptr;              /*!< Write position in buffer */
+    lwcell_http_range_fn recv_fn; /*!< Body data callback, `NULL` when data are skipped */
+    void* arg;                    /*!< Callback argument */
+} lwcell_http_rx_t;
+
+/**
+ * \brief           HTTP service kept initialized between requests
+ *
+ * Parameters are valid only while service is active and describe values already set in device
+ */
+typedef struct {
+    uint8_t active;                                  /*!< Service is initialized */
+    uint8_t cid_set;                                 /*!< Bearer profile is set */
+    uint8_t range_set;                               /*!< Range parameters are set */
+    uint8_t content_set;                             /*!< Content type is set, device default is not used anymore */
+    uint32_t brk;                                    /*!< Value of `BREAK` parameter */
+    uint32_t brk_end;                                /*!< Value of `BREAKEND` parameter */
+    char url[LWCELL_CFG_HTTP_SESSION_PARAM_LEN];     /*!< URL set in device, empty when not known */
+    char content[LWCELL_CFG_HTTP_SESSION_PARAM_LEN]; /*!< Content type set in device, empty when not known */
+} lwcell_http_session_t;
+
+#endif /* LWCELL_CFG_HTTP || __DOXYGEN__ */
+
+#if LWCELL_CFG_MQTT || __DOXYGEN__
+
+/**
+ * \brief           Incoming `+MSUB` notification state
+ */
+typedef struct {
+    uint8_t read;     /*!< Reading payload of notification */
+    size_t topic_len; /*!< Length of topic, saved at the beginning of receive buffer */
+    size_t tot_len;   /*!< Total length of payload */
+    size_t rem_len;   /*!< Remaining payload bytes to read */
+    size_t ptr;       /*!< Write position in receive buffer */
+} lwcell_mqtt_rx_t;
+
+/**
+ * \brief           Native MQTT session state
+ */
+typedef struct {
+    uint8_t active;                          /*!< Session with broker is established */
+    lwcell_mqtt_session_recv_fn recv_fn;     /*!< Message receive callback */
+    lwcell_mqtt_session_closed_fn closed_fn; /*!< Session closed callback */
+    void* arg;                               /*!< Callbacks argument */
+    uint8_t* buff;                           /*!< Receive buffer for topic and payload */
+    size_t buff_len;                         /*!< Length of receive buffer */
+    lwcell_mqtt_rx_t rx;                     /*!< Notification being received */
+} lwcell_mqtt_session_t;
+
+#endif /* LWCELL_CFG_MQTT || __DOXYGEN__ */
+
 /**
  * \ingroup         LWCELL_SMS
  * \brief           SMS memory information
@@ -715,14 +1018,14 @@ typedef struct {
 #if LWCELL_CFG_HTTP || __DOXYGEN__
         lwcell_conn_t http_conns[LWCELL_CFG_MAX_HTTP_CONNS];
 #endif
-#if LWCELL_CFG_MQTT || __DOXYGEN__
-    lwcell_conn_t mqtt_conns[LWCELL_CFG_MAX_MQTT_CONNS];
-#endif
 #endif
     };
 
     lwcell_ipd_t ipd;                         /*!< Connection incoming data structure */
     uint8_t conn_val_id;                     /*!< Validation ID increased each time device connects to network */
+#if LWCELL_CFG_TRANSPARENT || __DOXYGEN__
+    lwcell_transparent_t transparent;        /*!< Transparent mode session */
+#endif                                       /* LWCELL_CFG_TRANSPARENT || __DOXYGEN__ */
 #endif                                       /* LWCELL_CFG_CONNS || __DOXYGEN__ */
 #if LWCELL_CFG_SMS || __DOXYGEN__
     lwcell_sms_t sms; /*!< SMS information */
@@ -733,6 +1036,16 @@ typedef struct {
 #if LWCELL_CFG_CALL || __DOXYGEN__
     lwcell_call_t call; /*!< Call information */
 #endif                 /* LWCELL_CFG_CALL || __DOXYGEN__ */
+#if LWCELL_CFG_PPP || __DOXYGEN__
+    lwcell_ppp_t ppp; /*!< PPP data mode session */
+#endif               /* LWCELL_CFG_PPP || __DOXYGEN__ */
+#if LWCELL_CFG_MQTT || __DOXYGEN__
+    lwcell_mqtt_session_t mqtt; /*!< Native MQTT session */
+#endif                         /* LWCELL_CFG_MQTT || __DOXYGEN__ */
+#if LWCELL_CFG_HTTP || __DOXYGEN__
+    lwcell_http_rx_t http_rx;           /*!< HTTP range body being received */
+    lwcell_http_session_t http_session; /*!< HTTP service kept between requests */
+#endif                                 /* LWCELL_CFG_HTTP || __DOXYGEN__ */
 } lwcell_modules_t;
 
 /**
@@ -753,10 +1066,23 @@ typedef struct {
 
     lwcell_msg_t* msg; /*!< Pointer to current user message being executed */
 
-    lwcell_evt_t evt;            /*!< Callback processing structure */
-    lwcell_evt_func_t* evt_func; /*!< Callback function linked list */
+    lwcell_evt_t evt;                                 /*!< Callback processing structure */
+    lwcell_evt_func_t* evt_func;                      /*!< Callback function linked list for all events */
+    lwcell_evt_func_t* evt_func_type[LWCELL_EVT_END]; /*!< Callback function linked lists per event type */
+#if LWCELL_CFG_EVT_DISPATCH || __DOXYGEN__
+    lwcell_evt_dispatch_t evt_dispatch; /*!< Deferred event dispatch */
+#endif                                 /* LWCELL_CFG_EVT_DISPATCH || __DOXYGEN__ */
 
     lwcell_modules_t m; /*!< All modules. When resetting, reset structure */
+#if LWCELL_CFG_STATS || __DOXYGEN__
+    lwcell_stats_t stats; /*!< Throughput counters */
+#endif                   /* LWCELL_CFG_STATS || __DOXYGEN__ */
+#if LWCELL_CFG_CMUX || __DOXYGEN__
+    lwcell_cmux_t cmux; /*!< AT port multiplexer. Not part of modules, as it must survive reset */
+#endif                 /* LWCELL_CFG_CMUX || __DOXYGEN__ */
+#if LWCELL_CFG_HTTP || __DOXYGEN__
+    uint32_t http_keep_alive; /*!< Time to keep HTTP service after request. Not part of modules, as it must survive reset */
+#endif                       /* LWCELL_CFG_HTTP || __DOXYGEN__ */
 
     union {
         struct {
@@ -867,8 +1193,15 @@ lwcellr_t lwcelli_process(const void* data, size_t len);
 lwcellr_t lwcelli_process_buffer(void);
 lwcellr_t lwcelli_initiate_cmd(lwcell_msg_t* msg);
 uint8_t lwcelli_is_valid_conn_ptr(lwcell_conn_p conn);
+void lwcelli_evt_call_subscribers(lwcell_evt_t* evt);
 lwcellr_t lwcelli_send_cb(lwcell_evt_type_t type);
 lwcellr_t lwcelli_send_conn_cb(lwcell_conn_t* conn, lwcell_evt_fn cb);
+#if LWCELL_CFG_EVT_DISPATCH
+void lwcelli_evt_dispatch_init(void);
+uint8_t lwcelli_evt_dispatch_is_sync_only(lwcell_evt_type_t type);
+lwcellr_t lwcelli_evt_dispatch_defer(lwcell_conn_t* conn, lwcell_evt_fn conn_fn);
+void lwcelli_evt_dispatch_process(lwcell_evt_dispatch_entry_t* entry);
+#endif /* LWCELL_CFG_EVT_DISPATCH */
 void lwcelli_conn_init(void);
 lwcellr_t lwcelli_send_msg_to_producer_mbox(lwcell_msg_t* msg, lwcellr_t (*process_fn)(lwcell_msg_t*),
                                           uint32_t max_block_time);
@@ -879,6 +1212,67 @@ void lwcelli_conn_start_timeout(lwcell_conn_p conn);
 lwcellr_t lwcelli_get_sim_info(const uint32_t blocking);
 
 void lwcelli_reset_everything(uint8_t forced);
+
+#if LWCELL_CFG_CMD_STATS
+void lwcelli_cmd_stats_enqueue(lwcell_msg_t* msg);
+void lwcelli_cmd_stats_dequeue(lwcell_msg_t* msg);
+void lwcelli_cmd_stats_step_start(lwcell_msg_t* msg);
+void lwcelli_cmd_stats_step_resp(lwcell_msg_t* msg);
+void lwcelli_cmd_stats_step_end(lwcell_msg_t* msg, uint8_t is_ok);
+void lwcelli_cmd_stats_cmd_end(lwcell_msg_t* msg, lwcellr_t res);
+
+#define LWCELL_CMD_STATS_ENQUEUE(msg)         lwcelli_cmd_stats_enqueue(msg)
+#define LWCELL_CMD_STATS_DEQUEUE(msg)         lwcelli_cmd_stats_dequeue(msg)
+#define LWCELL_CMD_STATS_STEP_START(msg)      lwcelli_cmd_stats_step_start(msg)
+#define LWCELL_CMD_STATS_STEP_RESP(msg)       lwcelli_cmd_stats_step_resp(msg)
+#define LWCELL_CMD_STATS_STEP_END(msg, is_ok) lwcelli_cmd_stats_step_end((msg), (is_ok))
+#define LWCELL_CMD_STATS_CMD_END(msg, res)    lwcelli_cmd_stats_cmd_end((msg), (res))
+#else /* LWCELL_CFG_CMD_STATS */
+#define LWCELL_CMD_STATS_ENQUEUE(msg)
+#define LWCELL_CMD_STATS_DEQUEUE(msg)
+#define LWCELL_CMD_STATS_STEP_START(msg)
+#define LWCELL_CMD_STATS_STEP_RESP(msg)
+#define LWCELL_CMD_STATS_STEP_END(msg, is_ok)
+#define LWCELL_CMD_STATS_CMD_END(msg, res)
+#endif /* !LWCELL_CFG_CMD_STATS */
+
+#if LWCELL_CFG_STATS
+size_t lwcelli_stats_at_port_send(const void* data, size_t len);
+
+#define LWCELL_STATS_INC(field)      ++lwcell.stats.field
+#define LWCELL_STATS_ADD(field, val) lwcell.stats.field += LWCELL_U32(val)
+#else /* LWCELL_CFG_STATS */
+#define LWCELL_STATS_INC(field)
+#define LWCELL_STATS_ADD(field, val)
+#endif /* !LWCELL_CFG_STATS */
+
+#if LWCELL_CFG_CMUX
+#define LWCELL_CMUX_DLCI_CTRL 0 /*!< Multiplexer control channel */
+#define LWCELL_CMUX_DLCI_AT   1 /*!< Channel for AT commands and URCs */
+#define LWCELL_CMUX_DLCI_DATA 2 /*!< Channel for connection and HTTP data */
+
+void lwcelli_cmux_start(void);
+void lwcelli_cmux_close(void);
+lwcellr_t lwcelli_cmux_open_dlc(uint8_t dlci);
+uint8_t lwcelli_cmux_get_port_speed(uint32_t baudrate);
+void lwcelli_cmux_input(const void* data, size_t len);
+size_t lwcelli_cmux_at_port_send(const void* data, size_t len);
+void lwcelli_cmux_data_send(const void* data, size_t len);
+void lwcelli_process_dlc(uint8_t dlci, const void* data, size_t len);
+void lwcelli_process_cmd_result(uint8_t is_ok);
+#endif /* LWCELL_CFG_CMUX */
+#if LWCELL_CFG_TRANSPARENT
+size_t lwcelli_transparent_input(const uint8_t* data, size_t len);
+void lwcelli_transparent_flush(void);
+#endif /* LWCELL_CFG_TRANSPARENT */
+#if LWCELL_CFG_PPP
+size_t lwcelli_ppp_input(const uint8_t* data, size_t len);
+void lwcelli_ppp_link_up(uint8_t dlci);
+void lwcelli_ppp_link_down(void);
+#endif /* LWCELL_CFG_PPP */
+#if LWCELL_CFG_TRANSPARENT || LWCELL_CFG_PPP
+void lwcelli_at_port_send_raw(const void* data, size_t len);
+#endif /* LWCELL_CFG_TRANSPARENT || LWCELL_CFG_PPP */
 void lwcelli_process_events_for_timeout_or_error(lwcell_msg_t* msg, lwcellr_t err);
 
 /**
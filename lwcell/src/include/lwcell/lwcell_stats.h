@@ -0,0 +1,104 @@
+/**
+ * \file            lwcell_stats.h
+ * \brief           Throughput counters and statistics
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWCELL_STATS_HDR_H
+#define LWCELL_STATS_HDR_H
+
+#include "lwcell/lwcell_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWCELL
+ * \defgroup        LWCELL_STATS Statistics
+ * \brief           Throughput counters for AT port, parser, connections and commands
+ * \{
+ *
+ * All counters are free-running `32-bit` values and wrap on overflow.
+ * Use \ref lwcell_stats_get_delta to get difference between two snapshots,
+ * which gives correct result also when counter wraps between them.
+ *
+ * Per-connection counters are available with \ref lwcell_conn_get_total_recved_count
+ * and \ref lwcell_conn_get_total_sent_count functions
+ */
+
+/**
+ * \brief           Library statistics snapshot
+ * \note            All members are of `uint32_t` type
+ */
+typedef struct {
+    uint32_t time; /*!< Snapshot time in units of milliseconds. Elapsed time when used as delta */
+
+    /* AT port */
+    uint32_t uart_rx_bytes; /*!< Number of bytes received from AT port */
+    uint32_t uart_rx_calls; /*!< Number of input function calls */
+    uint32_t uart_tx_bytes; /*!< Number of bytes sent to AT port */
+    uint32_t uart_tx_calls; /*!< Number of send function calls, excluding flush calls */
+
+    /* Parser */
+    uint32_t lines;       /*!< Number of all parsed lines, excluding empty lines */
+    uint32_t lines_ok;    /*!< Number of `OK` lines */
+    uint32_t lines_error; /*!< Number of `ERROR` lines, including `+CME ERROR` and `+CMS ERROR` */
+    uint32_t lines_urc;   /*!< Number of other lines starting with `+` character */
+    uint32_t lines_other; /*!< Number of all other lines */
+
+    /* Connection data */
+    uint32_t ipd_bytes;     /*!< Number of connection data bytes received from AT port */
+    uint32_t ipd_dropped;   /*!< Number of received connection bytes dropped due to allocation failure,
+                                    ignore-more request or closing connection */
+    uint32_t send_segments; /*!< Number of `+CIPSEND` segments started */
+    uint32_t send_bytes;    /*!< Number of connection data bytes successfully sent */
+    uint32_t send_retries;  /*!< Number of segments sent again after `SEND FAIL` */
+    uint32_t send_fails;    /*!< Number of `SEND FAIL` responses */
+
+    /* Commands */
+    uint32_t cmd_count;    /*!< Number of finished commands */
+    uint32_t cmd_errors;   /*!< Number of commands finished with error, excluding timeouts */
+    uint32_t cmd_timeouts; /*!< Number of command timeouts, reported with \ref LWCELL_EVT_CMD_TIMEOUT event */
+} lwcell_stats_t;
+
+lwcellr_t lwcell_stats_get(lwcell_stats_t* stats);
+lwcellr_t lwcell_stats_get_delta(lwcell_stats_t* prev, lwcell_stats_t* delta);
+lwcellr_t lwcell_stats_reset(void);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWCELL_STATS_HDR_H */
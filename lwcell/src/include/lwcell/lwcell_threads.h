@@ -42,6 +42,9 @@ extern "C" {
 
 void lwcell_thread_produce(void* const arg);
 void lwcell_thread_process(void* const arg);
+#if LWCELL_CFG_EVT_DISPATCH
+void lwcell_thread_evt_dispatch(void* const arg);
+#endif /* LWCELL_CFG_EVT_DISPATCH */
 
 #ifdef __cplusplus
 }
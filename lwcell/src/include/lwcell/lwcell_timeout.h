@@ -49,6 +49,7 @@ extern "C" {
 
 lwcellr_t lwcell_timeout_add(uint32_t time, lwcell_timeout_fn fn, void* arg);
 lwcellr_t lwcell_timeout_remove(lwcell_timeout_fn fn);
+lwcellr_t lwcell_timeout_remove_arg(lwcell_timeout_fn fn, void* arg);
 
 /**
  * \}
@@ -0,0 +1,121 @@
+/**
+ * \file            lwcell_trace.h
+ * \brief           Binary trace ring buffer
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWCELL_TRACE_HDR_H
+#define LWCELL_TRACE_HDR_H
+
+#include "lwcell/lwcell_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWCELL
+ * \defgroup        LWCELL_TRACE Binary trace
+ * \brief           Low-overhead binary trace ring buffer
+ * \{
+ *
+ * Trace points store compact fixed-size records to RAM ring buffer,
+ * without any string formatting. Records are read with \ref lwcell_trace_read
+ * and rendered on the host with `tools/lwcell_trace_decode.py` script.
+ *
+ * Oldest records are overwritten when ring buffer is full.
+ *
+ * \note            Trace points are only placed in the code running with core locked,
+ *                  hence writing a record does not need any additional locking
+ */
+
+/**
+ * \brief           List of trace record identifiers
+ *
+ * Comment of each entry lists meaning of arguments, used by host decoder script.
+ * New entries must be added to the end of the list to keep decoder compatible with older dumps.
+ */
+typedef enum {
+    LWCELL_TRACE_ID_NONE = 0x00,      /*!< Invalid entry. Args: - */
+    LWCELL_TRACE_ID_CMD_START,        /*!< Producer thread started command. Args: cmd_def, blocking */
+    LWCELL_TRACE_ID_CMD_STEP,         /*!< AT step sent to AT port. Args: cmd_def, cmd, step */
+    LWCELL_TRACE_ID_CMD_END,          /*!< Command finished. Args: cmd_def, res */
+    LWCELL_TRACE_ID_CMD_TIMEOUT,      /*!< Command timeout. Args: cmd_def, cmd */
+    LWCELL_TRACE_ID_INPUT,            /*!< Data chunk received from AT port. Args: len */
+    LWCELL_TRACE_ID_LINE,             /*!< Received line parsed. Args: len, chars, cmd */
+    LWCELL_TRACE_ID_EVT,              /*!< Global event sent. Args: type */
+    LWCELL_TRACE_ID_IPD_START,        /*!< Start of connection data. Args: conn, tot_len, buff_len */
+    LWCELL_TRACE_ID_IPD_READ,         /*!< Connection data copied or skipped. Args: conn, len, skipped */
+    LWCELL_TRACE_ID_IPD_DELIVER,      /*!< Packet buffer sent to upper layer. Args: conn, len, res */
+    LWCELL_TRACE_ID_IPD_ALLOC_FAIL,   /*!< Packet buffer allocation failed. Args: conn, len */
+    LWCELL_TRACE_ID_CONN_SEND,        /*!< Send data command started. Args: conn, len, tries */
+    LWCELL_TRACE_ID_CONN_SEND_RESULT, /*!< Send data command finished. Args: conn, len, is_ok */
+} lwcell_trace_id_t;
+
+/**
+ * \brief           Single trace record
+ */
+typedef struct {
+    uint32_t time;   /*!< Timestamp, as returned by \ref LWCELL_CFG_TRACE_TIMESTAMP */
+    uint16_t id;     /*!< Record identifier. Member of \ref lwcell_trace_id_t enumeration */
+    uint16_t seq;    /*!< Sequence number, used to detect lost records */
+    uint32_t arg[3]; /*!< Record arguments */
+} lwcell_trace_rec_t;
+
+#if LWCELL_CFG_TRACE || __DOXYGEN__
+
+void lwcelli_trace_write(lwcell_trace_id_t id, uint32_t a0, uint32_t a1, uint32_t a2);
+
+/**
+ * \brief           Write trace record
+ * \param[in]       id: Record identifier. Member of \ref lwcell_trace_id_t enumeration
+ * \param[in]       a0: First argument
+ * \param[in]       a1: Second argument
+ * \param[in]       a2: Third argument
+ * \hideinitializer
+ */
+#define LWCELL_TRACE(id, a0, a1, a2) lwcelli_trace_write((id), (uint32_t)(a0), (uint32_t)(a1), (uint32_t)(a2))
+
+size_t lwcell_trace_read(lwcell_trace_rec_t* recs, size_t max_recs, uint32_t* lost);
+void lwcell_trace_reset(void);
+
+#else /* LWCELL_CFG_TRACE || __DOXYGEN__ */
+#define LWCELL_TRACE(id, a0, a1, a2)
+#endif /* !(LWCELL_CFG_TRACE || __DOXYGEN__) */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWCELL_TRACE_HDR_H */
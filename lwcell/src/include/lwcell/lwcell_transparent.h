@@ -0,0 +1,94 @@
+/**
+ * \file            lwcell_transparent.h
+ * \brief           Transparent mode API
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWCELL_TRANSPARENT_HDR_H
+#define LWCELL_TRANSPARENT_HDR_H
+
+#include "lwcell/lwcell_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWCELL
+ * \defgroup        LWCELL_TRANSPARENT Transparent mode API
+ * \brief           Single connection in transparent data mode
+ * \{
+ *
+ * Transparent session switches device to single connection mode with `AT+CIPMUX=0` and `AT+CIPMODE=1`,
+ * brings up PDP context and opens connection. When device replies with `CONNECT`,
+ * it enters data mode and all bytes between host and device belong to the connection.
+ *
+ * Received data are passed to application callback directly from input processing,
+ * without `+RECEIVE` header parsing and packet buffers.
+ * Data are sent with \ref lwcell_transparent_write directly to AT port,
+ * without `AT+CIPSEND` prompt and `SEND OK` round-trip.
+ *
+ * Session is finished with \ref lwcell_transparent_stop, which sends `+++` escape sequence
+ * with guard time, closes connection and restores multiple connection mode.
+ * PDP context is deactivated by the procedure,
+ * \ref lwcell_network_attach must be called again before using connection API.
+ *
+ * \note            Other commands are rejected while device is in data mode
+ */
+
+/**
+ * \brief           Transparent mode receive callback
+ *
+ * Called from processing thread with received connection data.
+ * When connection has been closed by remote side, callback is called with `data` set to `NULL`.
+ *
+ * \param[in]       data: Received data or `NULL` when connection has been closed
+ * \param[in]       len: Length of data in units of bytes
+ * \param[in]       arg: User argument
+ */
+typedef void (*lwcell_transparent_recv_fn)(const void* data, size_t len, void* arg);
+
+lwcellr_t lwcell_transparent_start(const char* apn, const char* user, const char* pass, lwcell_conn_type_t type,
+                                   const char* const host, lwcell_port_t port, lwcell_transparent_recv_fn recv_fn,
+                                   void* const arg, const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg,
+                                   const uint32_t blocking);
+lwcellr_t lwcell_transparent_write(const void* data, size_t btw);
+lwcellr_t lwcell_transparent_stop(const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+uint8_t lwcell_transparent_is_active(void);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWCELL_TRANSPARENT_HDR_H */
@@ -449,8 +449,33 @@ typedef enum lwcell_cb_type_t {
     LWCELL_EVT_PB_LIST,         /*!< Phonebook list event */
     LWCELL_EVT_PB_SEARCH,       /*!< Phonebook search event */
 #endif                         /* LWCELL_CFG_PHONEBOOK || __DOXYGEN__ */
+#if LWCELL_CFG_HTTP || __DOXYGEN__
+    LWCELL_EVT_HTTP_POST_PROGRESS, /*!< Segment of HTTP POST body has been written to device */
+#endif                            /* LWCELL_CFG_HTTP || __DOXYGEN__ */
+
+    LWCELL_EVT_END,             /*!< Last event entry, used to size internal tables. Never sent to application */
 } lwcell_evt_type_t;
 
+/**
+ * \ingroup         LWCELL_EVT
+ * \brief           Bit mask of event types, used with \ref lwcell_evt_register_mask
+ */
+typedef uint64_t lwcell_evt_mask_t;
+
+/**
+ * \ingroup         LWCELL_EVT
+ * \brief           Get bit mask for single event type
+ * \param[in]       type: Event type. Member of \ref lwcell_evt_type_t enumeration
+ * \hideinitializer
+ */
+#define LWCELL_EVT_MASK(type) ((lwcell_evt_mask_t)1 << (type))
+
+/**
+ * \ingroup         LWCELL_EVT
+ * \brief           Bit mask for all event types
+ */
+#define LWCELL_EVT_MASK_ALL   ((lwcell_evt_mask_t)-1)
+
 /**
  * \ingroup         LWCELL_EVT
  * \brief           Global callback structure to pass as parameter to callback function
@@ -579,9 +604,40 @@ typedef struct lwcell_evt {
             lwcellr_t res;              /*!< Operation success */
         } pb_search;                   /*!< Phonebok search list. Use with \ref LWCELL_EVT_PB_SEARCH event */
 #endif                                 /* LWCELL_CFG_PHONEBOOK || __DOXYGEN__ */
+#if LWCELL_CFG_HTTP || __DOXYGEN__
+        struct {
+            uint32_t sent;  /*!< Number of body bytes written to device */
+            uint32_t total; /*!< Total length of body */
+        } http_post_progress; /*!< HTTP POST body progress. Use with \ref LWCELL_EVT_HTTP_POST_PROGRESS event */
+#endif                        /* LWCELL_CFG_HTTP || __DOXYGEN__ */
     } evt;                             /*!< Callback event union */
 } lwcell_evt_t;
 
+/**
+ * \ingroup         LWCELL_EVT
+ * \brief           Event dispatch policy, used when \ref LWCELL_CFG_EVT_DISPATCH is enabled
+ */
+typedef enum {
+    LWCELL_EVT_DISPATCH_POLICY_SYNC = 0x00,  /*!< Event is always delivered synchronously from stack thread */
+    LWCELL_EVT_DISPATCH_POLICY_DROP,         /*!< Event is delivered from dispatch thread.
+                                                    It is dropped when dispatch queue is full */
+    LWCELL_EVT_DISPATCH_POLICY_SYNC_ON_FULL, /*!< Event is delivered from dispatch thread.
+                                                    It is delivered synchronously when dispatch queue is full */
+} lwcell_evt_dispatch_policy_t;
+
+/**
+ * \ingroup         LWCELL_EVT
+ * \brief           Event dispatch queue statistics
+ */
+typedef struct {
+    size_t depth;           /*!< Number of events currently waiting in the queue */
+    size_t depth_max;       /*!< Maximal number of events waiting in the queue at the same time */
+    uint32_t queued;        /*!< Number of events put to the queue */
+    uint32_t dispatched;    /*!< Number of events delivered from dispatch thread */
+    uint32_t dropped;       /*!< Number of events dropped because queue was full */
+    uint32_t sync_fallback; /*!< Number of events delivered synchronously because queue was full */
+} lwcell_evt_dispatch_stats_t;
+
 #define LWCELL_SIZET_MAX ((size_t)(-1)) /*!< Maximal value of size_t variable type */
 
 /**
@@ -606,13 +662,23 @@ typedef size_t (*lwcell_ll_send_fn)(const void* data, size_t len);
  */
 typedef uint8_t (*lwcell_ll_reset_fn)(uint8_t state);
 
+/**
+ * \ingroup         LWCELL_LL
+ * \brief           Function prototype for AT port reconfiguration at runtime
+ * \param[in]       baudrate: New UART baudrate to use for communication with device
+ * \return          `1` on successful action, `0` otherwise
+ */
+typedef uint8_t (*lwcell_ll_reconfigure_fn)(uint32_t baudrate);
+
 /**
  * \ingroup         LWCELL_LL
  * \brief           Low level user specific functions
  */
 typedef struct {
-    lwcell_ll_send_fn send_fn;   /*!< Callback function to transmit data */
-    lwcell_ll_reset_fn reset_fn; /*!< Reset callback function */
+    lwcell_ll_send_fn send_fn;               /*!< Callback function to transmit data */
+    lwcell_ll_reset_fn reset_fn;             /*!< Reset callback function */
+    lwcell_ll_reconfigure_fn reconfigure_fn; /*!< AT port reconfiguration callback function, optional.
+                                                    Required for \ref LWCELL_CFG_AT_PORT_AUTOBAUD */
 
     struct {
         uint32_t baudrate; /*!< UART baudrate value */
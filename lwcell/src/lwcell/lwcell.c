@@ -136,6 +136,21 @@ lwcell_init(lwcell_evt_fn evt_func, const uint32_t blocking) {
         goto cleanup;
     }
     lwcell_sys_sem_wait(&lwcell.sem_sync, 0); /* Wait semaphore, should be unlocked in produce thread */
+#if LWCELL_CFG_EVT_DISPATCH
+    lwcelli_evt_dispatch_init(); /* Set default dispatch policies */
+    if (!lwcell_sys_mutex_create(&lwcell.evt_dispatch.mutex)
+        || !lwcell_sys_mbox_create(&lwcell.evt_dispatch.mbox, LWCELL_CFG_EVT_DISPATCH_QUEUE_SIZE)
+        || !lwcell_sys_thread_create(&lwcell.evt_dispatch.thread, "lwcell_evt_dispatch", lwcell_thread_evt_dispatch,
+                                     &lwcell.sem_sync, LWCELL_SYS_THREAD_SS, LWCELL_SYS_THREAD_PRIO)) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_INIT | LWCELL_DBG_LVL_SEVERE | LWCELL_DBG_TYPE_TRACE,
+                      "[LWCELL CORE] Cannot create event dispatch thread!\r\n");
+        lwcell_sys_thread_terminate(&lwcell.thread_produce); /* Delete produce thread */
+        lwcell_sys_thread_terminate(&lwcell.thread_process); /* Delete process thread */
+        lwcell_sys_sem_release(&lwcell.sem_sync);            /* Release semaphore and return */
+        goto cleanup;
+    }
+    lwcell_sys_sem_wait(&lwcell.sem_sync, 0); /* Wait semaphore, should be unlocked in dispatch thread */
+#endif                                       /* LWCELL_CFG_EVT_DISPATCH */
     lwcell_sys_sem_release(&lwcell.sem_sync); /* Release semaphore manually */
 
     lwcell_core_lock();
@@ -145,6 +160,9 @@ lwcell_init(lwcell_evt_fn evt_func, const uint32_t blocking) {
 #if !LWCELL_CFG_INPUT_USE_PROCESS
     lwcell_buff_init(&lwcell.buff, LWCELL_CFG_RCV_BUFF_SIZE); /* Init buffer for input data */
 #endif                                                     /* !LWCELL_CFG_INPUT_USE_PROCESS */
+#if LWCELL_CFG_HTTP
+    lwcell.http_keep_alive = LWCELL_CFG_HTTP_KEEP_ALIVE;
+#endif /* LWCELL_CFG_HTTP */
 
     lwcell.status.f.initialized = 1; /* We are initialized now */
     lwcell.status.f.dev_present = 1; /* We assume device is present at this point */
@@ -183,6 +201,16 @@ cleanup:
         lwcell_sys_mbox_delete(&lwcell.mbox_process);
         lwcell_sys_mbox_invalid(&lwcell.mbox_process);
     }
+#if LWCELL_CFG_EVT_DISPATCH
+    if (lwcell_sys_mbox_isvalid(&lwcell.evt_dispatch.mbox)) {
+        lwcell_sys_mbox_delete(&lwcell.evt_dispatch.mbox);
+        lwcell_sys_mbox_invalid(&lwcell.evt_dispatch.mbox);
+    }
+    if (lwcell_sys_mutex_isvalid(&lwcell.evt_dispatch.mutex)) {
+        lwcell_sys_mutex_delete(&lwcell.evt_dispatch.mutex);
+        lwcell_sys_mutex_invalid(&lwcell.evt_dispatch.mutex);
+    }
+#endif /* LWCELL_CFG_EVT_DISPATCH */
     if (lwcell_sys_sem_isvalid(&lwcell.sem_sync)) {
         lwcell_sys_sem_delete(&lwcell.sem_sync);
         lwcell_sys_sem_invalid(&lwcell.sem_sync);
@@ -219,6 +247,11 @@ lwcell_reset_with_delay(uint32_t delay, const lwcell_api_cmd_evt_fn evt_fn, void
     LWCELL_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
     LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_RESET;
     LWCELL_MSG_VAR_REF(msg).msg.reset.delay = delay;
+#if LWCELL_CFG_AT_PORT_AUTOBAUD
+    if (lwcell.ll.reconfigure_fn != NULL) {
+        LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_AT_PORT_PROBE; /* Find device baudrate first */
+    }
+#endif /* LWCELL_CFG_AT_PORT_AUTOBAUD */
 
     return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 60000);
 }
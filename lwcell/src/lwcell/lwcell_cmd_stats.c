@@ -0,0 +1,220 @@
+/**
+ * \file            lwcell_cmd_stats.c
+ * \brief           Command latency statistics
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "lwcell/lwcell_cmd_stats.h"
+#include "lwcell/lwcell_private.h"
+
+#if LWCELL_CFG_CMD_STATS || __DOXYGEN__
+
+static lwcell_cmd_stats_t cmd_stats[LWCELL_CMD_END];
+
+/**
+ * \brief           Add time to `log2` histogram
+ * \param[in,out]   hist: Histogram with \ref LWCELL_CFG_CMD_STATS_HIST_SIZE buckets
+ * \param[in]       time: Time in units of milliseconds
+ */
+static void
+prv_hist_add(uint32_t* hist, uint32_t time) {
+    size_t bucket = 0;
+
+    for (; time > 0 && bucket < (LWCELL_CFG_CMD_STATS_HIST_SIZE - 1); time >>= 1) {
+        ++bucket;
+    }
+    ++hist[bucket];
+}
+
+/**
+ * \brief           Get statistics entry for command
+ * \param[in]       cmd: Command type
+ * \return          Statistics entry or `NULL` if command is not valid
+ */
+static lwcell_cmd_stats_t*
+prv_get_entry(lwcell_cmd_t cmd) {
+    if ((size_t)cmd < LWCELL_ARRAYSIZE(cmd_stats)) {
+        return &cmd_stats[cmd];
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Message has been put to producer queue
+ * \param[in]       msg: Message handle
+ */
+void
+lwcelli_cmd_stats_enqueue(lwcell_msg_t* msg) {
+    msg->stats.t_enqueue = lwcell_sys_now();
+}
+
+/**
+ * \brief           Message has been taken from producer queue
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Message handle
+ */
+void
+lwcelli_cmd_stats_dequeue(lwcell_msg_t* msg) {
+    msg->stats.t_dequeue = lwcell_sys_now();
+}
+
+/**
+ * \brief           First byte of new AT step is about to be sent to AT port
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Message handle. Can be `NULL`
+ */
+void
+lwcelli_cmd_stats_step_start(lwcell_msg_t* msg) {
+    if (msg != NULL) {
+        msg->stats.t_step = lwcell_sys_now();
+        msg->stats.step_active = 1;
+        msg->stats.step_resp = 0;
+    }
+}
+
+/**
+ * \brief           Data received from AT port while message is active
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Message handle
+ */
+void
+lwcelli_cmd_stats_step_resp(lwcell_msg_t* msg) {
+    if (msg->stats.step_active && !msg->stats.step_resp) {
+        msg->stats.t_step_resp = lwcell_sys_now();
+        msg->stats.step_resp = 1;
+    }
+}
+
+/**
+ * \brief           Final response for current AT step received
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Message handle
+ * \param[in]       is_ok: Set to `1` if step finished with `OK`, `0` on error
+ */
+void
+lwcelli_cmd_stats_step_end(lwcell_msg_t* msg, uint8_t is_ok) {
+    lwcell_cmd_stats_t* s;
+    uint32_t time;
+
+    if (!msg->stats.step_active || (s = prv_get_entry(msg->cmd)) == NULL) {
+        return;
+    }
+    time = lwcell_sys_now() - msg->stats.t_step;
+    ++s->step_count;
+    if (!is_ok) {
+        ++s->step_errors;
+    }
+    if (msg->stats.step_resp) {
+        s->first_resp_total += msg->stats.t_step_resp - msg->stats.t_step;
+    }
+    s->modem_total += time;
+    if (time > s->modem_max) {
+        s->modem_max = time;
+    }
+    prv_hist_add(s->modem_hist, time);
+    msg->stats.step_active = 0;
+
+    LWCELL_DEBUGF(LWCELL_CFG_DBG_THREAD | LWCELL_DBG_TYPE_TRACE, "[LWCELL STATS] Cmd %d step %d finished in %u ms\r\n",
+                  (int)msg->cmd_def, (int)msg->cmd, (unsigned)time);
+}
+
+/**
+ * \brief           Command has been completed by producer thread
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Message handle
+ * \param[in]       res: Final command result
+ */
+void
+lwcelli_cmd_stats_cmd_end(lwcell_msg_t* msg, lwcellr_t res) {
+    lwcell_cmd_stats_t* s;
+    uint32_t wait, exec;
+
+    if ((s = prv_get_entry(msg->cmd_def)) == NULL) {
+        return;
+    }
+    wait = msg->stats.t_dequeue - msg->stats.t_enqueue;
+    exec = lwcell_sys_now() - msg->stats.t_dequeue;
+    ++s->count;
+    if (res == lwcellTIMEOUT) {
+        ++s->timeouts;
+    } else if (res != lwcellOK) {
+        ++s->errors;
+    }
+    s->queue_wait_total += wait;
+    if (wait > s->queue_wait_max) {
+        s->queue_wait_max = wait;
+    }
+    s->exec_total += exec;
+    if (exec > s->exec_max) {
+        s->exec_max = exec;
+    }
+    prv_hist_add(s->queue_wait_hist, wait);
+}
+
+/**
+ * \brief           Get number of command types with statistics
+ * \return          Number of command types. Valid command index is from `0` to returned value
+ */
+size_t
+lwcell_cmd_stats_get_count(void) {
+    return LWCELL_ARRAYSIZE(cmd_stats);
+}
+
+/**
+ * \brief           Get statistics for single command type
+ * \note            Command index is the same number as printed by debug messages
+ * \param[in]       cmd: Command index, less than value returned by \ref lwcell_cmd_stats_get_count
+ * \param[out]      stats: Pointer to output statistics structure
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_cmd_stats_get(size_t cmd, lwcell_cmd_stats_t* stats) {
+    LWCELL_ASSERT(cmd < LWCELL_ARRAYSIZE(cmd_stats));
+    LWCELL_ASSERT(stats != NULL);
+
+    lwcell_core_lock();
+    LWCELL_MEMCPY(stats, &cmd_stats[cmd], sizeof(*stats));
+    lwcell_core_unlock();
+    return lwcellOK;
+}
+
+/**
+ * \brief           Reset statistics for all command types
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_cmd_stats_reset(void) {
+    lwcell_core_lock();
+    LWCELL_MEMSET(cmd_stats, 0x00, sizeof(cmd_stats));
+    lwcell_core_unlock();
+    return lwcellOK;
+}
+
+#endif /* LWCELL_CFG_CMD_STATS || __DOXYGEN__ */
@@ -0,0 +1,476 @@
+/**
+ * \file            lwcell_cmux.c
+ * \brief           AT port multiplexer, 3GPP TS 27.010
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "lwcell/lwcell_cmux.h"
+#include "lwcell/lwcell_private.h"
+#include "lwcell/lwcell_timeout.h"
+
+#if LWCELL_CFG_CMUX || __DOXYGEN__
+
+/* Frame fields */
+#define CMUX_FLAG           0xF9 /* Opening and closing flag */
+#define CMUX_EA             0x01 /* Extension bit */
+#define CMUX_CR             0x02 /* Command/response bit */
+#define CMUX_PF             0x10 /* Poll/final bit */
+#define CMUX_FCS_GOOD       0xCF /* Frame check sequence result of valid frame */
+
+/* Frame types */
+#define CMUX_SABM           0x2F /* Set asynchronous balanced mode */
+#define CMUX_UA             0x63 /* Unnumbered acknowledgement */
+#define CMUX_DM             0x0F /* Disconnected mode */
+#define CMUX_DISC           0x43 /* Disconnect */
+#define CMUX_UIH            0xEF /* Unnumbered information with header check */
+#define CMUX_UI             0x03 /* Unnumbered information */
+
+/* Control channel message types */
+#define CMUX_MSG_CLD        0x30 /* Multiplexer close down */
+#define CMUX_MSG_TEST       0x08 /* Test command */
+#define CMUX_MSG_MSC        0x38 /* Modem status command */
+
+/* Time in units of milliseconds to wait for response to SABM frame */
+#define CMUX_SABM_TIMEOUT   1000
+
+/**
+ * \brief           Update frame check sequence with new byte
+ * \param[in]       fcs: Current value
+ * \param[in]       ch: New byte
+ * \return          Updated value
+ */
+static uint8_t
+fcs_update(uint8_t fcs, uint8_t ch) {
+    fcs ^= ch;
+    for (size_t i = 0; i < 8; ++i) {
+        fcs = (fcs & 0x01) ? LWCELL_U8((fcs >> 1) ^ 0xE0) : LWCELL_U8(fcs >> 1);
+    }
+    return fcs;
+}
+
+/**
+ * \brief           Send single frame to low-level AT port
+ * \param[in]       dlci: Channel DLCI
+ * \param[in]       cr: Command/response bit value
+ * \param[in]       ctrl: Control field
+ * \param[in]       data: Information field, may be `NULL` when `len == 0`
+ * \param[in]       len: Length of information field
+ */
+static void
+send_frame(uint8_t dlci, uint8_t cr, uint8_t ctrl, const void* data, size_t len) {
+    uint8_t hdr[5], tail[2], fcs = 0xFF;
+    size_t hdr_len = 0;
+
+    hdr[hdr_len++] = CMUX_FLAG;
+    hdr[hdr_len++] = LWCELL_U8((dlci << 2) | (cr ? CMUX_CR : 0) | CMUX_EA);
+    hdr[hdr_len++] = ctrl;
+    if (len <= 0x7F) {
+        hdr[hdr_len++] = LWCELL_U8((len << 1) | CMUX_EA);
+    } else {
+        hdr[hdr_len++] = LWCELL_U8(len << 1);
+        hdr[hdr_len++] = LWCELL_U8(len >> 7);
+    }
+    for (size_t i = 1; i < hdr_len; ++i) {
+        fcs = fcs_update(fcs, hdr[i]);
+    }
+    tail[0] = LWCELL_U8(0xFF - fcs);
+    tail[1] = CMUX_FLAG;
+
+    lwcell.ll.send_fn(hdr, hdr_len);
+    if (len > 0) {
+        lwcell.ll.send_fn(data, len);
+    }
+    lwcell.ll.send_fn(tail, sizeof(tail));
+    lwcell.ll.send_fn(NULL, 0);
+}
+
+/**
+ * \brief           Send buffered data as single frame
+ */
+static void
+tx_flush(void) {
+    if (lwcell.cmux.tx.len > 0) {
+        send_frame(lwcell.cmux.tx.dlci, 1, CMUX_UIH, lwcell.cmux.tx.data, lwcell.cmux.tx.len);
+        lwcell.cmux.tx.len = 0;
+    }
+}
+
+/**
+ * \brief           Get channel for data of currently active command
+ * \return          Channel DLCI
+ */
+static uint8_t
+get_cmd_dlci(void) {
+    if (!(lwcell.cmux.dlc_open & (1 << LWCELL_CMUX_DLCI_DATA))) {
+        return LWCELL_CMUX_DLCI_AT;
+    }
+#if LWCELL_CFG_TRANSPARENT
+    if (lwcell.m.transparent.data_mode) {
+        return LWCELL_CMUX_DLCI_DATA;
+    }
+#endif /* LWCELL_CFG_TRANSPARENT */
+#if LWCELL_CFG_PPP
+    if (lwcell.m.ppp.data_mode) { /* Data channel belongs to PPP, only escape sequence is sent there */
+        return CMD_IS_CUR(LWCELL_CMD_PPP) ? LWCELL_CMUX_DLCI_DATA : LWCELL_CMUX_DLCI_AT;
+    }
+#endif /* LWCELL_CFG_PPP */
+    switch (CMD_GET_CUR()) {
+        case LWCELL_CMD_CIPSTART:
+        case LWCELL_CMD_CIPSEND:
+        case LWCELL_CMD_CIPCLOSE:
+#if LWCELL_CFG_TRANSPARENT
+        case LWCELL_CMD_TRANSPARENT_ESCAPE:
+#endif /* LWCELL_CFG_TRANSPARENT */
+#if LWCELL_CFG_PPP
+        case LWCELL_CMD_PPP_DIAL:
+        case LWCELL_CMD_PPP: return LWCELL_CMUX_DLCI_DATA;
+        case LWCELL_CMD_ATH: return CMD_IS_DEF(LWCELL_CMD_PPP_STOP) ? LWCELL_CMUX_DLCI_DATA : LWCELL_CMUX_DLCI_AT;
+#endif /* LWCELL_CFG_PPP */
+        case LWCELL_CMD_HTTPDATA:
+        case LWCELL_CMD_HTTPREAD: return LWCELL_CMUX_DLCI_DATA;
+        default: return LWCELL_CMUX_DLCI_AT;
+    }
+}
+
+/**
+ * \brief           Timeout callback, device did not respond to `SABM` frame
+ * \param[in]       arg: Message that opened the channel
+ */
+static void
+sabm_timeout(void* arg) {
+    if (lwcell.msg != arg || !lwcell.cmux.sabm_pend) {
+        return;
+    }
+    lwcell.cmux.sabm_pend = 0;
+    lwcelli_process_cmd_result(0);
+}
+
+/**
+ * \brief           Process message received on control channel
+ */
+static void
+process_ctrl_msg(void) {
+    uint8_t type;
+
+    if (lwcell.cmux.rx.len < 2 || !(lwcell.cmux.rx.data[0] & CMUX_CR)) {
+        return; /* Responses to our commands need no action */
+    }
+    type = LWCELL_U8(lwcell.cmux.rx.data[0] >> 2);
+    if (type == CMUX_MSG_MSC || type == CMUX_MSG_TEST || type == CMUX_MSG_CLD) {
+        /* Send same message back as response */
+        lwcell.cmux.rx.data[0] &= LWCELL_U8(~CMUX_CR);
+        send_frame(LWCELL_CMUX_DLCI_CTRL, 1, CMUX_UIH, lwcell.cmux.rx.data, lwcell.cmux.rx.len);
+    }
+    if (type == CMUX_MSG_CLD) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_INIT | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                      "[LWCELL CMUX] Multiplexer closed by device\r\n");
+        LWCELL_MEMSET(&lwcell.cmux, 0x00, sizeof(lwcell.cmux));
+    }
+}
+
+/**
+ * \brief           Process fully received and valid frame
+ */
+static void
+process_frame(void) {
+    uint8_t dlci = LWCELL_U8(lwcell.cmux.rx.addr >> 2);
+    uint8_t type = LWCELL_U8(lwcell.cmux.rx.ctrl & ~CMUX_PF);
+
+    switch (type) {
+        case CMUX_UIH:
+        case CMUX_UI: {
+            if (dlci == LWCELL_CMUX_DLCI_CTRL) {
+                process_ctrl_msg();
+            } else if (dlci <= LWCELL_CMUX_DLCI_DATA) {
+                lwcelli_process_dlc(dlci, lwcell.cmux.rx.data, lwcell.cmux.rx.len);
+            }
+            break;
+        }
+        case CMUX_UA:
+        case CMUX_DM: {
+            if (lwcell.cmux.sabm_pend && dlci == lwcell.cmux.sabm_dlci) {
+                lwcell.cmux.sabm_pend = 0;
+                lwcell_timeout_remove(sabm_timeout);
+                if (type == CMUX_UA) {
+                    lwcell.cmux.dlc_open |= LWCELL_U8(1 << dlci);
+                    if (dlci != LWCELL_CMUX_DLCI_CTRL) {
+                        /* Report ready to send and receive, some devices do not send data before */
+                        const uint8_t msc[] = {(CMUX_MSG_MSC << 2) | CMUX_CR | CMUX_EA, (2 << 1) | CMUX_EA,
+                                               LWCELL_U8((dlci << 2) | 0x03), 0x8D};
+
+                        send_frame(LWCELL_CMUX_DLCI_CTRL, 1, CMUX_UIH, msc, sizeof(msc));
+                    }
+                }
+                lwcelli_process_cmd_result(type == CMUX_UA);
+            }
+            break;
+        }
+        case CMUX_SABM:
+        case CMUX_DISC: {
+            send_frame(dlci, 0, CMUX_UA | CMUX_PF, NULL, 0);
+            if (type == CMUX_SABM) {
+                lwcell.cmux.dlc_open |= LWCELL_U8(1 << dlci);
+            } else {
+                lwcell.cmux.dlc_open &= LWCELL_U8(~(1 << dlci));
+            }
+            break;
+        }
+        default: break;
+    }
+}
+
+/**
+ * \brief           Enter multiplexer mode, after device accepted `AT+CMUX` command
+ */
+void
+lwcelli_cmux_start(void) {
+    LWCELL_MEMSET(&lwcell.cmux, 0x00, sizeof(lwcell.cmux));
+    lwcell.cmux.active = 1;
+    lwcell.cmux.rx.state = LWCELL_CMUX_RX_FLAG;
+}
+
+/**
+ * \brief           Close multiplexer and return device to AT command mode
+ */
+void
+lwcelli_cmux_close(void) {
+    const uint8_t cld[] = {(CMUX_MSG_CLD << 2) | CMUX_CR | CMUX_EA, CMUX_EA};
+
+    if (!lwcell.cmux.active) {
+        return;
+    }
+    tx_flush();
+    send_frame(LWCELL_CMUX_DLCI_CTRL, 1, CMUX_UIH, cld, sizeof(cld));
+    lwcell_timeout_remove(sabm_timeout);
+    LWCELL_MEMSET(&lwcell.cmux, 0x00, sizeof(lwcell.cmux));
+}
+
+/**
+ * \brief           Open multiplexer channel with `SABM` frame.
+ *                  Current command step finishes when device responds with `UA` or `DM` frame
+ * \param[in]       dlci: Channel DLCI
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcelli_cmux_open_dlc(uint8_t dlci) {
+    lwcell_timeout_remove(sabm_timeout);
+    if (lwcell_timeout_add(CMUX_SABM_TIMEOUT, sabm_timeout, lwcell.msg) != lwcellOK) {
+        return lwcellERRMEM;
+    }
+    lwcell.cmux.sabm_dlci = dlci;
+    lwcell.cmux.sabm_pend = 1;
+    send_frame(dlci, 1, CMUX_SABM | CMUX_PF, NULL, 0);
+    return lwcellOK;
+}
+
+/**
+ * \brief           Get `port_speed` parameter of `AT+CMUX` command
+ * \param[in]       baudrate: AT port baudrate
+ * \return          Parameter value, or `0` if baudrate has no code
+ */
+uint8_t
+lwcelli_cmux_get_port_speed(uint32_t baudrate) {
+    const uint32_t rates[] = {9600, 19200, 38400, 57600, 115200, 230400};
+
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(rates); ++i) {
+        if (rates[i] == baudrate) {
+            return LWCELL_U8(i + 1);
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Process data received on AT port in multiplexer mode
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data
+ */
+void
+lwcelli_cmux_input(const void* data, size_t len) {
+    const uint8_t* d = data;
+    uint8_t ch;
+
+    while (len > 0 && lwcell.cmux.active) {
+        ch = *d;
+        switch (lwcell.cmux.rx.state) {
+            case LWCELL_CMUX_RX_FLAG: {
+                if (ch == CMUX_FLAG) {
+                    lwcell.cmux.rx.state = LWCELL_CMUX_RX_ADDR;
+                }
+                break;
+            }
+            case LWCELL_CMUX_RX_ADDR: {
+                if (ch != CMUX_FLAG) { /* Flags may repeat between frames */
+                    lwcell.cmux.rx.addr = ch;
+                    lwcell.cmux.rx.fcs = fcs_update(0xFF, ch);
+                    lwcell.cmux.rx.state = LWCELL_CMUX_RX_CTRL;
+                }
+                break;
+            }
+            case LWCELL_CMUX_RX_CTRL: {
+                lwcell.cmux.rx.ctrl = ch;
+                lwcell.cmux.rx.fcs = fcs_update(lwcell.cmux.rx.fcs, ch);
+                lwcell.cmux.rx.state = LWCELL_CMUX_RX_LEN1;
+                break;
+            }
+            case LWCELL_CMUX_RX_LEN1:
+            case LWCELL_CMUX_RX_LEN2: {
+                lwcell.cmux.rx.fcs = fcs_update(lwcell.cmux.rx.fcs, ch);
+                if (lwcell.cmux.rx.state == LWCELL_CMUX_RX_LEN1) {
+                    lwcell.cmux.rx.len = ch >> 1;
+                    lwcell.cmux.rx.ptr = 0;
+                    if (!(ch & CMUX_EA)) {
+                        lwcell.cmux.rx.state = LWCELL_CMUX_RX_LEN2;
+                        break;
+                    }
+                } else {
+                    lwcell.cmux.rx.len |= (size_t)ch << 7;
+                }
+                lwcell.cmux.rx.state = lwcell.cmux.rx.len > 0 ? LWCELL_CMUX_RX_DATA : LWCELL_CMUX_RX_FCS;
+                break;
+            }
+            case LWCELL_CMUX_RX_DATA: {
+                /* Copy as much as possible at once, information field of UIH frame is not part of FCS */
+                size_t tocopy = LWCELL_MIN(len, lwcell.cmux.rx.len - lwcell.cmux.rx.ptr);
+
+                if (lwcell.cmux.rx.ptr + tocopy <= sizeof(lwcell.cmux.rx.data)) {
+                    LWCELL_MEMCPY(&lwcell.cmux.rx.data[lwcell.cmux.rx.ptr], d, tocopy);
+                }
+                if ((lwcell.cmux.rx.ctrl & ~CMUX_PF) == CMUX_UI) {
+                    for (size_t i = 0; i < tocopy; ++i) {
+                        lwcell.cmux.rx.fcs = fcs_update(lwcell.cmux.rx.fcs, d[i]);
+                    }
+                }
+                lwcell.cmux.rx.ptr += tocopy;
+                d += tocopy - 1;
+                len -= tocopy - 1;
+                if (lwcell.cmux.rx.ptr == lwcell.cmux.rx.len) {
+                    lwcell.cmux.rx.state = LWCELL_CMUX_RX_FCS;
+                }
+                break;
+            }
+            case LWCELL_CMUX_RX_FCS: {
+                lwcell.cmux.rx.fcs = fcs_update(lwcell.cmux.rx.fcs, ch);
+                lwcell.cmux.rx.state = LWCELL_CMUX_RX_END;
+                break;
+            }
+            case LWCELL_CMUX_RX_END: {
+                if (ch == CMUX_FLAG) {
+                    /* Process only valid frames, which fit to buffer */
+                    if (lwcell.cmux.rx.fcs == CMUX_FCS_GOOD && lwcell.cmux.rx.len <= sizeof(lwcell.cmux.rx.data)) {
+                        process_frame();
+                    } else {
+                        LWCELL_DEBUGF(LWCELL_CFG_DBG_INIT | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                                      "[LWCELL CMUX] Invalid frame dropped\r\n");
+                    }
+                    lwcell.cmux.rx.state = LWCELL_CMUX_RX_ADDR; /* Closing flag may also open next frame */
+                } else {
+                    lwcell.cmux.rx.state = LWCELL_CMUX_RX_FLAG;
+                }
+                break;
+            }
+            default: break;
+        }
+        ++d;
+        --len;
+    }
+}
+
+/**
+ * \brief           Send data to AT port, packed to frames when multiplexer is active
+ * \note            Use `AT_PORT_SEND` macros instead of calling function directly
+ * \param[in]       data: Data to send. Set to `NULL` to flush data
+ * \param[in]       len: Number of bytes to send
+ * \return          Number of bytes accepted
+ */
+size_t
+lwcelli_cmux_at_port_send(const void* data, size_t len) {
+    const uint8_t* d = data;
+    uint8_t dlci;
+
+    if (!lwcell.cmux.active) {
+        return lwcell.ll.send_fn(data, len);
+    }
+    if (data == NULL || len == 0) {
+        tx_flush();
+        return 0;
+    }
+
+    /* Data of different channels may not share the frame */
+    dlci = get_cmd_dlci();
+    if (lwcell.cmux.tx.len > 0 && lwcell.cmux.tx.dlci != dlci) {
+        tx_flush();
+    }
+    lwcell.cmux.tx.dlci = dlci;
+    for (size_t rem = len; rem > 0;) {
+        size_t tocopy = LWCELL_MIN(rem, sizeof(lwcell.cmux.tx.data) - lwcell.cmux.tx.len);
+
+        LWCELL_MEMCPY(&lwcell.cmux.tx.data[lwcell.cmux.tx.len], d, tocopy);
+        lwcell.cmux.tx.len += tocopy;
+        d += tocopy;
+        rem -= tocopy;
+        if (lwcell.cmux.tx.len == sizeof(lwcell.cmux.tx.data)) {
+            tx_flush();
+        }
+    }
+    return len;
+}
+
+/**
+ * \brief           Send data to data channel, independently of active command.
+ *                  Used by PPP, while AT channel may be busy with other command
+ * \param[in]       data: Data to send
+ * \param[in]       len: Number of bytes to send
+ */
+void
+lwcelli_cmux_data_send(const void* data, size_t len) {
+    const uint8_t* d = data;
+
+    tx_flush(); /* Keep order with data of active command */
+    for (size_t off = 0; off < len; off += sizeof(lwcell.cmux.tx.data)) {
+        send_frame(LWCELL_CMUX_DLCI_DATA, 1, CMUX_UIH, &d[off], LWCELL_MIN(len - off, sizeof(lwcell.cmux.tx.data)));
+    }
+}
+
+/**
+ * \brief           Check if multiplexer mode is active on AT port
+ * \return          `1` if active, `0` otherwise
+ */
+uint8_t
+lwcell_cmux_is_active(void) {
+    uint8_t active;
+
+    lwcell_core_lock();
+    active = lwcell.cmux.active;
+    lwcell_core_unlock();
+    return active;
+}
+
+#endif /* LWCELL_CFG_CMUX || __DOXYGEN__ */
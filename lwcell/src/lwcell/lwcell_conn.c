@@ -103,6 +103,8 @@ lwcelli_conn_get_val_id(lwcell_conn_p conn) {
  * \param[in]       port: Remote port connection
  * \param[in]       data: Pointer to data to send
  * \param[in]       btw: Number of bytes to send
+ * \param[in]       data2: Pointer to data sent right after `data` in the same packets. Set to `NULL` if not used
+ * \param[in]       btw2: Number of bytes to send from `data2`
  * \param[out]      bw: Pointer to output variable to save number of sent data when successfully sent
  * \param[in]       fau: "Free After Use" flag. Set to `1` if stack should free the memory after data sent
  * \param[in]       blocking: Status whether command should be blocking or not
@@ -110,7 +112,7 @@ lwcelli_conn_get_val_id(lwcell_conn_p conn) {
  */
 static lwcellr_t
 conn_send(lwcell_conn_p conn, const lwcell_ip_t* const ip, lwcell_port_t port, const void* data, size_t btw,
-          size_t* const bw, uint8_t fau, const uint32_t blocking) {
+          const void* data2, size_t btw2, size_t* const bw, uint8_t fau, const uint32_t blocking) {
     LWCELL_MSG_VAR_DEFINE(msg);
 
     LWCELL_ASSERT(conn != NULL);
@@ -128,7 +130,9 @@ conn_send(lwcell_conn_p conn, const lwcell_ip_t* const ip, lwcell_port_t port, c
 
     LWCELL_MSG_VAR_REF(msg).msg.conn_send.conn = conn;
     LWCELL_MSG_VAR_REF(msg).msg.conn_send.data = data;
-    LWCELL_MSG_VAR_REF(msg).msg.conn_send.btw = btw;
+    LWCELL_MSG_VAR_REF(msg).msg.conn_send.data_len = btw;
+    LWCELL_MSG_VAR_REF(msg).msg.conn_send.data2 = data2;
+    LWCELL_MSG_VAR_REF(msg).msg.conn_send.btw = btw + (data2 != NULL ? btw2 : 0);
     LWCELL_MSG_VAR_REF(msg).msg.conn_send.bw = bw;
     LWCELL_MSG_VAR_REF(msg).msg.conn_send.remote_ip = ip;
     LWCELL_MSG_VAR_REF(msg).msg.conn_send.remote_port = port;
@@ -153,7 +157,7 @@ flush_buff(lwcell_conn_p conn) {
          * simply free the memory and stop execution
          */
         if (conn->buff.ptr > 0) { /* Anything to send at the moment? */
-            res = conn_send(conn, NULL, 0, conn->buff.buff, conn->buff.ptr, NULL, 1, 0);
+            res = conn_send(conn, NULL, 0, conn->buff.buff, conn->buff.ptr, NULL, 0, NULL, 1, 0);
         } else {
             res = lwcellERR;
         }
@@ -280,7 +284,7 @@ lwcell_conn_sendto(lwcell_conn_p conn, const lwcell_ip_t* const ip, lwcell_port_
     LWCELL_ASSERT(conn != NULL);
 
     flush_buff(conn); /* Flush currently written memory if exists */
-    return conn_send(conn, ip, port, data, btw, bw, 0, blocking);
+    return conn_send(conn, ip, port, data, btw, NULL, 0, bw, 0, blocking);
 }
 
 /**
@@ -316,11 +320,39 @@ lwcell_conn_send(lwcell_conn_p conn, const void* data, size_t btw, size_t* const
     lwcell_core_unlock();
     res = flush_buff(conn); /* Flush currently written memory if exists */
     if (btw > 0) {          /* Check for remaining data */
-        res = conn_send(conn, NULL, 0, d, btw, bw, 0, blocking);
+        res = conn_send(conn, NULL, 0, d, btw, NULL, 0, bw, 0, blocking);
     }
     return res;
 }
 
+/**
+ * \brief           Send data composed of two memory parts on already active connection
+ *
+ * Parts are sent as single stream, packet sent to device may contain end of first part
+ * and beginning of second part. Use it to send content of ring buffer, when data wrap
+ * around the end of buffer memory, with the same number of device send commands as linear data.
+ *
+ * \note           Data are not copied, both parts must stay valid until send event is received
+ *
+ * \param[in]       conn: Connection handle to send data
+ * \param[in]       data: First part of data to send
+ * \param[in]       btw: Number of bytes to send from first part
+ * \param[in]       data2: Second part of data to send. Set to `NULL` to send first part only
+ * \param[in]       btw2: Number of bytes to send from second part
+ * \param[out]      bw: Pointer to output variable to save number of sent data when successfully sent
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_conn_send_parts(lwcell_conn_p conn, const void* data, size_t btw, const void* data2, size_t btw2,
+                       size_t* const bw, const uint32_t blocking) {
+    LWCELL_ASSERT(conn != NULL);
+    LWCELL_ASSERT(data2 == NULL || btw2 > 0);
+
+    flush_buff(conn); /* Flush currently written memory if exists */
+    return conn_send(conn, NULL, 0, data, btw, data2, btw2, bw, 0, blocking);
+}
+
 /**
  * \brief           Notify connection about received data which means connection is ready to accept more data
  *
@@ -512,7 +544,7 @@ lwcell_conn_write(lwcell_conn_p conn, const void* data, size_t btw, uint8_t flus
         /* Step 1.1 */
         if (conn->buff.ptr == conn->buff.len || flush) {
             /* Try to send to processing queue in non-blocking way */
-            if (conn_send(conn, NULL, 0, conn->buff.buff, conn->buff.ptr, NULL, 1, 0) != lwcellOK) {
+            if (conn_send(conn, NULL, 0, conn->buff.buff, conn->buff.ptr, NULL, 0, NULL, 1, 0) != lwcellOK) {
                 LWCELL_DEBUGF(LWCELL_CFG_DBG_CONN | LWCELL_DBG_TYPE_TRACE, "[LWCELL CONN] Free write buffer: %p\r\n",
                               conn->buff.buff);
                 lwcell_mem_free_s((void**)&conn->buff.buff);
@@ -527,7 +559,7 @@ lwcell_conn_write(lwcell_conn_p conn, const void* data, size_t btw, uint8_t flus
         buff = lwcell_mem_malloc(sizeof(*buff) * LWCELL_CFG_CONN_MAX_DATA_LEN);
         if (buff != NULL) {
             LWCELL_MEMCPY(buff, d, LWCELL_CFG_CONN_MAX_DATA_LEN); /* Copy data to buffer */
-            if (conn_send(conn, NULL, 0, buff, LWCELL_CFG_CONN_MAX_DATA_LEN, NULL, 1, 0) != lwcellOK) {
+            if (conn_send(conn, NULL, 0, buff, LWCELL_CFG_CONN_MAX_DATA_LEN, NULL, 0, NULL, 1, 0) != lwcellOK) {
                 LWCELL_DEBUGF(LWCELL_CFG_DBG_CONN | LWCELL_DBG_TYPE_TRACE, "[LWCELL CONN] Free write buffer: %p\r\n",
                               (void*)buff);
                 lwcell_mem_free_s((void**)&buff);
@@ -595,6 +627,24 @@ lwcell_conn_get_total_recved_count(lwcell_conn_p conn) {
     return tot;
 }
 
+/**
+ * \brief           Get total number of bytes successfully sent on connection
+ * \param[in]       conn: Connection handle
+ * \return          Count of sent bytes on connection
+ */
+size_t
+lwcell_conn_get_total_sent_count(lwcell_conn_p conn) {
+    size_t tot;
+
+    LWCELL_ASSERT(conn != NULL);
+
+    lwcell_core_lock();
+    tot = conn->total_sent; /* Get total sent bytes */
+    lwcell_core_unlock();
+
+    return tot;
+}
+
 /**
  * \brief           Get connection remote IP address
  * \param[in]       conn: Connection handle
@@ -34,72 +34,217 @@
 #include "lwcell/lwcell_evt.h"
 #include "lwcell/lwcell_private.h"
 
+#if LWCELL_CFG_EVT_DISPATCH
+/* Callback list is walked by dispatch thread without core lock, protect it with dispatch mutex */
+#define LWCELL_EVT_DISPATCH_LIST_LOCK()                                                                                \
+    do {                                                                                                               \
+        if (lwcell_sys_mutex_isvalid(&lwcell.evt_dispatch.mutex)) {                                                    \
+            lwcell_sys_mutex_lock(&lwcell.evt_dispatch.mutex);                                                         \
+        }                                                                                                              \
+    } while (0)
+#define LWCELL_EVT_DISPATCH_LIST_UNLOCK()                                                                              \
+    do {                                                                                                               \
+        if (lwcell_sys_mutex_isvalid(&lwcell.evt_dispatch.mutex)) {                                                    \
+            lwcell_sys_mutex_unlock(&lwcell.evt_dispatch.mutex);                                                       \
+        }                                                                                                              \
+    } while (0)
+#else /* LWCELL_CFG_EVT_DISPATCH */
+#define LWCELL_EVT_DISPATCH_LIST_LOCK()
+#define LWCELL_EVT_DISPATCH_LIST_UNLOCK()
+#endif /* !LWCELL_CFG_EVT_DISPATCH */
+
+/**
+ * \brief           Check if function is already registered, either for all or for selected events
+ * \param[in]       fn: Callback function to check
+ * \return          `1` if registered, `0` otherwise
+ */
+static uint8_t
+prv_evt_is_registered(lwcell_evt_fn fn) {
+    for (lwcell_evt_func_t* func = lwcell.evt_func; func != NULL; func = func->next) {
+        if (func->fn == fn) {
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(lwcell.evt_func_type); ++i) {
+        for (lwcell_evt_func_t* func = lwcell.evt_func_type[i]; func != NULL; func = func->next) {
+            if (func->fn == fn) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Append new function entry to the end of the list
+ * \param[in,out]   head: Pointer to list head
+ * \param[in]       fn: Callback function to add
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+static lwcellr_t
+prv_evt_list_append(lwcell_evt_func_t** head, lwcell_evt_fn fn) {
+    lwcell_evt_func_t** link;
+    lwcell_evt_func_t* new_func;
+
+    new_func = lwcell_mem_malloc(sizeof(*new_func));
+    if (new_func == NULL) {
+        return lwcellERRMEM;
+    }
+    LWCELL_MEMSET(new_func, 0x00, sizeof(*new_func));
+    new_func->fn = fn; /* Set function pointer */
+    for (link = head; *link != NULL; link = &(*link)->next) {}
+    *link = new_func; /* Set new function as last */
+    return lwcellOK;
+}
+
+/**
+ * \brief           Remove function entry from the list, if it exists
+ * \param[in,out]   head: Pointer to list head
+ * \param[in]       fn: Callback function to remove
+ */
+static void
+prv_evt_list_remove(lwcell_evt_func_t** head, lwcell_evt_fn fn) {
+    for (lwcell_evt_func_t** link = head; *link != NULL; link = &(*link)->next) {
+        if ((*link)->fn == fn) {
+            lwcell_evt_func_t* func = *link;
+            *link = func->next;
+            lwcell_mem_free_s((void**)&func);
+            break;
+        }
+    }
+}
+
 /**
  * \brief           Register callback function for global (non-connection based) events
+ * \note            Function receives all events. Use \ref lwcell_evt_register_mask
+ *                  to receive only selected event types
  * \param[in]       fn: Callback function to call on specific event
  * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
  */
 lwcellr_t
 lwcell_evt_register(lwcell_evt_fn fn) {
+    return lwcell_evt_register_mask(fn, LWCELL_EVT_MASK_ALL);
+}
+
+/**
+ * \brief           Register callback function for selected global (non-connection based) events
+ *
+ * Function is added to subscriber list of each event type set in the mask,
+ * therefore it is not called (nor checked) for any other event type.
+ *
+ * \note            Functions registered for all events are called before
+ *                  functions registered for selected event types
+ * \param[in]       fn: Callback function to call on specific event
+ * \param[in]       mask: Bit mask of event types, built with \ref LWCELL_EVT_MASK macro.
+ *                      Use \ref LWCELL_EVT_MASK_ALL to receive all events
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_evt_register_mask(lwcell_evt_fn fn, lwcell_evt_mask_t mask) {
     lwcellr_t res = lwcellOK;
-    lwcell_evt_func_t *func, *new_func;
 
     LWCELL_ASSERT(fn != NULL);
+    LWCELL_ASSERT(mask > 0);
 
+    LWCELL_EVT_DISPATCH_LIST_LOCK();
     lwcell_core_lock();
 
     /* Check if function already exists on list */
-    for (func = lwcell.evt_func; func != NULL; func = func->next) {
-        if (func->fn == fn) {
-            res = lwcellERR;
-            break;
+    if (prv_evt_is_registered(fn)) {
+        res = lwcellERR;
+    } else if (mask == LWCELL_EVT_MASK_ALL) {
+        if (lwcell.evt_func != NULL) {
+            res = prv_evt_list_append(&lwcell.evt_func, fn);
+        } else {
+            res = lwcellERRMEM;
+        }
+    } else {
+        for (size_t i = 0; res == lwcellOK && i < LWCELL_ARRAYSIZE(lwcell.evt_func_type); ++i) {
+            if (mask & LWCELL_EVT_MASK(i)) {
+                res = prv_evt_list_append(&lwcell.evt_func_type[i], fn);
+            }
         }
-    }
 
-    if (res == lwcellOK) {
-        new_func = lwcell_mem_malloc(sizeof(*new_func));
-        if (new_func != NULL) {
-            LWCELL_MEMSET(new_func, 0x00, sizeof(*new_func));
-            new_func->fn = fn; /* Set function pointer */
-            for (func = lwcell.evt_func; func != NULL && func->next != NULL; func = func->next) {}
-            if (func != NULL) {
-                func->next = new_func; /* Set new function as next */
-                res = lwcellOK;
-            } else {
-                lwcell_mem_free_s((void**)&new_func);
-                res = lwcellERRMEM;
+        /* Revert partial registration */
+        if (res != lwcellOK) {
+            for (size_t i = 0; i < LWCELL_ARRAYSIZE(lwcell.evt_func_type); ++i) {
+                prv_evt_list_remove(&lwcell.evt_func_type[i], fn);
             }
-        } else {
-            res = lwcellERRMEM;
         }
     }
     lwcell_core_unlock();
+    LWCELL_EVT_DISPATCH_LIST_UNLOCK();
     return res;
 }
 
 /**
  * \brief           Unregister callback function for global (non-connection based) events
  * \note            Function must be first registered using \ref lwcell_evt_register
+ *                  or \ref lwcell_evt_register_mask
  * \param[in]       fn: Callback function to remove from event list
  * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
  */
 lwcellr_t
 lwcell_evt_unregister(lwcell_evt_fn fn) {
-    lwcell_evt_func_t *func, *prev;
     LWCELL_ASSERT(fn != NULL);
 
+    LWCELL_EVT_DISPATCH_LIST_LOCK();
     lwcell_core_lock();
-    for (prev = lwcell.evt_func, func = lwcell.evt_func->next; func != NULL; prev = func, func = func->next) {
-        if (func->fn == fn) {
-            prev->next = func->next;
-            lwcell_mem_free_s((void**)&func);
-            break;
-        }
+    if (lwcell.evt_func != NULL) {
+        prv_evt_list_remove(&lwcell.evt_func->next, fn); /* First entry is default function, never removed */
+    }
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(lwcell.evt_func_type); ++i) {
+        prv_evt_list_remove(&lwcell.evt_func_type[i], fn);
     }
     lwcell_core_unlock();
+    LWCELL_EVT_DISPATCH_LIST_UNLOCK();
     return lwcellOK;
 }
 
+#if LWCELL_CFG_EVT_DISPATCH || __DOXYGEN__
+
+/**
+ * \brief           Set dispatch policy for specific event type
+ * \note            Available only when \ref LWCELL_CFG_EVT_DISPATCH is enabled
+ * \note            Events with pointers valid only during the callback, such as phonebook search,
+ *                  SMS read or operator scan, are always synchronous
+ * \param[in]       type: Event type to set policy for
+ * \param[in]       policy: Dispatch policy. Member of \ref lwcell_evt_dispatch_policy_t enumeration
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_evt_dispatch_set_policy(lwcell_evt_type_t type, lwcell_evt_dispatch_policy_t policy) {
+    LWCELL_ASSERT((size_t)type < LWCELL_ARRAYSIZE(lwcell.evt_dispatch.policy));
+    LWCELL_ASSERT(policy <= LWCELL_EVT_DISPATCH_POLICY_SYNC_ON_FULL);
+
+    if (policy != LWCELL_EVT_DISPATCH_POLICY_SYNC && lwcelli_evt_dispatch_is_sync_only(type)) {
+        return lwcellERRPAR;
+    }
+
+    lwcell_core_lock();
+    lwcell.evt_dispatch.policy[type] = (uint8_t)policy;
+    lwcell_core_unlock();
+    return lwcellOK;
+}
+
+/**
+ * \brief           Get dispatch queue statistics
+ * \note            Available only when \ref LWCELL_CFG_EVT_DISPATCH is enabled
+ * \param[out]      stats: Pointer to output statistics structure
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_evt_dispatch_get_stats(lwcell_evt_dispatch_stats_t* stats) {
+    LWCELL_ASSERT(stats != NULL);
+
+    lwcell_core_lock();
+    LWCELL_MEMCPY(stats, &lwcell.evt_dispatch.stats, sizeof(*stats));
+    lwcell_core_unlock();
+    return lwcellOK;
+}
+
+#endif /* LWCELL_CFG_EVT_DISPATCH || __DOXYGEN__ */
+
 /**
  * \brief           Get event type
  * \param[in]       cc: Event handle
@@ -463,3 +608,27 @@ lwcell_evt_call_changed_get_call(lwcell_evt_t* cc) {
 }
 
 #endif /* LWCELL_CFG_CALL || __DOXYGEN__ */
+
+#if LWCELL_CFG_HTTP || __DOXYGEN__
+
+/**
+ * \brief           Get number of HTTP POST body bytes written to device
+ * \param[in]       cc: Event handle
+ * \return          Number of bytes written so far
+ */
+uint32_t
+lwcell_evt_http_post_progress_get_sent(lwcell_evt_t* cc) {
+    return cc->evt.http_post_progress.sent;
+}
+
+/**
+ * \brief           Get total length of HTTP POST body
+ * \param[in]       cc: Event handle
+ * \return          Body length in units of bytes
+ */
+uint32_t
+lwcell_evt_http_post_progress_get_total(lwcell_evt_t* cc) {
+    return cc->evt.http_post_progress.total;
+}
+
+#endif /* LWCELL_CFG_HTTP || __DOXYGEN__ */
@@ -488,6 +488,318 @@ lwcellr_t lwcell_http_client_write(lwcell_http_client_p client, const void* data
 }
 
 
+/**
+ * \brief           Download part of the resource with `HTTP GET` and range request
+ *
+ * Body is passed to `recv_fn` in packet buffers of up to \ref LWCELL_CFG_CONN_MAX_DATA_LEN bytes,
+ * so that memory usage does not depend on the length of the range.
+ * Server must answer with `206 Partial Content`, or with `200 OK` when `offset` is `0`,
+ * in this case complete resource is received.
+ *
+ * \note           Application protocol bearer must be attached with \ref lwcell_network_attach
+ *                  and \ref LWCELL_PDP_APP_PROTOCOL before calling this function
+ *
+ * \param[in]       url: Resource URL. Pointer must be valid until command finishes
+ * \param[in]       offset: Offset of the first byte to download
+ * \param[in]       len: Number of bytes to download, must be greater than `0`
+ * \param[in]       recv_fn: Callback function called for received body data
+ * \param[in]       arg: Custom argument for `recv_fn`
+ * \param[out]      status: Pointer to output HTTP status code. Set to `NULL` if not used
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise.
+ *                  Requested range beyond the end of the resource (`416`) is reported as success
+ */
+lwcellr_t
+lwcell_http_get_range(const char* url, uint32_t offset, uint32_t len, lwcell_http_range_fn recv_fn, void* arg,
+                      uint16_t* status, const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg,
+                      const uint32_t blocking) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_ASSERT(url != NULL);
+    LWCELL_ASSERT(len > 0);
+    LWCELL_ASSERT(recv_fn != NULL);
+
+    if (status != NULL) {
+        *status = 0;
+    }
+
+    LWCELL_MSG_VAR_ALLOC(msg, blocking);
+    LWCELL_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_HTTP_GET_RANGE;
+    LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_HTTPINIT;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.url = url;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.offset = offset;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.len = len;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.recv_fn = recv_fn;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.arg = arg;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.status = status;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.res = lwcellOK;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 120000);
+}
+
+/**
+ * \brief           Download context for \ref lwcell_http_download
+ */
+typedef struct {
+    uint32_t offset;         /*!< Offset of the next byte to download */
+    lwcell_http_range_fn fn; /*!< User callback function */
+    void* arg;               /*!< User callback argument */
+    uint8_t aborted;         /*!< Set to `1` when user callback stopped the download */
+} http_download_t;
+
+/**
+ * \brief           Range callback of \ref lwcell_http_download, tracking download progress
+ * \param[in]       pbuf: Packet buffer with body data
+ * \param[in]       offset: Offset of first byte in `pbuf`
+ * \param[in]       arg: Download context
+ * \return          Result of user callback
+ */
+static lwcellr_t
+prv_http_download_fn(lwcell_pbuf_p pbuf, uint32_t offset, void* arg) {
+    http_download_t* dl = arg;
+    lwcellr_t res;
+
+    res = dl->fn(pbuf, offset, dl->arg);
+    dl->offset = offset + LWCELL_U32(lwcell_pbuf_length(pbuf, 1));
+    if (res != lwcellOK) {
+        dl->aborted = 1;
+    }
+    return res;
+}
+
+/**
+ * \brief           Download resource in ranges, resuming at the last received byte after failure
+ *
+ * Resource is requested in consecutive ranges of `range_len` bytes with \ref lwcell_http_get_range.
+ * When a range fails (timeout, modem error, dropped connection), it is requested again
+ * from the first byte not yet received, up to \ref LWCELL_CFG_HTTP_DOWNLOAD_RETRIES times in a row.
+ * Download finishes when server returns less data than requested, complete resource (`200`),
+ * or reports range beyond the end of the resource (`416`).
+ *
+ * \note           Function is blocking and cannot be called from callback function
+ *
+ * \param[in]       url: Resource URL
+ * \param[in]       offset: Offset of the first byte to download, use `0` for complete resource
+ * \param[in]       range_len: Number of bytes requested in one range
+ * \param[in]       recv_fn: Callback function called for received body data
+ * \param[in]       arg: Custom argument for `recv_fn`
+ * \param[out]      downloaded: Pointer to output number of bytes received. Set to `NULL` if not used
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_http_download(const char* url, uint32_t offset, uint32_t range_len, lwcell_http_range_fn recv_fn, void* arg,
+                     uint32_t* downloaded) {
+    http_download_t dl = {.offset = offset, .fn = recv_fn, .arg = arg};
+    lwcellr_t res;
+    uint32_t start;
+    uint16_t status;
+    uint8_t retries = 0;
+
+    LWCELL_ASSERT(url != NULL);
+    LWCELL_ASSERT(range_len > 0);
+    LWCELL_ASSERT(recv_fn != NULL);
+
+    while (1) {
+        start = dl.offset;
+        res = lwcell_http_get_range(url, start, range_len, prv_http_download_fn, &dl, &status, NULL, NULL, 1);
+        if (dl.aborted) {
+            res = lwcellERR;
+            break;
+        }
+        if (res == lwcellOK) {
+            retries = 0;
+            if (status == 200 || status == 416 || (dl.offset - start) < range_len) {
+                break;
+            }
+            continue;
+        }
+
+        /*
+         * Server refused the request or ignored the range, repeating it does not help.
+         * Codes from `600` up are reported by the modem for network errors and are retried
+         */
+        if (status > 0 && status < 600 && status != 206 && (status != 200 || start > 0)) {
+            LWCELL_DEBUGF(LWCELL_CFG_DBG_HTTP_CLIENT_TRACE_WARNING,
+                          "[HTTP CLIENT] Range download failed with status %d\r\n", (int)status);
+            break;
+        }
+        if (res == lwcellERRPAR || res == lwcellERRBLOCKING) {
+            break;
+        }
+        if (dl.offset != start) {
+            retries = 0; /* Progress was made, start counting again */
+        }
+        if (++retries > LWCELL_CFG_HTTP_DOWNLOAD_RETRIES) {
+            break;
+        }
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_HTTP_CLIENT_TRACE_WARNING,
+                      "[HTTP CLIENT] Range download failed, resuming at offset %u\r\n", (unsigned)dl.offset);
+    }
+    if (downloaded != NULL) {
+        *downloaded = dl.offset - offset;
+    }
+    return res;
+}
+
+
+
 
+/**
+ * \brief           Send `HTTP POST` request with body produced by application in segments
+ *
+ * Body is announced to device with `AT+HTTPDATA` and requested from `body_fn`
+ * in segments of up to \ref LWCELL_CFG_HTTP_POST_SEGMENT_LEN bytes, written to device as they are produced.
+ * Complete body is never copied to memory by the stack.
+ * \ref LWCELL_EVT_HTTP_POST_PROGRESS event is sent after every segment.
+ *
+ * \note           Application protocol bearer must be attached with \ref lwcell_network_attach
+ *                  and \ref LWCELL_PDP_APP_PROTOCOL before calling this function
+ *
+ * \param[in]       url: Resource URL. Pointer must be valid until command finishes
+ * \param[in]       content_type: Value of `Content-Type` header. Set to `NULL` to use device default
+ * \param[in]       len: Body length, up to \ref LWCELL_CFG_HTTP_POST_MAX_LEN bytes
+ * \param[in]       body_fn: Callback function producing body data
+ * \param[in]       body_arg: Custom argument for `body_fn`
+ * \param[in]       recv_fn: Callback function called for response body. Set to `NULL` to skip response body
+ * \param[in]       recv_arg: Custom argument for `recv_fn`
+ * \param[out]      status: Pointer to output HTTP status code. Set to `NULL` if not used
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK when server accepted the request with `2xx` status code,
+ *                  member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_http_post(const char* url, const char* content_type, uint32_t len, lwcell_http_body_fn body_fn, void* body_arg,
+                 lwcell_http_range_fn recv_fn, void* recv_arg, uint16_t* status, const lwcell_api_cmd_evt_fn evt_fn,
+                 void* const evt_arg, const uint32_t blocking) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_ASSERT(url != NULL);
+    LWCELL_ASSERT(len > 0 && len <= LWCELL_CFG_HTTP_POST_MAX_LEN);
+    LWCELL_ASSERT(body_fn != NULL);
+
+    if (status != NULL) {
+        *status = 0;
+    }
+
+    LWCELL_MSG_VAR_ALLOC(msg, blocking);
+    LWCELL_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_HTTP_POST;
+    LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_HTTPINIT;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.url = url;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.content_type = content_type;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.body_fn = body_fn;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.body_arg = body_arg;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.body_len = len;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.recv_fn = recv_fn;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.arg = recv_arg;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.status = status;
+    LWCELL_MSG_VAR_REF(msg).msg.http_req.res = lwcellOK;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 180000);
+}
+
+/**
+ * \brief           Body producer for \ref lwcell_http_post_pbuf, copying from packet buffer chain
+ * \param[out]      buff: Buffer to fill
+ * \param[in]       btw: Number of bytes to write
+ * \param[in]       offset: Offset in the body
+ * \param[in]       arg: Packet buffer chain
+ * \return          Number of bytes written
+ */
+static size_t
+prv_http_pbuf_body_fn(void* buff, size_t btw, uint32_t offset, void* arg) {
+    return lwcell_pbuf_copy(arg, buff, btw, offset);
+}
+
+/**
+ * \brief           Send `HTTP POST` request with body in packet buffer chain
+ *
+ * Body is written to device directly from packet buffers, segment by segment,
+ * without copying the chain to contiguous memory.
+ *
+ * \note           Packet buffer must stay valid until command finishes.
+ *                  Use \ref lwcell_pbuf_ref before non-blocking call, when buffer is freed by other owner
+ *
+ * \param[in]       url: Resource URL. Pointer must be valid until command finishes
+ * \param[in]       content_type: Value of `Content-Type` header. Set to `NULL` to use device default
+ * \param[in]       pbuf: Packet buffer chain with body
+ * \param[in]       recv_fn: Callback function called for response body. Set to `NULL` to skip response body
+ * \param[in]       recv_arg: Custom argument for `recv_fn`
+ * \param[out]      status: Pointer to output HTTP status code. Set to `NULL` if not used
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK when server accepted the request with `2xx` status code,
+ *                  member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_http_post_pbuf(const char* url, const char* content_type, lwcell_pbuf_p pbuf, lwcell_http_range_fn recv_fn,
+                      void* recv_arg, uint16_t* status, const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg,
+                      const uint32_t blocking) {
+    LWCELL_ASSERT(pbuf != NULL);
+
+    return lwcell_http_post(url, content_type, LWCELL_U32(lwcell_pbuf_length(pbuf, 1)), prv_http_pbuf_body_fn, pbuf,
+                            recv_fn, recv_arg, status, evt_fn, evt_arg, blocking);
+}
+
+/**
+ * \brief           Set time to keep HTTP service of device initialized after request
+ *
+ * While service is kept, \ref lwcell_http_get_range and \ref lwcell_http_post skip `AT+HTTPINIT`
+ * and send only parameters, which have changed since previous request.
+ * Service is terminated with `AT+HTTPTERM` when no request has been started within `idle_time`,
+ * after any failed request or with \ref lwcell_http_session_close.
+ *
+ * \note           Setting takes effect after next request.
+ *                  Already kept service is terminated after previously set time
+ *
+ * \param[in]       idle_time: Time in units of milliseconds. Set to `0` to terminate service after every request
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_http_set_keep_alive(uint32_t idle_time) {
+    lwcell_core_lock();
+    lwcell.http_keep_alive = idle_time;
+    lwcell_core_unlock();
+    return lwcellOK;
+}
+
+/**
+ * \brief           Terminate HTTP service kept initialized between requests
+ *
+ * Use it to release resources of device before idle time of service has expired
+ *
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success or when service is not kept, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_http_session_close(const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+    uint8_t active;
+
+    lwcell_core_lock();
+    active = lwcell.m.http_session.active;
+    lwcell_core_unlock();
+    if (!active) {
+        if (evt_fn != NULL) {
+            evt_fn(lwcellOK, evt_arg);
+        }
+        return lwcellOK;
+    }
+
+    LWCELL_MSG_VAR_ALLOC(msg, blocking);
+    LWCELL_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_HTTP_SESSION_CLOSE;
+    LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_HTTPTERM;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 10000);
+}
 
 #endif /* LWCELL_CFG_HTTP || __DOXYGEN__ */
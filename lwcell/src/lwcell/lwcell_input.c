@@ -35,9 +35,6 @@
 #include "lwcell/lwcell_buff.h"
 #include "lwcell/lwcell_private.h"
 
-static uint32_t lwcell_recv_total_len;
-static uint32_t lwcell_recv_calls;
-
 #if !LWCELL_CFG_INPUT_USE_PROCESS || __DOXYGEN__
 
 /**
@@ -54,8 +51,8 @@ lwcell_input(const void* data, size_t len) {
     }
     lwcell_buff_write(&lwcell.buff, data, len);         /* Write data to buffer */
     lwcell_sys_mbox_putnow(&lwcell.mbox_process, NULL); /* Write empty box, don't care if write fails */
-    lwcell_recv_total_len += len;                       /* Update total number of received bytes */
-    ++lwcell_recv_calls;                                /* Update number of calls */
+    LWCELL_STATS_ADD(uart_rx_bytes, len);               /* Update total number of received bytes */
+    LWCELL_STATS_INC(uart_rx_calls);                    /* Update number of calls */
     return lwcellOK;
 }
 
@@ -82,11 +79,18 @@ lwcell_input_process(const void* data, size_t len) {
         return lwcellERR;
     }
 
-    lwcell_recv_total_len += len; /* Update total number of received bytes */
-    ++lwcell_recv_calls;          /* Update number of calls */
-
     lwcell_core_lock();
-    res = lwcelli_process(data, len); /* Process input data */
+    LWCELL_STATS_ADD(uart_rx_bytes, len); /* Update total number of received bytes */
+    LWCELL_STATS_INC(uart_rx_calls);      /* Update number of calls */
+#if LWCELL_CFG_CMUX
+    if (lwcell.cmux.active) {
+        lwcelli_cmux_input(data, len); /* Demultiplex frames first */
+        res = lwcellOK;
+    } else
+#endif /* LWCELL_CFG_CMUX */
+    {
+        res = lwcelli_process(data, len); /* Process input data */
+    }
     lwcell_core_unlock();
     return res;
 }
@@ -69,11 +69,18 @@ typedef struct {
 #define RECV_IDX(index)             recv_buff.data[index]
 
 /* Send data over AT port */
-#define AT_PORT_SEND_STR(str)       lwcell.ll.send_fn((const void*)(str), (size_t)strlen(str))
-#define AT_PORT_SEND_CONST_STR(str) lwcell.ll.send_fn((const void*)(str), (size_t)(sizeof(str) - 1))
-#define AT_PORT_SEND_CHR(ch)        lwcell.ll.send_fn((const void*)(ch), (size_t)1)
-#define AT_PORT_SEND_FLUSH()        lwcell.ll.send_fn(NULL, 0)
-#define AT_PORT_SEND(d, l)          lwcell.ll.send_fn((const void*)(d), (size_t)(l))
+#if LWCELL_CFG_STATS
+#define AT_PORT_SEND_FN lwcelli_stats_at_port_send
+#elif LWCELL_CFG_CMUX
+#define AT_PORT_SEND_FN lwcelli_cmux_at_port_send
+#else /* LWCELL_CFG_STATS */
+#define AT_PORT_SEND_FN lwcell.ll.send_fn
+#endif /* !LWCELL_CFG_STATS */
+#define AT_PORT_SEND_STR(str)       AT_PORT_SEND_FN((const void*)(str), (size_t)strlen(str))
+#define AT_PORT_SEND_CONST_STR(str) AT_PORT_SEND_FN((const void*)(str), (size_t)(sizeof(str) - 1))
+#define AT_PORT_SEND_CHR(ch)        AT_PORT_SEND_FN((const void*)(ch), (size_t)1)
+#define AT_PORT_SEND_FLUSH()        AT_PORT_SEND_FN(NULL, 0)
+#define AT_PORT_SEND(d, l)          AT_PORT_SEND_FN((const void*)(d), (size_t)(l))
 #define AT_PORT_SEND_WITH_FLUSH(d, l)                                                                                  \
     do {                                                                                                               \
         AT_PORT_SEND((d), (l));                                                                                        \
@@ -83,6 +90,8 @@ typedef struct {
 /* Beginning and end of every AT command */
 #define AT_PORT_SEND_BEGIN_AT()                                                                                        \
     do {                                                                                                               \
+        LWCELL_CMD_STATS_STEP_START(lwcell.msg);                                                                       \
+        LWCELL_TRACE(LWCELL_TRACE_ID_CMD_STEP, CMD_GET_DEF(), CMD_GET_CUR(), lwcell.msg != NULL ? lwcell.msg->i : 0);  \
         AT_PORT_SEND_CONST_STR("AT");                                                                                  \
     } while (0)
 #define AT_PORT_SEND_END_AT()                                                                                          \
@@ -117,8 +126,48 @@ typedef struct {
 #endif /* !__DOXYGEN__ */
 
 static lwcell_recv_t recv_buff;
+static uint8_t ch_prev1, ch_prev2;
+static lwcell_unicode_t unicode;
 static lwcellr_t lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat);
 
+#if LWCELL_CFG_CMUX || __DOXYGEN__
+/**
+ * \brief           Input parser context of multiplexer channel, saved while other channel is processed
+ */
+typedef struct {
+    lwcell_recv_t recv_buff;  /*!< Received line */
+    uint8_t ch_prev1;         /*!< Previous character */
+    uint8_t ch_prev2;         /*!< Character before previous */
+    lwcell_unicode_t unicode; /*!< Unicode decoder state */
+#if LWCELL_CFG_CONN || __DOXYGEN__
+    lwcell_ipd_t ipd; /*!< Connection data being received */
+#endif                /* LWCELL_CFG_CONN || __DOXYGEN__ */
+#if LWCELL_CFG_MQTT || __DOXYGEN__
+    lwcell_mqtt_rx_t mqtt_rx; /*!< MQTT message being received */
+#endif                        /* LWCELL_CFG_MQTT || __DOXYGEN__ */
+#if LWCELL_CFG_HTTP || __DOXYGEN__
+    lwcell_http_rx_t http_rx; /*!< HTTP body being received */
+#endif                        /* LWCELL_CFG_HTTP || __DOXYGEN__ */
+} lwcell_parser_ctx_t;
+
+static lwcell_parser_ctx_t parser_ctx[LWCELL_CMUX_DLCI_DATA]; /* Saved contexts, index is `DLCI - 1` */
+static uint8_t parser_ctx_dlci = LWCELL_CMUX_DLCI_AT;        /* Channel of active context */
+#endif /* LWCELL_CFG_CMUX || __DOXYGEN__ */
+
+#if LWCELL_CFG_PPP
+/* Check if data being processed belong to PPP, AT channel keeps command mode when PPP uses multiplexer */
+#if LWCELL_CFG_CMUX
+#define PPP_IS_DATA_CHANNEL() (lwcell.m.ppp.dlci == 0 || lwcell.m.ppp.dlci == parser_ctx_dlci)
+#else /* LWCELL_CFG_CMUX */
+#define PPP_IS_DATA_CHANNEL() 1
+#endif /* !LWCELL_CFG_CMUX */
+#endif /* LWCELL_CFG_PPP */
+
+#if LWCELL_CFG_HTTP
+/* Check if active command is request with body exchanged in segments through device HTTP service */
+#define HTTP_REQ_IS_DEF() (CMD_IS_DEF(LWCELL_CMD_HTTP_GET_RANGE) || CMD_IS_DEF(LWCELL_CMD_HTTP_POST))
+#endif /* LWCELL_CFG_HTTP */
+
 /**
  * \brief           Memory mapping
  */
@@ -458,6 +507,304 @@ reset_connections(uint8_t forced) {
 
 #endif /* LWCELL_CFG_CONN || __DOXYGEN__ */
 
+#if LWCELL_CFG_MQTT || __DOXYGEN__
+
+/**
+ * \brief           Close native MQTT session
+ * \param[in]       notify: Set to `1` to notify MQTT client, when session was not closed on its request
+ */
+static void
+mqtt_session_close(uint8_t notify) {
+    lwcell_mqtt_session_t* s = &lwcell.m.mqtt;
+
+    if (s->active) {
+        s->active = 0;
+        s->buff = NULL;
+        if (notify && s->closed_fn != NULL) {
+            s->closed_fn(s->arg);
+        }
+    }
+}
+
+/**
+ * \brief           Process payload of received MQTT message
+ *
+ * Message is passed to MQTT client when complete. It is skipped
+ * when topic and payload do not fit into receive buffer together.
+ *
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data
+ * \return          Number of processed bytes
+ */
+static size_t
+mqtt_session_input(const uint8_t* data, size_t len) {
+    lwcell_mqtt_session_t* s = &lwcell.m.mqtt;
+
+    len = LWCELL_MIN(len, s->rx.rem_len);
+    if (len > 0 && s->active && s->buff != NULL && s->rx.ptr < s->buff_len) {
+        LWCELL_MEMCPY(&s->buff[s->rx.ptr], data, LWCELL_MIN(len, s->buff_len - s->rx.ptr));
+    }
+    s->rx.ptr += len;
+    s->rx.rem_len -= len;
+    if (s->rx.rem_len == 0) {
+        s->rx.read = 0;
+        if (s->active && s->buff != NULL && s->rx.ptr <= s->buff_len) {
+            s->recv_fn((const char*)s->buff, s->rx.topic_len, &s->buff[s->rx.topic_len], s->rx.tot_len, s->arg);
+        } else {
+            LWCELL_DEBUGF(LWCELL_CFG_DBG_IPD | LWCELL_DBG_TYPE_TRACE,
+                          "[LWCELL MQTT] Message of %d byte(s) skipped\r\n", (int)s->rx.tot_len);
+        }
+    }
+    return len;
+}
+
+#endif /* LWCELL_CFG_MQTT || __DOXYGEN__ */
+
+#if LWCELL_CFG_HTTP || __DOXYGEN__
+
+/**
+ * \brief           Stop delivering body data of HTTP range and release its buffer
+ *
+ * Must be called whenever callback argument is not valid anymore,
+ * so that partially filled buffer is never passed to stale callback
+ */
+static void
+http_rx_reset(void) {
+    lwcell_http_rx_t* rx = &lwcell.m.http_rx;
+
+    if (rx->buff != NULL) {
+        lwcell_pbuf_free_s(&rx->buff);
+    }
+    rx->buff_ptr = 0;
+    rx->read = 0;
+    rx->recv_fn = NULL;
+}
+
+/**
+ * \brief           Process body data of HTTP range
+ *
+ * Data are copied to packet buffers of up to \ref LWCELL_CFG_CONN_MAX_DATA_LEN bytes,
+ * each buffer is passed to user as soon as it is full.
+ * Memory used for range of any length is therefore bounded by single buffer.
+ *
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data
+ * \return          Number of processed bytes
+ */
+static size_t
+http_rx_input(const uint8_t* data, size_t len) {
+    lwcell_http_rx_t* rx = &lwcell.m.http_rx;
+
+    len = LWCELL_MIN(len, rx->rem_len);
+    if (rx->buff == NULL && rx->recv_fn != NULL) {
+        size_t new_len = LWCELL_MIN(rx->rem_len, LWCELL_CFG_CONN_MAX_DATA_LEN);
+
+        do {
+            rx->buff = lwcell_pbuf_new(new_len);
+        } while (rx->buff == NULL && (new_len = (new_len >> 1)) >= LWCELL_CFG_CONN_MIN_DATA_LEN);
+        if (rx->buff == NULL) {
+            LWCELL_DEBUGF(LWCELL_CFG_DBG_IPD | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                          "[LWCELL HTTP] Buffer allocation failed, skipping %d byte(s)\r\n", (int)rx->rem_len);
+            rx->recv_fn = NULL; /* Data cannot be delivered in order anymore */
+            rx->failed = 1;
+        }
+        rx->buff_ptr = 0;
+    }
+    if (rx->buff != NULL) {
+        len = LWCELL_MIN(len, rx->buff->len - rx->buff_ptr);
+        LWCELL_MEMCPY(&rx->buff->payload[rx->buff_ptr], data, len);
+        rx->buff_ptr += len;
+    }
+    rx->rem_len -= len;
+
+    /* Deliver full buffer */
+    if (rx->buff != NULL && rx->buff_ptr == rx->buff->len) {
+        lwcellr_t res = rx->recv_fn != NULL ? rx->recv_fn(rx->buff, rx->offset, rx->arg) : lwcellERR;
+
+        rx->offset += LWCELL_U32(rx->buff->len);
+        lwcell_pbuf_free_s(&rx->buff);
+        if (res != lwcellOK) {
+            rx->recv_fn = NULL; /* Skip remaining data */
+        }
+    } else if (rx->buff == NULL) {
+        rx->offset += LWCELL_U32(len);
+    }
+    if (rx->rem_len == 0) {
+        rx->read = 0;
+    }
+    return len;
+}
+
+/**
+ * \brief           Write next segment of HTTP POST request body to device
+ *
+ * Body is requested from application one segment at a time, from processing thread
+ * and never from line parser. Next segment is scheduled as new timeout,
+ * so received data are processed between segments and memory is bounded by single segment.
+ * Device expects exact number of bytes announced with `AT+HTTPDATA`,
+ * when application fails to provide the body, remaining part is filled with zeros
+ * and request is not sent to server.
+ *
+ * \param[in]       arg: Message which announced the body
+ */
+static void
+http_post_body_timeout(void* arg) {
+    static const uint8_t pad[16] = {0};
+    lwcell_msg_t* msg = arg;
+    uint32_t sent, total;
+    uint8_t* buff;
+    size_t len;
+
+    if (lwcell.msg != msg || !CMD_IS_CUR(LWCELL_CMD_HTTPDATA)) {
+        return; /* Command finished meanwhile */
+    }
+    sent = msg->msg.http_req.body_sent;
+    total = msg->msg.http_req.body_len;
+    if (!msg->msg.http_req.body_failed && sent < total) {
+        len = LWCELL_MIN(LWCELL_CFG_HTTP_POST_SEGMENT_LEN, total - sent);
+        if ((buff = lwcell_mem_malloc(len)) != NULL
+            && msg->msg.http_req.body_fn(buff, len, sent, msg->msg.http_req.body_arg) == len) {
+            AT_PORT_SEND_WITH_FLUSH(buff, len);
+            sent += LWCELL_U32(len);
+            msg->msg.http_req.body_sent = sent;
+
+            lwcell.evt.evt.http_post_progress.sent = sent;
+            lwcell.evt.evt.http_post_progress.total = total;
+            lwcelli_send_cb(LWCELL_EVT_HTTP_POST_PROGRESS);
+        } else {
+            LWCELL_DEBUGW(LWCELL_CFG_DBG_IPD | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING, buff == NULL,
+                          "[LWCELL HTTP] Cannot allocate body segment\r\n");
+            msg->msg.http_req.body_failed = 1;
+        }
+        lwcell_mem_free_s((void**)&buff);
+    }
+    if (!msg->msg.http_req.body_failed && sent < total
+        && lwcell_timeout_add(0, http_post_body_timeout, msg) != lwcellOK) {
+        msg->msg.http_req.body_failed = 1;
+    }
+    if (msg->msg.http_req.body_failed) {
+        for (; sent < total; sent += LWCELL_U32(len)) {
+            len = LWCELL_MIN(sizeof(pad), total - sent);
+            AT_PORT_SEND(pad, len);
+        }
+        AT_PORT_SEND_FLUSH();
+        msg->msg.http_req.body_sent = total;
+    }
+}
+
+/**
+ * \brief           Start writing body of HTTP POST request after `DOWNLOAD` prompt
+ *
+ * Only schedules first segment, application is never called from line parser.
+ */
+static void
+http_post_send_body(void) {
+    lwcell_msg_t* msg = lwcell.msg;
+
+    msg->msg.http_req.body_sent = 0;
+    if (lwcell_timeout_add(0, http_post_body_timeout, msg) != lwcellOK) {
+        msg->msg.http_req.body_failed = 1;
+        http_post_body_timeout(msg); /* Pad the body, so device can finish the command */
+    }
+}
+
+/**
+ * \brief           Terminate HTTP service, when no request has been started within keep-alive time
+ * \param[in]       arg: Custom user argument
+ */
+static void
+http_session_idle_timeout(void* arg) {
+    LWCELL_UNUSED(arg);
+    if (lwcell.m.http_session.active) {
+        lwcell_http_session_close(NULL, NULL, 0);
+    }
+}
+
+/**
+ * \brief           Forget parameters of HTTP service, after it has been terminated or its state is not known
+ */
+static void
+http_session_reset(void) {
+    lwcell_timeout_remove(http_session_idle_timeout);
+    LWCELL_MEMSET(&lwcell.m.http_session, 0x00, sizeof(lwcell.m.http_session));
+}
+
+/**
+ * \brief           Check if parameter of HTTP service is already set to required value
+ * \param[in]       param: Value remembered by session, empty when not known
+ * \param[in]       val: Value required by request
+ * \return          `1` if value is set, `0` otherwise
+ */
+static uint8_t
+http_session_param_is_set(const char* param, const char* val) {
+    return param[0] != '\0' && !strcmp(param, val);
+}
+
+/**
+ * \brief           Remember parameter value set to HTTP service
+ * \param[out]      param: Value remembered by session
+ * \param[in]       val: Value set to device
+ */
+static void
+http_session_param_save(char* param, const char* val) {
+    size_t len = strlen(val);
+
+    if (len < LWCELL_CFG_HTTP_SESSION_PARAM_LEN) {
+        LWCELL_MEMCPY(param, val, len + 1);
+    } else {
+        param[0] = '\0'; /* Value is sent again with next request */
+    }
+}
+
+/**
+ * \brief           Get command of HTTP request following `cmd`
+ *
+ * Parameters already set to required value in kept service are skipped
+ *
+ * \param[in]       msg: HTTP request message
+ * \param[in]       cmd: Command which has finished
+ * \return          Next command to execute
+ */
+static lwcell_cmd_t
+http_req_next_cmd(lwcell_msg_t* msg, lwcell_cmd_t cmd) {
+    lwcell_http_session_t* s = &lwcell.m.http_session;
+
+    switch (cmd) {
+        case LWCELL_CMD_HTTPINIT:
+            if (!s->cid_set) {
+                return LWCELL_CMD_HTTPPARA_CID;
+            }
+            /* fall through */
+        case LWCELL_CMD_HTTPPARA_CID:
+            if (!http_session_param_is_set(s->url, msg->msg.http_req.url)) {
+                return LWCELL_CMD_HTTPPARA_URL;
+            }
+            /* fall through */
+        case LWCELL_CMD_HTTPPARA_URL:
+            if (CMD_IS_DEF(LWCELL_CMD_HTTP_POST)) {
+                if (msg->msg.http_req.content_type != NULL
+                    && !(s->content_set && http_session_param_is_set(s->content, msg->msg.http_req.content_type))) {
+                    return LWCELL_CMD_HTTPPARA_CONTENT;
+                }
+                return LWCELL_CMD_HTTPDATA;
+            }
+            if (!s->range_set || s->brk != msg->msg.http_req.offset) {
+                return LWCELL_CMD_HTTPPARA_BREAK;
+            }
+            /* fall through */
+        case LWCELL_CMD_HTTPPARA_BREAK:
+            if (!s->range_set || s->brk_end != msg->msg.http_req.offset + msg->msg.http_req.len - 1) {
+                return LWCELL_CMD_HTTPPARA_BREAKEND;
+            }
+            /* fall through */
+        case LWCELL_CMD_HTTPPARA_BREAKEND: return LWCELL_CMD_HTTPACTION_GET;
+        case LWCELL_CMD_HTTPPARA_CONTENT: return LWCELL_CMD_HTTPDATA;
+        default: return LWCELL_CMD_IDLE;
+    }
+}
+
+#endif /* LWCELL_CFG_HTTP || __DOXYGEN__ */
+
 /**
  * \brief           Reset everything after reset was detected
  * \param[in]       forced: Set to `1` if reset forced by user
@@ -466,6 +813,24 @@ void
 lwcelli_reset_everything(uint8_t forced) {
     LWCELL_UNUSED(forced);
 
+#if LWCELL_CFG_CMUX
+    /* Return device to AT command mode and release saved parser contexts */
+    lwcelli_cmux_close();
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(parser_ctx); ++i) {
+#if LWCELL_CFG_CONN
+        if (parser_ctx[i].ipd.buff != NULL) {
+            lwcell_pbuf_free_s(&parser_ctx[i].ipd.buff);
+        }
+#endif /* LWCELL_CFG_CONN */
+#if LWCELL_CFG_HTTP
+        if (parser_ctx[i].http_rx.buff != NULL) {
+            lwcell_pbuf_free_s(&parser_ctx[i].http_rx.buff);
+        }
+#endif /* LWCELL_CFG_HTTP */
+        LWCELL_MEMSET(&parser_ctx[i], 0x00, sizeof(parser_ctx[i]));
+    }
+#endif /* LWCELL_CFG_CMUX */
+
     /**
      * \todo: Put stack to default state:
      *          - Close all the connection in memory
@@ -483,6 +848,11 @@ lwcelli_reset_everything(uint8_t forced) {
     }
 #endif /* LWCELL_CFG_CONN */
 
+#if LWCELL_CFG_HTTP
+    http_rx_reset();
+    LWCELL_MEMSET(&lwcell.m.http_rx, 0x00, sizeof(lwcell.m.http_rx));
+#endif /* LWCELL_CFG_HTTP */
+
 #if LWCELL_CFG_NETWORK
     /* Notify app about detached network PDP context */
     if (lwcell.m.network.is_attached) {
@@ -491,6 +861,21 @@ lwcelli_reset_everything(uint8_t forced) {
     }
 #endif /* LWCELL_CFG_NETWORK */
 
+#if LWCELL_CFG_PPP
+    /* Notify IP stack about lost PPP link */
+    lwcelli_ppp_link_down();
+#endif /* LWCELL_CFG_PPP */
+
+#if LWCELL_CFG_MQTT
+    /* Notify MQTT client about lost session */
+    mqtt_session_close(1);
+#endif /* LWCELL_CFG_MQTT */
+
+#if LWCELL_CFG_HTTP
+    /* HTTP service is not initialized anymore */
+    http_session_reset();
+#endif /* LWCELL_CFG_HTTP */
+
     /* Invalid GSM modules */
     LWCELL_MEMSET(&lwcell.m, 0x00, sizeof(lwcell.m));
 
@@ -499,6 +884,25 @@ lwcelli_reset_everything(uint8_t forced) {
     lwcell.m.model = LWCELL_DEVICE_MODEL_UNKNOWN;
 }
 
+/**
+ * \brief           Call all callback functions subscribed to event type
+ * \param[in]       evt: Event to deliver
+ */
+void
+lwcelli_evt_call_subscribers(lwcell_evt_t* evt) {
+    /* Functions registered for all events */
+    for (lwcell_evt_func_t* link = lwcell.evt_func; link != NULL; link = link->next) {
+        link->fn(evt);
+    }
+
+    /* Functions registered only for this event type */
+    if ((size_t)evt->type < LWCELL_ARRAYSIZE(lwcell.evt_func_type)) {
+        for (lwcell_evt_func_t* link = lwcell.evt_func_type[evt->type]; link != NULL; link = link->next) {
+            link->fn(evt);
+        }
+    }
+}
+
 /**
  * \brief           Process callback function to user with specific type
  * \param[in]       type: Callback event type
@@ -507,11 +911,17 @@ lwcelli_reset_everything(uint8_t forced) {
 lwcellr_t
 lwcelli_send_cb(lwcell_evt_type_t type) {
     lwcell.evt.type = type; /* Set callback type to process */
+    LWCELL_TRACE(LWCELL_TRACE_ID_EVT, type, 0, 0);
 
-    /* Call callback function for all registered functions */
-    for (lwcell_evt_func_t* link = lwcell.evt_func; link != NULL; link = link->next) {
-        link->fn(&lwcell.evt);
+#if LWCELL_CFG_EVT_DISPATCH
+    /* Try to move event to dispatch thread first */
+    if (lwcelli_evt_dispatch_defer(NULL, NULL) == lwcellOK) {
+        return lwcellOK;
     }
+#endif /* LWCELL_CFG_EVT_DISPATCH */
+
+    /* Call callback function for all registered functions */
+    lwcelli_evt_call_subscribers(&lwcell.evt);
     return lwcellOK;
 }
 
@@ -534,6 +944,11 @@ lwcelli_send_conn_cb(lwcell_conn_t* conn, lwcell_evt_fn evt) {
     if (evt != NULL) {                                   /* Try with user connection */
         return evt(&lwcell.evt);                         /* Call temporary function */
     } else if (conn != NULL && conn->evt_func != NULL) { /* Connection custom callback? */
+#if LWCELL_CFG_EVT_DISPATCH
+        if (lwcelli_evt_dispatch_defer(conn, conn->evt_func) == lwcellOK) {
+            return lwcellOK;
+        }
+#endif                                                   /* LWCELL_CFG_EVT_DISPATCH */
         return conn->evt_func(&lwcell.evt);              /* Process callback function */
     } else if (conn == NULL) {
         return lwcellOK;
@@ -555,6 +970,175 @@ lwcelli_send_conn_cb(lwcell_conn_t* conn, lwcell_evt_fn evt) {
     return lwcell_conn_close(conn, 0);
 }
 
+#endif /* LWCELL_CFG_CONN || __DOXYGEN__ */
+
+#if LWCELL_CFG_EVT_DISPATCH || __DOXYGEN__
+
+/**
+ * \brief           Set default dispatch policies for all event types
+ */
+void
+lwcelli_evt_dispatch_init(void) {
+    for (size_t i = 0; i < LWCELL_ARRAYSIZE(lwcell.evt_dispatch.policy); ++i) {
+        lwcell.evt_dispatch.policy[i] = lwcelli_evt_dispatch_is_sync_only((lwcell_evt_type_t)i)
+                                            ? (uint8_t)LWCELL_EVT_DISPATCH_POLICY_SYNC
+                                            : (uint8_t)LWCELL_CFG_EVT_DISPATCH_POLICY_DEFAULT;
+    }
+#if LWCELL_CFG_CONN
+    /*
+     * Connection events are consumed by netconn and application modules,
+     * which expect to run in the stack context. Keep them synchronous
+     */
+    lwcell.evt_dispatch.policy[LWCELL_EVT_CONN_RECV] = LWCELL_EVT_DISPATCH_POLICY_SYNC;
+    lwcell.evt_dispatch.policy[LWCELL_EVT_CONN_SEND] = LWCELL_EVT_DISPATCH_POLICY_SYNC;
+    lwcell.evt_dispatch.policy[LWCELL_EVT_CONN_ACTIVE] = LWCELL_EVT_DISPATCH_POLICY_SYNC;
+    lwcell.evt_dispatch.policy[LWCELL_EVT_CONN_CLOSE] = LWCELL_EVT_DISPATCH_POLICY_SYNC;
+    lwcell.evt_dispatch.policy[LWCELL_EVT_CONN_POLL] = LWCELL_EVT_DISPATCH_POLICY_SYNC;
+#endif /* LWCELL_CFG_CONN */
+}
+
+/**
+ * \brief           Check if event must always be delivered synchronously.
+ *
+ * Such events carry pointers to API message data or to arrays provided by the caller,
+ * which are freed or out of scope once command finishes, or to device state
+ * overwritten by next response. Pointers are only valid during the callback
+ *
+ * \param[in]       type: Event type
+ * \return          `1` if event cannot be deferred, `0` otherwise
+ */
+uint8_t
+lwcelli_evt_dispatch_is_sync_only(lwcell_evt_type_t type) {
+    switch (type) {
+#if LWCELL_CFG_CONN
+        case LWCELL_EVT_CONN_ERROR: /* Host string from API message */
+#endif                              /* LWCELL_CFG_CONN */
+        case LWCELL_EVT_OPERATOR_SCAN:
+        case LWCELL_EVT_NETWORK_OPERATOR_CURRENT:
+#if LWCELL_CFG_SMS
+        case LWCELL_EVT_SMS_READ:
+        case LWCELL_EVT_SMS_LIST:
+#endif /* LWCELL_CFG_SMS */
+#if LWCELL_CFG_CALL
+        case LWCELL_EVT_CALL_CHANGED:
+#endif /* LWCELL_CFG_CALL */
+#if LWCELL_CFG_PHONEBOOK
+        case LWCELL_EVT_PB_LIST:
+        case LWCELL_EVT_PB_SEARCH:
+#endif /* LWCELL_CFG_PHONEBOOK */
+            return 1;
+        default: return 0;
+    }
+}
+
+/**
+ * \brief           Try to put current global event structure to dispatch queue
+ * \note            Function must be called with core locked
+ * \param[in]       conn: Connection handle for connection event, `NULL` for global event
+ * \param[in]       conn_fn: Connection callback function, used when `conn != NULL`
+ * \return          \ref lwcellOK if event was handled (queued or dropped),
+ *                  member of \ref lwcellr_t otherwise and event must be delivered synchronously
+ */
+lwcellr_t
+lwcelli_evt_dispatch_defer(lwcell_conn_t* conn, lwcell_evt_fn conn_fn) {
+    lwcell_evt_dispatch_t* d = &lwcell.evt_dispatch;
+    lwcell_evt_dispatch_entry_t* entry;
+    lwcell_evt_dispatch_policy_t policy;
+
+    if (!lwcell_sys_mbox_isvalid(&d->mbox) || (size_t)lwcell.evt.type >= LWCELL_ARRAYSIZE(d->policy)) {
+        return lwcellERR;
+    }
+    policy = (lwcell_evt_dispatch_policy_t)d->policy[lwcell.evt.type];
+    if (policy == LWCELL_EVT_DISPATCH_POLICY_SYNC) {
+        return lwcellERR;
+    }
+
+    /* Check for free entry */
+    if (d->stats.depth >= LWCELL_ARRAYSIZE(d->entries)) {
+        if (policy == LWCELL_EVT_DISPATCH_POLICY_DROP) {
+            ++d->stats.dropped;
+            LWCELL_DEBUGF(LWCELL_CFG_DBG_THREAD | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                          "[LWCELL EVT] Dispatch queue full, event %d dropped\r\n", (int)lwcell.evt.type);
+            return lwcellOK;
+        }
+        ++d->stats.sync_fallback;
+        return lwcellERRMEM;
+    }
+
+    /* Copy event to next entry */
+    entry = &d->entries[d->w];
+    LWCELL_MEMCPY(&entry->evt, &lwcell.evt, sizeof(entry->evt));
+#if LWCELL_CFG_CONN
+    entry->conn = conn;
+    entry->conn_fn = conn_fn;
+    entry->conn_val_id = conn != NULL ? conn->val_id : 0;
+
+    /* Packet buffer is freed by stack after the event, keep it alive until dispatched */
+    if (entry->evt.type == LWCELL_EVT_CONN_RECV && entry->evt.evt.conn_data_recv.buff != NULL) {
+        lwcell_pbuf_ref(entry->evt.evt.conn_data_recv.buff);
+    }
+#else  /* LWCELL_CFG_CONN */
+    LWCELL_UNUSED(conn);
+    LWCELL_UNUSED(conn_fn);
+#endif /* !LWCELL_CFG_CONN */
+
+    if (!lwcell_sys_mbox_putnow(&d->mbox, entry)) {
+#if LWCELL_CFG_CONN
+        if (entry->evt.type == LWCELL_EVT_CONN_RECV && entry->evt.evt.conn_data_recv.buff != NULL) {
+            lwcell_pbuf_free(entry->evt.evt.conn_data_recv.buff);
+        }
+#endif /* LWCELL_CFG_CONN */
+        ++d->stats.sync_fallback;
+        return lwcellERRMEM;
+    }
+    d->w = (d->w + 1) % LWCELL_ARRAYSIZE(d->entries);
+    ++d->stats.queued;
+    if (++d->stats.depth > d->stats.depth_max) {
+        d->stats.depth_max = d->stats.depth;
+    }
+    return lwcellOK;
+}
+
+/**
+ * \brief           Deliver deferred event to its callback functions
+ * \note            Function is called from dispatch thread, with core unlocked
+ * \param[in]       entry: Queue entry to process
+ */
+void
+lwcelli_evt_dispatch_process(lwcell_evt_dispatch_entry_t* entry) {
+#if LWCELL_CFG_CONN
+    if (entry->conn != NULL) {
+        uint8_t is_valid;
+
+        /* Connection may have been reused in the meantime */
+        lwcell_core_lock();
+        is_valid = entry->conn->val_id == entry->conn_val_id;
+        lwcell_core_unlock();
+        if (is_valid) {
+            entry->conn_fn(&entry->evt);
+        }
+        if (entry->evt.type == LWCELL_EVT_CONN_RECV && entry->evt.evt.conn_data_recv.buff != NULL) {
+            lwcell_pbuf_free(entry->evt.evt.conn_data_recv.buff);
+        }
+    } else
+#endif /* LWCELL_CFG_CONN */
+    {
+        lwcell_sys_mutex_lock(&lwcell.evt_dispatch.mutex);
+        lwcelli_evt_call_subscribers(&entry->evt);
+        lwcell_sys_mutex_unlock(&lwcell.evt_dispatch.mutex);
+    }
+
+    /* Release entry */
+    lwcell_core_lock();
+    --lwcell.evt_dispatch.stats.depth;
+    ++lwcell.evt_dispatch.stats.dispatched;
+    lwcell_core_unlock();
+}
+
+#endif /* LWCELL_CFG_EVT_DISPATCH || __DOXYGEN__ */
+
+#if LWCELL_CFG_CONN || __DOXYGEN__
+
 /**
  * \brief           Process and send data from device buffer
  * \return          Member of \ref lwcellr_t enumeration
@@ -570,6 +1154,8 @@ lwcelli_tcpip_process_send_data(void) {
         return lwcellERR;
     }
     lwcell.msg->msg.conn_send.sent = LWCELL_MIN(lwcell.msg->msg.conn_send.btw, LWCELL_CFG_CONN_MAX_DATA_LEN);
+    LWCELL_STATS_INC(send_segments);
+    LWCELL_TRACE(LWCELL_TRACE_ID_CONN_SEND, c->num, lwcell.msg->msg.conn_send.sent, lwcell.msg->msg.conn_send.tries);
 
     AT_PORT_SEND_BEGIN_AT();
     AT_PORT_SEND_CONST_STR("+CIPSEND=");
@@ -587,6 +1173,29 @@ lwcelli_tcpip_process_send_data(void) {
     return lwcellOK;
 }
 
+/**
+ * \brief           Write data of current packet to device after `> ` prompt
+ *
+ * Packet may contain end of first and beginning of second data part
+ */
+static void
+lwcelli_tcpip_send_packet_data(void) {
+    const lwcell_msg_t* msg = lwcell.msg;
+    size_t ptr = msg->msg.conn_send.ptr, len = msg->msg.conn_send.sent;
+
+    if (ptr < msg->msg.conn_send.data_len) {
+        size_t part = LWCELL_MIN(len, msg->msg.conn_send.data_len - ptr);
+
+        AT_PORT_SEND(&msg->msg.conn_send.data[ptr], part);
+        ptr += part;
+        len -= part;
+    }
+    if (len > 0) {
+        AT_PORT_SEND(&msg->msg.conn_send.data2[ptr - msg->msg.conn_send.data_len], len);
+    }
+    AT_PORT_SEND_FLUSH();
+}
+
 /**
  * \brief           Process data sent and send remaining
  * \param[in]       sent: Status whether data were sent or not,
@@ -595,6 +1204,8 @@ lwcelli_tcpip_process_send_data(void) {
  */
 static uint8_t
 lwcelli_tcpip_process_data_sent(uint8_t sent) {
+    LWCELL_TRACE(LWCELL_TRACE_ID_CONN_SEND_RESULT, lwcell.msg->msg.conn_send.conn->num, lwcell.msg->msg.conn_send.sent,
+                 sent);
     if (sent) { /* Data were successfully sent */
         lwcell.msg->msg.conn_send.sent_all += lwcell.msg->msg.conn_send.sent;
         lwcell.msg->msg.conn_send.btw -= lwcell.msg->msg.conn_send.sent;
@@ -602,13 +1213,17 @@ lwcelli_tcpip_process_data_sent(uint8_t sent) {
         if (lwcell.msg->msg.conn_send.bw != NULL) {
             *lwcell.msg->msg.conn_send.bw += lwcell.msg->msg.conn_send.sent;
         }
+        lwcell.msg->msg.conn_send.conn->total_sent += lwcell.msg->msg.conn_send.sent;
         lwcell.msg->msg.conn_send.tries = 0;
+        LWCELL_STATS_ADD(send_bytes, lwcell.msg->msg.conn_send.sent);
     } else {                                  /* We were not successful */
         ++lwcell.msg->msg.conn_send.tries;    /* Increase number of tries */
+        LWCELL_STATS_INC(send_fails);
         if (lwcell.msg->msg.conn_send.tries
             == LWCELL_CFG_MAX_SEND_RETRIES) { /* In case we reached max number of retransmissions */
             return 1;                         /* Return 1 and indicate error */
         }
+        LWCELL_STATS_INC(send_retries);
     }
     if (lwcell.msg->msg.conn_send.btw > 0) {                 /* Do we still have data to send? */
         if (lwcelli_tcpip_process_send_data() != lwcellOK) { /* Check if we can continue */
@@ -718,6 +1333,37 @@ lwcelli_conn_closed_process(uint8_t conn_num, uint8_t forced) {
 
 #endif /* LWCELL_CFG_CONN || __DOXYGEN__ */
 
+/**
+ * \brief           Process status of current command step and start next step or finish the command
+ * \param[in]       stat: Pointer to status variables
+ */
+static void
+process_cmd_result(lwcell_status_flags_t* stat) {
+    lwcellr_t res = lwcellOK;
+    if (lwcell.msg != NULL) {                /* Do we have active message? */
+        LWCELL_CMD_STATS_STEP_END(lwcell.msg, stat->is_ok);
+        res = lwcelli_process_sub_cmd(lwcell.msg, stat);
+        if (res != lwcellCONT) {             /* Shall we continue with next subcommand under this one? */
+            if (stat->is_ok) {               /* Check OK status */
+                res = lwcell.msg->res = lwcellOK;
+            } else {                         /* Or error status */
+                res = lwcell.msg->res = res; /* Set the error status */
+            }
+        } else {
+            ++lwcell.msg->i; /* Number of continue calls */
+        }
+
+        /*
+         * When the command is finished,
+         * release synchronization semaphore
+         * from user thread and start with next command
+         */
+        if (res != lwcellCONT) {                      /* Do we have to continue to wait for command? */
+            lwcell_sys_sem_release(&lwcell.sem_sync); /* Release semaphore */
+        }
+    }
+}
+
 /**
  * \brief           Process received string from GSM
  * \param[in]       rcv: Pointer to \ref lwcell_recv_t structure with input string
@@ -730,6 +1376,10 @@ lwcelli_parse_received(lwcell_recv_t* rcv) {
     if (rcv->len == 2 && rcv->data[0] == '\r' && rcv->data[1] == '\n') {
         return;
     }
+    LWCELL_TRACE(LWCELL_TRACE_ID_LINE, rcv->len,
+                 LWCELL_U32((uint8_t)rcv->data[0]) | (LWCELL_U32((uint8_t)rcv->data[1]) << 8)
+                     | (LWCELL_U32((uint8_t)rcv->data[2]) << 16) | (LWCELL_U32((uint8_t)rcv->data[3]) << 24),
+                 CMD_GET_CUR());
 
     /* Check OK response */
     stat.is_ok = rcv->len == (2 + CRLF_LEN) && !strcmp(rcv->data, "OK" CRLF); /* Check if received string is OK */
@@ -749,6 +1399,16 @@ lwcelli_parse_received(lwcell_recv_t* rcv) {
             }
         }
     }
+    LWCELL_STATS_INC(lines);
+    if (stat.is_ok) {
+        LWCELL_STATS_INC(lines_ok);
+    } else if (stat.is_error) {
+        LWCELL_STATS_INC(lines_error);
+    } else if (rcv->data[0] == '+') {
+        LWCELL_STATS_INC(lines_urc);
+    } else {
+        LWCELL_STATS_INC(lines_other);
+    }
 #if LWCELL_CFG_PROTOCOL
 #if LWCELL_CFG_HTTP
     if (CMD_IS_CUR(LWCELL_CMD_HTTPACTION_GET) ||
@@ -758,7 +1418,7 @@ lwcelli_parse_received(lwcell_recv_t* rcv) {
             stat.is_ok = 0;
             return;
         }
-        if(stat.is_error){
+        if(stat.is_error && CMD_IS_DEF(LWCELL_CMD_HTTPINIT)){
             lwcell.msg->msg.conn_start.conn_res = LWCELL_CONN_CONNECT_ERROR;
             return;
         }
@@ -779,6 +1439,14 @@ lwcelli_parse_received(lwcell_recv_t* rcv) {
             lwcelli_parse_ipd(rcv->data);                                              /* Parse IPD */
 #if LWCELL_CFG_PROTOCOL
 #if LWCELL_CFG_HTTP
+        } else if (HTTP_REQ_IS_DEF() && !strncmp(rcv->data, "+HTTPREAD", 9)) {
+            if (CMD_IS_CUR(LWCELL_CMD_HTTPREAD)) {
+                lwcelli_parse_httpread_range(rcv->data);
+            }
+        } else if (HTTP_REQ_IS_DEF() && !strncmp(rcv->data, "+HTTPACTION", 11)) {
+            if (CMD_IS_CUR(LWCELL_CMD_HTTPACTION_GET) || CMD_IS_CUR(LWCELL_CMD_HTTPACTION_POST)) {
+                stat.is_ok = lwcelli_parse_httpaction_range(rcv->data); /* Request has finished */
+            }
         } else if (!strncmp(rcv->data, "+HTTPREAD", 9)) {
             lwcell_parse_httpread(rcv->data);
         } else if (!strncmp(rcv->data, "+HTTPACTION", 11)) {
@@ -796,10 +1464,6 @@ lwcelli_parse_received(lwcell_recv_t* rcv) {
                 stat.is_error = 1;
             }
 #endif
-#if LWCELL_CFG_MQTT
-        } else if (!strncmp(rcv->data, "+MSUB", 9)) {
-            /// TODO: Parse +MSUB.
-#endif
 #endif
 #endif                                                                                 /* LWCELL_CFG_CONN */
         } else if (!strncmp(rcv->data, "+CREG", 5)) {                                  /* Check for +CREG indication */
@@ -896,6 +1560,15 @@ lwcelli_parse_received(lwcell_recv_t* rcv) {
             }
             lwcelli_conn_closed_process(num, forced); /* Connection closed, process */
 #endif                                                /* LWCELL_CFG_CONN */
+#if LWCELL_CFG_HTTP
+        } else if (rcv->data[0] == 'D' && CMD_IS_CUR(LWCELL_CMD_HTTPDATA) && CMD_IS_DEF(LWCELL_CMD_HTTP_POST)
+                   && !strncmp(rcv->data, "DOWNLOAD" CRLF, 8 + CRLF_LEN)) {
+            http_post_send_body(); /* Device waits for body, "OK" follows when all bytes are received */
+#endif                             /* LWCELL_CFG_HTTP */
+#if LWCELL_CFG_MQTT
+        } else if (rcv->data[0] == 'C' && lwcell.m.mqtt.active && !strcmp(rcv->data, "CLOSED" CRLF)) {
+            mqtt_session_close(1); /* Connection to broker lost */
+#endif                             /* LWCELL_CFG_MQTT */
 #if LWCELL_CFG_CALL
         } else if (rcv->data[0] == 'C' && !strncmp(rcv->data, "Call Ready" CRLF, 10 + CRLF_LEN)) {
             lwcell.m.call.ready = 1;
@@ -1004,6 +1677,75 @@ lwcelli_parse_received(lwcell_recv_t* rcv) {
             } else if (CMD_IS_CUR(LWCELL_CMD_CMGS) && stat.is_ok) {
                 /* At this point we have to wait for "> " to send data */
 #endif /* LWCELL_CFG_SMS */
+#if LWCELL_CFG_TRANSPARENT
+        } else if (CMD_IS_DEF(LWCELL_CMD_TRANSPARENT_START) && CMD_IS_CUR(LWCELL_CMD_CIPSTART)) {
+            /* OK is returned before connection status */
+            if (stat.is_ok) {
+                stat.is_ok = 0;
+            }
+            if (!strcmp(rcv->data, "CONNECT" CRLF)) {
+                /* Device is in data mode from now on */
+                lwcell.m.transparent.recv_fn = lwcell.msg->msg.transparent_start.recv_fn;
+                lwcell.m.transparent.arg = lwcell.msg->msg.transparent_start.arg;
+                lwcell.m.transparent.closed_match = 0;
+                lwcell.m.transparent.data_mode = 1;
+                lwcell.msg->msg.transparent_start.conn_res = LWCELL_CONN_CONNECT_OK;
+                stat.is_ok = 1;
+            } else if (!strncmp(rcv->data, "CONNECT FAIL", 12) || !strncmp(rcv->data, "ALREADY CONNECT", 15)) {
+                lwcell.msg->msg.transparent_start.conn_res = LWCELL_CONN_CONNECT_ERROR;
+                stat.is_error = 1;
+            }
+        } else if (CMD_IS_DEF(LWCELL_CMD_TRANSPARENT_STOP) && CMD_IS_CUR(LWCELL_CMD_CIPCLOSE)) {
+            if (!strcmp(rcv->data, "CLOSE OK" CRLF)) {
+                stat.is_ok = 1;
+            }
+#endif /* LWCELL_CFG_TRANSPARENT */
+#if LWCELL_CFG_PPP
+        } else if (CMD_IS_CUR(LWCELL_CMD_PPP_DIAL)) {
+            if (!strncmp(rcv->data, "CONNECT", 7)) {
+                /* Device is in PPP data mode from now on, on channel where dial command was sent */
+#if LWCELL_CFG_CMUX
+                lwcelli_ppp_link_up(lwcell.cmux.active && parser_ctx_dlci == LWCELL_CMUX_DLCI_DATA ? parser_ctx_dlci
+                                                                                                  : 0);
+#else  /* LWCELL_CFG_CMUX */
+                lwcelli_ppp_link_up(0);
+#endif /* !LWCELL_CFG_CMUX */
+                stat.is_ok = 1;
+            } else if (!strncmp(rcv->data, "NO CARRIER", 10) || !strncmp(rcv->data, "NO DIALTONE", 11)
+                       || !strncmp(rcv->data, "BUSY", 4)) {
+                stat.is_error = 1;
+            }
+#endif /* LWCELL_CFG_PPP */
+#if LWCELL_CFG_MQTT
+        } else if (CMD_IS_CUR(LWCELL_CMD_MIPSTART)) {
+            /* OK is returned before connection status */
+            if (stat.is_ok) {
+                stat.is_ok = 0;
+            }
+            if (!strcmp(rcv->data, "CONNECT OK" CRLF) || !strcmp(rcv->data, "ALREADY CONNECT" CRLF)) {
+                stat.is_ok = 1;
+            } else if (!strncmp(rcv->data, "CONNECT FAIL", 12)) {
+                stat.is_error = 1;
+            }
+        } else if (CMD_IS_CUR(LWCELL_CMD_MCONNECT)) {
+            /* OK is returned before broker response */
+            if (stat.is_ok) {
+                stat.is_ok = 0;
+            }
+            if (!strcmp(rcv->data, "CONNACK OK" CRLF)) {
+                stat.is_ok = 1;
+            } else if (!strncmp(rcv->data, "CONNACK", 7)) {
+                stat.is_error = 1;
+            }
+        } else if (CMD_IS_CUR(LWCELL_CMD_MSUB) || CMD_IS_CUR(LWCELL_CMD_MUNSUB)) {
+            /* OK is returned before broker acknowledge */
+            if (stat.is_ok) {
+                stat.is_ok = 0;
+            }
+            if (!strcmp(rcv->data, CMD_IS_CUR(LWCELL_CMD_MSUB) ? "SUBACK" CRLF : "UNSUBACK" CRLF)) {
+                stat.is_ok = 1;
+            }
+#endif /* LWCELL_CFG_MQTT */
 #if LWCELL_CFG_CONN
         } else if (CMD_IS_CUR(LWCELL_CMD_CIPSTATUS)) {
             /* For CIPSTATUS, OK is returned before important data */
@@ -1094,31 +1836,73 @@ lwcelli_parse_received(lwcell_recv_t* rcv) {
      * and proceed with next command
      */
     if (stat.is_ok || stat.is_error) {
-        lwcellr_t res = lwcellOK;
-        if (lwcell.msg != NULL) {                /* Do we have active message? */
-            res = lwcelli_process_sub_cmd(lwcell.msg, &stat);
-            if (res != lwcellCONT) {             /* Shall we continue with next subcommand under this one? */
-                if (stat.is_ok) {                /* Check OK status */
-                    res = lwcell.msg->res = lwcellOK;
-                } else {                         /* Or error status */
-                    res = lwcell.msg->res = res; /* Set the error status */
-                }
-            } else {
-                ++lwcell.msg->i; /* Number of continue calls */
-            }
+        process_cmd_result(&stat);
+    }
+}
 
-            /*
-             * When the command is finished,
-             * release synchronization semaphore
-             * from user thread and start with next command
-             */
-            if (res != lwcellCONT) {                      /* Do we have to continue to wait for command? */
-                lwcell_sys_sem_release(&lwcell.sem_sync); /* Release semaphore */
-            }
-        }
+#if LWCELL_CFG_CMUX || __DOXYGEN__
+
+/**
+ * \brief           Finish current command step with status, received outside of AT response line,
+ *                  such as multiplexer frame
+ * \param[in]       is_ok: Set to `1` on success, `0` on error
+ */
+void
+lwcelli_process_cmd_result(uint8_t is_ok) {
+    lwcell_status_flags_t stat;
+
+    stat.is_ok = is_ok;
+    stat.is_error = !is_ok;
+    process_cmd_result(&stat);
+}
+
+/**
+ * \brief           Process data received on multiplexer channel.
+ *                  Parser context of previous channel is saved and context of new channel restored first
+ * \param[in]       dlci: Channel DLCI, \ref LWCELL_CMUX_DLCI_AT or \ref LWCELL_CMUX_DLCI_DATA
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data
+ */
+void
+lwcelli_process_dlc(uint8_t dlci, const void* data, size_t len) {
+    if (dlci != parser_ctx_dlci) {
+        lwcell_parser_ctx_t* ctx = &parser_ctx[parser_ctx_dlci - 1];
+
+        ctx->recv_buff = recv_buff;
+        ctx->ch_prev1 = ch_prev1;
+        ctx->ch_prev2 = ch_prev2;
+        ctx->unicode = unicode;
+#if LWCELL_CFG_CONN
+        ctx->ipd = lwcell.m.ipd;
+#endif /* LWCELL_CFG_CONN */
+#if LWCELL_CFG_MQTT
+        ctx->mqtt_rx = lwcell.m.mqtt.rx;
+#endif /* LWCELL_CFG_MQTT */
+#if LWCELL_CFG_HTTP
+        ctx->http_rx = lwcell.m.http_rx;
+#endif /* LWCELL_CFG_HTTP */
+
+        ctx = &parser_ctx[dlci - 1];
+        recv_buff = ctx->recv_buff;
+        ch_prev1 = ctx->ch_prev1;
+        ch_prev2 = ctx->ch_prev2;
+        unicode = ctx->unicode;
+#if LWCELL_CFG_CONN
+        lwcell.m.ipd = ctx->ipd;
+#endif /* LWCELL_CFG_CONN */
+#if LWCELL_CFG_MQTT
+        lwcell.m.mqtt.rx = ctx->mqtt_rx;
+#endif /* LWCELL_CFG_MQTT */
+#if LWCELL_CFG_HTTP
+        lwcell.m.http_rx = ctx->http_rx;
+#endif /* LWCELL_CFG_HTTP */
+        parser_ctx_dlci = dlci;
     }
+    lwcelli_process(data, len);
 }
 
+#endif /* LWCELL_CFG_CMUX || __DOXYGEN__ */
+
 #if !LWCELL_CFG_INPUT_USE_PROCESS || __DOXYGEN__
 /**
  * \brief           Process data from input buffer
@@ -1143,7 +1927,14 @@ lwcelli_process_buffer(void) {
             data = lwcell_buff_get_linear_block_read_address(&lwcell.buff);
 
             /* Process actual received data */
-            lwcelli_process(data, len);
+#if LWCELL_CFG_CMUX
+            if (lwcell.cmux.active) {
+                lwcelli_cmux_input(data, len);
+            } else
+#endif /* LWCELL_CFG_CMUX */
+            {
+                lwcelli_process(data, len);
+            }
 
             /*
              * Once data is processed, simply skip
@@ -1167,13 +1958,15 @@ lwcelli_process(const void* data, size_t data_len) {
     uint8_t ch;
     const uint8_t* d = data;
     size_t d_len = data_len;
-    static uint8_t ch_prev1, ch_prev2;
-    static lwcell_unicode_t unicode;
 
     /* Check status if device is available */
     if (!lwcell.status.f.dev_present) {
         return lwcellERRNODEVICE;
     }
+    if (d_len > 0 && lwcell.msg != NULL) {
+        LWCELL_CMD_STATS_STEP_RESP(lwcell.msg);
+    }
+    LWCELL_TRACE(LWCELL_TRACE_ID_INPUT, d_len, 0, 0);
 
     while (d_len > 0) { /* Read entire set of characters from buffer */
         ch = *d;        /* Get next character */
@@ -1181,6 +1974,34 @@ lwcelli_process(const void* data, size_t data_len) {
         --d_len;        /* Decrease remaining length, must be here as it is decreased later too */
 
         if (0) {
+#if LWCELL_CFG_TRANSPARENT
+        } else if (lwcell.m.transparent.data_mode) { /* Raw connection data in transparent mode */
+            size_t len = lwcelli_transparent_input(d - 1, d_len + 1);
+
+            d += len - 1;
+            d_len -= len - 1;
+#endif /* LWCELL_CFG_TRANSPARENT */
+#if LWCELL_CFG_PPP
+        } else if (lwcell.m.ppp.data_mode && PPP_IS_DATA_CHANNEL()) { /* PPP data for IP stack */
+            size_t len = lwcelli_ppp_input(d - 1, d_len + 1);
+
+            d += len - 1;
+            d_len -= len - 1;
+#endif /* LWCELL_CFG_PPP */
+#if LWCELL_CFG_MQTT
+        } else if (lwcell.m.mqtt.rx.read) { /* Payload of received MQTT message */
+            size_t len = mqtt_session_input(d - 1, d_len + 1);
+
+            d += len - 1;
+            d_len -= len - 1;
+#endif /* LWCELL_CFG_MQTT */
+#if LWCELL_CFG_HTTP
+        } else if (lwcell.m.http_rx.read) { /* Body of HTTP range */
+            size_t len = http_rx_input(d - 1, d_len + 1);
+
+            d += len - 1;
+            d_len -= len - 1;
+#endif /* LWCELL_CFG_HTTP */
 #if LWCELL_CFG_CONN
         } else if (lwcell.m.ipd.read) { /* Read connection data */
             size_t len;
@@ -1197,6 +2018,11 @@ lwcelli_process(const void* data, size_t data_len) {
                                                                                                : lwcell.m.ipd.rem_len));
             LWCELL_DEBUGF(LWCELL_CFG_DBG_IPD | LWCELL_DBG_TYPE_TRACE, "[LWCELL IPD] New length to read: %d bytes\r\n",
                           (int)len);
+            LWCELL_TRACE(LWCELL_TRACE_ID_IPD_READ, lwcell.m.ipd.conn->num, len + 1, lwcell.m.ipd.buff == NULL);
+            LWCELL_STATS_ADD(ipd_bytes, len + 1);
+            if (lwcell.m.ipd.buff == NULL) {
+                LWCELL_STATS_ADD(ipd_dropped, len + 1);
+            }
             if (len > 0) {
                 if (lwcell.m.ipd.buff != NULL) { /* Is buffer valid? */
                     LWCELL_MEMCPY(&lwcell.m.ipd.buff->payload[lwcell.m.ipd.buff_ptr], d, len);
@@ -1232,6 +2058,7 @@ lwcelli_process(const void* data, size_t data_len) {
                     lwcell.evt.evt.conn_data_recv.buff = lwcell.m.ipd.buff;
                     lwcell.evt.evt.conn_data_recv.conn = lwcell.m.ipd.conn;
                     res = lwcelli_send_conn_cb(lwcell.m.ipd.conn, NULL);
+                    LWCELL_TRACE(LWCELL_TRACE_ID_IPD_DELIVER, lwcell.m.ipd.conn->num, lwcell.m.ipd.buff->tot_len, res);
 
                     lwcell_pbuf_free(lwcell.m.ipd.buff); /* Free packet buffer at this point */
                     LWCELL_DEBUGF(LWCELL_CFG_DBG_IPD | LWCELL_DBG_TYPE_TRACE, "[LWCELL IPD] Free packet buffer\r\n");
@@ -1262,6 +2089,9 @@ lwcelli_process(const void* data, size_t data_len) {
                         LWCELL_DEBUGW(LWCELL_CFG_DBG_IPD | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
                                       lwcell.m.ipd.buff == NULL,
                                       "[LWCELL IPD] Buffer allocation failed for %d bytes\r\n", (int)new_len);
+                        if (lwcell.m.ipd.buff == NULL) {
+                            LWCELL_TRACE(LWCELL_TRACE_ID_IPD_ALLOC_FAIL, lwcell.m.ipd.conn->num, new_len, 0);
+                        }
                     } else {
                         lwcell.m.ipd.buff = NULL; /* Reset it */
                     }
@@ -1382,12 +2212,17 @@ lwcelli_process(const void* data, size_t data_len) {
                             LWCELL_DEBUGW(LWCELL_CFG_DBG_IPD | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
                                           lwcell.m.ipd.buff == NULL,
                                           "[LWCELL IPD] Buffer allocation failed for %d byte(s)\r\n", (int)len);
+                            if (lwcell.m.ipd.buff == NULL) {
+                                LWCELL_TRACE(LWCELL_TRACE_ID_IPD_ALLOC_FAIL, lwcell.m.ipd.conn->num, len, 0);
+                            }
                         } else {
                             lwcell.m.ipd.buff = NULL; /* Ignore reading on closed connection */
                             LWCELL_DEBUGF(LWCELL_CFG_DBG_IPD | LWCELL_DBG_TYPE_TRACE,
                                           "[LWCELL IPD] Connection %d closed or in closing, skipping %d byte(s)\r\n",
                                           (int)lwcell.m.ipd.conn->num, (int)len);
                         }
+                        LWCELL_TRACE(LWCELL_TRACE_ID_IPD_START, lwcell.m.ipd.conn->num, lwcell.m.ipd.tot_len,
+                                     lwcell.m.ipd.buff != NULL ? lwcell.m.ipd.buff->len : 0);
                         lwcell.m.ipd.conn->status.f.data_received = 1; /* We have first received data */
                         lwcell.m.ipd.buff_ptr = 0;                     /* Reset buffer write pointer */
                     }
@@ -1398,6 +2233,18 @@ lwcelli_process(const void* data, size_t data_len) {
                      *
                      * Check if any command active which may expect that kind of response
                      */
+#if LWCELL_CFG_MQTT
+                    /* Payload of received MQTT message follows header on the same line */
+                    if (ch == ',' && RECV_LEN() > 12 && !strncmp(recv_buff.data, "+MSUB:", 6)
+                        && !strcmp(&recv_buff.data[RECV_LEN() - 6], " byte,") && lwcelli_parse_msub(recv_buff.data)) {
+                        RECV_RESET();
+                        if (lwcell.m.mqtt.rx.rem_len > 0) {
+                            lwcell.m.mqtt.rx.read = 1; /* Start reading payload */
+                        } else {
+                            mqtt_session_input(NULL, 0);
+                        }
+                    }
+#endif /* LWCELL_CFG_MQTT */
                     if (ch_prev2 == '\n' && ch_prev1 == '>' && ch == ' ') {
                         if (0) {
 #if LWCELL_CFG_CONN
@@ -1405,8 +2252,7 @@ lwcelli_process(const void* data, size_t data_len) {
                             RECV_RESET(); /* Reset received object */
 
                             /* Now actually send the data prepared before */
-                            AT_PORT_SEND_WITH_FLUSH(&lwcell.msg->msg.conn_send.data[lwcell.msg->msg.conn_send.ptr],
-                                                    lwcell.msg->msg.conn_send.sent);
+                            lwcelli_tcpip_send_packet_data();
                             lwcell.msg->msg.conn_send.wait_send_ok_err =
                                 1;                                /* Now we are waiting for "SEND OK" or "SEND ERROR" */
 #endif                                                            /* LWCELL_CFG_CONN */
@@ -1416,6 +2262,11 @@ lwcelli_process(const void* data, size_t data_len) {
                             AT_PORT_SEND_CTRL_Z();
                             AT_PORT_SEND_FLUSH();
 #endif /* LWCELL_CFG_SMS */
+#if LWCELL_CFG_MQTT
+                        } else if (CMD_IS_CUR(LWCELL_CMD_MPUB)) { /* Publish message payload */
+                            RECV_RESET();
+                            AT_PORT_SEND_WITH_FLUSH(lwcell.msg->msg.mqtt_topic.data, lwcell.msg->msg.mqtt_topic.len);
+#endif /* LWCELL_CFG_MQTT */
                         }
                     } else if (CMD_IS_CUR(LWCELL_CMD_COPS_GET_OPT)) {
                         if (RECV_LEN() > 5 && !strncmp(recv_buff.data, "+COPS:", 6)) {
@@ -1446,12 +2297,100 @@ lwcelli_process(const void* data, size_t data_len) {
             }
         }
 
-        ch_prev2 = ch_prev1; /* Save previous character as previous previous */
-        ch_prev1 = ch;       /* Set current as previous */
+        ch_prev2 = ch_prev1; /* Save previous character as previous previous */
+        ch_prev1 = ch;       /* Set current as previous */
+    }
+    return lwcellOK;
+}
+
+#if LWCELL_CFG_AT_PORT_AUTOBAUD || __DOXYGEN__
+
+/**
+ * \brief           Set new AT port baudrate through low-level reconfigure callback
+ * \param[in]       baudrate: New baudrate
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+at_port_set_baudrate(uint32_t baudrate) {
+    if (lwcell.ll.uart.baudrate == baudrate) {
+        return 1;
+    }
+    if (lwcell.ll.reconfigure_fn == NULL || !lwcell.ll.reconfigure_fn(baudrate)) {
+        return 0;
+    }
+    LWCELL_DEBUGF(LWCELL_CFG_DBG_INIT | LWCELL_DBG_TYPE_TRACE, "[LWCELL AT] AT port baudrate changed to %d\r\n",
+                  (int)baudrate);
+    lwcell.ll.uart.baudrate = baudrate;
+    RECV_RESET(); /* Data received on old baudrate are not valid anymore */
+    return 1;
+}
+
+/**
+ * \brief           Get baudrate to probe, skipping duplicates in probe sequence
+ * \param[in]       msg: Reset message
+ * \return          Baudrate to probe, or `0` when sequence has been finished
+ */
+static uint32_t
+at_port_get_probe_baudrate(lwcell_msg_t* msg) {
+    const uint32_t rates[] = {msg->msg.reset.baudrate_prev, LWCELL_CFG_AT_PORT_BAUDRATE_MAX,
+                              LWCELL_CFG_AT_PORT_BAUDRATE};
+
+    for (; msg->msg.reset.probe_idx < LWCELL_ARRAYSIZE(rates); ++msg->msg.reset.probe_idx) {
+        uint8_t dup = 0;
+
+        for (size_t i = 0; i < msg->msg.reset.probe_idx; ++i) {
+            dup |= rates[i] == rates[msg->msg.reset.probe_idx];
+        }
+        if (!dup) {
+            return rates[msg->msg.reset.probe_idx];
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Timeout callback for `AT` probe and verify commands.
+ *                  Device did not respond on current baudrate
+ * \param[in]       arg: Reset message that started the timeout
+ */
+static void
+at_port_probe_timeout(void* arg) {
+    lwcell_msg_t* msg = arg;
+    uint32_t baudrate;
+
+    if (lwcell.msg != msg) {
+        return;
     }
-    return lwcellOK;
+    if (CMD_IS_CUR(LWCELL_CMD_AT_PORT_PROBE)) {
+        /* Try next baudrate, continue with default baudrate when none responds */
+        ++msg->msg.reset.probe_idx;
+        if ((baudrate = at_port_get_probe_baudrate(msg)) == 0) {
+            LWCELL_DEBUGF(LWCELL_CFG_DBG_INIT | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                          "[LWCELL AT] Device does not respond to AT probe\r\n");
+            baudrate = LWCELL_CFG_AT_PORT_BAUDRATE;
+            msg->cmd = LWCELL_CMD_RESET;
+        }
+        at_port_set_baudrate(baudrate);
+    } else if (CMD_IS_CUR(LWCELL_CMD_AT_PORT_VERIFY)) {
+        /*
+         * Device accepted new baudrate, but does not respond on it.
+         * Its actual baudrate is not known, probe all of them again
+         * and do not try to change it anymore
+         */
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_INIT | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                      "[LWCELL AT] No response on new baudrate, probing device baudrate\r\n");
+        msg->msg.reset.ipr_failed = 1;
+        msg->msg.reset.probe_idx = 0;
+        at_port_set_baudrate(msg->msg.reset.baudrate_prev);
+        msg->cmd = LWCELL_CMD_AT_PORT_PROBE;
+    } else {
+        return;
+    }
+    msg->fn(msg);
 }
 
+#endif /* LWCELL_CFG_AT_PORT_AUTOBAUD || __DOXYGEN__ */
+
 /* Temporary macros, only available for inside lwcelli_process_sub_cmd function */
 /* Set new command, but first check for error on previous */
 #define SET_NEW_CMD_CHECK_ERROR(new_cmd)                                                                               \
@@ -1479,7 +2418,19 @@ static lwcellr_t
 lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
     lwcell_cmd_t n_cmd = LWCELL_CMD_IDLE;
     if (CMD_IS_DEF(LWCELL_CMD_RESET)) {
-        switch (CMD_GET_CUR()) {                                                     /* Check current command */
+        switch (CMD_GET_CUR()) { /* Check current command */
+#if LWCELL_CFG_AT_PORT_AUTOBAUD
+            case LWCELL_CMD_AT_PORT_PROBE: {
+                lwcell_timeout_remove(at_port_probe_timeout);
+                if (msg->msg.reset.ipr_failed) {
+                    /* Device has been reset already, reset would restore its saved baudrate */
+                    SET_NEW_CMD(LWCELL_CMD_CPIN_GET);
+                } else {
+                    SET_NEW_CMD(LWCELL_CMD_RESET); /* Device responds, now reset it */
+                }
+                break;
+            }
+#endif /* LWCELL_CFG_AT_PORT_AUTOBAUD */
             case LWCELL_CMD_RESET: {
                 lwcelli_reset_everything(1);                                         /* Reset everything */
                 SET_NEW_CMD(LWCELL_CFG_AT_ECHO ? LWCELL_CMD_ATE1 : LWCELL_CMD_ATE0); /* Set ECHO mode */
@@ -1487,7 +2438,36 @@ lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
                 break;
             }
             case LWCELL_CMD_ATE0:
-            case LWCELL_CMD_ATE1: SET_NEW_CMD(LWCELL_CMD_CPIN_GET); break; /* Get SIM state */
+            case LWCELL_CMD_ATE1: {
+#if LWCELL_CFG_AT_PORT_AUTOBAUD
+                if (lwcell.ll.reconfigure_fn != NULL && lwcell.ll.uart.baudrate != LWCELL_CFG_AT_PORT_BAUDRATE_MAX
+                    && !msg->msg.reset.ipr_failed) {
+                    SET_NEW_CMD(LWCELL_CMD_IPR); /* Switch to maximal baudrate */
+                    break;
+                }
+#endif /* LWCELL_CFG_AT_PORT_AUTOBAUD */
+                SET_NEW_CMD(LWCELL_CMD_CPIN_GET); /* Get SIM state */
+                break;
+            }
+#if LWCELL_CFG_AT_PORT_AUTOBAUD
+            case LWCELL_CMD_IPR: {
+                if (stat->is_ok) {
+                    msg->msg.reset.baudrate_prev = lwcell.ll.uart.baudrate;
+                    lwcell_delay(10); /* Give device time to apply new baudrate */
+                    at_port_set_baudrate(LWCELL_CFG_AT_PORT_BAUDRATE_MAX);
+                    SET_NEW_CMD(LWCELL_CMD_AT_PORT_VERIFY);
+                } else {
+                    SET_NEW_CMD(LWCELL_CMD_CPIN_GET); /* Baudrate not supported, stay on current one */
+                }
+                break;
+            }
+            case LWCELL_CMD_AT_PORT_VERIFY: {
+                lwcell_timeout_remove(at_port_probe_timeout);
+                SET_NEW_CMD(LWCELL_CMD_AT_W); /* Save baudrate for next boot */
+                break;
+            }
+            case LWCELL_CMD_AT_W: SET_NEW_CMD(LWCELL_CMD_CPIN_GET); break;
+#endif /* LWCELL_CFG_AT_PORT_AUTOBAUD */
             case LWCELL_CMD_CPIN_GET: SET_NEW_CMD(LWCELL_CMD_CFUN_SET); break; /* Set full functionality */
             case LWCELL_CMD_CFUN_SET: SET_NEW_CMD(LWCELL_CMD_CMEE_SET); break; /* Set detailed error reporting */
             case LWCELL_CMD_CMEE_SET: SET_NEW_CMD(LWCELL_CMD_CGMI_GET); break; /* Get manufacturer */
@@ -1511,10 +2491,41 @@ lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
             {
                 if(lwcell.m.model != LWCELL_DEVICE_MODEL_AIR724x) SET_NEW_CMD(LWCELL_CMD_CLCC_SET); break;
             } /* Set call state */
+#if LWCELL_CFG_CMUX
+            case LWCELL_CMD_CMUX_SET: {
+                if (stat->is_ok) {
+                    lwcelli_cmux_start();
+                    msg->msg.reset.cmux_dlci = LWCELL_CMUX_DLCI_CTRL;
+                    SET_NEW_CMD(LWCELL_CMD_CMUX_SABM); /* Open control channel first */
+                }
+                break;
+            }
+            case LWCELL_CMD_CMUX_SABM: {
+                if (stat->is_ok && msg->msg.reset.cmux_dlci < LWCELL_CMUX_DLCI_DATA) {
+                    ++msg->msg.reset.cmux_dlci;
+                    SET_NEW_CMD(LWCELL_CMD_CMUX_SABM); /* Open next channel */
+                }
+                break;
+            }
+#endif /* LWCELL_CFG_CMUX */
             case LWCELL_CMD_CLCC_SET:
             default: break;
         }
 
+#if LWCELL_CFG_CMUX
+        if (n_cmd == LWCELL_CMD_IDLE && (CMD_IS_CUR(LWCELL_CMD_CREG_SET) || CMD_IS_CUR(LWCELL_CMD_CLCC_SET))
+            && !stat->is_error) {
+            SET_NEW_CMD(LWCELL_CMD_CMUX_SET); /* Enter multiplexer mode as last step */
+        } else if ((CMD_IS_CUR(LWCELL_CMD_CMUX_SET) || CMD_IS_CUR(LWCELL_CMD_CMUX_SABM)) && !stat->is_ok) {
+            /* Multiplexer is optional, continue in AT command mode */
+            LWCELL_DEBUGF(LWCELL_CFG_DBG_INIT | LWCELL_DBG_TYPE_TRACE | LWCELL_DBG_LVL_WARNING,
+                          "[LWCELL CMUX] Device refused multiplexer mode\r\n");
+            lwcelli_cmux_close();
+            stat->is_ok = 1;
+            stat->is_error = 0;
+        }
+#endif /* LWCELL_CFG_CMUX */
+
         /* Send event */
         if (n_cmd == LWCELL_CMD_IDLE) {
             RESET_SEND_EVT(msg, lwcellOK);
@@ -1688,6 +2699,83 @@ lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
             lwcelli_send_cb(LWCELL_EVT_PB_SEARCH);
         }
 #endif /* LWCELL_CFG_PHONEBOOK */
+#if LWCELL_CFG_TRANSPARENT
+    } else if (CMD_IS_DEF(LWCELL_CMD_TRANSPARENT_START)) {
+        switch (CMD_GET_CUR()) {
+            case LWCELL_CMD_CIPSHUT: {
+                /* Multiple connection mode and its PDP context are gone */
+                if (!stat->is_error && LWCELL_BIT_VALUE(lwcell.m.network.is_attached, LWCELL_BIT(LWCELL_PDP_SOCKET))) {
+                    LWCELL_BIT_CLEAR(lwcell.m.network.is_attached, LWCELL_BIT(LWCELL_PDP_SOCKET));
+                    lwcelli_send_cb(LWCELL_EVT_NETWORK_DETACHED);
+                }
+                SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CIPMUX_SET);
+                break;
+            }
+            case LWCELL_CMD_CIPMUX_SET: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CIPMODE); break;
+            case LWCELL_CMD_CIPMODE: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CSTT_SET); break;
+            case LWCELL_CMD_CSTT_SET: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CIICR); break;
+            case LWCELL_CMD_CIICR: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CIFSR); break;
+            case LWCELL_CMD_CIFSR: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CIPSTART); break;
+            default: break;
+        }
+    } else if (CMD_IS_DEF(LWCELL_CMD_TRANSPARENT_STOP)) {
+        switch (CMD_GET_CUR()) {
+            case LWCELL_CMD_TRANSPARENT_ESCAPE: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CIPCLOSE); break;
+            case LWCELL_CMD_CIPCLOSE: SET_NEW_CMD(LWCELL_CMD_CIPSHUT); break; /* Connection may be closed already */
+            case LWCELL_CMD_CIPSHUT: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CIPMODE); break;
+            case LWCELL_CMD_CIPMODE: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_CIPMUX_SET); break;
+            default: break;
+        }
+#endif /* LWCELL_CFG_TRANSPARENT */
+#if LWCELL_CFG_PPP
+    } else if (CMD_IS_DEF(LWCELL_CMD_PPP_START)) {
+        if (CMD_IS_CUR(LWCELL_CMD_CGDCONT_SET)) {
+            SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_PPP_DIAL);
+        }
+    } else if (CMD_IS_DEF(LWCELL_CMD_PPP_STOP)) {
+        if (CMD_IS_CUR(LWCELL_CMD_PPP)) {
+            SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_ATH);
+        }
+#endif /* LWCELL_CFG_PPP */
+#if LWCELL_CFG_MQTT
+    } else if (CMD_IS_DEF(LWCELL_CMD_MQTT_CONNECT)) {
+        switch (CMD_GET_CUR()) {
+            case LWCELL_CMD_MCONFIG: SET_NEW_CMD_CHECK_ERROR(LWCELL_CMD_MIPSTART); break;
+            case LWCELL_CMD_MIPSTART: {
+                if (stat->is_error) {
+                    msg->cmd = LWCELL_CMD_IDLE;
+                    return lwcellERRCONNFAIL; /* Broker is not reachable */
+                }
+                SET_NEW_CMD(LWCELL_CMD_MCONNECT);
+                break;
+            }
+            case LWCELL_CMD_MCONNECT: {
+                if (stat->is_ok) { /* Broker accepted client, session is ready */
+                    lwcell.m.mqtt.recv_fn = msg->msg.mqtt_connect.recv_fn;
+                    lwcell.m.mqtt.closed_fn = msg->msg.mqtt_connect.closed_fn;
+                    lwcell.m.mqtt.arg = msg->msg.mqtt_connect.arg;
+                    lwcell.m.mqtt.buff = msg->msg.mqtt_connect.buff;
+                    lwcell.m.mqtt.buff_len = msg->msg.mqtt_connect.buff_len;
+                    lwcell.m.mqtt.active = 1;
+                } else {
+                    SET_NEW_CMD(LWCELL_CMD_MIPCLOSE); /* Broker refused client, close TCP connection first */
+                }
+                break;
+            }
+            case LWCELL_CMD_MIPCLOSE: {
+                stat->is_ok = 0; /* Report refused connection after TCP connection is closed */
+                break;
+            }
+            default: break;
+        }
+    } else if (CMD_IS_DEF(LWCELL_CMD_MQTT_DISCONNECT)) {
+        if (CMD_IS_CUR(LWCELL_CMD_MDISCONNECT)) {
+            SET_NEW_CMD(LWCELL_CMD_MIPCLOSE); /* Broker may have closed connection already */
+        } else if (CMD_IS_CUR(LWCELL_CMD_MIPCLOSE)) {
+            mqtt_session_close(0);
+            stat->is_ok = 1;
+        }
+#endif /* LWCELL_CFG_MQTT */
 #if LWCELL_CFG_NETWORK
     } else if (CMD_IS_DEF(LWCELL_CMD_NETWORK_ATTACH)) {
         if (msg->msg.network_attach.pdp.type == LWCELL_PDP_SOCKET) {
@@ -1856,7 +2944,124 @@ lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
             }
 #endif
         }
+    } else if (HTTP_REQ_IS_DEF()) {
+        /* Once service is initialized, it is always terminated to be ready for next request */
+        if (stat->is_error && msg->msg.http_req.is_init && !CMD_IS_CUR(LWCELL_CMD_HTTPTERM)) {
+            msg->msg.http_req.res = lwcellERR;
+            SET_NEW_CMD(LWCELL_CMD_HTTPTERM);
+        } else {
+            switch (CMD_GET_CUR()) {
+                case LWCELL_CMD_HTTPINIT: {
+                    if (stat->is_ok) {
+                        msg->msg.http_req.is_init = 1;
+                        lwcell.m.http_session.active = 1;
+                        SET_NEW_CMD(http_req_next_cmd(msg, LWCELL_CMD_HTTPINIT));
+                    } else if (!msg->msg.http_req.init_retry) {
+                        /* Service may be left initialized by aborted request, terminate it and try again */
+                        msg->msg.http_req.init_retry = 1;
+                        SET_NEW_CMD(LWCELL_CMD_HTTPTERM);
+                    }
+                    break;
+                }
+                case LWCELL_CMD_HTTPPARA_CID: {
+                    lwcell.m.http_session.cid_set = 1;
+                    SET_NEW_CMD(http_req_next_cmd(msg, LWCELL_CMD_HTTPPARA_CID));
+                    break;
+                }
+                case LWCELL_CMD_HTTPPARA_URL: {
+                    http_session_param_save(lwcell.m.http_session.url, msg->msg.http_req.url);
+                    SET_NEW_CMD(http_req_next_cmd(msg, LWCELL_CMD_HTTPPARA_URL));
+                    break;
+                }
+                case LWCELL_CMD_HTTPPARA_BREAK: {
+                    lwcell.m.http_session.brk = msg->msg.http_req.offset;
+                    SET_NEW_CMD(http_req_next_cmd(msg, LWCELL_CMD_HTTPPARA_BREAK));
+                    break;
+                }
+                case LWCELL_CMD_HTTPPARA_BREAKEND: {
+                    lwcell.m.http_session.brk_end = msg->msg.http_req.offset + msg->msg.http_req.len - 1;
+                    lwcell.m.http_session.range_set = 1;
+                    SET_NEW_CMD(http_req_next_cmd(msg, LWCELL_CMD_HTTPPARA_BREAKEND));
+                    break;
+                }
+                case LWCELL_CMD_HTTPPARA_CONTENT: {
+                    lwcell.m.http_session.content_set = 1;
+                    http_session_param_save(lwcell.m.http_session.content, msg->msg.http_req.content_type);
+                    SET_NEW_CMD(http_req_next_cmd(msg, LWCELL_CMD_HTTPPARA_CONTENT));
+                    break;
+                }
+                case LWCELL_CMD_HTTPDATA: {
+                    if (msg->msg.http_req.body_failed) {
+                        msg->msg.http_req.res = lwcellERR; /* Incomplete body must not reach the server */
+                        SET_NEW_CMD(LWCELL_CMD_HTTPTERM);
+                    } else {
+                        SET_NEW_CMD(LWCELL_CMD_HTTPACTION_POST);
+                    }
+                    break;
+                }
+                case LWCELL_CMD_HTTPACTION_POST: {
+                    uint16_t code = msg->msg.http_req.code;
+
+                    if (code < 200 || code > 299) {
+                        msg->msg.http_req.res = lwcellERR;
+                        SET_NEW_CMD(LWCELL_CMD_HTTPTERM);
+                    } else if (msg->msg.http_req.recv_fn != NULL && msg->msg.http_req.data_len > 0) {
+                        SET_NEW_CMD(LWCELL_CMD_HTTPREAD);
+                    } else {
+                        SET_NEW_CMD(LWCELL_CMD_HTTPTERM);
+                    }
+                    break;
+                }
+                case LWCELL_CMD_HTTPACTION_GET: {
+                    uint16_t code = msg->msg.http_req.code;
+
+                    if (code == 206 || (code == 200 && msg->msg.http_req.offset == 0)) {
+                        SET_NEW_CMD(msg->msg.http_req.data_len > 0 ? LWCELL_CMD_HTTPREAD : LWCELL_CMD_HTTPTERM);
+                    } else {
+                        /* Range beyond end of resource is not an error, there is simply no more data */
+                        if (code != 416) {
+                            msg->msg.http_req.res = lwcellERR;
+                        }
+                        SET_NEW_CMD(LWCELL_CMD_HTTPTERM);
+                    }
+                    break;
+                }
+                case LWCELL_CMD_HTTPREAD: {
+                    if (lwcell.m.http_rx.read) {
+                        msg->msg.http_req.res = lwcellERR; /* Body is not complete */
+                    } else if (lwcell.m.http_rx.failed) {
+                        msg->msg.http_req.res = lwcellERRMEM;
+                    }
+                    SET_NEW_CMD(LWCELL_CMD_HTTPTERM);
+                    break;
+                }
+                case LWCELL_CMD_HTTPTERM: {
+                    http_session_reset();
+                    if (!msg->msg.http_req.is_init) {
+                        SET_NEW_CMD(LWCELL_CMD_HTTPINIT);
+                    } else {
+                        http_rx_reset();
+                        stat->is_ok = msg->msg.http_req.res == lwcellOK;
+                    }
+                    break;
+                }
+                default: break;
+            }
+
+            /* Keep service initialized after successful request, it is terminated when idle */
+            if (n_cmd == LWCELL_CMD_HTTPTERM && msg->msg.http_req.res == lwcellOK && lwcell.http_keep_alive > 0) {
+                lwcell_timeout_remove(http_session_idle_timeout);
+                if (lwcell_timeout_add(lwcell.http_keep_alive, http_session_idle_timeout, NULL) == lwcellOK) {
+                    http_rx_reset();
+                    stat->is_ok = 1;
+                    SET_NEW_CMD(LWCELL_CMD_IDLE);
+                }
+            }
+        }
+    } else if (CMD_IS_DEF(LWCELL_CMD_HTTP_SESSION_CLOSE)) {
+        http_session_reset(); /* Service is not initialized anymore, also when it was not before */
     } else if (CMD_IS_DEF(LWCELL_CMD_HTTPTERM)) {
+        http_session_reset(); /* Service terminated by connection API */
 
 
 #endif
@@ -1890,6 +3095,57 @@ lwcelli_process_sub_cmd(lwcell_msg_t* msg, lwcell_status_flags_t* stat) {
     return stat->is_ok ? lwcellOK : lwcellERR;
 }
 
+#if LWCELL_CFG_TRANSPARENT || LWCELL_CFG_PPP || __DOXYGEN__
+
+/**
+ * \brief           Send raw data to AT port and flush them, used in transparent and PPP data mode
+ * \param[in]       data: Data to send
+ * \param[in]       len: Length of data
+ */
+void
+lwcelli_at_port_send_raw(const void* data, size_t len) {
+    AT_PORT_SEND_WITH_FLUSH(data, len);
+}
+
+#endif /* LWCELL_CFG_TRANSPARENT || LWCELL_CFG_PPP || __DOXYGEN__ */
+
+#if LWCELL_CFG_TRANSPARENT || __DOXYGEN__
+
+/**
+ * \brief           Guard time before escape sequence has expired
+ * \param[in]       arg: Message which started escape procedure
+ */
+static void
+transparent_escape_timeout(void* arg) {
+    if (lwcell.msg != arg || !CMD_IS_CUR(LWCELL_CMD_TRANSPARENT_ESCAPE)) {
+        return;
+    }
+    AT_PORT_SEND_WITH_FLUSH("+++", 3);
+    /* Device replies with OK after second guard time, everything received now is parsed as AT response */
+    lwcelli_transparent_flush(); /* Kept characters are connection data received before escape */
+    lwcell.m.transparent.data_mode = 0;
+}
+
+#endif /* LWCELL_CFG_TRANSPARENT || __DOXYGEN__ */
+
+#if LWCELL_CFG_PPP || __DOXYGEN__
+
+/**
+ * \brief           Guard time before PPP escape sequence has expired
+ * \param[in]       arg: Message which started escape procedure
+ */
+static void
+ppp_escape_timeout(void* arg) {
+    if (lwcell.msg != arg || !CMD_IS_CUR(LWCELL_CMD_PPP)) {
+        return;
+    }
+    AT_PORT_SEND_WITH_FLUSH("+++", 3);
+    /* Device replies with OK after second guard time, everything received now is parsed as AT response */
+    lwcelli_ppp_link_down();
+}
+
+#endif /* LWCELL_CFG_PPP || __DOXYGEN__ */
+
 /**
  * \brief           Function to initialize every AT command
  * \note            Never call this function directly. Set as initialization function for command and use `msg->fn(msg)`
@@ -1918,6 +3174,52 @@ lwcelli_initiate_cmd(lwcell_msg_t* msg) {
             AT_PORT_SEND_END_AT();
             break;
         }
+#if LWCELL_CFG_AT_PORT_AUTOBAUD
+        case LWCELL_CMD_AT_PORT_PROBE:
+        case LWCELL_CMD_AT_PORT_VERIFY: { /* Check if device responds on current baudrate */
+            if (CMD_IS_CUR(LWCELL_CMD_AT_PORT_PROBE) && msg->msg.reset.probe_idx == 0) {
+                msg->msg.reset.baudrate_prev = lwcell.ll.uart.baudrate;
+                at_port_get_probe_baudrate(msg);
+            }
+            lwcell_timeout_remove(at_port_probe_timeout);
+            if (lwcell_timeout_add(LWCELL_CFG_AT_PORT_PROBE_TIMEOUT, at_port_probe_timeout, msg) != lwcellOK) {
+                return lwcellERRMEM;
+            }
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case LWCELL_CMD_IPR: { /* Set fixed baudrate */
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+IPR=");
+            lwcelli_send_number(LWCELL_U32(LWCELL_CFG_AT_PORT_BAUDRATE_MAX), 0, 0);
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case LWCELL_CMD_AT_W: { /* Store active profile */
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("&W");
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+#endif /* LWCELL_CFG_AT_PORT_AUTOBAUD */
+#if LWCELL_CFG_CMUX
+        case LWCELL_CMD_CMUX_SET: { /* Enter basic mode multiplexer, UIH frames */
+            uint8_t port_speed = lwcelli_cmux_get_port_speed(lwcell.ll.uart.baudrate);
+
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CMUX=0,0,");
+            if (port_speed > 0) {
+                lwcelli_send_number(LWCELL_U32(port_speed), 0, 0);
+            }
+            lwcelli_send_number(LWCELL_U32(LWCELL_CFG_CMUX_N1), 0, 1);
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case LWCELL_CMD_CMUX_SABM: { /* Open multiplexer channel */
+            return lwcelli_cmux_open_dlc(msg->msg.reset.cmux_dlci);
+        }
+#endif /* LWCELL_CFG_CMUX */
         case LWCELL_CMD_ATE0:
         case LWCELL_CMD_ATE1: {
             AT_PORT_SEND_BEGIN_AT();
@@ -2134,6 +3436,17 @@ lwcelli_initiate_cmd(lwcell_msg_t* msg) {
         case LWCELL_CMD_CIPSTART: { /* Start a new connection */
             lwcell_conn_t* c = NULL;
 
+#if LWCELL_CFG_TRANSPARENT
+            if (CMD_IS_DEF(LWCELL_CMD_TRANSPARENT_START)) { /* Single connection mode has no connection number */
+                AT_PORT_SEND_BEGIN_AT();
+                AT_PORT_SEND_CONST_STR("+CIPSTART=");
+                lwcelli_send_string(msg->msg.transparent_start.type == LWCELL_CONN_TYPE_UDP ? "UDP" : "TCP", 0, 1, 0);
+                lwcelli_send_string(msg->msg.transparent_start.host, 0, 1, 1);
+                lwcelli_send_port(msg->msg.transparent_start.port, 0, 1);
+                AT_PORT_SEND_END_AT();
+                break;
+            }
+#endif /* LWCELL_CFG_TRANSPARENT */
             /* Do we have network connection? */
             /* Check if we are connected to network */
 
@@ -2170,6 +3483,14 @@ lwcelli_initiate_cmd(lwcell_msg_t* msg) {
         }
         case LWCELL_CMD_CIPCLOSE: { /* Close the connection */
             lwcell_conn_p c = msg->msg.conn_close.conn;
+#if LWCELL_CFG_TRANSPARENT
+            if (CMD_IS_DEF(LWCELL_CMD_TRANSPARENT_STOP)) {
+                AT_PORT_SEND_BEGIN_AT();
+                AT_PORT_SEND_CONST_STR("+CIPCLOSE");
+                AT_PORT_SEND_END_AT();
+                break;
+            }
+#endif /* LWCELL_CFG_TRANSPARENT */
             if (c != NULL &&
                 /* Is connection already closed or command for this connection is not valid anymore? */
                 (!lwcell_conn_is_active(c) || c->val_id != msg->msg.conn_close.val_id)) {
@@ -2310,13 +3631,15 @@ lwcelli_initiate_cmd(lwcell_msg_t* msg) {
             AT_PORT_SEND_END_AT();
             break;
         }
-        case LWCELL_CMD_ATH: { /* Disconnect existing connection (hang-up phone call) */
+#endif                                 /* LWCELL_CFG_CALL */
+#if LWCELL_CFG_CALL || LWCELL_CFG_PPP
+        case LWCELL_CMD_ATH: { /* Disconnect existing connection (hang-up phone call or data call) */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("H");
             AT_PORT_SEND_END_AT();
             break;
         }
-#endif                                  /* LWCELL_CFG_CALL */
+#endif                                  /* LWCELL_CFG_CALL || LWCELL_CFG_PPP */
 #if LWCELL_CFG_PHONEBOOK
         case LWCELL_CMD_CPBS_GET_OPT: { /* Get available phonebook storages */
             AT_PORT_SEND_BEGIN_AT();
@@ -2403,10 +3726,137 @@ lwcelli_initiate_cmd(lwcell_msg_t* msg) {
         }
         case LWCELL_CMD_CIPMUX_SET: {
             AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPMUX=1");
+#if LWCELL_CFG_TRANSPARENT
+            if (CMD_IS_DEF(LWCELL_CMD_TRANSPARENT_START)) {
+                AT_PORT_SEND_CONST_STR("+CIPMUX=0");
+            } else
+#endif /* LWCELL_CFG_TRANSPARENT */
+            {
+                AT_PORT_SEND_CONST_STR("+CIPMUX=1");
+            }
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+#if LWCELL_CFG_TRANSPARENT
+        case LWCELL_CMD_CIPMODE: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CIPMODE=");
+            lwcelli_send_number(LWCELL_U32(CMD_IS_DEF(LWCELL_CMD_TRANSPARENT_START)), 0, 0);
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case LWCELL_CMD_TRANSPARENT_ESCAPE: {
+            if (!lwcell.m.transparent.data_mode) { /* Device already left data mode, continue with close */
+                msg->cmd = LWCELL_CMD_CIPCLOSE;
+                return lwcelli_initiate_cmd(msg);
+            }
+            /* Escape sequence is sent after guard time without data */
+            LWCELL_CMD_STATS_STEP_START(msg);
+            return lwcell_timeout_add(LWCELL_CFG_TRANSPARENT_GUARD_TIME, transparent_escape_timeout, msg);
+        }
+#endif /* LWCELL_CFG_TRANSPARENT */
+#if LWCELL_CFG_PPP
+        case LWCELL_CMD_CGDCONT_SET: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CGDCONT=1,\"IP\",");
+            lwcelli_send_string(msg->msg.ppp_start.apn, 1, 1, 0);
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case LWCELL_CMD_PPP_DIAL: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("D*99#");
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case LWCELL_CMD_PPP: {
+            if (!lwcell.m.ppp.data_mode) { /* Data call has ended already, hang-up is harmless */
+                msg->cmd = LWCELL_CMD_ATH;
+                return lwcelli_initiate_cmd(msg);
+            }
+            /* Escape sequence is sent after guard time without data */
+            LWCELL_CMD_STATS_STEP_START(msg);
+            return lwcell_timeout_add(LWCELL_CFG_PPP_GUARD_TIME, ppp_escape_timeout, msg);
+        }
+#endif /* LWCELL_CFG_PPP */
+#if LWCELL_CFG_MQTT
+        case LWCELL_CMD_MCONFIG: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+MCONFIG=");
+            lwcelli_send_string(msg->msg.mqtt_connect.id, 0, 1, 0);
+            lwcelli_send_string(msg->msg.mqtt_connect.user, 0, 1, 1);
+            lwcelli_send_string(msg->msg.mqtt_connect.pass, 0, 1, 1);
+            if (msg->msg.mqtt_connect.will_topic != NULL) {
+                lwcelli_send_number(LWCELL_U32(msg->msg.mqtt_connect.will_qos), 0, 1);
+                lwcelli_send_number(0, 0, 1); /* Will retain */
+                lwcelli_send_string(msg->msg.mqtt_connect.will_topic, 0, 1, 1);
+                lwcelli_send_string(msg->msg.mqtt_connect.will_message, 0, 1, 1);
+            }
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case LWCELL_CMD_MIPSTART: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+MIPSTART=");
+            lwcelli_send_string(msg->msg.mqtt_connect.host, 0, 1, 0);
+            lwcelli_send_port(msg->msg.mqtt_connect.port, 0, 1);
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case LWCELL_CMD_MCONNECT: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+MCONNECT=");
+            lwcelli_send_number(LWCELL_U32(!!msg->msg.mqtt_connect.clean_session), 0, 0);
+            lwcelli_send_number(LWCELL_U32(msg->msg.mqtt_connect.keep_alive), 0, 1);
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case LWCELL_CMD_MSUB: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+MSUB=");
+            lwcelli_send_string(msg->msg.mqtt_topic.topic, 0, 1, 0);
+            lwcelli_send_number(LWCELL_U32(msg->msg.mqtt_topic.qos), 0, 1);
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case LWCELL_CMD_MUNSUB: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+MUNSUB=");
+            lwcelli_send_string(msg->msg.mqtt_topic.topic, 0, 1, 0);
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case LWCELL_CMD_MPUB: {
+            AT_PORT_SEND_BEGIN_AT();
+            if (msg->msg.mqtt_topic.len > 0) { /* Binary payload is sent after "> " prompt */
+                AT_PORT_SEND_CONST_STR("+MPUBEX=");
+            } else {
+                AT_PORT_SEND_CONST_STR("+MPUB=");
+            }
+            lwcelli_send_string(msg->msg.mqtt_topic.topic, 0, 1, 0);
+            lwcelli_send_number(LWCELL_U32(msg->msg.mqtt_topic.qos), 0, 1);
+            lwcelli_send_number(LWCELL_U32(msg->msg.mqtt_topic.retain), 0, 1);
+            if (msg->msg.mqtt_topic.len > 0) {
+                lwcelli_send_number(LWCELL_U32(msg->msg.mqtt_topic.len), 0, 1);
+            } else {
+                lwcelli_send_string("", 0, 1, 1);
+            }
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case LWCELL_CMD_MDISCONNECT: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+MDISCONNECT");
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case LWCELL_CMD_MIPCLOSE: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+MIPCLOSE");
             AT_PORT_SEND_END_AT();
             break;
         }
+#endif /* LWCELL_CFG_MQTT */
         case LWCELL_CMD_CIPRXGET_SET: {
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CIPRXGET=0");
@@ -2416,9 +3866,18 @@ lwcelli_initiate_cmd(lwcell_msg_t* msg) {
         case LWCELL_CMD_CSTT_SET: {
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CSTT=");
-            lwcelli_send_string(msg->msg.network_attach.apn, 1, 1, 0);
-            lwcelli_send_string(msg->msg.network_attach.user, 1, 1, 1);
-            lwcelli_send_string(msg->msg.network_attach.pass, 1, 1, 1);
+#if LWCELL_CFG_TRANSPARENT
+            if (CMD_IS_DEF(LWCELL_CMD_TRANSPARENT_START)) {
+                lwcelli_send_string(msg->msg.transparent_start.apn, 1, 1, 0);
+                lwcelli_send_string(msg->msg.transparent_start.user, 1, 1, 1);
+                lwcelli_send_string(msg->msg.transparent_start.pass, 1, 1, 1);
+            } else
+#endif /* LWCELL_CFG_TRANSPARENT */
+            {
+                lwcelli_send_string(msg->msg.network_attach.apn, 1, 1, 0);
+                lwcelli_send_string(msg->msg.network_attach.user, 1, 1, 1);
+                lwcelli_send_string(msg->msg.network_attach.pass, 1, 1, 1);
+            }
             AT_PORT_SEND_END_AT();
             break;
         }
@@ -2474,23 +3933,35 @@ lwcelli_initiate_cmd(lwcell_msg_t* msg) {
         }
 #if LWCELL_CFG_HTTP
         case LWCELL_CMD_HTTPINIT: {
-            lwcell_conn_t *c = NULL;
-            msg->msg.conn_start.num = LWCELL_CFG_HTTP_CONN_OFFSET;
-            int16_t cm = LWCELL_CFG_HTTP_CONN_OFFSET + LWCELL_CFG_MAX_HTTP_CONNS;
-            for(int16_t i = cm - 1; i >= LWCELL_CFG_HTTP_CONN_OFFSET; --i){
-                if(!lwcell.m.conns[i].status.f.active){
-                    c = &lwcell.m.conns[i];
-                    c->num = LWCELL_U8(i);
-                    msg->msg.conn_start.num = LWCELL_U8(i);
-                    break;
+            if (HTTP_REQ_IS_DEF() && lwcell.m.http_session.active) {
+                if (msg->msg.http_req.content_type == NULL && lwcell.m.http_session.content_set) {
+                    /* Content type cannot be reset to device default, restart the service */
+                    msg->cmd = LWCELL_CMD_HTTPTERM;
+                } else {
+                    msg->msg.http_req.is_init = 1; /* Continue with kept service */
+                    msg->cmd = http_req_next_cmd(msg, LWCELL_CMD_HTTPINIT);
                 }
+                return lwcelli_initiate_cmd(msg);
             }
-            if(c == NULL){
-                lwcelli_send_conn_error_cb(msg, lwcellERRNOFREECONN);
-                return lwcellERRNOFREECONN;
-            }
-            if(msg->msg.conn_start.conn != NULL){
-                *msg->msg.conn_start.conn = c;
+            if (!HTTP_REQ_IS_DEF()) {
+                lwcell_conn_t *c = NULL;
+                msg->msg.conn_start.num = LWCELL_CFG_HTTP_CONN_OFFSET;
+                int16_t cm = LWCELL_CFG_HTTP_CONN_OFFSET + LWCELL_CFG_MAX_HTTP_CONNS;
+                for(int16_t i = cm - 1; i >= LWCELL_CFG_HTTP_CONN_OFFSET; --i){
+                    if(!lwcell.m.conns[i].status.f.active){
+                        c = &lwcell.m.conns[i];
+                        c->num = LWCELL_U8(i);
+                        msg->msg.conn_start.num = LWCELL_U8(i);
+                        break;
+                    }
+                }
+                if(c == NULL){
+                    lwcelli_send_conn_error_cb(msg, lwcellERRNOFREECONN);
+                    return lwcellERRNOFREECONN;
+                }
+                if(msg->msg.conn_start.conn != NULL){
+                    *msg->msg.conn_start.conn = c;
+                }
             }
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+HTTPINIT");
@@ -2513,7 +3984,11 @@ lwcelli_initiate_cmd(lwcell_msg_t* msg) {
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+HTTPPARA=");
             lwcelli_send_string("CID", 0, 1, 0);
-            lwcelli_send_number(msg->msg.network_attach.pdp.id, 0, 1);
+            if (HTTP_REQ_IS_DEF()) {
+                lwcelli_send_number(1, 0, 1); /* Bearer profile opened with `AT+SAPBR` */
+            } else {
+                lwcelli_send_number(msg->msg.network_attach.pdp.id, 0, 1);
+            }
             AT_PORT_SEND_END_AT();
             break;
         }
@@ -2521,6 +3996,11 @@ lwcelli_initiate_cmd(lwcell_msg_t* msg) {
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+HTTPPARA=");
             lwcelli_send_string("URL", 0, 1, 0);
+            if (HTTP_REQ_IS_DEF()) {
+                lwcelli_send_string(msg->msg.http_req.url, 1, 1, 1);
+                AT_PORT_SEND_END_AT();
+                break;
+            }
             AT_PORT_SEND_COMMA_COND(1);
             AT_PORT_SEND_QUOTE_COND(1);
             lwcelli_send_string(msg->msg.conn_start.host, 1, 0, 0);
@@ -2554,6 +4034,7 @@ lwcelli_initiate_cmd(lwcell_msg_t* msg) {
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+HTTPPARA=");
             lwcelli_send_string("BREAK", 0, 1, 0);
+            lwcelli_send_number(LWCELL_U32(msg->msg.http_req.offset), 0, 1);
             AT_PORT_SEND_END_AT();
             break;
         }
@@ -2561,6 +4042,7 @@ lwcelli_initiate_cmd(lwcell_msg_t* msg) {
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+HTTPPARA=");
             lwcelli_send_string("BREAKEND", 0, 1, 0);
+            lwcelli_send_number(LWCELL_U32(msg->msg.http_req.offset + msg->msg.http_req.len - 1), 0, 1);
             AT_PORT_SEND_END_AT();
             break;
         }
@@ -2578,6 +4060,22 @@ lwcelli_initiate_cmd(lwcell_msg_t* msg) {
             AT_PORT_SEND_END_AT();
             break;
         }
+        case LWCELL_CMD_HTTPPARA_CONTENT: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+HTTPPARA=");
+            lwcelli_send_string("CONTENT", 0, 1, 0);
+            lwcelli_send_string(msg->msg.http_req.content_type, 1, 1, 1);
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case LWCELL_CMD_HTTPDATA: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+HTTPDATA=");
+            lwcelli_send_number(msg->msg.http_req.body_len, 0, 0);
+            lwcelli_send_number(120000, 0, 1); /* Maximal time to input body, device limit */
+            AT_PORT_SEND_END_AT();
+            break;
+        }
         case LWCELL_CMD_HTTPACTION_GET: {
 
             AT_PORT_SEND_BEGIN_AT();
@@ -2682,6 +4180,7 @@ lwcelli_send_msg_to_producer_mbox(lwcell_msg_t* msg, lwcellr_t (*process_fn)(lwc
     }
     msg->block_time = max_block_time;                    /* Set blocking status if necessary */
     msg->fn = process_fn;                                /* Save processing function to be called as callback */
+    LWCELL_CMD_STATS_ENQUEUE(msg);
     if (msg->is_blocking) {
         lwcell_sys_mbox_put(&lwcell.mbox_producer, msg); /* Write message to producer queue and wait forever */
     } else {
@@ -2749,6 +4248,21 @@ lwcelli_process_events_for_timeout_or_error(lwcell_msg_t* msg, lwcellr_t err) {
         }
 #endif /* LWCELL_CFG_CONN */
 
+#if LWCELL_CFG_HTTP
+        case LWCELL_CMD_HTTP_GET_RANGE:
+        case LWCELL_CMD_HTTP_POST: {
+            /* Data may still arrive, callback argument is not valid anymore */
+            http_rx_reset();
+            lwcell_timeout_remove(http_post_body_timeout);
+            http_session_reset(); /* Service state is not known, next request starts with initialization */
+            break;
+        }
+        case LWCELL_CMD_HTTP_SESSION_CLOSE: {
+            http_session_reset();
+            break;
+        }
+#endif /* LWCELL_CFG_HTTP */
+
 #if LWCELL_CFG_SMS
         case LWCELL_CMD_CMGS: {
             /* Send error event */
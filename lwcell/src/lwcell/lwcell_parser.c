@@ -362,7 +362,7 @@ lwcelli_parse_csq(const char* str) {
         rssi = 0;
     }
     lwcell.m.rssi = rssi;                 /* Save RSSI to global variable */
-    if (lwcell.msg->cmd_def == LWCELL_CMD_CSQ_GET && lwcell.msg->msg.csq.rssi != NULL) {
+    if (lwcell.msg != NULL && lwcell.msg->cmd_def == LWCELL_CMD_CSQ_GET && lwcell.msg->msg.csq.rssi != NULL) {
         *lwcell.msg->msg.csq.rssi = rssi; /* Save to user variable */
     }
 
@@ -984,6 +984,108 @@ lwcelli_parse_ipd(const char* str) {
     return 1;
 }
 
+#if LWCELL_CFG_MQTT || __DOXYGEN__
+
+/**
+ * \brief           Parse header of received MQTT message and prepare payload read
+ *
+ * Header is in format `+MSUB: "<topic>",<len> byte,` and payload follows on the same line.
+ * Topic is saved at the beginning of native MQTT session receive buffer.
+ *
+ * \param[in]       str: Input string with complete header
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwcelli_parse_msub(const char* str) {
+    lwcell_mqtt_session_t* s = &lwcell.m.mqtt;
+    const char* topic;
+    size_t topic_len;
+
+    str += 6; /* Skip "+MSUB:" */
+    if (*str == ' ') {
+        ++str;
+    }
+    if (*str != '"') {
+        return 0;
+    }
+    topic = ++str;
+    while (*str != '\0' && *str != '"') {
+        ++str;
+    }
+    if (*str != '"') {
+        return 0;
+    }
+    topic_len = LWCELL_SZ(str - topic);
+    ++str;
+
+    s->rx.tot_len = s->rx.rem_len = LWCELL_SZ(lwcelli_parse_number(&str));
+    if (strcmp(str, " byte,")) { /* Length must be followed by payload */
+        return 0;
+    }
+    s->rx.topic_len = topic_len;
+    s->rx.ptr = topic_len;
+    if (s->active && s->buff != NULL && topic_len <= s->buff_len) {
+        LWCELL_MEMCPY(s->buff, topic, topic_len);
+    }
+    return 1;
+}
+
+#endif /* LWCELL_CFG_MQTT || __DOXYGEN__ */
+
+#if LWCELL_CFG_HTTP || __DOXYGEN__
+
+/**
+ * \brief           Parse result of HTTP range request
+ *
+ * Result is in format `+HTTPACTION: <method>,<status>,<len>`.
+ *
+ * \param[in]       str: Input string
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwcelli_parse_httpaction_range(const char* str) {
+    if (*str == '+') {
+        str += 13;
+    }
+    lwcelli_parse_number(&str); /* Skip method */
+    lwcell.msg->msg.http_req.code = LWCELL_U16(lwcelli_parse_number(&str));
+    lwcell.msg->msg.http_req.data_len = LWCELL_SZ(lwcelli_parse_number(&str));
+    if (lwcell.msg->msg.http_req.status != NULL) {
+        *lwcell.msg->msg.http_req.status = lwcell.msg->msg.http_req.code;
+    }
+    return 1;
+}
+
+/**
+ * \brief           Parse header of HTTP body and prepare body read
+ *
+ * Header is in format `+HTTPREAD: <len>` and body follows in the next line.
+ *
+ * \param[in]       str: Input string
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwcelli_parse_httpread_range(const char* str) {
+    lwcell_http_rx_t* rx = &lwcell.m.http_rx;
+
+    if (*str == '+') {
+        str += 11;
+    }
+    rx->rem_len = LWCELL_SZ(lwcelli_parse_number(&str));
+    rx->read = rx->rem_len > 0;
+    rx->failed = 0;
+    rx->buff = NULL;
+    rx->buff_ptr = 0;
+    rx->recv_fn = lwcell.msg->msg.http_req.recv_fn;
+    rx->arg = lwcell.msg->msg.http_req.arg;
+
+    /* Server which ignores range sends complete resource */
+    rx->offset = lwcell.msg->msg.http_req.code == 206 ? lwcell.msg->msg.http_req.offset : 0;
+    return 1;
+}
+
+#endif /* LWCELL_CFG_HTTP || __DOXYGEN__ */
+
 /**
  * \brief              Parse SAPBR statements
  * \param[in]          str: Input string
@@ -1052,18 +1154,6 @@ uint8_t lwcell_parse_sapbr(const char *str, int *s) {
                 for(int i = LWCELL_CFG_HTTP_CONN_OFFSET; i < cm; i++){
                     lwcelli_conn_closed_process(i, 1);
                 }
-#endif
-#if LWCELL_CFG_MQTT
-                LWCELL_MSG_VAR_DEFINE(mc_msg);
-
-                LWCELL_MSG_VAR_ALLOC(mc_msg, 0);
-                LWCELL_MSG_VAR_SET_EVT(mc_msg, NULL, NULL);
-                LWCELL_MSG_VAR_REF(mc_msg).cmd_def = LWCELL_CMD_SAPBR_QUERY;
-                lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(mc_msg), lwcelli_initiate_cmd, 60000);
-                cm = LWCELL_CFG_MQTT_CONN_OFFSET + LWCELL_CFG_MAX_MQTT_CONNS;
-                for(int i = LWCELL_CFG_MQTT_CONN_OFFSET; i < cm; i++){
-                    lwcelli_conn_closed_process(i, 1);
-                }
 #endif
                 if(tmp_state != LWCELL_BIT_VALUE(lwcell.m.network.is_attached, LWCELL_BIT(pdp_type))){
                     LWCELL_BIT_CLEAR(lwcell.m.network.is_attached, LWCELL_BIT(pdp_type));
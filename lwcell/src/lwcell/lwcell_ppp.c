@@ -0,0 +1,218 @@
+/**
+ * \file            lwcell_ppp.c
+ * \brief           PPP data mode API
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "lwcell/lwcell_ppp.h"
+#include "lwcell/lwcell_private.h"
+
+#if LWCELL_CFG_PPP || __DOXYGEN__
+
+/* Notification sent by device when packet data call has ended */
+static const char no_carrier_str[] = "\r\nNO CARRIER\r\n";
+#define NO_CARRIER_STR_LEN (sizeof(no_carrier_str) - 1)
+
+/**
+ * \brief           Process data received from device in PPP data mode
+ *
+ * All data are passed to network interface. PPP frames are delimited by flag characters,
+ * so `NO CARRIER` notification is only matched in parallel and not held back,
+ * IP stack discards it as noise outside of frames.
+ *
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data
+ * \return          Number of processed bytes. When smaller than `len`,
+ *                  device left data mode and remaining data are AT responses
+ */
+size_t
+lwcelli_ppp_input(const uint8_t* data, size_t len) {
+    uint8_t m = lwcell.m.ppp.nc_match;
+    size_t i;
+
+    for (i = 0; i < len; ++i) {
+        if ((uint8_t)no_carrier_str[m] != data[i]) {
+            m = LWCELL_U8((uint8_t)no_carrier_str[0] == data[i]); /* Only first character repeats in notification */
+        } else if (++m == NO_CARRIER_STR_LEN) {
+            ++i;
+            break;
+        }
+    }
+    if (lwcell.m.ppp.netif->input_fn != NULL) {
+        lwcell.m.ppp.netif->input_fn(data, i, lwcell.m.ppp.arg);
+    }
+    LWCELL_STATS_ADD(ipd_bytes, i);
+    if (m == NO_CARRIER_STR_LEN) {
+        LWCELL_DEBUGF(LWCELL_CFG_DBG_CONN | LWCELL_DBG_TYPE_TRACE, "[LWCELL PPP] Data call ended by device\r\n");
+        lwcelli_ppp_link_down();
+    } else {
+        lwcell.m.ppp.nc_match = m;
+    }
+    return i;
+}
+
+/**
+ * \brief           Device entered PPP data mode after `CONNECT` response to dial command
+ * \param[in]       dlci: Multiplexer channel of PPP data, `0` when PPP uses AT port
+ */
+void
+lwcelli_ppp_link_up(uint8_t dlci) {
+    lwcell.m.ppp.netif = lwcell.msg->msg.ppp_start.netif;
+    lwcell.m.ppp.arg = lwcell.msg->msg.ppp_start.arg;
+    lwcell.m.ppp.dlci = dlci;
+    lwcell.m.ppp.nc_match = 0;
+    lwcell.m.ppp.data_mode = 1;
+    if (lwcell.m.ppp.netif->link_fn != NULL) {
+        lwcell.m.ppp.netif->link_fn(1, lwcell.m.ppp.arg);
+    }
+}
+
+/**
+ * \brief           Device left PPP data mode, notify network interface
+ */
+void
+lwcelli_ppp_link_down(void) {
+    if (!lwcell.m.ppp.data_mode) {
+        return;
+    }
+    lwcell.m.ppp.data_mode = 0;
+    lwcell.m.ppp.nc_match = 0;
+    if (lwcell.m.ppp.netif->link_fn != NULL) {
+        lwcell.m.ppp.netif->link_fn(0, lwcell.m.ppp.arg);
+    }
+}
+
+/**
+ * \brief           Start PPP data mode session
+ *
+ * PDP context `1` is set with given APN and packet data call is dialed.
+ * Function returns successfully when device replied with `CONNECT`
+ * and network interface has been notified with link up status.
+ *
+ * \param[in]       apn: APN name
+ * \param[in]       netif: Network interface of IP stack. It must stay valid during entire session
+ * \param[in]       arg: Custom argument for network interface functions
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_ppp_start(const char* apn, const lwcell_ppp_netif_t* netif, void* const arg, const lwcell_api_cmd_evt_fn evt_fn,
+                 void* const evt_arg, const uint32_t blocking) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_ASSERT(apn != NULL);
+    LWCELL_ASSERT(netif != NULL);
+    LWCELL_ASSERT(netif->input_fn != NULL);
+
+    LWCELL_MSG_VAR_ALLOC(msg, blocking);
+    LWCELL_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_PPP_START;
+    LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_CGDCONT_SET;
+    LWCELL_MSG_VAR_REF(msg).msg.ppp_start.apn = apn;
+    LWCELL_MSG_VAR_REF(msg).msg.ppp_start.netif = netif;
+    LWCELL_MSG_VAR_REF(msg).msg.ppp_start.arg = arg;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 60000);
+}
+
+/**
+ * \brief           Send PPP data from IP stack to device.
+ *                  Data are written directly to PPP channel from caller thread
+ *
+ * Function can be used as output callback of IP stack, such as lwIP `pppos`.
+ *
+ * \param[in]       data: Data to send
+ * \param[in]       len: Number of bytes to send
+ * \return          Number of bytes sent, `0` when device is not in PPP data mode
+ */
+size_t
+lwcell_ppp_output(const void* data, size_t len) {
+    size_t res = 0;
+
+    LWCELL_ASSERT(data != NULL);
+
+    lwcell_core_lock();
+    if (lwcell.m.ppp.data_mode && !CMD_IS_CUR(LWCELL_CMD_PPP)) {
+#if LWCELL_CFG_CMUX
+        if (lwcell.m.ppp.dlci > 0) {
+            lwcelli_cmux_data_send(data, len);
+        } else
+#endif /* LWCELL_CFG_CMUX */
+        {
+            lwcelli_at_port_send_raw(data, len);
+        }
+        res = len;
+    }
+    lwcell_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Stop PPP data mode session.
+ *
+ * IP stack shall terminate PPP link first, device then ends data call by itself.
+ * When device is still in PPP data mode, `+++` escape sequence is sent with guard time
+ * and data call is hung up with `ATH`.
+ *
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_ppp_stop(const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_MSG_VAR_ALLOC(msg, blocking);
+    LWCELL_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_PPP_STOP;
+    LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_PPP;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd,
+                                             60000 + 2 * LWCELL_CFG_PPP_GUARD_TIME);
+}
+
+/**
+ * \brief           Check if device is in PPP data mode
+ * \return          `1` if data mode is active, `0` otherwise
+ */
+uint8_t
+lwcell_ppp_is_active(void) {
+    uint8_t res;
+
+    lwcell_core_lock();
+    res = lwcell.m.ppp.data_mode;
+    lwcell_core_unlock();
+    return res;
+}
+
+#endif /* LWCELL_CFG_PPP || __DOXYGEN__ */
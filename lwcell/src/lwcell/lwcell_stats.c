@@ -0,0 +1,119 @@
+/**
+ * \file            lwcell_stats.c
+ * \brief           Throughput counters and statistics
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "lwcell/lwcell_stats.h"
+#include "lwcell/lwcell_private.h"
+
+#if LWCELL_CFG_STATS || __DOXYGEN__
+
+/**
+ * \brief           Send data to AT port and update transmit counters
+ * \note            Use `AT_PORT_SEND` macros instead of calling function directly
+ * \param[in]       data: Data to send. Set to `NULL` to flush data
+ * \param[in]       len: Number of bytes to send
+ * \return          Value returned by low-level send function
+ */
+size_t
+lwcelli_stats_at_port_send(const void* data, size_t len) {
+    if (data != NULL && len > 0) {
+        LWCELL_STATS_ADD(uart_tx_bytes, len);
+        LWCELL_STATS_INC(uart_tx_calls);
+    }
+#if LWCELL_CFG_CMUX
+    return lwcelli_cmux_at_port_send(data, len);
+#else  /* LWCELL_CFG_CMUX */
+    return lwcell.ll.send_fn(data, len);
+#endif /* !LWCELL_CFG_CMUX */
+}
+
+/**
+ * \brief           Get snapshot of library statistics
+ * \param[out]      stats: Pointer to output statistics structure
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_stats_get(lwcell_stats_t* stats) {
+    LWCELL_ASSERT(stats != NULL);
+
+    lwcell_core_lock();
+    LWCELL_MEMCPY(stats, &lwcell.stats, sizeof(*stats));
+    stats->time = lwcell_sys_now();
+    lwcell_core_unlock();
+    return lwcellOK;
+}
+
+/**
+ * \brief           Get difference between current statistics and previous snapshot
+ *
+ * Function takes new snapshot, writes difference to `delta` and then
+ * replaces `prev` with new snapshot, ready for next call.
+ * Member `time` of `delta` is elapsed time between snapshots,
+ * which can be used to calculate rates.
+ *
+ * \note            Use \ref lwcell_stats_get to create first snapshot
+ * \param[in,out]   prev: Previous snapshot on input, new snapshot on output
+ * \param[out]      delta: Pointer to output difference structure
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_stats_get_delta(lwcell_stats_t* prev, lwcell_stats_t* delta) {
+    lwcell_stats_t now;
+    const uint32_t* n = (const uint32_t*)&now;
+    const uint32_t* p = (const uint32_t*)prev;
+    uint32_t* d = (uint32_t*)delta;
+
+    LWCELL_ASSERT(prev != NULL);
+    LWCELL_ASSERT(delta != NULL);
+
+    lwcell_stats_get(&now);
+    for (size_t i = 0; i < sizeof(now) / sizeof(uint32_t); ++i) {
+        d[i] = n[i] - p[i]; /* Unsigned difference is correct also after wrap */
+    }
+    LWCELL_MEMCPY(prev, &now, sizeof(*prev));
+    return lwcellOK;
+}
+
+/**
+ * \brief           Reset all statistics counters to zero
+ * \note            Per-connection counters are not affected
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_stats_reset(void) {
+    lwcell_core_lock();
+    LWCELL_MEMSET(&lwcell.stats, 0x00, sizeof(lwcell.stats));
+    lwcell_core_unlock();
+    return lwcellOK;
+}
+
+#endif /* LWCELL_CFG_STATS || __DOXYGEN__ */
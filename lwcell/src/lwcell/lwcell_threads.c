@@ -66,6 +66,8 @@ lwcell_thread_produce(void* const arg) {
 
         res = lwcellOK; /* Start with OK */
         e->msg = msg;   /* Set message handle */
+        LWCELL_CMD_STATS_DEQUEUE(msg);
+        LWCELL_TRACE(LWCELL_TRACE_ID_CMD_START, msg->cmd_def, msg->is_blocking, 0);
 
         /*
          * This check is performed when adding command to queue
@@ -75,6 +77,20 @@ lwcell_thread_produce(void* const arg) {
         if (!e->status.f.dev_present) {
             res = lwcellERRNODEVICE;
         }
+#if LWCELL_CFG_TRANSPARENT
+        /* Device in data mode does not accept commands, only stop and reset are allowed */
+        if (res == lwcellOK && e->m.transparent.data_mode && msg->cmd_def != LWCELL_CMD_TRANSPARENT_STOP
+            && msg->cmd_def != LWCELL_CMD_RESET) {
+            res = lwcellERR;
+        }
+#endif /* LWCELL_CFG_TRANSPARENT */
+#if LWCELL_CFG_PPP
+        /* PPP on AT port blocks commands, with multiplexer AT channel stays available */
+        if (res == lwcellOK && e->m.ppp.data_mode && e->m.ppp.dlci == 0 && msg->cmd_def != LWCELL_CMD_PPP_STOP
+            && msg->cmd_def != LWCELL_CMD_RESET) {
+            res = lwcellERR;
+        }
+#endif /* LWCELL_CFG_PPP */
 
         /* For reset message, we can have delay! */
         if (res == lwcellOK && msg->cmd_def == LWCELL_CMD_RESET) {
@@ -113,6 +129,8 @@ lwcell_thread_produce(void* const arg) {
 
             /* Notify application on command timeout */
             if (res == lwcellTIMEOUT) {
+                LWCELL_TRACE(LWCELL_TRACE_ID_CMD_TIMEOUT, msg->cmd_def, msg->cmd, 0);
+                LWCELL_STATS_INC(cmd_timeouts);
                 lwcelli_send_cb(LWCELL_EVT_CMD_TIMEOUT);
             }
 
@@ -151,6 +169,12 @@ lwcell_thread_produce(void* const arg) {
 
             msg->res = res; /* Save response */
         }
+        LWCELL_CMD_STATS_CMD_END(msg, msg->res);
+        LWCELL_STATS_INC(cmd_count);
+        if (msg->res != lwcellOK && msg->res != lwcellTIMEOUT) {
+            LWCELL_STATS_INC(cmd_errors);
+        }
+        LWCELL_TRACE(LWCELL_TRACE_ID_CMD_END, msg->cmd_def, msg->res, 0);
 
 #if LWCELL_CFG_USE_API_FUNC_EVT
         /* Send event function to user */
@@ -220,3 +244,33 @@ lwcell_thread_process(void* const arg) {
 #endif                            /* !LWCELL_CFG_INPUT_USE_PROCESS */
     }
 }
+
+#if LWCELL_CFG_EVT_DISPATCH || __DOXYGEN__
+
+/**
+ * \brief           Thread for delivering deferred events to application callbacks
+ * \param[in]       arg: User argument. Semaphore to release when thread starts
+ * \sa              LWCELL_CFG_EVT_DISPATCH
+ */
+void
+lwcell_thread_evt_dispatch(void* const arg) {
+    lwcell_sys_sem_t* sem = arg;
+    lwcell_t* e = &lwcell;
+    lwcell_evt_dispatch_entry_t* entry;
+    uint32_t time;
+
+    /* Thread is running, unlock semaphore */
+    if (lwcell_sys_sem_isvalid(sem)) {
+        lwcell_sys_sem_release(sem); /* Release semaphore */
+    }
+
+    while (1) {
+        time = lwcell_sys_mbox_get(&e->evt_dispatch.mbox, (void**)&entry, 0);
+        if (time == LWCELL_SYS_TIMEOUT || entry == NULL) {
+            continue;
+        }
+        lwcelli_evt_dispatch_process(entry); /* Deliver event to callbacks */
+    }
+}
+
+#endif /* LWCELL_CFG_EVT_DISPATCH || __DOXYGEN__ */
@@ -186,18 +186,20 @@ lwcell_timeout_add(uint32_t time, lwcell_timeout_fn fn, void* arg) {
 }
 
 /**
- * \brief           Remove callback from timeout list
+ * \brief           Remove first timeout matching callback and optionally its argument
  * \param[in]       fn: Callback function to identify timeout to remove
+ * \param[in]       arg: Callback argument to identify timeout to remove
+ * \param[in]       match_arg: Set to `1` to match `arg` too, `0` to match only callback function
  * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
  */
-lwcellr_t
-lwcell_timeout_remove(lwcell_timeout_fn fn) {
+static lwcellr_t
+timeout_remove(lwcell_timeout_fn fn, void* arg, uint8_t match_arg) {
     uint8_t success = 0;
 
     lwcell_core_lock();
     for (lwcell_timeout_t *t = first_timeout, *t_prev = NULL; t != NULL;
          t_prev = t, t = t->next) { /* Check all entries */
-        if (t->fn == fn) {          /* Do we have a match from callback point of view? */
+        if (t->fn == fn && (!match_arg || t->arg == arg)) { /* Do we have a match from callback point of view? */
 
             /*
              * We have to first increase
@@ -227,3 +229,28 @@ lwcell_timeout_remove(lwcell_timeout_fn fn) {
     lwcell_core_unlock();
     return success ? lwcellOK : lwcellERR;
 }
+
+/**
+ * \brief           Remove callback from timeout list
+ * \param[in]       fn: Callback function to identify timeout to remove
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_timeout_remove(lwcell_timeout_fn fn) {
+    return timeout_remove(fn, NULL, 0);
+}
+
+/**
+ * \brief           Remove callback with specific argument from timeout list
+ *
+ * Use it when the same callback function is used for more timeouts,
+ * each with different argument, such as one timeout per application object.
+ *
+ * \param[in]       fn: Callback function to identify timeout to remove
+ * \param[in]       arg: Callback argument to identify timeout to remove
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_timeout_remove_arg(lwcell_timeout_fn fn, void* arg) {
+    return timeout_remove(fn, arg, 1);
+}
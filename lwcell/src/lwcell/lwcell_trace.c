@@ -0,0 +1,113 @@
+/**
+ * \file            lwcell_trace.c
+ * \brief           Binary trace ring buffer
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "lwcell/lwcell_trace.h"
+#include "lwcell/lwcell_private.h"
+
+#if LWCELL_CFG_TRACE || __DOXYGEN__
+
+#if (LWCELL_CFG_TRACE_BUFF_SIZE & (LWCELL_CFG_TRACE_BUFF_SIZE - 1)) != 0
+#error "LWCELL_CFG_TRACE_BUFF_SIZE must be power of 2!"
+#endif /* (LWCELL_CFG_TRACE_BUFF_SIZE & (LWCELL_CFG_TRACE_BUFF_SIZE - 1)) != 0 */
+
+#define TRACE_MASK (LWCELL_CFG_TRACE_BUFF_SIZE - 1)
+
+static lwcell_trace_rec_t trace_recs[LWCELL_CFG_TRACE_BUFF_SIZE];
+static volatile uint32_t trace_w; /* Total number of records written */
+static uint32_t trace_r;          /* Total number of records read */
+
+/**
+ * \brief           Write trace record to ring buffer
+ * \note            Use \ref LWCELL_TRACE macro instead of calling function directly
+ * \param[in]       id: Record identifier. Member of \ref lwcell_trace_id_t enumeration
+ * \param[in]       a0: First argument
+ * \param[in]       a1: Second argument
+ * \param[in]       a2: Third argument
+ */
+void
+lwcelli_trace_write(lwcell_trace_id_t id, uint32_t a0, uint32_t a1, uint32_t a2) {
+    uint32_t w = trace_w;
+    lwcell_trace_rec_t* rec = &trace_recs[w & TRACE_MASK];
+
+    rec->time = LWCELL_CFG_TRACE_TIMESTAMP();
+    rec->id = (uint16_t)id;
+    rec->seq = (uint16_t)w;
+    rec->arg[0] = a0;
+    rec->arg[1] = a1;
+    rec->arg[2] = a2;
+    trace_w = w + 1;
+}
+
+/**
+ * \brief           Read trace records, oldest first
+ *
+ * Records are consumed and are not returned again on next call.
+ *
+ * \param[out]      recs: Output array of records
+ * \param[in]       max_recs: Maximal number of records to read
+ * \param[out]      lost: Output variable to write number of records overwritten before they were read.
+ *                      Set to `NULL` if not used
+ * \return          Number of records written to output array
+ */
+size_t
+lwcell_trace_read(lwcell_trace_rec_t* recs, size_t max_recs, uint32_t* lost) {
+    uint32_t w, lost_cnt = 0;
+    size_t cnt = 0;
+
+    lwcell_core_lock();
+    w = trace_w;
+    if ((w - trace_r) > LWCELL_CFG_TRACE_BUFF_SIZE) { /* Skip overwritten records */
+        lost_cnt = w - trace_r - LWCELL_CFG_TRACE_BUFF_SIZE;
+        trace_r = w - LWCELL_CFG_TRACE_BUFF_SIZE;
+    }
+    for (; cnt < max_recs && trace_r != w; ++cnt, ++trace_r) {
+        LWCELL_MEMCPY(&recs[cnt], &trace_recs[trace_r & TRACE_MASK], sizeof(*recs));
+    }
+    lwcell_core_unlock();
+    if (lost != NULL) {
+        *lost = lost_cnt;
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Discard all records in trace ring buffer
+ */
+void
+lwcell_trace_reset(void) {
+    lwcell_core_lock();
+    trace_r = trace_w;
+    lwcell_core_unlock();
+}
+
+#endif /* LWCELL_CFG_TRACE || __DOXYGEN__ */
@@ -0,0 +1,251 @@
+/**
+ * \file            lwcell_transparent.c
+ * \brief           Transparent mode API
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "lwcell/lwcell_transparent.h"
+#include "lwcell/lwcell_private.h"
+
+#if LWCELL_CFG_TRANSPARENT || __DOXYGEN__
+
+#if !LWCELL_CFG_CONN
+#error "LWCELL_CFG_CONN must be enabled to use transparent mode!"
+#endif /* !LWCELL_CFG_CONN */
+
+/* Notification sent by device when connection is closed in data mode */
+static const char closed_str[] = "\r\nCLOSED\r\n";
+#define CLOSED_STR_LEN (sizeof(closed_str) - 1)
+
+/**
+ * \brief           Send data to application
+ * \param[in]       data: Data to send
+ * \param[in]       len: Length of data
+ */
+static void
+prv_recv(const void* data, size_t len) {
+    if (len > 0 && lwcell.m.transparent.recv_fn != NULL) {
+        lwcell.m.transparent.recv_fn(data, len, lwcell.m.transparent.arg);
+    }
+    LWCELL_STATS_ADD(ipd_bytes, len);
+}
+
+/**
+ * \brief           Characters kept back as possible `CLOSED` notification were not followed by the rest of it
+ *                  in \ref LWCELL_CFG_TRANSPARENT_HOLD_TIME, they are connection data
+ * \param[in]       arg: Unused
+ */
+static void
+prv_hold_timeout(void* arg) {
+    LWCELL_UNUSED(arg);
+    lwcelli_transparent_flush();
+}
+
+/**
+ * \brief           Send characters kept back as possible `CLOSED` notification to application
+ */
+void
+lwcelli_transparent_flush(void) {
+    lwcell_timeout_remove(prv_hold_timeout);
+    if (lwcell.m.transparent.closed_match > 0) {
+        prv_recv(closed_str, lwcell.m.transparent.closed_match);
+        lwcell.m.transparent.closed_match = 0;
+    }
+}
+
+/**
+ * \brief           Process data received from device in data mode
+ *
+ * Data are passed to application as they are received.
+ * Characters possibly being part of `CLOSED` notification are kept back
+ * until notification is matched or cancelled by next character,
+ * or for \ref LWCELL_CFG_TRANSPARENT_HOLD_TIME when no more characters are received.
+ *
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data
+ * \return          Number of processed bytes. When smaller than `len`,
+ *                  device left data mode and remaining data are AT responses
+ */
+size_t
+lwcelli_transparent_input(const uint8_t* data, size_t len) {
+    size_t i = 0, start = 0;
+    uint8_t m, held = lwcell.m.transparent.closed_match > 0;
+
+    while (i < len) {
+        m = lwcell.m.transparent.closed_match;
+        if ((uint8_t)closed_str[m] == data[i]) {
+            if (m == 0) {
+                prv_recv(&data[start], i - start); /* Send everything before possible notification */
+            }
+            ++i;
+            if (++m == CLOSED_STR_LEN) {
+                lwcell_timeout_remove(prv_hold_timeout);
+                lwcell.m.transparent.closed_match = 0;
+                lwcell.m.transparent.data_mode = 0;
+                if (lwcell.m.transparent.recv_fn != NULL) {
+                    lwcell.m.transparent.recv_fn(NULL, 0, lwcell.m.transparent.arg);
+                }
+                return i;
+            }
+            lwcell.m.transparent.closed_match = m;
+            start = i;
+        } else if (m > 0) {
+            /*
+             * Kept characters are connection data.
+             * Notification can only start again at current character, check it from the beginning
+             */
+            prv_recv(closed_str, m);
+            lwcell.m.transparent.closed_match = 0;
+            start = i;
+        } else {
+            ++i;
+        }
+    }
+    if (lwcell.m.transparent.closed_match == 0) {
+        prv_recv(&data[start], len - start);
+    }
+    if (held || lwcell.m.transparent.closed_match > 0) {
+        /* Hold time restarts with every received character */
+        lwcell_timeout_remove(prv_hold_timeout);
+        if (lwcell.m.transparent.closed_match > 0) {
+            lwcell_timeout_add(LWCELL_CFG_TRANSPARENT_HOLD_TIME, prv_hold_timeout, NULL);
+        }
+    }
+    return len;
+}
+
+/**
+ * \brief           Start transparent mode session with single connection
+ *
+ * Device is switched to single connection transparent mode and PDP context is activated with given APN.
+ * Function returns successfully when connection is established and device is in data mode.
+ *
+ * \param[in]       apn: APN name
+ * \param[in]       user: User name to attach. Set to `NULL` if not used
+ * \param[in]       pass: User password to attach. Set to `NULL` if not used
+ * \param[in]       type: Connection type. This parameter can be a value of \ref lwcell_conn_type_t enumeration
+ * \param[in]       host: Connection host. In case of IP, write it as string, ex. "192.168.1.1"
+ * \param[in]       port: Connection port
+ * \param[in]       recv_fn: Callback function for received data
+ * \param[in]       arg: Custom argument for receive callback function
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_transparent_start(const char* apn, const char* user, const char* pass, lwcell_conn_type_t type,
+                         const char* const host, lwcell_port_t port, lwcell_transparent_recv_fn recv_fn,
+                         void* const arg, const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg,
+                         const uint32_t blocking) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_ASSERT(host != NULL);
+    LWCELL_ASSERT(port > 0);
+    LWCELL_ASSERT(recv_fn != NULL);
+    LWCELL_ASSERT(type == LWCELL_CONN_TYPE_TCP || type == LWCELL_CONN_TYPE_UDP);
+
+    LWCELL_MSG_VAR_ALLOC(msg, blocking);
+    LWCELL_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_TRANSPARENT_START;
+    LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_CIPSHUT;
+    LWCELL_MSG_VAR_REF(msg).msg.transparent_start.apn = apn;
+    LWCELL_MSG_VAR_REF(msg).msg.transparent_start.user = user;
+    LWCELL_MSG_VAR_REF(msg).msg.transparent_start.pass = pass;
+    LWCELL_MSG_VAR_REF(msg).msg.transparent_start.type = type;
+    LWCELL_MSG_VAR_REF(msg).msg.transparent_start.host = host;
+    LWCELL_MSG_VAR_REF(msg).msg.transparent_start.port = port;
+    LWCELL_MSG_VAR_REF(msg).msg.transparent_start.recv_fn = recv_fn;
+    LWCELL_MSG_VAR_REF(msg).msg.transparent_start.arg = arg;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd, 200000);
+}
+
+/**
+ * \brief           Send data to connection in transparent mode.
+ *                  Data are written directly to AT port from caller thread
+ * \param[in]       data: Data to send
+ * \param[in]       btw: Number of bytes to write
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_transparent_write(const void* data, size_t btw) {
+    lwcellr_t res = lwcellCLOSED;
+
+    LWCELL_ASSERT(data != NULL);
+
+    lwcell_core_lock();
+    if (lwcell.m.transparent.data_mode && !CMD_IS_CUR(LWCELL_CMD_TRANSPARENT_ESCAPE)) {
+        lwcelli_at_port_send_raw(data, btw);
+        res = lwcellOK;
+    }
+    lwcell_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Stop transparent mode session.
+ *
+ * Device returns to command mode with `+++` escape sequence, connection is closed,
+ * PDP context is deactivated and multiple connection mode is restored.
+ *
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwcellOK on success, member of \ref lwcellr_t enumeration otherwise
+ */
+lwcellr_t
+lwcell_transparent_stop(const lwcell_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    LWCELL_MSG_VAR_DEFINE(msg);
+
+    LWCELL_MSG_VAR_ALLOC(msg, blocking);
+    LWCELL_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWCELL_MSG_VAR_REF(msg).cmd_def = LWCELL_CMD_TRANSPARENT_STOP;
+    LWCELL_MSG_VAR_REF(msg).cmd = LWCELL_CMD_TRANSPARENT_ESCAPE;
+
+    return lwcelli_send_msg_to_producer_mbox(&LWCELL_MSG_VAR_REF(msg), lwcelli_initiate_cmd,
+                                             60000 + 2 * LWCELL_CFG_TRANSPARENT_GUARD_TIME);
+}
+
+/**
+ * \brief           Check if device is in transparent data mode
+ * \return          `1` if data mode is active, `0` otherwise
+ */
+uint8_t
+lwcell_transparent_is_active(void) {
+    uint8_t res;
+
+    lwcell_core_lock();
+    res = lwcell.m.transparent.data_mode;
+    lwcell_core_unlock();
+    return res;
+}
+
+#endif /* LWCELL_CFG_TRANSPARENT || __DOXYGEN__ */
@@ -255,6 +255,17 @@ configure_uart(uint32_t baudrate) {
     }
 }
 
+/**
+ * \brief           Change UART baudrate at runtime
+ * \param[in]       baudrate: New baudrate
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+reconfigure_uart(uint32_t baudrate) {
+    configure_uart(baudrate);
+    return 1;
+}
+
 #if defined(LWCELL_RESET_PIN)
 /**
  * \brief           Hardware reset callback
@@ -306,7 +317,8 @@ lwcell_ll_init(lwcell_ll_t* ll) {
 #endif /* !LWCELL_CFG_MEM_CUSTOM */
 
     if (!initialized) {
-        ll->send_fn = send_data; /* Set callback function to send data */
+        ll->send_fn = send_data;               /* Set callback function to send data */
+        ll->reconfigure_fn = reconfigure_uart; /* Set callback function to change baudrate */
 #if defined(LWCELL_RESET_PIN)
         ll->reset_fn = reset_device; /* Set callback for hardware reset */
 #endif                               /* defined(LWCELL_RESET_PIN) */
@@ -226,7 +226,8 @@ lwcell_ll_init(lwcell_ll_t* ll) {
 
     /* Step 2: Set AT port send function to use when we have data to transmit */
     if (!initialized) {
-        ll->send_fn = send_data; /* Set callback function to send data */
+        ll->send_fn = send_data;             /* Set callback function to send data */
+        ll->reconfigure_fn = configure_uart; /* Set callback function to change baudrate */
     }
 
     /* Step 3: Configure AT port to be able to send/receive data to/from GSM device */
@@ -0,0 +1,416 @@
+/**
+ * \file            lwcell_sys_posix.c
+ * \brief           System dependant functions for POSIX systems
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwCELL - Lightweight cellular modem AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lwcell/lwcell_private.h"
+#include "system/lwcell_sys.h"
+
+#if !__DOXYGEN__
+
+/**
+ * \brief           Binary semaphore, with the same semantics as on other ports
+ */
+struct lwcell_sys_posix_sem {
+    pthread_mutex_t mutex; /*!< Mutex to protect counter */
+    pthread_cond_t cond;   /*!< Condition signaled when counter is released */
+    uint8_t cnt;           /*!< Semaphore counter, either `0` or `1` */
+};
+
+/**
+ * \brief           Message queue implementation
+ */
+struct lwcell_sys_posix_mbox {
+    pthread_mutex_t mutex;     /*!< Mutex to protect queue */
+    pthread_cond_t not_empty;  /*!< Condition signaled when entry is written */
+    pthread_cond_t not_full;   /*!< Condition signaled when entry is read */
+    size_t in, out, cnt, size; /*!< Queue indexes, number of entries and queue size */
+    void* entries[];           /*!< Queue entries */
+};
+
+/**
+ * \brief           Thread start arguments
+ */
+typedef struct {
+    lwcell_sys_thread_fn fn; /*!< Thread function */
+    void* arg;               /*!< Thread function argument */
+} posix_thread_start_t;
+
+static struct timespec sys_start_time;
+static lwcell_sys_mutex_t sys_mutex; /* Mutex ID for main protection */
+
+/**
+ * \brief           Get absolute time for condition wait with relative timeout in milliseconds
+ * \param[out]      ts: Absolute time output
+ * \param[in]       timeout: Timeout in units of milliseconds
+ */
+static void
+prv_abs_time(struct timespec* ts, uint32_t timeout) {
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += timeout / 1000;
+    ts->tv_nsec += (long)(timeout % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ++ts->tv_sec;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * \brief           Wait for condition with optional timeout
+ * \param[in]       cond: Condition to wait for
+ * \param[in]       mutex: Locked mutex
+ * \param[in]       ts: Absolute timeout or `NULL` to wait forever
+ * \return          `1` when condition was signaled, `0` on timeout
+ */
+static uint8_t
+prv_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* ts) {
+    if (ts == NULL) {
+        pthread_cond_wait(cond, mutex);
+        return 1;
+    }
+    return pthread_cond_timedwait(cond, mutex, ts) != ETIMEDOUT;
+}
+
+/**
+ * \brief           Thread start trampoline
+ * \param[in]       arg: Thread start arguments, allocated by creator
+ * \return          `NULL`
+ */
+static void*
+prv_thread_start(void* arg) {
+    posix_thread_start_t s = *(posix_thread_start_t*)arg;
+
+    free(arg);
+    s.fn(s.arg);
+    return NULL;
+}
+
+uint8_t
+lwcell_sys_init(void) {
+    clock_gettime(CLOCK_MONOTONIC, &sys_start_time);
+
+    lwcell_sys_mutex_create(&sys_mutex);
+    return 1;
+}
+
+uint32_t
+lwcell_sys_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((now.tv_sec - sys_start_time.tv_sec) * 1000
+                      + (now.tv_nsec - sys_start_time.tv_nsec) / 1000000L);
+}
+
+uint8_t
+lwcell_sys_protect(void) {
+    lwcell_sys_mutex_lock(&sys_mutex);
+    return 1;
+}
+
+uint8_t
+lwcell_sys_unprotect(void) {
+    lwcell_sys_mutex_unlock(&sys_mutex);
+    return 1;
+}
+
+uint8_t
+lwcell_sys_mutex_create(lwcell_sys_mutex_t* p) {
+    pthread_mutexattr_t attr;
+
+    *p = malloc(sizeof(**p));
+    if (*p == NULL) {
+        return 0;
+    }
+
+    /* Mutex must be recursive, as on other ports */
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    if (pthread_mutex_init(*p, &attr) != 0) {
+        free(*p);
+        *p = NULL;
+    }
+    pthread_mutexattr_destroy(&attr);
+    return *p != NULL;
+}
+
+uint8_t
+lwcell_sys_mutex_delete(lwcell_sys_mutex_t* p) {
+    pthread_mutex_destroy(*p);
+    free(*p);
+    return 1;
+}
+
+uint8_t
+lwcell_sys_mutex_lock(lwcell_sys_mutex_t* p) {
+    return pthread_mutex_lock(*p) == 0;
+}
+
+uint8_t
+lwcell_sys_mutex_unlock(lwcell_sys_mutex_t* p) {
+    return pthread_mutex_unlock(*p) == 0;
+}
+
+uint8_t
+lwcell_sys_mutex_isvalid(lwcell_sys_mutex_t* p) {
+    return p != NULL && *p != NULL;
+}
+
+uint8_t
+lwcell_sys_mutex_invalid(lwcell_sys_mutex_t* p) {
+    *p = LWCELL_SYS_MUTEX_NULL;
+    return 1;
+}
+
+uint8_t
+lwcell_sys_sem_create(lwcell_sys_sem_t* p, uint8_t cnt) {
+    *p = malloc(sizeof(**p));
+    if (*p != NULL) {
+        pthread_mutex_init(&(*p)->mutex, NULL);
+        pthread_cond_init(&(*p)->cond, NULL);
+        (*p)->cnt = !!cnt;
+    }
+    return *p != NULL;
+}
+
+uint8_t
+lwcell_sys_sem_delete(lwcell_sys_sem_t* p) {
+    pthread_cond_destroy(&(*p)->cond);
+    pthread_mutex_destroy(&(*p)->mutex);
+    free(*p);
+    return 1;
+}
+
+uint32_t
+lwcell_sys_sem_wait(lwcell_sys_sem_t* p, uint32_t timeout) {
+    lwcell_sys_sem_t sem = *p;
+    struct timespec ts;
+    uint32_t time = lwcell_sys_now();
+
+    if (timeout > 0) {
+        prv_abs_time(&ts, timeout);
+    }
+    pthread_mutex_lock(&sem->mutex);
+    while (sem->cnt == 0) {
+        if (!prv_cond_wait(&sem->cond, &sem->mutex, timeout > 0 ? &ts : NULL)) {
+            pthread_mutex_unlock(&sem->mutex);
+            return LWCELL_SYS_TIMEOUT;
+        }
+    }
+    sem->cnt = 0;
+    pthread_mutex_unlock(&sem->mutex);
+    return lwcell_sys_now() - time;
+}
+
+uint8_t
+lwcell_sys_sem_release(lwcell_sys_sem_t* p) {
+    lwcell_sys_sem_t sem = *p;
+
+    pthread_mutex_lock(&sem->mutex);
+    sem->cnt = 1;
+    pthread_cond_signal(&sem->cond);
+    pthread_mutex_unlock(&sem->mutex);
+    return 1;
+}
+
+uint8_t
+lwcell_sys_sem_isvalid(lwcell_sys_sem_t* p) {
+    return p != NULL && *p != NULL;
+}
+
+uint8_t
+lwcell_sys_sem_invalid(lwcell_sys_sem_t* p) {
+    *p = LWCELL_SYS_SEM_NULL;
+    return 1;
+}
+
+uint8_t
+lwcell_sys_mbox_create(lwcell_sys_mbox_t* b, size_t size) {
+    lwcell_sys_mbox_t mbox;
+
+    mbox = malloc(sizeof(*mbox) + size * sizeof(void*));
+    if (mbox != NULL) {
+        memset(mbox, 0x00, sizeof(*mbox));
+        mbox->size = size;
+        pthread_mutex_init(&mbox->mutex, NULL);
+        pthread_cond_init(&mbox->not_empty, NULL);
+        pthread_cond_init(&mbox->not_full, NULL);
+    }
+    *b = mbox;
+    return *b != NULL;
+}
+
+uint8_t
+lwcell_sys_mbox_delete(lwcell_sys_mbox_t* b) {
+    lwcell_sys_mbox_t mbox = *b;
+
+    pthread_cond_destroy(&mbox->not_full);
+    pthread_cond_destroy(&mbox->not_empty);
+    pthread_mutex_destroy(&mbox->mutex);
+    free(mbox);
+    return 1;
+}
+
+uint32_t
+lwcell_sys_mbox_put(lwcell_sys_mbox_t* b, void* m) {
+    lwcell_sys_mbox_t mbox = *b;
+    uint32_t time = lwcell_sys_now();
+
+    pthread_mutex_lock(&mbox->mutex);
+    while (mbox->cnt == mbox->size) {
+        pthread_cond_wait(&mbox->not_full, &mbox->mutex);
+    }
+    mbox->entries[mbox->in] = m;
+    mbox->in = (mbox->in + 1) % mbox->size;
+    ++mbox->cnt;
+    pthread_cond_signal(&mbox->not_empty);
+    pthread_mutex_unlock(&mbox->mutex);
+    return lwcell_sys_now() - time;
+}
+
+uint32_t
+lwcell_sys_mbox_get(lwcell_sys_mbox_t* b, void** m, uint32_t timeout) {
+    lwcell_sys_mbox_t mbox = *b;
+    struct timespec ts;
+    uint32_t time = lwcell_sys_now();
+
+    if (timeout > 0) {
+        prv_abs_time(&ts, timeout);
+    }
+    pthread_mutex_lock(&mbox->mutex);
+    while (mbox->cnt == 0) {
+        if (!prv_cond_wait(&mbox->not_empty, &mbox->mutex, timeout > 0 ? &ts : NULL)) {
+            pthread_mutex_unlock(&mbox->mutex);
+            return LWCELL_SYS_TIMEOUT;
+        }
+    }
+    *m = mbox->entries[mbox->out];
+    mbox->out = (mbox->out + 1) % mbox->size;
+    --mbox->cnt;
+    pthread_cond_signal(&mbox->not_full);
+    pthread_mutex_unlock(&mbox->mutex);
+    return lwcell_sys_now() - time;
+}
+
+uint8_t
+lwcell_sys_mbox_putnow(lwcell_sys_mbox_t* b, void* m) {
+    lwcell_sys_mbox_t mbox = *b;
+    uint8_t res = 0;
+
+    pthread_mutex_lock(&mbox->mutex);
+    if (mbox->cnt < mbox->size) {
+        mbox->entries[mbox->in] = m;
+        mbox->in = (mbox->in + 1) % mbox->size;
+        ++mbox->cnt;
+        pthread_cond_signal(&mbox->not_empty);
+        res = 1;
+    }
+    pthread_mutex_unlock(&mbox->mutex);
+    return res;
+}
+
+uint8_t
+lwcell_sys_mbox_getnow(lwcell_sys_mbox_t* b, void** m) {
+    lwcell_sys_mbox_t mbox = *b;
+    uint8_t res = 0;
+
+    pthread_mutex_lock(&mbox->mutex);
+    if (mbox->cnt > 0) {
+        *m = mbox->entries[mbox->out];
+        mbox->out = (mbox->out + 1) % mbox->size;
+        --mbox->cnt;
+        pthread_cond_signal(&mbox->not_full);
+        res = 1;
+    }
+    pthread_mutex_unlock(&mbox->mutex);
+    return res;
+}
+
+uint8_t
+lwcell_sys_mbox_isvalid(lwcell_sys_mbox_t* b) {
+    return b != NULL && *b != NULL; /* Return status if message box is valid */
+}
+
+uint8_t
+lwcell_sys_mbox_invalid(lwcell_sys_mbox_t* b) {
+    *b = LWCELL_SYS_MBOX_NULL; /* Invalidate message box */
+    return 1;
+}
+
+uint8_t
+lwcell_sys_thread_create(lwcell_sys_thread_t* t, const char* name, lwcell_sys_thread_fn thread_func, void* const arg,
+                         size_t stack_size, lwcell_sys_thread_prio_t prio) {
+    posix_thread_start_t* s;
+    pthread_t h;
+
+    LWCELL_UNUSED(name);
+    LWCELL_UNUSED(stack_size);
+    LWCELL_UNUSED(prio);
+
+    if ((s = malloc(sizeof(*s))) == NULL) {
+        return 0;
+    }
+    s->fn = thread_func;
+    s->arg = arg;
+    if (pthread_create(&h, NULL, prv_thread_start, s) != 0) {
+        free(s);
+        return 0;
+    }
+    pthread_detach(h);
+    if (t != NULL) {
+        *t = h;
+    }
+    return 1;
+}
+
+uint8_t
+lwcell_sys_thread_terminate(lwcell_sys_thread_t* t) {
+    if (t == NULL) { /* Shall we terminate ourself? */
+        pthread_exit(NULL);
+    } else {
+        pthread_cancel(*t);
+    }
+    return 1;
+}
+
+uint8_t
+lwcell_sys_thread_yield(void) {
+    sched_yield();
+    return 1;
+}
+
+#endif /* !__DOXYGEN__ */
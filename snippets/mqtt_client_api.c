@@ -97,7 +97,8 @@ mqtt_client_api_thread(void const* arg) {
             if ((res = lwcell_mqtt_client_api_receive(client, &buf, 50000)) == lwcellOK) {
                 if (buf != NULL) {
                     printf("Publish received!\r\n");
-                    printf("Topic: %s, payload: %s\r\n", buf->topic, buf->payload);
+                    printf("Topic: %s, payload: %.*s\r\n", buf->topic, (int)buf->payload_len,
+                           (const char*)buf->payload);
                     lwcell_mqtt_client_api_buf_free(buf);
                     buf = NULL;
                 }
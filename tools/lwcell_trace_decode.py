@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""
+Decode LwCELL binary trace records.
+
+Input file is raw memory of lwcell_trace_rec_t records, as returned by
+lwcell_trace_read function, written in little-endian byte order.
+
+Record names and argument names are read from lwcell_trace.h header,
+so decoder always matches the library version.
+
+Usage:
+    lwcell_trace_decode.py trace.bin [--header path/to/lwcell_trace.h]
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+REC_FORMAT = "<IHH3I"
+REC_SIZE = struct.calcsize(REC_FORMAT)
+DEFAULT_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "lwcell", "src", "include", "lwcell",
+                              "lwcell_trace.h")
+
+
+def parse_header(path):
+    """Parse trace identifier enumeration and return {id: (name, [arg names])}"""
+    with open(path, "r", encoding="utf-8") as f:
+        text = f.read()
+    m = re.search(r"typedef enum \{(.*?)\} lwcell_trace_id_t;", text, re.S)
+    if m is None:
+        raise ValueError("lwcell_trace_id_t enumeration not found in " + path)
+    ids = {}
+    value = -1
+    for line in m.group(1).splitlines():
+        e = re.match(r"\s*LWCELL_TRACE_ID_(\w+)\s*(?:=\s*(\w+))?\s*,.*?Args:\s*(.*?)\s*\*/", line)
+        if e is None:
+            continue
+        value = int(e.group(2), 0) if e.group(2) is not None else value + 1
+        args = [a.strip() for a in e.group(3).split(",") if a.strip() not in ("", "-")]
+        ids[value] = (e.group(1), args)
+    return ids
+
+
+def format_arg(name, value):
+    """Format single argument"""
+    if name == "chars":
+        raw = struct.pack("<I", value)
+        return name + "=" + repr(raw.split(b"\x00")[0].decode("ascii", "replace"))
+    if name == "res":
+        return name + "=" + str(value if value < 0x80000000 else value - 0x100000000)
+    return name + "=" + str(value)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode LwCELL binary trace records")
+    parser.add_argument("file", help="Binary file with trace records")
+    parser.add_argument("--header", default=DEFAULT_HEADER, help="Path to lwcell_trace.h")
+    args = parser.parse_args()
+
+    ids = parse_header(args.header)
+    with open(args.file, "rb") as f:
+        data = f.read()
+
+    prev_time = None
+    prev_seq = None
+    for off in range(0, len(data) - REC_SIZE + 1, REC_SIZE):
+        time, rec_id, seq, a0, a1, a2 = struct.unpack_from(REC_FORMAT, data, off)
+        if prev_seq is not None and seq != ((prev_seq + 1) & 0xFFFF):
+            print("--- %d record(s) lost ---" % ((seq - prev_seq - 1) & 0xFFFF))
+        name, arg_names = ids.get(rec_id, ("UNKNOWN_%d" % rec_id, []))
+        values = [a0, a1, a2]
+        fields = [format_arg(n, v) for n, v in zip(arg_names, values)]
+        delta = time - prev_time if prev_time is not None else 0
+        print("%10u (+%6u) #%05u %-18s %s" % (time, delta & 0xFFFFFFFF, seq, name, " ".join(fields)))
+        prev_time = time
+        prev_seq = seq
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())